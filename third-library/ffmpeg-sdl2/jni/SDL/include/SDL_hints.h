@@ -707,6 +707,38 @@ extern "C" {
  */
 #define SDL_HINT_RPI_VIDEO_LAYER           "SDL_RPI_VIDEO_LAYER"
 
+/**
+ *  \brief  A variable controlling how an opened playback device converts
+ *          from the rate the application asked for to the rate the
+ *          hardware runs at.
+ *
+ *  This variable can be set to the following values:
+ *    "0" or "fast"    - The filters of SDL_BuildAudioCVT(), which only step
+ *                       in powers of two and restart on every buffer
+ *    "1" or "medium"  - A 16 tap windowed-sinc polyphase filter (default)
+ *    "2" or "best"    - A 48 tap windowed-sinc polyphase filter
+ *
+ *  The value is read when each device is opened, so devices opened at
+ *  different times can use different modes.
+ */
+#define SDL_HINT_AUDIO_RESAMPLING_MODE     "SDL_AUDIO_RESAMPLING_MODE"
+
+/**
+ *  \brief  A variable controlling the colorspace the software YUV texture
+ *          path converts with, for 32-bit RGB targets.
+ *
+ *  This variable can be set to the following values:
+ *    "JPEG" or "BT601_FULL"  - BT.601, full range
+ *    "BT601"                 - BT.601, limited (video) range
+ *    "BT709"                 - BT.709, limited range
+ *    "BT709_FULL"            - BT.709, full range
+ *    "AUTOMATIC"             - BT.601 up to 576 lines, BT.709 above, limited
+ *                              range (default)
+ *
+ *  The value is read when each texture is created.
+ */
+#define SDL_HINT_YUV_CONVERSION_MODE       "SDL_YUV_CONVERSION_MODE"
+
 /**
  *  \brief  An enumeration of hint priorities
  */
@@ -49,4 +49,29 @@ typedef struct
 } SDL_AudioRateFilters;
 extern const SDL_AudioRateFilters sdl_audio_rate_filters[];
 
+/* Streaming resampler for opened devices, working on interleaved float
+   frames. Put takes up to (frames) frames and returns how many fit; at most
+   max_frames more always fit once Get has returned less than asked for. */
+typedef struct SDL_AudioResampler SDL_AudioResampler;
+extern SDL_AudioResampler *SDL_NewAudioResampler(int channels, int src_rate,
+                                                 int dst_rate, int taps,
+                                                 int max_frames);
+extern void SDL_ResetAudioResampler(SDL_AudioResampler * r);
+extern void SDL_FreeAudioResampler(SDL_AudioResampler * r);
+extern int SDL_PutAudioResampler(SDL_AudioResampler * r, const float *in, int frames);
+extern int SDL_GetAudioResampler(SDL_AudioResampler * r, float *out, int frames);
+
+/* Vector path for the resampler's filter loop: SSE2 on x86, NEON when the
+   compiler targets it. */
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#if defined(__SSE2__)
+#define HAVE_SSE2_AUDIO 1
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAVE_NEON_AUDIO 1
+#include <arm_neon.h>
+#endif
+#endif
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -1118,4 +1118,252 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
 }
 
 
+
+/*
+ * Streaming polyphase resampler for opened devices.
+ *
+ * The filters above are stateless and rebuilt for every buffer, so they can
+ *  only do power-of-two steps and click at buffer edges. This one keeps a
+ *  history of planar float input between calls and computes each output
+ *  frame as a dot product of (taps) input frames with one row of a
+ *  Kaiser-windowed sinc table built when the device is opened. The rate
+ *  ratio is reduced to out_step/in_step; with at most
+ *  SDL_RESAMPLER_MAX_PHASES output phases the table has a row for every one
+ *  of them, otherwise the two nearest rows are interpolated.
+ */
+#define SDL_RESAMPLER_MAX_PHASES 512
+
+struct SDL_AudioResampler
+{
+    int channels;
+    int taps;                   /* filter length, a multiple of 4 */
+    int in_step;                /* src_rate / gcd(src_rate, dst_rate) */
+    int out_step;               /* dst_rate / gcd(src_rate, dst_rate) */
+    int phases;                 /* rows in (filter), less the guard row */
+    float *filter;              /* (phases + 1) rows of (taps) coefficients */
+    float *row;                 /* interpolated row, when phases < out_step */
+    float *fifo;                /* (channels) planes of (capacity) frames */
+    int capacity;
+    int fill;                   /* frames held in each plane */
+    int pos;                    /* first input frame of the next output */
+    int phase;                  /* position of the next output past (pos),
+                                   in 1/out_step input frames */
+};
+
+/* Zeroth order modified Bessel function of the first kind, for the window. */
+static double
+SDL_BesselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    int k;
+
+    for (k = 1; k < 50 && term > sum * 1e-12; k++) {
+        const double t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+static int
+SDL_GreatestCommonDivisor(int a, int b)
+{
+    while (b != 0) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+SDL_AudioResampler *
+SDL_NewAudioResampler(int channels, int src_rate, int dst_rate, int taps,
+                      int max_frames)
+{
+    const int gcd = SDL_GreatestCommonDivisor(src_rate, dst_rate);
+    const double half = taps / 2;
+    /* cut off a little below the lower of the two Nyquist rates */
+    const double cutoff = 0.97 * SDL_min(1.0, ((double) dst_rate) / src_rate);
+    const double beta = (taps >= 32) ? 9.0 : 6.5;
+    const double i0_beta = SDL_BesselI0(beta);
+    SDL_AudioResampler *r;
+    int p, k;
+
+    SDL_assert(channels > 0);
+    SDL_assert(src_rate > 0 && dst_rate > 0);
+    SDL_assert(taps >= 4 && (taps % 4) == 0);
+
+    r = (SDL_AudioResampler *) SDL_calloc(1, sizeof (SDL_AudioResampler));
+    if (r == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    r->channels = channels;
+    r->taps = taps;
+    r->in_step = src_rate / gcd;
+    r->out_step = dst_rate / gcd;
+    r->phases = SDL_min(r->out_step, SDL_RESAMPLER_MAX_PHASES);
+    r->capacity = taps + max_frames;
+    r->filter = (float *) SDL_malloc((r->phases + 1) * taps * sizeof (float));
+    r->row = (float *) SDL_malloc(taps * sizeof (float));
+    r->fifo = (float *) SDL_malloc(channels * r->capacity * sizeof (float));
+    if (!r->filter || !r->row || !r->fifo) {
+        SDL_FreeAudioResampler(r);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Row (p) filters the input (p / phases) of a frame past the tap at
+       half - 1; the extra last row is the first one shifted a frame along,
+       so interpolation never has to wrap. */
+    for (p = 0; p <= r->phases; p++) {
+        float *row = r->filter + p * taps;
+        double sum = 0.0;
+
+        for (k = 0; k < taps; k++) {
+            const double x = k - (half - 1) - ((double) p) / r->phases;
+            const double w = x / half;
+            double h = cutoff;
+            if (x != 0.0) {
+                h = SDL_sin(M_PI * cutoff * x) / (M_PI * x);
+            }
+            h *= (w * w < 1.0) ? SDL_BesselI0(beta * SDL_sqrt(1.0 - w * w)) / i0_beta : 0.0;
+            row[k] = (float) h;
+            sum += h;
+        }
+        /* unity gain at DC for every phase */
+        for (k = 0; k < taps; k++) {
+            row[k] = (float) (row[k] / sum);
+        }
+    }
+
+    SDL_ResetAudioResampler(r);
+    return r;
+}
+
+void
+SDL_ResetAudioResampler(SDL_AudioResampler * r)
+{
+    /* start with half a filter of silence, so the first output frame lines
+       up with the first input frame */
+    r->fill = r->taps / 2 - 1;
+    r->pos = 0;
+    r->phase = 0;
+    SDL_memset(r->fifo, '\0', r->channels * r->capacity * sizeof (float));
+}
+
+void
+SDL_FreeAudioResampler(SDL_AudioResampler * r)
+{
+    if (r) {
+        SDL_free(r->filter);
+        SDL_free(r->row);
+        SDL_free(r->fifo);
+        SDL_free(r);
+    }
+}
+
+int
+SDL_PutAudioResampler(SDL_AudioResampler * r, const float *in, int frames)
+{
+    const int channels = r->channels;
+    int c, i;
+
+    /* drop what has been consumed when the new frames wouldn't fit */
+    if (r->fill + frames > r->capacity && r->pos > 0) {
+        for (c = 0; c < channels; c++) {
+            float *plane = r->fifo + c * r->capacity;
+            SDL_memmove(plane, plane + r->pos, (r->fill - r->pos) * sizeof (float));
+        }
+        r->fill -= r->pos;
+        r->pos = 0;
+    }
+
+    frames = SDL_min(frames, r->capacity - r->fill);
+    for (c = 0; c < channels; c++) {
+        float *dst = r->fifo + c * r->capacity + r->fill;
+        const float *src = in + c;
+        for (i = 0; i < frames; i++, src += channels) {
+            dst[i] = *src;
+        }
+    }
+    r->fill += frames;
+    return frames;
+}
+
+static SDL_INLINE float
+SDL_ResampleDot(const float *x, const float *h, int taps)
+{
+    int k;
+#if HAVE_SSE2_AUDIO
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (k = 0; k + 8 <= taps; k += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(h + k)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + k + 4), _mm_loadu_ps(h + k + 4)));
+    }
+    if (k < taps) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(h + k)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+    acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+    return _mm_cvtss_f32(acc0);
+#elif HAVE_NEON_AUDIO
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    float32x2_t sum;
+    for (k = 0; k < taps; k += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(x + k), vld1q_f32(h + k));
+    }
+    sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+    float acc = 0.0f;
+    for (k = 0; k < taps; k++) {
+        acc += x[k] * h[k];
+    }
+    return acc;
+#endif
+}
+
+int
+SDL_GetAudioResampler(SDL_AudioResampler * r, float *out, int frames)
+{
+    const int channels = r->channels;
+    const int taps = r->taps;
+    int done = 0;
+    int c, k;
+
+    while (done < frames && r->pos + taps <= r->fill) {
+        const float *row;
+
+        if (r->phases == r->out_step) {
+            row = r->filter + r->phase * taps;
+        } else {
+            const double where = ((double) r->phase) * r->phases / r->out_step;
+            const int p = (int) where;
+            const float t = (float) (where - p);
+            const float *a = r->filter + p * taps;
+            const float *b = a + taps;
+            for (k = 0; k < taps; k++) {
+                r->row[k] = a[k] + (b[k] - a[k]) * t;
+            }
+            row = r->row;
+        }
+
+        for (c = 0; c < channels; c++) {
+            *(out++) = SDL_ResampleDot(r->fifo + c * r->capacity + r->pos, row, taps);
+        }
+        done++;
+
+        r->phase += r->in_step;
+        r->pos += r->phase / r->out_step;
+        r->phase %= r->out_step;
+    }
+
+    return done;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
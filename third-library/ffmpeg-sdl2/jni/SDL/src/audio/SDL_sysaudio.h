@@ -136,15 +136,6 @@ typedef struct SDL_AudioDriver
 } SDL_AudioDriver;
 
 
-/* Streamer */
-typedef struct
-{
-    Uint8 *buffer;
-    int max_len;                /* the maximum length in bytes */
-    int read_pos, write_pos;    /* the position of the write and read heads in bytes */
-} SDL_AudioStreamer;
-
-
 /* Define the SDL audio driver structure */
 struct SDL_AudioDevice
 {
@@ -158,9 +149,13 @@ struct SDL_AudioDevice
     /* An audio conversion block for audio format emulation */
     SDL_AudioCVT convert;
 
-    /* The streamer, if sample rate conversion necessitates it */
-    int use_streamer;
-    SDL_AudioStreamer streamer;
+    /* The resampler, if sample rate conversion necessitates it. (convert)
+       then only takes the callback's data to float at the device's channel
+       count, and (resample_cvt) takes the resampled float to the device's
+       format. */
+    struct SDL_AudioResampler *resampler;
+    SDL_AudioCVT resample_cvt;
+    int callback_len;
 
     /* Current state flags */
     SDL_atomic_t shutdown; /* true if we are signaling the play thread to end. */
@@ -20,7 +20,9 @@
 */
 #include "../SDL_internal.h"
 
-/* This is the software implementation of the YUV texture support */
+/* This is the software implementation of the YUV texture support.
+   third-library/mediaplayer/sdl and third-library/ffmpeg-sdl2/jni/SDL
+   carry the same copy of this file: change both. */
 
 /* This code was derived from code carrying the following copyright notices:
 
@@ -83,9 +85,12 @@
  */
 
 #include "SDL_assert.h"
+#include "SDL_atomic.h"
+#include "SDL_hints.h"
 #include "SDL_video.h"
 #include "SDL_cpuinfo.h"
 #include "SDL_yuv_sw_c.h"
+#include "../thread/SDL_systhread.h"
 
 
 /* The colorspace conversion functions */
@@ -856,6 +861,566 @@ Color32DitherYUY2Mod2X(int *colortab, Uint32 * rgb_2_pix,
     }
 }
 
+/*
+ * Row converters for 32-bit targets with 8-bit channels.
+ *
+ * These take one row of luma and the matching half-width rows of chroma and
+ *  compute R = (Y' + cr_r * Cr) / 64, G = (Y' - cb_g * Cb - cr_g * Cr) / 64
+ *  and B = (Y' + cb_b * Cb) / 64, where Y' = (lum * 0x0101 * y_gain) >> 16
+ *  less y_bias, the same way in C and in each vector version: 16-bit lanes
+ *  that saturate where the result clamps anyway.
+ */
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#if defined(__SSE2__)
+#define HAVE_SSE2_YUV 1
+#include <emmintrin.h>
+#if defined(__clang__) || \
+    (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define HAVE_AVX2_YUV 1
+#define SDL_TARGETING_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAVE_NEON_YUV 1
+#include <arm_neon.h>
+#endif
+#endif
+
+static SDL_INLINE Uint32
+SDL_SW_ClampRGB(int x)
+{
+    x >>= 6;
+    return (x < 0) ? 0 : (x > 255) ? 255 : (Uint32) x;
+}
+
+static void
+ColorRGB32Row(const SDL_SW_YUVTexture * swdata,
+              const Uint8 *lum, const Uint8 *cb, const Uint8 *cr,
+              Uint32 *out, int cols)
+{
+    const int rs = swdata->rgb_shift[0];
+    const int gs = swdata->rgb_shift[1];
+    const int bs = swdata->rgb_shift[2];
+    int x;
+
+    for (x = 0; x < cols; x++) {
+        const int u = cb[x >> 1] - 128;
+        const int v = cr[x >> 1] - 128;
+        const int y = (int) ((lum[x] * 0x0101u * swdata->y_gain) >> 16) - swdata->y_bias;
+
+        out[x] = (SDL_SW_ClampRGB(y + swdata->cr_r * v) << rs) |
+                 (SDL_SW_ClampRGB(y - swdata->cb_g * u - swdata->cr_g * v) << gs) |
+                 (SDL_SW_ClampRGB(y + swdata->cb_b * u) << bs) |
+                 swdata->rgb_alpha;
+    }
+}
+
+#if HAVE_SSE2_YUV || HAVE_NEON_YUV
+/* Byte position of each channel in memory, alpha (or padding) last */
+static void
+SDL_SW_ChannelBytes(const SDL_SW_YUVTexture * swdata, int *index, Uint8 *alpha)
+{
+    int used = 0;
+    int i;
+
+    index[3] = 3;
+    *alpha = 0;
+    for (i = 0; i < 3; i++) {
+        index[i] = swdata->rgb_shift[i] / 8;
+        used |= 1 << index[i];
+    }
+    for (i = 0; i < 4; i++) {
+        if (!(used & (1 << i))) {
+            index[3] = i;
+            *alpha = (Uint8) (swdata->rgb_alpha >> (i * 8));
+        }
+    }
+}
+#endif
+
+#if HAVE_SSE2_YUV
+/* Interleaves 16 pixels from four byte planes, in memory order */
+static SDL_INLINE void
+SDL_SW_StoreRGB32_SSE2(Uint32 *out, const __m128i *c)
+{
+    const __m128i lo01 = _mm_unpacklo_epi8(c[0], c[1]);
+    const __m128i hi01 = _mm_unpackhi_epi8(c[0], c[1]);
+    const __m128i lo23 = _mm_unpacklo_epi8(c[2], c[3]);
+    const __m128i hi23 = _mm_unpackhi_epi8(c[2], c[3]);
+    _mm_storeu_si128((__m128i *) out, _mm_unpacklo_epi16(lo01, lo23));
+    _mm_storeu_si128((__m128i *) (out + 4), _mm_unpackhi_epi16(lo01, lo23));
+    _mm_storeu_si128((__m128i *) (out + 8), _mm_unpacklo_epi16(hi01, hi23));
+    _mm_storeu_si128((__m128i *) (out + 12), _mm_unpackhi_epi16(hi01, hi23));
+}
+
+static void
+ColorRGB32Row_SSE2(const SDL_SW_YUVTexture * swdata,
+                   const Uint8 *lum, const Uint8 *cb, const Uint8 *cr,
+                   Uint32 *out, int cols)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i y_gain = _mm_set1_epi16((short) swdata->y_gain);
+    const __m128i y_bias = _mm_set1_epi16((short) swdata->y_bias);
+    const __m128i cr_r = _mm_set1_epi16((short) swdata->cr_r);
+    const __m128i cr_g = _mm_set1_epi16((short) swdata->cr_g);
+    const __m128i cb_g = _mm_set1_epi16((short) swdata->cb_g);
+    const __m128i cb_b = _mm_set1_epi16((short) swdata->cb_b);
+    __m128i c[4];
+    int index[4];
+    Uint8 alpha;
+    int x;
+
+    SDL_SW_ChannelBytes(swdata, index, &alpha);
+    c[index[3]] = _mm_set1_epi8((char) alpha);
+
+    for (x = 0; x + 16 <= cols; x += 16) {
+        const __m128i y = _mm_loadu_si128((const __m128i *) (lum + x));
+        const __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (cb + x / 2)), zero), c128);
+        const __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (cr + x / 2)), zero), c128);
+        const __m128i r_uv = _mm_mullo_epi16(v, cr_r);
+        const __m128i g_uv = _mm_add_epi16(_mm_mullo_epi16(u, cb_g), _mm_mullo_epi16(v, cr_g));
+        const __m128i b_uv = _mm_mullo_epi16(u, cb_b);
+        const __m128i ylo = _mm_subs_epi16(_mm_mulhi_epu16(_mm_unpacklo_epi8(y, y), y_gain), y_bias);
+        const __m128i yhi = _mm_subs_epi16(_mm_mulhi_epu16(_mm_unpackhi_epi8(y, y), y_gain), y_bias);
+
+        c[index[0]] = _mm_packus_epi16(
+            _mm_srai_epi16(_mm_adds_epi16(ylo, _mm_unpacklo_epi16(r_uv, r_uv)), 6),
+            _mm_srai_epi16(_mm_adds_epi16(yhi, _mm_unpackhi_epi16(r_uv, r_uv)), 6));
+        c[index[1]] = _mm_packus_epi16(
+            _mm_srai_epi16(_mm_subs_epi16(ylo, _mm_unpacklo_epi16(g_uv, g_uv)), 6),
+            _mm_srai_epi16(_mm_subs_epi16(yhi, _mm_unpackhi_epi16(g_uv, g_uv)), 6));
+        c[index[2]] = _mm_packus_epi16(
+            _mm_srai_epi16(_mm_adds_epi16(ylo, _mm_unpacklo_epi16(b_uv, b_uv)), 6),
+            _mm_srai_epi16(_mm_adds_epi16(yhi, _mm_unpackhi_epi16(b_uv, b_uv)), 6));
+        SDL_SW_StoreRGB32_SSE2(out + x, c);
+    }
+
+    ColorRGB32Row(swdata, lum + x, cb + x / 2, cr + x / 2, out + x, cols - x);
+}
+#endif /* HAVE_SSE2_YUV */
+
+#if HAVE_AVX2_YUV
+/* 16 luma samples as lum * 0x0101 */
+static SDL_INLINE SDL_TARGETING_AVX2 __m256i
+SDL_SW_Lum_AVX2(__m128i y)
+{
+    const __m256i w = _mm256_cvtepu8_epi16(y);
+    return _mm256_or_si256(w, _mm256_slli_epi16(w, 8));
+}
+
+/* 16 chroma terms to 32 lanes, each one twice */
+static SDL_INLINE SDL_TARGETING_AVX2 __m256i
+SDL_SW_DoubleLo_AVX2(__m256i x)
+{
+    const __m256i w = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(x));
+    return _mm256_or_si256(w, _mm256_slli_epi32(w, 16));
+}
+
+static SDL_INLINE SDL_TARGETING_AVX2 __m256i
+SDL_SW_DoubleHi_AVX2(__m256i x)
+{
+    const __m256i w = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1));
+    return _mm256_or_si256(w, _mm256_slli_epi32(w, 16));
+}
+
+static SDL_TARGETING_AVX2 void
+ColorRGB32Row_AVX2(const SDL_SW_YUVTexture * swdata,
+                   const Uint8 *lum, const Uint8 *cb, const Uint8 *cr,
+                   Uint32 *out, int cols)
+{
+    const __m256i c128 = _mm256_set1_epi16(128);
+    const __m256i y_gain = _mm256_set1_epi16((short) swdata->y_gain);
+    const __m256i y_bias = _mm256_set1_epi16((short) swdata->y_bias);
+    const __m256i cr_r = _mm256_set1_epi16((short) swdata->cr_r);
+    const __m256i cr_g = _mm256_set1_epi16((short) swdata->cr_g);
+    const __m256i cb_g = _mm256_set1_epi16((short) swdata->cb_g);
+    const __m256i cb_b = _mm256_set1_epi16((short) swdata->cb_b);
+    __m256i c[4];
+    int index[4];
+    Uint8 alpha;
+    int x;
+
+    SDL_SW_ChannelBytes(swdata, index, &alpha);
+    c[index[3]] = _mm256_set1_epi8((char) alpha);
+
+    /* packus leaves pixels 0-7 and 16-23 in the low lane, so after the
+       unpacks each store pairs up the matching low and high halves */
+    for (x = 0; x + 32 <= cols; x += 32) {
+        const __m128i y0 = _mm_loadu_si128((const __m128i *) (lum + x));
+        const __m128i y1 = _mm_loadu_si128((const __m128i *) (lum + x + 16));
+        const __m256i u = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (cb + x / 2))), c128);
+        const __m256i v = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (cr + x / 2))), c128);
+        const __m256i r_uv = _mm256_mullo_epi16(v, cr_r);
+        const __m256i g_uv = _mm256_add_epi16(_mm256_mullo_epi16(u, cb_g), _mm256_mullo_epi16(v, cr_g));
+        const __m256i b_uv = _mm256_mullo_epi16(u, cb_b);
+        const __m256i ylo = _mm256_subs_epi16(_mm256_mulhi_epu16(SDL_SW_Lum_AVX2(y0), y_gain), y_bias);
+        const __m256i yhi = _mm256_subs_epi16(_mm256_mulhi_epu16(SDL_SW_Lum_AVX2(y1), y_gain), y_bias);
+        __m256i lo01, hi01, lo23, hi23, a, b, d, e;
+
+        c[index[0]] = _mm256_packus_epi16(
+            _mm256_srai_epi16(_mm256_adds_epi16(ylo, SDL_SW_DoubleLo_AVX2(r_uv)), 6),
+            _mm256_srai_epi16(_mm256_adds_epi16(yhi, SDL_SW_DoubleHi_AVX2(r_uv)), 6));
+        c[index[1]] = _mm256_packus_epi16(
+            _mm256_srai_epi16(_mm256_subs_epi16(ylo, SDL_SW_DoubleLo_AVX2(g_uv)), 6),
+            _mm256_srai_epi16(_mm256_subs_epi16(yhi, SDL_SW_DoubleHi_AVX2(g_uv)), 6));
+        c[index[2]] = _mm256_packus_epi16(
+            _mm256_srai_epi16(_mm256_adds_epi16(ylo, SDL_SW_DoubleLo_AVX2(b_uv)), 6),
+            _mm256_srai_epi16(_mm256_adds_epi16(yhi, SDL_SW_DoubleHi_AVX2(b_uv)), 6));
+
+        lo01 = _mm256_unpacklo_epi8(c[0], c[1]);
+        hi01 = _mm256_unpackhi_epi8(c[0], c[1]);
+        lo23 = _mm256_unpacklo_epi8(c[2], c[3]);
+        hi23 = _mm256_unpackhi_epi8(c[2], c[3]);
+        a = _mm256_unpacklo_epi16(lo01, lo23);
+        b = _mm256_unpackhi_epi16(lo01, lo23);
+        d = _mm256_unpacklo_epi16(hi01, hi23);
+        e = _mm256_unpackhi_epi16(hi01, hi23);
+        _mm256_storeu_si256((__m256i *) (out + x), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i *) (out + x + 8), _mm256_permute2x128_si256(a, b, 0x31));
+        _mm256_storeu_si256((__m256i *) (out + x + 16), _mm256_permute2x128_si256(d, e, 0x20));
+        _mm256_storeu_si256((__m256i *) (out + x + 24), _mm256_permute2x128_si256(d, e, 0x31));
+    }
+
+    ColorRGB32Row_SSE2(swdata, lum + x, cb + x / 2, cr + x / 2, out + x, cols - x);
+}
+#endif /* HAVE_AVX2_YUV */
+
+#if HAVE_NEON_YUV
+static SDL_INLINE int16x8_t
+SDL_SW_LumNEON(uint8x8_t y, uint16x4_t y_gain)
+{
+    const uint16x8_t w = vmovl_u8(y);
+    const uint16x8_t yy = vorrq_u16(w, vshlq_n_u16(w, 8));
+    return vreinterpretq_s16_u16(vcombine_u16(
+        vshrn_n_u32(vmull_u16(vget_low_u16(yy), y_gain), 16),
+        vshrn_n_u32(vmull_u16(vget_high_u16(yy), y_gain), 16)));
+}
+
+static void
+ColorRGB32Row_NEON(const SDL_SW_YUVTexture * swdata,
+                   const Uint8 *lum, const Uint8 *cb, const Uint8 *cr,
+                   Uint32 *out, int cols)
+{
+    const uint8x8_t c128 = vdup_n_u8(128);
+    const uint16x4_t y_gain = vdup_n_u16((Uint16) swdata->y_gain);
+    const int16x8_t y_bias = vdupq_n_s16((Sint16) swdata->y_bias);
+    const Sint16 cr_r = (Sint16) swdata->cr_r;
+    const Sint16 cr_g = (Sint16) swdata->cr_g;
+    const Sint16 cb_g = (Sint16) swdata->cb_g;
+    const Sint16 cb_b = (Sint16) swdata->cb_b;
+    uint8x16x4_t c;
+    int index[4];
+    Uint8 alpha;
+    int x;
+
+    SDL_SW_ChannelBytes(swdata, index, &alpha);
+    c.val[index[3]] = vdupq_n_u8(alpha);
+
+    for (x = 0; x + 16 <= cols; x += 16) {
+        const uint8x16_t y = vld1q_u8(lum + x);
+        const int16x8_t u = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(cb + x / 2), c128));
+        const int16x8_t v = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(cr + x / 2), c128));
+        const int16x8_t r = vmulq_n_s16(v, cr_r);
+        const int16x8_t g = vmlaq_n_s16(vmulq_n_s16(u, cb_g), v, cr_g);
+        const int16x8_t b = vmulq_n_s16(u, cb_b);
+        const int16x8x2_t r_uv = vzipq_s16(r, r);
+        const int16x8x2_t g_uv = vzipq_s16(g, g);
+        const int16x8x2_t b_uv = vzipq_s16(b, b);
+        const int16x8_t ylo = vqsubq_s16(SDL_SW_LumNEON(vget_low_u8(y), y_gain), y_bias);
+        const int16x8_t yhi = vqsubq_s16(SDL_SW_LumNEON(vget_high_u8(y), y_gain), y_bias);
+
+        c.val[index[0]] = vcombine_u8(vqshrun_n_s16(vqaddq_s16(ylo, r_uv.val[0]), 6),
+                                      vqshrun_n_s16(vqaddq_s16(yhi, r_uv.val[1]), 6));
+        c.val[index[1]] = vcombine_u8(vqshrun_n_s16(vqsubq_s16(ylo, g_uv.val[0]), 6),
+                                      vqshrun_n_s16(vqsubq_s16(yhi, g_uv.val[1]), 6));
+        c.val[index[2]] = vcombine_u8(vqshrun_n_s16(vqaddq_s16(ylo, b_uv.val[0]), 6),
+                                      vqshrun_n_s16(vqaddq_s16(yhi, b_uv.val[1]), 6));
+        vst4q_u8((Uint8 *) (out + x), c);
+    }
+
+    ColorRGB32Row(swdata, lum + x, cb + x / 2, cr + x / 2, out + x, cols - x);
+}
+#endif /* HAVE_NEON_YUV */
+
+/*
+ * Whole-rectangle conversion for DisplayRow. Clipping and scaling are done
+ *  in the same pass, picking the nearest source sample like SDL_SoftStretch
+ *  does, and bands of output rows are spread over worker threads.
+ */
+#define SDL_SW_YUV_MAX_SLICES 8
+#define SDL_SW_YUV_MIN_SLICE_ROWS 64
+
+typedef struct
+{
+    SDL_SW_YUVTexture *swdata;
+    SDL_Rect src;
+    int w, h;                   /* output size */
+    Uint8 *pixels;
+    int pitch;
+    const Uint8 *lum, *cb, *cr;
+    int lum_pitch, chroma_pitch;
+    int chroma_vshift;          /* 1 for 4:2:0, 0 for packed 4:2:2 */
+    SDL_bool direct;            /* rows can be converted in place */
+    int *lum_offsets;           /* per output pixel, when not direct */
+    int *chroma_offsets;        /* per output pixel pair */
+} SDL_SW_YUVJob;
+
+typedef struct
+{
+    struct SDL_SW_YUVThreads *threads;
+    int index;
+    int first_row, last_row;
+    SDL_sem *start;
+    SDL_Thread *thread;
+} SDL_SW_YUVSlice;
+
+struct SDL_SW_YUVThreads
+{
+    SDL_SW_YUVJob job;
+    SDL_SW_YUVSlice slices[SDL_SW_YUV_MAX_SLICES];
+    int count;                  /* slices, the calling thread's included */
+    SDL_sem *done;
+    SDL_atomic_t quit;
+    int max_w;                  /* widest output the buffers below fit */
+    int *offsets;
+    Uint8 *scratch;             /* gathered rows, one set per slice */
+};
+typedef struct SDL_SW_YUVThreads SDL_SW_YUVThreads;
+
+static void
+SDL_SW_ConvertRows(SDL_SW_YUVThreads * threads, int index)
+{
+    const SDL_SW_YUVJob *job = &threads->job;
+    const SDL_SW_YUVSlice *slice = &threads->slices[index];
+    const SDL_SW_YUVTexture *swdata = job->swdata;
+    const int w = job->w;
+    const int cw = (w + 1) / 2;
+    const int *lum_offsets = job->lum_offsets;
+    const int *chroma_offsets = job->chroma_offsets;
+    Uint8 *lum_row = threads->scratch + index * (threads->max_w + 2 * ((threads->max_w + 1) / 2));
+    Uint8 *cb_row = lum_row + w;
+    Uint8 *cr_row = cb_row + cw;
+    Uint32 *prev = NULL;
+    int prev_sy = -1;
+    int dy, i;
+
+    for (dy = slice->first_row; dy < slice->last_row; dy++) {
+        const int sy = job->src.y + (dy * job->src.h) / job->h;
+        const Uint8 *lum = job->lum + sy * job->lum_pitch;
+        const Uint8 *cb = job->cb + (sy >> job->chroma_vshift) * job->chroma_pitch;
+        const Uint8 *cr = job->cr + (sy >> job->chroma_vshift) * job->chroma_pitch;
+        Uint32 *out = (Uint32 *) (job->pixels + dy * job->pitch);
+
+        if (sy == prev_sy) {
+            /* stretched vertically: same source row as the last one */
+            SDL_memcpy(out, prev, w * sizeof(Uint32));
+        } else if (job->direct) {
+            swdata->DisplayRow(swdata, lum + job->src.x, cb + job->src.x / 2,
+                               cr + job->src.x / 2, out, w);
+        } else {
+            for (i = 0; i < w; i++) {
+                lum_row[i] = lum[lum_offsets[i]];
+            }
+            for (i = 0; i < cw; i++) {
+                cb_row[i] = cb[chroma_offsets[i]];
+                cr_row[i] = cr[chroma_offsets[i]];
+            }
+            swdata->DisplayRow(swdata, lum_row, cb_row, cr_row, out, w);
+        }
+        prev = out;
+        prev_sy = sy;
+    }
+}
+
+static int SDLCALL
+SDL_SW_YUVSliceThread(void *data)
+{
+    SDL_SW_YUVSlice *slice = (SDL_SW_YUVSlice *) data;
+    SDL_SW_YUVThreads *threads = slice->threads;
+
+    for (;;) {
+        SDL_SemWait(slice->start);
+        if (SDL_AtomicGet(&threads->quit)) {
+            break;
+        }
+        SDL_SW_ConvertRows(threads, slice->index);
+        SDL_SemPost(threads->done);
+    }
+    return 0;
+}
+
+static SDL_SW_YUVThreads *
+SDL_SW_CreateYUVThreads(void)
+{
+    const int wanted = SDL_min(SDL_GetCPUCount(), SDL_SW_YUV_MAX_SLICES);
+    SDL_SW_YUVThreads *threads;
+    int i;
+
+    threads = (SDL_SW_YUVThreads *) SDL_calloc(1, sizeof(*threads));
+    if (!threads) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    threads->count = 1;
+
+    /* Running single threaded is fine if any of this fails */
+    if (wanted > 1) {
+        threads->done = SDL_CreateSemaphore(0);
+    }
+    for (i = 1; i < wanted && threads->done; i++) {
+        SDL_SW_YUVSlice *slice = &threads->slices[i];
+
+        slice->threads = threads;
+        slice->index = i;
+        slice->start = SDL_CreateSemaphore(0);
+        if (!slice->start) {
+            break;
+        }
+        slice->thread = SDL_CreateThreadInternal(SDL_SW_YUVSliceThread, "SDLYUVSlice",
+                                                 64 * 1024, slice);
+        if (!slice->thread) {
+            SDL_DestroySemaphore(slice->start);
+            break;
+        }
+        threads->count++;
+    }
+    return threads;
+}
+
+static void
+SDL_SW_DestroyYUVThreads(SDL_SW_YUVThreads * threads)
+{
+    int i;
+
+    if (!threads) {
+        return;
+    }
+    SDL_AtomicSet(&threads->quit, 1);
+    for (i = 1; i < threads->count; i++) {
+        SDL_SemPost(threads->slices[i].start);
+        SDL_WaitThread(threads->slices[i].thread, NULL);
+        SDL_DestroySemaphore(threads->slices[i].start);
+    }
+    if (threads->done) {
+        SDL_DestroySemaphore(threads->done);
+    }
+    SDL_free(threads->offsets);
+    SDL_free(threads->scratch);
+    SDL_free(threads);
+}
+
+static int
+SDL_SW_CopyYUVToRGB32(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
+                      int w, int h, void *pixels, int pitch)
+{
+    SDL_SW_YUVThreads *threads = swdata->threads;
+    SDL_SW_YUVJob *job;
+    const int cw = (w + 1) / 2;
+    int lum_step, chroma_step;
+    int count, i;
+
+    if (!threads) {
+        threads = swdata->threads = SDL_SW_CreateYUVThreads();
+        if (!threads) {
+            return -1;
+        }
+    }
+    if (w > threads->max_w) {
+        int *offsets = (int *) SDL_realloc(threads->offsets, (w + cw) * sizeof(int));
+        Uint8 *scratch = (Uint8 *) SDL_realloc(threads->scratch, threads->count * (w + 2 * cw));
+        if (offsets) {
+            threads->offsets = offsets;
+        }
+        if (scratch) {
+            threads->scratch = scratch;
+        }
+        if (!offsets || !scratch) {
+            return SDL_OutOfMemory();
+        }
+        threads->max_w = w;
+    }
+
+    job = &threads->job;
+    job->swdata = swdata;
+    job->src = *srcrect;
+    job->w = w;
+    job->h = h;
+    job->pixels = (Uint8 *) pixels;
+    job->pitch = pitch;
+    switch (swdata->format) {
+    case SDL_PIXELFORMAT_YV12:
+        job->lum = swdata->planes[0];
+        job->cr = swdata->planes[1];
+        job->cb = swdata->planes[2];
+        break;
+    case SDL_PIXELFORMAT_IYUV:
+        job->lum = swdata->planes[0];
+        job->cr = swdata->planes[2];
+        job->cb = swdata->planes[1];
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+        job->lum = swdata->planes[0];
+        job->cr = job->lum + 3;
+        job->cb = job->lum + 1;
+        break;
+    case SDL_PIXELFORMAT_UYVY:
+        job->lum = swdata->planes[0] + 1;
+        job->cr = job->lum + 1;
+        job->cb = job->lum - 1;
+        break;
+    case SDL_PIXELFORMAT_YVYU:
+        job->lum = swdata->planes[0];
+        job->cr = job->lum + 1;
+        job->cb = job->lum + 3;
+        break;
+    default:
+        return SDL_SetError("Unsupported YUV format in copy");
+    }
+    if (swdata->format == SDL_PIXELFORMAT_YV12 ||
+        swdata->format == SDL_PIXELFORMAT_IYUV) {
+        job->lum_pitch = swdata->pitches[0];
+        job->chroma_pitch = swdata->pitches[1];
+        job->chroma_vshift = 1;
+        lum_step = 1;
+        chroma_step = 1;
+    } else {
+        job->lum_pitch = swdata->pitches[0];
+        job->chroma_pitch = swdata->pitches[0];
+        job->chroma_vshift = 0;
+        lum_step = 2;
+        chroma_step = 4;
+    }
+
+    job->direct = (lum_step == 1 && srcrect->w == w && !(srcrect->x & 1));
+    if (!job->direct) {
+        /* each pair of output pixels takes the chroma of the first one */
+        job->lum_offsets = threads->offsets;
+        job->chroma_offsets = threads->offsets + w;
+        for (i = 0; i < w; i++) {
+            job->lum_offsets[i] = (srcrect->x + (i * srcrect->w) / w) * lum_step;
+        }
+        for (i = 0; i < cw; i++) {
+            job->chroma_offsets[i] = ((srcrect->x + (2 * i * srcrect->w) / w) / 2) * chroma_step;
+        }
+    }
+
+    count = SDL_min(threads->count, SDL_max(1, h / SDL_SW_YUV_MIN_SLICE_ROWS));
+    for (i = 0; i < count; i++) {
+        threads->slices[i].first_row = h * i / count;
+        threads->slices[i].last_row = h * (i + 1) / count;
+    }
+    for (i = 1; i < count; i++) {
+        SDL_SemPost(threads->slices[i].start);
+    }
+    SDL_SW_ConvertRows(threads, 0);
+    for (i = 1; i < count; i++) {
+        SDL_SemWait(threads->done);
+    }
+    return 0;
+}
+
 /*
  * How many 1 bits are there in the Uint32.
  * Low performance, do not call often.
@@ -885,6 +1450,13 @@ free_bits_at_bottom(Uint32 a)
     return 1 + free_bits_at_bottom(a >> 1);
 }
 
+static SDL_bool
+is_byte_mask(Uint32 a)
+{
+    return (a == 0x000000FF || a == 0x0000FF00 ||
+            a == 0x00FF0000 || a == 0xFF000000);
+}
+
 static int
 SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
 {
@@ -948,6 +1520,30 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
         b_2_pix_alloc[i + 512] = b_2_pix_alloc[511];
     }
 
+    /* 32-bit targets with a byte per channel get the row converters */
+    swdata->DisplayRow = NULL;
+    if (bpp == 32 && is_byte_mask(Rmask) && is_byte_mask(Gmask) &&
+        is_byte_mask(Bmask) && (!Amask || is_byte_mask(Amask))) {
+        swdata->rgb_shift[0] = free_bits_at_bottom(Rmask);
+        swdata->rgb_shift[1] = free_bits_at_bottom(Gmask);
+        swdata->rgb_shift[2] = free_bits_at_bottom(Bmask);
+        swdata->rgb_alpha = Amask;
+        swdata->DisplayRow = ColorRGB32Row;
+#if HAVE_SSE2_YUV
+        if (SDL_HasSSE2()) {
+            swdata->DisplayRow = ColorRGB32Row_SSE2;
+        }
+#endif
+#if HAVE_AVX2_YUV
+        if (SDL_HasAVX2()) {
+            swdata->DisplayRow = ColorRGB32Row_AVX2;
+        }
+#endif
+#if HAVE_NEON_YUV
+        swdata->DisplayRow = ColorRGB32Row_NEON;
+#endif
+    }
+
     /* You have chosen wisely... */
     switch (swdata->format) {
     case SDL_PIXELFORMAT_YV12:
@@ -1017,6 +1613,51 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
     return 0;
 }
 
+/*
+ * Fill in the DisplayRow coefficients for the matrix and range picked by
+ *  SDL_HINT_YUV_CONVERSION_MODE.
+ */
+static void
+SDL_SW_SetupYUVCoefficients(SDL_SW_YUVTexture * swdata)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_MODE);
+    SDL_bool bt709 = (swdata->h > 576);
+    SDL_bool full_range = SDL_FALSE;
+    double kr, kb, kg;
+    double y_scale = 255.0 / 219.0;
+    double c_scale = 255.0 / 224.0;
+    double y_offset = 16.0;
+
+    if (hint) {
+        if (SDL_strcasecmp(hint, "JPEG") == 0 || SDL_strcasecmp(hint, "BT601_FULL") == 0) {
+            bt709 = SDL_FALSE;
+            full_range = SDL_TRUE;
+        } else if (SDL_strcasecmp(hint, "BT601") == 0) {
+            bt709 = SDL_FALSE;
+        } else if (SDL_strcasecmp(hint, "BT709") == 0) {
+            bt709 = SDL_TRUE;
+        } else if (SDL_strcasecmp(hint, "BT709_FULL") == 0) {
+            bt709 = SDL_TRUE;
+            full_range = SDL_TRUE;
+        }
+    }
+    if (full_range) {
+        y_scale = 1.0;
+        c_scale = 1.0;
+        y_offset = 0.0;
+    }
+    kr = bt709 ? 0.2126 : 0.299;
+    kb = bt709 ? 0.0722 : 0.114;
+    kg = 1.0 - kr - kb;
+
+    swdata->y_gain = (int) (y_scale * 64.0 * 65536.0 / 257.0 + 0.5);
+    swdata->y_bias = (int) (y_offset * y_scale * 64.0 + 0.5) - 32;
+    swdata->cr_r = (int) (64.0 * 2.0 * (1.0 - kr) * c_scale + 0.5);
+    swdata->cr_g = (int) (64.0 * 2.0 * kr * (1.0 - kr) / kg * c_scale + 0.5);
+    swdata->cb_g = (int) (64.0 * 2.0 * kb * (1.0 - kb) / kg * c_scale + 0.5);
+    swdata->cb_b = (int) (64.0 * 2.0 * (1.0 - kb) * c_scale + 0.5);
+}
+
 SDL_SW_YUVTexture *
 SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
 {
@@ -1050,6 +1691,7 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
     swdata->target_format = SDL_PIXELFORMAT_UNKNOWN;
     swdata->w = w;
     swdata->h = h;
+    SDL_SW_SetupYUVCoefficients(swdata);
     swdata->pixels = (Uint8 *) SDL_malloc(w * h * 2);
     swdata->colortab = (int *) SDL_malloc(4 * 256 * sizeof(int));
     swdata->rgb_2_pix = (Uint32 *) SDL_malloc(3 * 768 * sizeof(Uint32));
@@ -1291,6 +1933,10 @@ SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
         }
     }
 
+    if (swdata->DisplayRow) {
+        return SDL_SW_CopyYUVToRGB32(swdata, srcrect, w, h, pixels, pitch);
+    }
+
     stretch = 0;
     scale_2x = 0;
     if (srcrect->x || srcrect->y || srcrect->w < swdata->w
@@ -1398,6 +2044,7 @@ SDL_SW_DestroyYUVTexture(SDL_SW_YUVTexture * swdata)
         SDL_free(swdata->rgb_2_pix);
         SDL_FreeSurface(swdata->stretch);
         SDL_FreeSurface(swdata->display);
+        SDL_SW_DestroyYUVThreads(swdata->threads);
         SDL_free(swdata);
     }
 }
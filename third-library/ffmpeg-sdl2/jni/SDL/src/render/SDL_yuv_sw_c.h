@@ -22,7 +22,9 @@
 
 #include "SDL_video.h"
 
-/* This is the software implementation of the YUV texture support */
+/* This is the software implementation of the YUV texture support.
+   third-library/mediaplayer/sdl and third-library/ffmpeg-sdl2/jni/SDL
+   carry the same copy of this file: change both. */
 
 struct SDL_SW_YUVTexture
 {
@@ -41,6 +43,22 @@ struct SDL_SW_YUVTexture
                        unsigned char *cb, unsigned char *out,
                        int rows, int cols, int mod);
 
+    /* Row converter for 32-bit targets with 8-bit channels; when set it
+       replaces Display1X/Display2X and the stretch surface */
+    void (*DisplayRow) (const struct SDL_SW_YUVTexture *swdata,
+                        const Uint8 *lum, const Uint8 *cb, const Uint8 *cr,
+                        Uint32 *out, int cols);
+    int rgb_shift[3];           /* bit position of R, G and B */
+    Uint32 rgb_alpha;           /* Amask of the target, or 0 */
+
+    /* YUV to RGB coefficients for DisplayRow, in 1/64 units */
+    int y_gain;                 /* applied to lum * 0x0101, keeps the top 16 bits */
+    int y_bias;
+    int cr_r, cr_g, cb_g, cb_b;
+
+    /* Worker threads for DisplayRow, created on first use */
+    struct SDL_SW_YUVThreads *threads;
+
     /* These are just so we don't have to allocate them separately */
     Uint16 pitches[3];
     Uint8 *planes[3];
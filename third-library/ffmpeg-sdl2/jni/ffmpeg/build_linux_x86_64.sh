@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Host build for profiling the player off-device: same codec set as the
+# android build, but with x86 asm (needs nasm or yasm) and -O3 instead of
+# --enable-small, installed to ./ffmpeg_linux_x86_64 for mediaplayer/CMakeLists.txt
+
+export HOST_CPU=${HOST_CPU:-host}
+
+if ! which nasm > /dev/null 2>&1 && ! which yasm > /dev/null 2>&1; then
+	echo "nasm/yasm not found, the x86 SIMD code would be left out"
+	exit 1
+fi
+
+./configure	\
+	--target-os=linux \
+	--prefix=./ffmpeg_linux_x86_64	\
+	--arch=x86_64	\
+	--cpu=$HOST_CPU	\
+	--enable-asm	\
+	--enable-x86asm	\
+	--enable-pic	\
+  	--disable-shared \
+  	--enable-static \
+  	--enable-zlib \
+  	--disable-doc \
+	--disable-ffprobe	\
+	--disable-ffplay	\
+	--disable-ffmpeg	\
+	--disable-ffserver	\
+	--disable-debug 	\
+	--extra-cflags="-O3 -fno-strict-aliasing"
+
+make clean
+make -j$(nproc)
+# make V=1
+
+make install
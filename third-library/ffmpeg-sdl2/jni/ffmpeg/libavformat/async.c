@@ -31,19 +31,28 @@
 #include "libavutil/avstring.h"
 #include "libavutil/error.h"
 #include "libavutil/fifo.h"
+#include "libavutil/internal.h"
 #include "libavutil/log.h"
 #include "libavutil/opt.h"
+#include "libavutil/random_seed.h"
 #include "libavutil/thread.h"
+#include "libavutil/time.h"
+#include "os_support.h"
 #include "url.h"
+#include <fcntl.h>
 #include <stdint.h>
 
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#if HAVE_IO_H
+#include <io.h>
+#endif
 
 #define BUFFER_CAPACITY         (4 * 1024 * 1024)
 #define READ_BACK_CAPACITY      (4 * 1024 * 1024)
 #define SHORT_SEEK_THRESHOLD    (256 * 1024)
+#define RATE_WINDOW             (1000 * 1000)
 
 typedef struct RingBuffer
 {
@@ -51,8 +60,15 @@ typedef struct RingBuffer
     int           read_back_capacity;
 
     int           read_pos;
+    int64_t       pos;          ///< logical position of the first byte in fifo
 } RingBuffer;
 
+/* downloaded bytes kept in the cache file, at their logical offset */
+typedef struct CacheRange {
+    int64_t start;
+    int64_t end;
+} CacheRange;
+
 typedef struct Context {
     AVClass        *class;
     URLContext     *inner;
@@ -70,6 +86,25 @@ typedef struct Context {
     int64_t         logical_pos;
     int64_t         logical_size;
     RingBuffer      ring;
+    int             ring_capacity_request;  ///< forward capacity wanted by the reader
+    int             seek_nowait;            ///< seek_request was made by a read, nobody waits for it
+
+    int64_t         download_pos;
+    int64_t         download_bytes;         ///< since download_start, time spent in reads only
+    int64_t         download_time;
+    int64_t         download_rate;          ///< bytes per second
+    int64_t         consume_start;
+    int64_t         consume_bytes;
+    int64_t         consume_rate;           ///< bytes per second
+    int64_t         reconnect_time;         ///< average duration of an inner seek
+
+    int             cache_fd;
+    char           *cache_path;             ///< the file behind cache_fd while it still has a name
+    pthread_mutex_t cache_mutex;            ///< file position of cache_fd, never taken with mutex held
+    CacheRange     *cache_ranges;
+    int             nb_cache_ranges;
+    int64_t         cache_size;
+    int64_t         file_read_end;          ///< reads below this are served from the cache file
 
     pthread_cond_t  cond_wakeup_main;
     pthread_cond_t  cond_wakeup_background;
@@ -78,6 +113,14 @@ typedef struct Context {
 
     int             abort_request;
     AVIOInterruptCB interrupt_callback;
+
+    /* options */
+    int             buffer_time;
+    int             max_buffer_size;
+    int             short_seek_time;
+    char           *cache_file;
+    int64_t         cache_max_size;
+    int             reconnects;
 } Context;
 
 static int ring_init(RingBuffer *ring, unsigned int capacity, int read_back_capacity)
@@ -96,10 +139,55 @@ static void ring_destroy(RingBuffer *ring)
     av_fifo_freep(&ring->fifo);
 }
 
-static void ring_reset(RingBuffer *ring)
+static void ring_reset(RingBuffer *ring, int64_t pos)
 {
     av_fifo_reset(ring->fifo);
     ring->read_pos = 0;
+    ring->pos      = pos;
+}
+
+/* logical position just past the last buffered byte */
+static int64_t ring_end(RingBuffer *ring)
+{
+    return ring->pos + av_fifo_size(ring->fifo);
+}
+
+static int ring_forward_capacity(RingBuffer *ring)
+{
+    return av_fifo_space(ring->fifo) + av_fifo_size(ring->fifo) - ring->read_back_capacity;
+}
+
+/* only while the writer is not running */
+static int ring_grow(RingBuffer *ring, int forward_capacity)
+{
+    int additional = forward_capacity - ring_forward_capacity(ring);
+
+    if (additional <= 0)
+        return 0;
+    return av_fifo_grow(ring->fifo, additional);
+}
+
+static void fifo_write_func(void *dest, void *src, int size)
+{
+    av_fifo_generic_write(dest, src, size, NULL);
+}
+
+/* only while the writer is not running, 0 without change if the data does not fit yet */
+static int ring_shrink(RingBuffer *ring, int forward_capacity)
+{
+    AVFifoBuffer *fifo;
+    int size = av_fifo_size(ring->fifo);
+
+    if (forward_capacity >= ring_forward_capacity(ring) ||
+        size > forward_capacity + ring->read_back_capacity)
+        return 0;
+    fifo = av_fifo_alloc(forward_capacity + ring->read_back_capacity);
+    if (!fifo)
+        return AVERROR(ENOMEM);
+    av_fifo_generic_read(ring->fifo, fifo, size, fifo_write_func);
+    av_fifo_freep(&ring->fifo);
+    ring->fifo = fifo;
+    return 1;
 }
 
 static int ring_size(RingBuffer *ring)
@@ -122,6 +210,7 @@ static int ring_generic_read(RingBuffer *ring, void *dest, int buf_size, void (*
 
     if (ring->read_pos > ring->read_back_capacity) {
         av_fifo_drain(ring->fifo, ring->read_pos - ring->read_back_capacity);
+        ring->pos     += ring->read_pos - ring->read_back_capacity;
         ring->read_pos = ring->read_back_capacity;
     }
 
@@ -134,19 +223,163 @@ static int ring_generic_write(RingBuffer *ring, void *src, int size, int (*func)
     return av_fifo_generic_write(ring->fifo, src, size, func);
 }
 
-static int ring_size_of_read_back(RingBuffer *ring)
+/* returns 0 if pos is outside the buffered data */
+static int ring_set_pos(RingBuffer *ring, int64_t pos)
 {
-    return ring->read_pos;
+    if (pos < ring->pos || pos > ring_end(ring))
+        return 0;
+    ring->read_pos = (int)(pos - ring->pos);
+    return 1;
 }
 
-static int ring_drain(RingBuffer *ring, int offset)
+/* newly covered bytes */
+static int64_t cache_range_add(Context *c, int64_t start, int64_t end)
 {
-    av_assert2(offset >= -ring_size_of_read_back(ring));
-    av_assert2(offset <= -ring_size(ring));
-    ring->read_pos += offset;
+    CacheRange *r;
+    int64_t covered = 0;
+    int i, j;
+
+    for (i = 0; i < c->nb_cache_ranges && c->cache_ranges[i].end < start; i++);
+    for (j = i; j < c->nb_cache_ranges && c->cache_ranges[j].start <= end; j++)
+        covered += c->cache_ranges[j].end - c->cache_ranges[j].start;
+
+    if (j == i) {
+        r = av_realloc_array(c->cache_ranges, c->nb_cache_ranges + 1, sizeof(*r));
+        if (!r)
+            return 0;
+        c->cache_ranges = r;
+        memmove(&r[i + 1], &r[i], (c->nb_cache_ranges - i) * sizeof(*r));
+        c->nb_cache_ranges++;
+        r[i].start = start;
+        r[i].end   = end;
+        return end - start;
+    }
+
+    /* merge ranges i..j-1 into i */
+    r = c->cache_ranges;
+    r[i].start = FFMIN(r[i].start, start);
+    r[i].end   = FFMAX(r[j - 1].end, end);
+    memmove(&r[i + 1], &r[j], (c->nb_cache_ranges - j) * sizeof(*r));
+    c->nb_cache_ranges -= j - i - 1;
+    return r[i].end - r[i].start - covered;
+}
+
+/* end of the cached range containing pos, or -1 */
+static int64_t cache_range_end(Context *c, int64_t pos)
+{
+    int i;
+
+    for (i = 0; i < c->nb_cache_ranges; i++) {
+        if (pos >= c->cache_ranges[i].start && pos < c->cache_ranges[i].end)
+            return c->cache_ranges[i].end;
+    }
+    return -1;
+}
+
+/*
+ * Background thread only, without the mutex: the disk must not stall the
+ * reader. Returns 1 if buf is now in the file at download_pos, the range is
+ * added to the map by the caller once it holds the mutex.
+ */
+static int cache_write(Context *c, const void *buf, int size)
+{
+    int ok;
+
+    if (c->cache_fd < 0 || c->cache_size + size > c->cache_max_size)
+        return 0;
+    pthread_mutex_lock(&c->cache_mutex);
+    ok = lseek(c->cache_fd, c->download_pos, SEEK_SET) == c->download_pos &&
+         write(c->cache_fd, buf, size) == size;
+    pthread_mutex_unlock(&c->cache_mutex);
+    if (!ok) {
+        av_log(NULL, AV_LOG_WARNING, "async: cache file write failed, caching stopped\n");
+        c->cache_max_size = 0;
+    }
+    return ok;
+}
+
+/* reader only, without the mutex; cached ranges never shrink or change */
+static int cache_read(Context *c, void *buf, int size, int64_t pos)
+{
+    int ret;
+
+    pthread_mutex_lock(&c->cache_mutex);
+    if (lseek(c->cache_fd, pos, SEEK_SET) != pos)
+        ret = AVERROR(errno);
+    else
+        ret = read(c->cache_fd, buf, size);
+    pthread_mutex_unlock(&c->cache_mutex);
+    return ret > 0 ? ret : ret < 0 ? ret : AVERROR(EIO);
+}
+
+/* a new file next to the cache_file prefix, so that contexts never share one */
+static int cache_open(URLContext *h)
+{
+    Context *c = h->priv_data;
+    int access = O_RDWR | O_CREAT | O_EXCL;
+    int i;
+
+#ifdef O_BINARY
+    access |= O_BINARY;
+#endif
+    for (i = 0; i < 16 && c->cache_fd < 0; i++) {
+        av_freep(&c->cache_path);
+        c->cache_path = av_asprintf("%s.%08x", c->cache_file, av_get_random_seed());
+        if (!c->cache_path)
+            return AVERROR(ENOMEM);
+        c->cache_fd = avpriv_open(c->cache_path, access, 0600);
+        if (c->cache_fd < 0 && errno != EEXIST)
+            break;
+    }
+    if (c->cache_fd < 0) {
+        av_log(h, AV_LOG_WARNING, "async: cannot create cache file %s\n", c->cache_path);
+        av_freep(&c->cache_path);
+        return AVERROR(EIO);
+    }
+#ifndef _WIN32
+    /* nothing is left behind even if the process dies */
+    if (!unlink(c->cache_path))
+        av_freep(&c->cache_path);
+#endif
     return 0;
 }
 
+static void cache_close(Context *c)
+{
+    if (c->cache_fd >= 0) {
+        /* the ranges only live in memory, the file is useless without them */
+        close(c->cache_fd);
+        c->cache_fd = -1;
+    }
+    if (c->cache_path)
+        unlink(c->cache_path);
+    av_freep(&c->cache_path);
+}
+
+/* bytes a forward seek may wait for rather than reconnect */
+static int64_t short_seek_threshold(Context *c)
+{
+    int64_t wait_time = c->short_seek_time >= 0 ? c->short_seek_time * 1000LL : c->reconnect_time;
+
+    return FFMAX(SHORT_SEEK_THRESHOLD, c->download_rate * wait_time / 1000000);
+}
+
+/*
+ * Asks the background thread to continue downloading at pos without waiting
+ * for it, the reader picks the data up from the ring once it is there.
+ * Called with the mutex held.
+ */
+static void request_seek_nowait(Context *c, int64_t pos)
+{
+    c->seek_request   = 1;
+    c->seek_nowait    = 1;
+    c->seek_pos       = pos;
+    c->seek_whence    = SEEK_SET;
+    c->seek_completed = 0;
+    c->seek_ret       = 0;
+    pthread_cond_signal(&c->cond_wakeup_background);
+}
+
 static int async_check_interrupt(void *arg)
 {
     URLContext *h   = arg;
@@ -165,11 +398,30 @@ static int wrapped_url_read(void *src, void *dst, int size)
 {
     URLContext *h   = src;
     Context    *c   = h->priv_data;
+    int64_t     start = av_gettime_relative();
     int         ret;
 
     ret = ffurl_read(c->inner, dst, size);
     c->inner_io_error = ret < 0 ? ret : 0;
 
+    if (ret > 0) {
+        int cached = cache_write(c, dst, ret);
+
+        pthread_mutex_lock(&c->mutex);
+        if (cached)
+            c->cache_size += cache_range_add(c, c->download_pos, c->download_pos + ret);
+        c->download_pos   += ret;
+        c->download_bytes += ret;
+        c->download_time  += av_gettime_relative() - start;
+        if (c->download_time >= RATE_WINDOW) {
+            int64_t rate = c->download_bytes * 1000000 / c->download_time;
+            c->download_rate  = c->download_rate ? (c->download_rate + rate) / 2 : rate;
+            c->download_bytes = 0;
+            c->download_time  = 0;
+        }
+        pthread_mutex_unlock(&c->mutex);
+    }
+
     return ret;
 }
 
@@ -194,23 +446,45 @@ static void *async_buffer_task(void *arg)
         }
 
         if (c->seek_request) {
+            int64_t seek_start = av_gettime_relative();
+
+            c->reconnects++;
             seek_ret = ffurl_seek(c->inner, c->seek_pos, c->seek_whence);
             if (seek_ret >= 0) {
+                int64_t t = av_gettime_relative() - seek_start;
+
+                c->reconnect_time = c->reconnect_time ? (c->reconnect_time + t) / 2 : t;
                 c->io_eof_reached = 0;
                 c->io_error       = 0;
-                ring_reset(ring);
+                c->download_pos   = seek_ret;
+                ring_reset(ring, seek_ret);
+            } else if (c->seek_nowait) {
+                /* a reader is waiting for the data */
+                c->io_eof_reached = 1;
+                c->io_error       = (int)seek_ret;
+                ring_reset(ring, c->seek_pos);
             }
 
             c->seek_completed = 1;
             c->seek_ret       = seek_ret;
             c->seek_request   = 0;
-
+            c->seek_nowait    = 0;
 
             pthread_cond_signal(&c->cond_wakeup_main);
             pthread_mutex_unlock(&c->mutex);
             continue;
         }
 
+        if (c->ring_capacity_request > ring_forward_capacity(ring)) {
+            if (ring_grow(ring, c->ring_capacity_request) < 0)
+                c->ring_capacity_request = 0;
+            else
+                av_log(h, AV_LOG_VERBOSE, "async: buffer grown to %d bytes\n", ring_forward_capacity(ring));
+        } else if (c->ring_capacity_request > 0 &&
+                   ring_shrink(ring, c->ring_capacity_request) > 0) {
+            av_log(h, AV_LOG_VERBOSE, "async: buffer shrunk to %d bytes\n", ring_forward_capacity(ring));
+        }
+
         fifo_space = ring_space(ring);
         if (c->io_eof_reached || fifo_space <= 0) {
             pthread_cond_signal(&c->cond_wakeup_main);
@@ -259,6 +533,22 @@ static int async_open(URLContext *h, const char *arg, int flags, AVDictionary **
 
     c->logical_size = ffurl_size(c->inner);
     h->is_streamed  = c->inner->is_streamed;
+    c->download_pos = FFMAX(ffurl_seek(c->inner, 0, SEEK_CUR), 0);
+    c->logical_pos  = c->download_pos;
+    c->ring.pos     = c->download_pos;
+
+    c->cache_fd = -1;
+    if (c->cache_file && c->cache_file[0] && !h->is_streamed && c->cache_max_size > 0 &&
+        cache_open(h) == AVERROR(ENOMEM)) {
+        ret = AVERROR(ENOMEM);
+        goto cache_fail;
+    }
+
+    ret = pthread_mutex_init(&c->cache_mutex, NULL);
+    if (ret != 0) {
+        av_log(h, AV_LOG_ERROR, "pthread_mutex_init failed : %s\n", av_err2str(ret));
+        goto cache_fail;
+    }
 
     ret = pthread_mutex_init(&c->mutex, NULL);
     if (ret != 0) {
@@ -293,6 +583,9 @@ cond_wakeup_background_fail:
 cond_wakeup_main_fail:
     pthread_mutex_destroy(&c->mutex);
 mutex_fail:
+    pthread_mutex_destroy(&c->cache_mutex);
+cache_fail:
+    cache_close(c);
     ffurl_close(c->inner);
 url_fail:
     ring_destroy(&c->ring);
@@ -314,15 +607,61 @@ static int async_close(URLContext *h)
     if (ret != 0)
         av_log(h, AV_LOG_ERROR, "pthread_join(): %s\n", av_err2str(ret));
 
+    av_log(h, AV_LOG_VERBOSE, "async: %d reconnects, %d cached ranges, %"PRId64" bytes cached\n",
+           c->reconnects, c->nb_cache_ranges, c->cache_size);
+
     pthread_cond_destroy(&c->cond_wakeup_background);
     pthread_cond_destroy(&c->cond_wakeup_main);
     pthread_mutex_destroy(&c->mutex);
+    pthread_mutex_destroy(&c->cache_mutex);
     ffurl_close(c->inner);
     ring_destroy(&c->ring);
+    cache_close(c);
+    av_freep(&c->cache_ranges);
 
     return 0;
 }
 
+/*
+ * Estimates how fast the data is consumed and asks for a forward capacity
+ * of buffer_time worth of it, larger or smaller. Only windows in which the
+ * ring stayed nearly full count: the reader was the bottleneck then, i.e.
+ * the player's own buffers were full and it read at the bitrate. While it
+ * fills them it reads as fast as the download goes, which says nothing
+ * about the bitrate. Called with the mutex held.
+ */
+static void update_consume_rate(Context *c, int size)
+{
+    int64_t now = av_gettime_relative();
+    int64_t rate, wanted;
+    int     capacity = ring_forward_capacity(&c->ring);
+
+    if (!c->buffer_time)
+        return;
+    if (ring_space(&c->ring) > capacity / 4 && !c->io_eof_reached) {
+        c->consume_start = 0;
+        c->consume_bytes = 0;
+        return;
+    }
+    if (!c->consume_start)
+        c->consume_start = now;
+    c->consume_bytes += size;
+    if (now - c->consume_start < RATE_WINDOW)
+        return;
+
+    rate = c->consume_bytes * 1000000 / (now - c->consume_start);
+    c->consume_rate  = c->consume_rate ? (c->consume_rate + rate) / 2 : rate;
+    c->consume_start = now;
+    c->consume_bytes = 0;
+
+    wanted = av_clip64(c->consume_rate * c->buffer_time / 1000, BUFFER_CAPACITY, c->max_buffer_size);
+    /* resize in large steps, a reallocation copies the whole buffer */
+    if (wanted > (int64_t)capacity * 5 / 4 || wanted < capacity / 2) {
+        c->ring_capacity_request = (int)wanted;
+        pthread_cond_signal(&c->cond_wakeup_background);
+    }
+}
+
 static int async_read_internal(URLContext *h, void *dest, int size, int read_complete,
                                void (*func)(void*, void*, int))
 {
@@ -339,6 +678,53 @@ static int async_read_internal(URLContext *h, void *dest, int size, int read_com
             ret = AVERROR_EXIT;
             break;
         }
+
+        if (c->logical_pos < c->file_read_end) {
+            /*
+             * served from the cache file; the download moves to file_read_end
+             * only when the reader gets close, it may well seek away before
+             */
+            if (!c->seek_request &&
+                (c->file_read_end < ring->pos || c->file_read_end > ring_end(ring)) &&
+                (c->logical_size <= 0 || c->file_read_end < c->logical_size) &&
+                c->file_read_end - c->logical_pos <= short_seek_threshold(c))
+                request_seek_nowait(c, c->file_read_end);
+
+            to_copy = (int)FFMIN(to_read, c->file_read_end - c->logical_pos);
+            if (!func) {
+                pthread_mutex_unlock(&c->mutex);
+                to_copy = cache_read(c, dest, to_copy, c->logical_pos);
+                pthread_mutex_lock(&c->mutex);
+                if (to_copy < 0) {
+                    av_log(h, AV_LOG_WARNING, "async: cache file read failed at %"PRId64"\n", c->logical_pos);
+                    c->file_read_end = 0;
+                    request_seek_nowait(c, c->logical_pos);
+                    continue;
+                }
+                dest = (uint8_t *)dest + to_copy;
+            }
+            c->logical_pos += to_copy;
+            to_read        -= to_copy;
+            ret             = size - to_read;
+            if (!func)
+                update_consume_rate(c, to_copy);
+
+            if (c->logical_pos >= c->file_read_end) {
+                c->file_read_end = 0;
+                if (!c->seek_request && !ring_set_pos(ring, c->logical_pos))
+                    request_seek_nowait(c, c->logical_pos);
+            }
+            if (to_read <= 0 || !read_complete)
+                break;
+            continue;
+        }
+
+        if (c->seek_nowait) {
+            pthread_cond_signal(&c->cond_wakeup_background);
+            pthread_cond_wait(&c->cond_wakeup_main, &c->mutex);
+            continue;
+        }
+
         fifo_size = ring_size(ring);
         to_copy   = FFMIN(to_read, fifo_size);
         if (to_copy > 0) {
@@ -348,6 +734,8 @@ static int async_read_internal(URLContext *h, void *dest, int size, int read_com
             c->logical_pos += to_copy;
             to_read        -= to_copy;
             ret             = size - to_read;
+            if (!func)
+                update_consume_rate(c, to_copy);
 
             if (to_read <= 0 || !read_complete)
                 break;
@@ -385,8 +773,7 @@ static int64_t async_seek(URLContext *h, int64_t pos, int whence)
     RingBuffer   *ring = &c->ring;
     int64_t       ret;
     int64_t       new_logical_pos;
-    int fifo_size;
-    int fifo_size_of_read_back;
+    int64_t       cache_end;
 
     if (whence == AVSEEK_SIZE) {
         av_log(h, AV_LOG_TRACE, "async_seek: AVSEEK_SIZE: %"PRId64"\n", (int64_t)c->logical_size);
@@ -402,40 +789,67 @@ static int64_t async_seek(URLContext *h, int64_t pos, int whence)
     }
     if (new_logical_pos < 0)
         return AVERROR(EINVAL);
-
-    fifo_size = ring_size(ring);
-    fifo_size_of_read_back = ring_size_of_read_back(ring);
-    if (new_logical_pos == c->logical_pos) {
-        /* current position */
+    if (new_logical_pos == c->logical_pos)
         return c->logical_pos;
-    } else if ((new_logical_pos >= (c->logical_pos - fifo_size_of_read_back)) &&
-               (new_logical_pos < (c->logical_pos + fifo_size + SHORT_SEEK_THRESHOLD))) {
-        int pos_delta = (int)(new_logical_pos - c->logical_pos);
-        /* fast seek */
-        av_log(h, AV_LOG_TRACE, "async_seek: fask_seek %"PRId64" from %d dist:%d/%d\n",
-                new_logical_pos, (int)c->logical_pos,
-                (int)(new_logical_pos - c->logical_pos), fifo_size);
-
-        if (pos_delta > 0) {
-            // fast seek forwards
-            async_read_internal(h, NULL, pos_delta, 1, fifo_do_not_copy_func);
-        } else {
-            // fast seek backwards
-            ring_drain(ring, pos_delta);
-            c->logical_pos = new_logical_pos;
+
+    pthread_mutex_lock(&c->mutex);
+
+    /* the ring is only meaningful once a pending reposition is done */
+    while (c->seek_nowait) {
+        if (async_check_interrupt(h)) {
+            pthread_mutex_unlock(&c->mutex);
+            return AVERROR_EXIT;
         }
+        pthread_cond_signal(&c->cond_wakeup_background);
+        pthread_cond_wait(&c->cond_wakeup_main, &c->mutex);
+    }
 
+    if (ring_set_pos(ring, new_logical_pos)) {
+        /* fast seek within the buffered data */
+        av_log(h, AV_LOG_TRACE, "async_seek: fast_seek %"PRId64" from %"PRId64"\n",
+               new_logical_pos, c->logical_pos);
+        c->file_read_end = 0;
+        c->logical_pos   = new_logical_pos;
+        pthread_cond_signal(&c->cond_wakeup_background);
+        pthread_mutex_unlock(&c->mutex);
+        return c->logical_pos;
+    } else if (new_logical_pos > ring_end(ring) &&
+               new_logical_pos - ring_end(ring) < short_seek_threshold(c)) {
+        /* short forward seek, wait for the download in flight */
+        int64_t pos_delta = new_logical_pos - ring_end(ring);
+
+        av_log(h, AV_LOG_TRACE, "async_seek: wait_seek %"PRId64" from %"PRId64" dist:%"PRId64"\n",
+               new_logical_pos, c->logical_pos, pos_delta);
+        ring_set_pos(ring, ring_end(ring));
+        c->file_read_end = 0;
+        c->logical_pos   = ring_end(ring);
+        pthread_mutex_unlock(&c->mutex);
+
+        while (pos_delta > 0) {
+            int n = async_read_internal(h, NULL, (int)FFMIN(pos_delta, INT_MAX), 1, fifo_do_not_copy_func);
+            if (n <= 0)
+                return n < 0 ? n : AVERROR_EOF;
+            pos_delta -= n;
+        }
+        return c->logical_pos;
+    } else if ((cache_end = cache_range_end(c, new_logical_pos)) > 0) {
+        /* read back from the cache file */
+        av_log(h, AV_LOG_TRACE, "async_seek: cache_seek %"PRId64" from %"PRId64", cached to %"PRId64"\n",
+               new_logical_pos, c->logical_pos, cache_end);
+        c->logical_pos   = new_logical_pos;
+        c->file_read_end = cache_end;
+        pthread_mutex_unlock(&c->mutex);
         return c->logical_pos;
     } else if (c->logical_size <= 0) {
         /* can not seek */
+        pthread_mutex_unlock(&c->mutex);
         return AVERROR(EINVAL);
     } else if (new_logical_pos > c->logical_size) {
         /* beyond end */
+        pthread_mutex_unlock(&c->mutex);
         return AVERROR(EINVAL);
     }
 
-    pthread_mutex_lock(&c->mutex);
-
     c->seek_request   = 1;
     c->seek_pos       = new_logical_pos;
     c->seek_whence    = SEEK_SET;
@@ -448,8 +862,10 @@ static int64_t async_seek(URLContext *h, int64_t pos, int whence)
             break;
         }
         if (c->seek_completed) {
-            if (c->seek_ret >= 0)
-                c->logical_pos  = c->seek_ret;
+            if (c->seek_ret >= 0) {
+                c->logical_pos   = c->seek_ret;
+                c->file_read_end = 0;
+            }
             ret = c->seek_ret;
             break;
         }
@@ -466,6 +882,18 @@ static int64_t async_seek(URLContext *h, int64_t pos, int whence)
 #define D AV_OPT_FLAG_DECODING_PARAM
 
 static const AVOption options[] = {
+    { "async_buffer_time", "resize the buffer to hold this much of the consumed data (in milliseconds), 0 to keep it fixed",
+        OFFSET(buffer_time), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX, D },
+    { "async_max_buffer_size", "upper bound of the grown buffer (in bytes)",
+        OFFSET(max_buffer_size), AV_OPT_TYPE_INT, { .i64 = 32 * 1024 * 1024 }, BUFFER_CAPACITY, INT_MAX / 2, D },
+    { "async_short_seek_time", "forward seeks the download reaches within this time (in milliseconds) wait instead of reconnecting, -1 for the measured reconnect time",
+        OFFSET(short_seek_time), AV_OPT_TYPE_INT, { .i64 = -1 }, -1, INT_MAX, D },
+    { "async_cache_file", "keep everything downloaded in a new file named after this prefix and read back from it instead of reconnecting",
+        OFFSET(cache_file), AV_OPT_TYPE_STRING, { .str = NULL }, 0, 0, D },
+    { "async_cache_max_size", "stop adding to the cache file beyond this size (in bytes)",
+        OFFSET(cache_max_size), AV_OPT_TYPE_INT64, { .i64 = 256 * 1024 * 1024 }, 0, INT64_MAX, D },
+    { "async_reconnects", "number of times the inner protocol was repositioned",
+        OFFSET(reconnects), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX, D | AV_OPT_FLAG_EXPORT | AV_OPT_FLAG_READONLY },
     {NULL},
 };
 
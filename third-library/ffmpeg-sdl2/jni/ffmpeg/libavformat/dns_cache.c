@@ -0,0 +1,174 @@
+/*
+ * Process-wide cache of resolved host addresses
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "libavutil/avstring.h"
+#include "libavutil/mem.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
+
+#include "dns_cache.h"
+
+#define DNS_CACHE_SIZE 32
+
+typedef struct DnsCacheEntry {
+    char            *key;           ///< "hostname:port/family", NULL if the slot is free
+    struct addrinfo *ai;
+    int64_t          expire_time;   ///< av_gettime_relative() based
+    int64_t          last_use;
+} DnsCacheEntry;
+
+static DnsCacheEntry dns_cache[DNS_CACHE_SIZE];
+static AVMutex dns_cache_mutex;
+static AVOnce dns_cache_once = AV_ONCE_INIT;
+
+static void dns_cache_init(void)
+{
+    ff_mutex_init(&dns_cache_mutex, NULL);
+}
+
+/* the copy is a single allocation per node, with ai_addr right after it */
+static struct addrinfo *dns_cache_copy(const struct addrinfo *ai)
+{
+    struct addrinfo *head = NULL, **tail = &head;
+
+    for (; ai; ai = ai->ai_next) {
+        struct addrinfo *node = av_mallocz(sizeof(*node) + ai->ai_addrlen);
+        if (!node) {
+            ff_dns_cache_free(head);
+            return NULL;
+        }
+        *node = *ai;
+        node->ai_canonname = NULL;
+        node->ai_next      = NULL;
+        node->ai_addr      = (struct sockaddr *)(node + 1);
+        memcpy(node->ai_addr, ai->ai_addr, ai->ai_addrlen);
+        *tail = node;
+        tail  = &node->ai_next;
+    }
+    return head;
+}
+
+static void dns_cache_clear_entry(DnsCacheEntry *entry)
+{
+    av_freep(&entry->key);
+    ff_dns_cache_free(entry->ai);
+    entry->ai = NULL;
+}
+
+/* an AF_INET6 lookup must not be served the addresses of an AF_UNSPEC one */
+static void dns_cache_key(char *key, int key_size, const char *hostname, int port, int family)
+{
+    snprintf(key, key_size, "%s:%d/%d", hostname, port, family);
+}
+
+static DnsCacheEntry *dns_cache_find(const char *key)
+{
+    int i;
+
+    for (i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (dns_cache[i].key && !strcmp(dns_cache[i].key, key))
+            return &dns_cache[i];
+    }
+    return NULL;
+}
+
+struct addrinfo *ff_dns_cache_get(const char *hostname, int port, int family)
+{
+    DnsCacheEntry *entry;
+    struct addrinfo *ai = NULL;
+    char key[1024];
+
+    dns_cache_key(key, sizeof(key), hostname, port, family);
+    ff_thread_once(&dns_cache_once, dns_cache_init);
+    ff_mutex_lock(&dns_cache_mutex);
+    entry = dns_cache_find(key);
+    if (entry) {
+        int64_t now = av_gettime_relative();
+        if (now >= entry->expire_time) {
+            dns_cache_clear_entry(entry);
+        } else {
+            entry->last_use = now;
+            ai = dns_cache_copy(entry->ai);
+        }
+    }
+    ff_mutex_unlock(&dns_cache_mutex);
+    return ai;
+}
+
+void ff_dns_cache_add(const char *hostname, int port, int family,
+                      const struct addrinfo *ai, int64_t timeout)
+{
+    DnsCacheEntry *entry;
+    struct addrinfo *copy;
+    int64_t now = av_gettime_relative();
+    char key[1024];
+    int i;
+
+    if (!ai || timeout <= 0)
+        return;
+    copy = dns_cache_copy(ai);
+    if (!copy)
+        return;
+
+    dns_cache_key(key, sizeof(key), hostname, port, family);
+    ff_thread_once(&dns_cache_once, dns_cache_init);
+    ff_mutex_lock(&dns_cache_mutex);
+    entry = dns_cache_find(key);
+    if (!entry) {
+        entry = &dns_cache[0];
+        for (i = 0; i < DNS_CACHE_SIZE && entry->key; i++) {
+            if (!dns_cache[i].key || dns_cache[i].last_use < entry->last_use)
+                entry = &dns_cache[i];
+        }
+    }
+    dns_cache_clear_entry(entry);
+    entry->key = av_strdup(key);
+    if (entry->key) {
+        entry->ai          = copy;
+        entry->expire_time = now + timeout * 1000;
+        entry->last_use    = now;
+        copy = NULL;
+    }
+    ff_mutex_unlock(&dns_cache_mutex);
+    ff_dns_cache_free(copy);
+}
+
+void ff_dns_cache_remove(const char *hostname, int port, int family)
+{
+    DnsCacheEntry *entry;
+    char key[1024];
+
+    dns_cache_key(key, sizeof(key), hostname, port, family);
+    ff_thread_once(&dns_cache_once, dns_cache_init);
+    ff_mutex_lock(&dns_cache_mutex);
+    entry = dns_cache_find(key);
+    if (entry)
+        dns_cache_clear_entry(entry);
+    ff_mutex_unlock(&dns_cache_mutex);
+}
+
+void ff_dns_cache_free(struct addrinfo *ai)
+{
+    while (ai) {
+        struct addrinfo *next = ai->ai_next;
+        av_free(ai);
+        ai = next;
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Process-wide cache of resolved host addresses
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFORMAT_DNS_CACHE_H
+#define AVFORMAT_DNS_CACHE_H
+
+#include <stdint.h>
+
+#include "network.h"
+
+/**
+ * Look up hostname:port as resolved for address family family (the
+ * ai_family of the getaddrinfo() hints, AF_UNSPEC for any).
+ *
+ * @return a private copy of the cached address list, to be released with
+ * ff_dns_cache_free(), or NULL if there is no unexpired entry
+ */
+struct addrinfo *ff_dns_cache_get(const char *hostname, int port, int family);
+
+/**
+ * Remember the addresses of hostname:port for family for timeout milliseconds,
+ * replacing any previous entry. The least recently used entry is evicted
+ * when the cache is full.
+ */
+void ff_dns_cache_add(const char *hostname, int port, int family,
+                      const struct addrinfo *ai, int64_t timeout);
+
+/**
+ * Drop the entry of hostname:port for family, e.g. after none of its
+ * addresses could be connected.
+ */
+void ff_dns_cache_remove(const char *hostname, int port, int family);
+
+void ff_dns_cache_free(struct addrinfo *ai);
+
+#endif /* AVFORMAT_DNS_CACHE_H */
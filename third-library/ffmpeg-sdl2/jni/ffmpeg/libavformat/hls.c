@@ -32,11 +32,14 @@
 #include "libavutil/mathematics.h"
 #include "libavutil/opt.h"
 #include "libavutil/dict.h"
+#include "libavutil/thread.h"
 #include "libavutil/time.h"
 #include "avformat.h"
 #include "internal.h"
 #include "avio_internal.h"
+#include "http.h"
 #include "id3v2.h"
+#include "url.h"
 
 #define INITIAL_BUFFER_SIZE 32768
 
@@ -77,6 +80,36 @@ struct segment {
 };
 
 struct rendition;
+struct playlist;
+
+enum PrefetchState {
+    PREFETCH_QUEUED,
+    PREFETCH_RUNNING,
+    PREFETCH_DONE,
+    PREFETCH_FAILED
+};
+
+/*
+ * A segment downloaded ahead of the reader by one of the prefetch threads.
+ * Jobs are owned by the HLSContext job list until the reader takes the one
+ * it needs, which is then served from memory by read_from_url().
+ */
+struct prefetch_job {
+    struct playlist *pls;
+    int seq_no;
+    char *url;
+    int64_t url_offset;
+    int64_t size;
+    AVDictionary *opts;
+    enum PrefetchState state;
+    int cancelled;
+    uint8_t *buf;
+    unsigned int buf_size;
+    int64_t buf_len;
+    int64_t read_pos;
+    int64_t throughput;         /* bits per second */
+    struct prefetch_job *next;
+};
 
 enum PlaylistType {
     PLS_TYPE_UNSPECIFIED,
@@ -115,6 +148,16 @@ struct playlist {
     int cur_seq_no;
     int64_t cur_seg_offset;
     int64_t last_load_time;
+    struct prefetch_job *prefetch_cur; /* segment being read, instead of input */
+    int64_t seg_io_time;               /* us spent in open and read, for segment_throughput */
+    int64_t seg_bytes;
+
+    /* abr: the variant whose segments this playlist reads, -1 if it does not
+     * follow abr_variant. It reads the segment list of abr_plays, and its own
+     * list is kept by abr_list_in meanwhile, see abr_take_list(). */
+    int abr_cur_variant;
+    struct playlist *abr_plays;
+    struct playlist *abr_list_in;
 
     /* Currently active Media Initialization Section */
     struct segment *cur_init_section;
@@ -206,6 +249,23 @@ typedef struct HLSContext {
     int strict_std_compliance;
     char *allowed_extensions;
     int max_reload;
+    int prefetch_segments;
+    int64_t segment_throughput;          ///< bits per second of the last downloaded segment
+    int abr;
+    int abr_variant;                     ///< variant to switch to at the next segment boundary
+    int cur_variant;                     ///< variant the main playlist currently takes its segments from
+    struct playlist *abr_pls;            ///< main playlist of the starting variant
+#if HAVE_THREADS
+    pthread_mutex_t prefetch_mutex;
+    pthread_cond_t prefetch_cond;
+    struct prefetch_worker *prefetch_workers;
+    int n_prefetch_workers;
+    int prefetch_abort;
+    struct prefetch_job *prefetch_jobs;
+    /* set by the workers, moved to segment_throughput by the reader, which
+     * is the thread the option is read from */
+    int64_t prefetch_throughput;
+#endif
 } HLSContext;
 
 static int read_chomp_line(AVIOContext *s, char *buf, int maxlen)
@@ -216,6 +276,18 @@ static int read_chomp_line(AVIOContext *s, char *buf, int maxlen)
     return len;
 }
 
+static void free_prefetch_job(struct prefetch_job **pjob)
+{
+    struct prefetch_job *job = *pjob;
+
+    if (!job)
+        return;
+    av_freep(&job->url);
+    av_dict_free(&job->opts);
+    av_freep(&job->buf);
+    av_freep(pjob);
+}
+
 static void free_segment_list(struct playlist *pls)
 {
     int i;
@@ -256,6 +328,7 @@ static void free_playlist_list(HLSContext *c)
         av_freep(&pls->pb.buffer);
         if (pls->input)
             ff_format_io_close(c->ctx, &pls->input);
+        free_prefetch_job(&pls->prefetch_cur);
         if (pls->ctx) {
             pls->ctx->pb = NULL;
             avformat_close_input(&pls->ctx);
@@ -893,7 +966,14 @@ static int read_from_url(struct playlist *pls, struct segment *seg,
     if (seg->size >= 0)
         buf_size = FFMIN(buf_size, seg->size - pls->cur_seg_offset);
 
-    if (mode == READ_COMPLETE) {
+    if (pls->prefetch_cur) {
+        struct prefetch_job *job = pls->prefetch_cur;
+        ret = FFMIN(buf_size, job->buf_len - job->read_pos);
+        if (ret <= 0)
+            return AVERROR_EOF;
+        memcpy(buf, job->buf + job->read_pos, ret);
+        job->read_pos += ret;
+    } else if (mode == READ_COMPLETE) {
         ret = avio_read(pls->input, buf, buf_size);
         if (ret != buf_size)
             av_log(NULL, AV_LOG_ERROR, "Could not read complete segment.\n");
@@ -1199,6 +1279,361 @@ cleanup:
     return ret;
 }
 
+#if HAVE_THREADS
+struct prefetch_worker {
+    HLSContext *c;
+    pthread_t thread;
+    int thread_created;
+    struct prefetch_job *job;
+    AVIOInterruptCB interrupt_callback;
+    /* kept open for the next request to the same server */
+    URLContext *conn;
+    char conn_origin[MAX_URL_SIZE];
+    int conn_ranged;
+};
+
+static int prefetch_interrupt_cb(void *opaque)
+{
+    struct prefetch_worker *w = opaque;
+    HLSContext *c = w->c;
+    int cancelled;
+
+    pthread_mutex_lock(&c->prefetch_mutex);
+    cancelled = c->prefetch_abort || (w->job && w->job->cancelled);
+    pthread_mutex_unlock(&c->prefetch_mutex);
+    return cancelled || ff_check_interrupt(c->interrupt_callback);
+}
+
+/* under prefetch_mutex */
+static void prefetch_unlink(HLSContext *c, struct prefetch_job *job)
+{
+    struct prefetch_job **link;
+
+    for (link = &c->prefetch_jobs; *link; link = &(*link)->next) {
+        if (*link == job) {
+            *link = job->next;
+            job->next = NULL;
+            return;
+        }
+    }
+}
+
+static void url_origin(char *origin, int origin_size, const char *url)
+{
+    char proto[16], host[256];
+    int port;
+
+    av_url_split(proto, sizeof(proto), NULL, 0, host, sizeof(host), &port,
+                 NULL, 0, url);
+    snprintf(origin, origin_size, "%s://%s:%d", proto, host, port);
+}
+
+static int prefetch_download(struct prefetch_worker *w, struct prefetch_job *job)
+{
+    HLSContext *c = w->c;
+    AVFormatContext *s = c->ctx;
+    char origin[MAX_URL_SIZE];
+    int ranged = job->size >= 0;
+    int reused = 0;
+    int64_t start = av_gettime_relative(), elapsed;
+    int ret;
+
+    url_origin(origin, sizeof(origin), job->url);
+    if (w->conn && !ranged && !w->conn_ranged && !strcmp(origin, w->conn_origin)) {
+        ret = ff_http_do_new_request(w->conn, job->url);
+        if (ret >= 0)
+            reused = 1;
+        else
+            ffurl_closep(&w->conn);
+    } else {
+        ffurl_closep(&w->conn);
+    }
+
+    if (!w->conn) {
+        AVDictionary *opts = NULL;
+
+        av_dict_copy(&opts, job->opts, 0);
+        av_dict_set(&opts, "multiple_requests", "1", 0);
+        if (ranged) {
+            av_dict_set_int(&opts, "offset", job->url_offset, 0);
+            av_dict_set_int(&opts, "end_offset", job->url_offset + job->size, 0);
+        }
+        ret = ffurl_open_whitelist(&w->conn, job->url, AVIO_FLAG_READ,
+                                   &w->interrupt_callback, &opts,
+                                   s->protocol_whitelist, s->protocol_blacklist, NULL);
+        av_dict_free(&opts);
+        if (ret < 0)
+            return ret;
+        av_strlcpy(w->conn_origin, origin, sizeof(w->conn_origin));
+        w->conn_ranged = ranged;
+    }
+
+    job->buf_len = 0;
+    for (;;) {
+        int64_t want = ranged ? job->size - job->buf_len : INITIAL_BUFFER_SIZE;
+        uint8_t *buf;
+
+        if (want <= 0)
+            break;
+        want = FFMIN(want, INITIAL_BUFFER_SIZE);
+        buf = av_fast_realloc(job->buf, &job->buf_size, job->buf_len + want);
+        if (!buf)
+            return AVERROR(ENOMEM);
+        job->buf = buf;
+
+        ret = ffurl_read(w->conn, job->buf + job->buf_len, want);
+        if (ret == AVERROR_EOF || ret == 0)
+            break;
+        if (ret < 0) {
+            ffurl_closep(&w->conn);
+            return ret;
+        }
+        job->buf_len += ret;
+    }
+    /* a server that does not know the length closes the connection */
+    if (ranged)
+        ffurl_closep(&w->conn);
+
+    elapsed = FFMAX(av_gettime_relative() - start, 1);
+    job->throughput = job->buf_len * 8 * 1000000 / elapsed;
+    av_log(s, AV_LOG_VERBOSE,
+           "HLS prefetched segment %d of playlist %d: %"PRId64" bytes in %"PRId64" ms, %"PRId64" kbps%s\n",
+           job->seq_no, job->pls->index, job->buf_len, elapsed / 1000,
+           job->throughput / 1000, reused ? ", reused connection" : "");
+    return 0;
+}
+
+static void *prefetch_thread(void *arg)
+{
+    struct prefetch_worker *w = arg;
+    HLSContext *c = w->c;
+    struct prefetch_job *job;
+    int ret;
+
+    pthread_mutex_lock(&c->prefetch_mutex);
+    while (!c->prefetch_abort) {
+        for (job = c->prefetch_jobs; job; job = job->next) {
+            if (job->state == PREFETCH_QUEUED && !job->cancelled)
+                break;
+        }
+        if (!job) {
+            pthread_cond_wait(&c->prefetch_cond, &c->prefetch_mutex);
+            continue;
+        }
+
+        job->state = PREFETCH_RUNNING;
+        w->job = job;
+        pthread_mutex_unlock(&c->prefetch_mutex);
+
+        ret = prefetch_download(w, job);
+
+        pthread_mutex_lock(&c->prefetch_mutex);
+        w->job = NULL;
+        job->state = ret < 0 ? PREFETCH_FAILED : PREFETCH_DONE;
+        if (ret >= 0)
+            c->prefetch_throughput = job->throughput;
+        if (ret < 0 && !job->cancelled && !c->prefetch_abort)
+            av_log(c->ctx, AV_LOG_WARNING, "HLS prefetch of segment %d of playlist %d failed: %s\n",
+                   job->seq_no, job->pls->index, av_err2str(ret));
+        /* nobody is going to take it, and its playlist may not schedule again */
+        if (job->cancelled) {
+            prefetch_unlink(c, job);
+            free_prefetch_job(&job);
+        }
+        pthread_cond_broadcast(&c->prefetch_cond);
+    }
+    pthread_mutex_unlock(&c->prefetch_mutex);
+
+    ffurl_closep(&w->conn);
+    return NULL;
+}
+
+static void prefetch_stop(HLSContext *c)
+{
+    struct prefetch_job *job;
+    int i;
+
+    if (!c->prefetch_workers)
+        return;
+
+    pthread_mutex_lock(&c->prefetch_mutex);
+    c->prefetch_abort = 1;
+    pthread_cond_broadcast(&c->prefetch_cond);
+    pthread_mutex_unlock(&c->prefetch_mutex);
+
+    for (i = 0; i < c->n_prefetch_workers; i++) {
+        if (c->prefetch_workers[i].thread_created)
+            pthread_join(c->prefetch_workers[i].thread, NULL);
+    }
+    av_freep(&c->prefetch_workers);
+    c->n_prefetch_workers = 0;
+
+    while ((job = c->prefetch_jobs)) {
+        c->prefetch_jobs = job->next;
+        free_prefetch_job(&job);
+    }
+    pthread_cond_destroy(&c->prefetch_cond);
+    pthread_mutex_destroy(&c->prefetch_mutex);
+}
+
+static int prefetch_start(HLSContext *c)
+{
+    int i, ret;
+
+    c->prefetch_workers = av_mallocz_array(c->prefetch_segments, sizeof(*c->prefetch_workers));
+    if (!c->prefetch_workers)
+        return AVERROR(ENOMEM);
+    c->n_prefetch_workers = c->prefetch_segments;
+    c->prefetch_abort = 0;
+    pthread_mutex_init(&c->prefetch_mutex, NULL);
+    pthread_cond_init(&c->prefetch_cond, NULL);
+
+    for (i = 0; i < c->n_prefetch_workers; i++) {
+        struct prefetch_worker *w = &c->prefetch_workers[i];
+        w->c = c;
+        w->interrupt_callback.callback = prefetch_interrupt_cb;
+        w->interrupt_callback.opaque = w;
+        ret = pthread_create(&w->thread, NULL, prefetch_thread, w);
+        if (ret) {
+            av_log(c->ctx, AV_LOG_ERROR, "Failed to create HLS prefetch thread: %s\n", av_err2str(AVERROR(ret)));
+            prefetch_stop(c);
+            return AVERROR(ret);
+        }
+        w->thread_created = 1;
+    }
+    return 0;
+}
+
+/*
+ * Queues the segments after the one being opened and drops stale jobs.
+ * Only plain http(s) segments are prefetched, local and encrypted ones are
+ * read as before.
+ */
+static void prefetch_schedule(HLSContext *c, struct playlist *pls)
+{
+    struct prefetch_job **link, *job;
+    int first = pls->cur_seq_no + 1;
+    int last = FFMIN(pls->cur_seq_no + c->prefetch_segments,
+                     pls->start_seq_no + pls->n_segments - 1);
+    int seq_no;
+
+    pthread_mutex_lock(&c->prefetch_mutex);
+    for (link = &c->prefetch_jobs; *link;) {
+        job = *link;
+        if (job->pls == pls && (job->seq_no < first || job->seq_no > last) &&
+            job->state != PREFETCH_RUNNING) {
+            *link = job->next;
+            free_prefetch_job(&job);
+            continue;
+        }
+        if (job->pls == pls && (job->seq_no < first || job->seq_no > last))
+            job->cancelled = 1;
+        link = &job->next;
+    }
+
+    for (seq_no = first; seq_no <= last; seq_no++) {
+        struct segment *seg = pls->segments[seq_no - pls->start_seq_no];
+
+        for (job = c->prefetch_jobs; job; job = job->next) {
+            if (job->pls == pls && job->seq_no == seq_no && !job->cancelled)
+                break;
+        }
+        if (job || seg->key_type != KEY_NONE || !av_strstart(seg->url, "http", NULL))
+            continue;
+
+        job = av_mallocz(sizeof(*job));
+        if (!job)
+            break;
+        job->pls        = pls;
+        job->seq_no     = seq_no;
+        job->url        = av_strdup(seg->url);
+        job->url_offset = seg->url_offset;
+        job->size       = seg->size;
+        job->state      = PREFETCH_QUEUED;
+        /* snapshot: the reader updates the cookies as it goes */
+        av_dict_copy(&job->opts, c->avio_opts, 0);
+        av_dict_set(&job->opts, "user_agent", c->user_agent, 0);
+        av_dict_set(&job->opts, "cookies", c->cookies, 0);
+        av_dict_set(&job->opts, "headers", c->headers, 0);
+        av_dict_set(&job->opts, "http_proxy", c->http_proxy, 0);
+        av_dict_set(&job->opts, "seekable", "0", 0);
+        if (!job->url) {
+            free_prefetch_job(&job);
+            break;
+        }
+        for (link = &c->prefetch_jobs; *link; link = &(*link)->next)
+            ;
+        *link = job;
+    }
+    pthread_cond_broadcast(&c->prefetch_cond);
+    pthread_mutex_unlock(&c->prefetch_mutex);
+}
+
+/*
+ * Waits for the prefetch of the current segment, NULL if there is none, it
+ * failed or the reader was interrupted while waiting.
+ */
+static struct prefetch_job *prefetch_take(HLSContext *c, struct playlist *pls)
+{
+    struct prefetch_job **link, *job = NULL;
+
+    pthread_mutex_lock(&c->prefetch_mutex);
+    for (;;) {
+        for (link = &c->prefetch_jobs; *link; link = &(*link)->next) {
+            if ((*link)->pls == pls && (*link)->seq_no == pls->cur_seq_no && !(*link)->cancelled)
+                break;
+        }
+        if (!*link)
+            break;
+        if ((*link)->state == PREFETCH_QUEUED || (*link)->state == PREFETCH_RUNNING) {
+            /* wake up now and then: a queued job does not poll the callback */
+            int64_t t = av_gettime() + 100000;
+            struct timespec tv = { .tv_sec  =  t / 1000000,
+                                   .tv_nsec = (t % 1000000) * 1000 };
+            if (ff_check_interrupt(c->interrupt_callback))
+                break;
+            pthread_cond_timedwait(&c->prefetch_cond, &c->prefetch_mutex, &tv);
+            continue;
+        }
+        job = *link;
+        *link = job->next;
+        job->next = NULL;
+        if (job->state == PREFETCH_FAILED)
+            free_prefetch_job(&job);
+        break;
+    }
+    if (c->prefetch_throughput) {
+        c->segment_throughput  = c->prefetch_throughput;
+        c->prefetch_throughput = 0;
+    }
+    pthread_mutex_unlock(&c->prefetch_mutex);
+    return job;
+}
+
+/* cancels the jobs of a playlist that is dropped or switched to another variant */
+static void prefetch_flush(HLSContext *c, struct playlist *pls)
+{
+    struct prefetch_job **link, *job;
+
+    if (!c->prefetch_workers)
+        return;
+
+    pthread_mutex_lock(&c->prefetch_mutex);
+    for (link = &c->prefetch_jobs; *link;) {
+        job = *link;
+        if (job->pls == pls && job->state != PREFETCH_RUNNING) {
+            *link = job->next;
+            free_prefetch_job(&job);
+            continue;
+        }
+        if (job->pls == pls)
+            job->cancelled = 1;
+        link = &job->next;
+    }
+    pthread_mutex_unlock(&c->prefetch_mutex);
+}
+#endif
+
 static int update_init_section(struct playlist *pls, struct segment *seg)
 {
     static const int max_init_section_size = 1024*1024;
@@ -1256,6 +1691,160 @@ static int update_init_section(struct playlist *pls, struct segment *seg)
     return 0;
 }
 
+static int find_timestamp_in_playlist(HLSContext *c, struct playlist *pls,
+                                      int64_t timestamp, int *seq_no);
+
+/*
+ * The playlist of var that has the part pls plays in its current variant:
+ * the main playlist, or the rendition of the same type, preferably with
+ * the same language and name.
+ */
+static struct playlist *abr_counterpart(HLSContext *c, struct playlist *pls, struct variant *var)
+{
+    struct playlist *cur = pls->abr_plays;
+    struct playlist *best = NULL;
+    struct rendition *rend;
+    int i, best_score = 0;
+
+    if (cur == c->variants[pls->abr_cur_variant]->playlists[0])
+        return var->playlists[0];
+    if (cur->n_renditions < 1)
+        return NULL;
+    rend = cur->renditions[0];
+
+    for (i = 1; i < var->n_playlists; i++) {
+        struct playlist *p = var->playlists[i];
+        struct rendition *r;
+        int score;
+
+        if (p->n_renditions < 1 || p->renditions[0]->type != rend->type)
+            continue;
+        r = p->renditions[0];
+        score = 1 + !strcmp(r->language, rend->language) * 2 + !strcmp(r->name, rend->name);
+        if (score > best_score) {
+            best       = p;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+/* swaps the segment lists, and everything that describes them, of a and b */
+static void abr_swap_lists(struct playlist *a, struct playlist *b)
+{
+    char url[MAX_URL_SIZE];
+
+    av_strlcpy(url, a->url, sizeof(url));
+    av_strlcpy(a->url, b->url, sizeof(a->url));
+    av_strlcpy(b->url, url, sizeof(b->url));
+    FFSWAP(int, a->finished, b->finished);
+    FFSWAP(enum PlaylistType, a->type, b->type);
+    FFSWAP(int64_t, a->target_duration, b->target_duration);
+    FFSWAP(int, a->start_seq_no, b->start_seq_no);
+    FFSWAP(int, a->n_segments, b->n_segments);
+    FFSWAP(struct segment **, a->segments, b->segments);
+    FFSWAP(int64_t, a->last_load_time, b->last_load_time);
+    FFSWAP(int, a->n_init_sections, b->n_init_sections);
+    FFSWAP(struct segment **, a->init_sections, b->init_sections);
+}
+
+/* makes pls read the segment list of target, handing its current one to
+ * the playlist that kept target's */
+static void abr_take_list(struct playlist *pls, struct playlist *target)
+{
+    struct playlist *holder = target->abr_list_in;
+    struct playlist *old    = pls->abr_plays;
+
+    if (holder == pls)
+        return;
+    abr_swap_lists(pls, holder);
+    target->abr_list_in = pls;
+    pls->abr_plays      = target;
+    old->abr_list_in    = holder;
+    holder->abr_plays   = old;
+}
+
+/* Whether pls plays a variant other than the one the ABR logic chose. */
+static int abr_switch_pending(HLSContext *c, struct playlist *pls)
+{
+    return pls->abr_cur_variant >= 0 && pls->abr_cur_variant != c->abr_variant &&
+           c->abr_variant >= 0 && c->abr_variant < c->n_variants;
+}
+
+/*
+ * Makes pls take its segments from the same part of variant c->abr_variant.
+ * VOD lists were all parsed by hls_read_header() and the next segment is
+ * looked up by time. A live list is fetched, which read_data() only asks
+ * for when the reload of the current one is due, and the next segment is
+ * the one as far from the live edge as the current one was.
+ * Returns 1 if pls now reads a freshly loaded list, 0 otherwise.
+ */
+static int switch_variant(HLSContext *c, struct playlist *pls)
+{
+    struct playlist *target = abr_counterpart(c, pls, c->variants[c->abr_variant]);
+    struct playlist *old = pls->abr_plays;
+    int from = pls->abr_cur_variant;
+    int64_t pos = c->first_timestamp == AV_NOPTS_VALUE ? 0 : c->first_timestamp;
+    int64_t behind = 0;
+    int i, ret = 0;
+
+    /* a rendition shared by both variants, or one that has no counterpart */
+    if (!target || target == old ||
+        (target->abr_list_in != pls && target->abr_list_in->needed &&
+         target->abr_list_in->abr_cur_variant >= 0))
+        goto done;
+
+    for (i = 0; i < pls->n_segments; i++) {
+        if (i < pls->cur_seq_no - pls->start_seq_no)
+            pos += pls->segments[i]->duration;
+        else
+            behind += pls->segments[i]->duration;
+    }
+    /* the edge has moved on since the current list was loaded */
+    behind += av_gettime_relative() - pls->last_load_time;
+
+    abr_take_list(pls, target);
+    if (!pls->finished)
+        ret = parse_playlist(c, pls->url, pls, NULL);
+    if (ret < 0 || pls->n_segments == 0) {
+        av_log(c->ctx, AV_LOG_WARNING, "Failed to switch playlist %d to variant %d, staying on %d\n",
+               pls->index, c->abr_variant, from);
+        abr_take_list(pls, old);
+        if (pls == c->abr_pls)
+            c->abr_variant = from;
+        pls->abr_cur_variant = c->abr_variant;
+        return 0;
+    }
+
+    if (pls->finished) {
+        find_timestamp_in_playlist(c, pls, pos, &pls->cur_seq_no);
+    } else {
+        int64_t edge = 0;
+        for (i = pls->n_segments - 1; i > 0; i--) {
+            edge += pls->segments[i]->duration;
+            if (edge >= behind) {
+                /* the closer of this segment's start and the next one's */
+                if (edge - behind > pls->segments[i]->duration / 2 && i + 1 < pls->n_segments)
+                    i++;
+                break;
+            }
+        }
+        pls->cur_seq_no = pls->start_seq_no + i;
+    }
+#if HAVE_THREADS
+    prefetch_flush(c, pls);
+#endif
+
+    av_log(c->ctx, AV_LOG_INFO, "Switched playlist %d from variant %d to %d (%d bps) at segment %d\n",
+           pls->index, from, c->abr_variant, c->variants[c->abr_variant]->bandwidth, pls->cur_seq_no);
+    ret = !pls->finished;
+done:
+    pls->abr_cur_variant = c->abr_variant;
+    if (pls == c->abr_pls)
+        c->cur_variant = c->abr_variant;
+    return ret;
+}
+
 static int64_t default_reload_interval(struct playlist *pls)
 {
     return pls->n_segments > 0 ?
@@ -1275,7 +1864,7 @@ restart:
     if (!v->needed)
         return AVERROR_EOF;
 
-    if (!v->input) {
+    if (!v->input && !v->prefetch_cur) {
         int64_t reload_interval;
         struct segment *seg;
 
@@ -1293,9 +1882,15 @@ restart:
         if (!v->needed) {
             av_log(v->parent, AV_LOG_INFO, "No longer receiving playlist %d\n",
                 v->index);
+#if HAVE_THREADS
+            prefetch_flush(c, v);
+#endif
             return AVERROR_EOF;
         }
 
+        if (v->finished && abr_switch_pending(c, v))
+            switch_variant(c, v);
+
         /* If this is a live stream and the reload interval has elapsed since
          * the last playlist reload, reload the playlists now. */
         reload_interval = default_reload_interval(v);
@@ -1306,7 +1901,11 @@ reload:
             return AVERROR_EOF;
         if (!v->finished &&
             av_gettime_relative() - v->last_load_time >= reload_interval) {
-            if ((ret = parse_playlist(c, v->url, v, NULL)) < 0) {
+            /* a live switch loads the new list in place of the reload
+             * that is due anyway, so it costs no extra request */
+            if (abr_switch_pending(c, v) && switch_variant(c, v) > 0)
+                ret = 0;
+            else if ((ret = parse_playlist(c, v->url, v, NULL)) < 0) {
                 av_log(v->parent, AV_LOG_WARNING, "Failed to reload playlist %d\n",
                        v->index);
                 return ret;
@@ -1341,7 +1940,22 @@ reload:
         if (ret)
             return ret;
 
+        v->seg_io_time = av_gettime_relative();
+        v->seg_bytes = 0;
+#if HAVE_THREADS
+        if (c->prefetch_segments > 0 && (c->prefetch_workers || prefetch_start(c) >= 0)) {
+            v->prefetch_cur = prefetch_take(c, v);
+            if (!v->prefetch_cur && ff_check_interrupt(c->interrupt_callback))
+                return AVERROR_EXIT;
+            prefetch_schedule(c, v);
+            v->cur_seg_offset = 0;
+        }
+        if (v->prefetch_cur)
+            ret = 0;
+        else
+#endif
         ret = open_input(c, v, seg);
+        v->seg_io_time = av_gettime_relative() - v->seg_io_time;
         if (ret < 0) {
             if (ff_check_interrupt(c->interrupt_callback))
                 return AVERROR_EXIT;
@@ -1361,7 +1975,17 @@ reload:
         return copy_size;
     }
 
-    ret = read_from_url(v, current_segment(v), buf, buf_size, READ_NORMAL);
+    if (v->input) {
+        /* only the time spent reading counts: while the player's buffer is
+         * full nobody calls us, and that is not the network being slow */
+        int64_t start = av_gettime_relative();
+        ret = read_from_url(v, current_segment(v), buf, buf_size, READ_NORMAL);
+        v->seg_io_time += av_gettime_relative() - start;
+        if (ret > 0)
+            v->seg_bytes += ret;
+    } else {
+        ret = read_from_url(v, current_segment(v), buf, buf_size, READ_NORMAL);
+    }
     if (ret > 0) {
         if (just_opened && v->is_id3_timestamped != 0) {
             /* Intercept ID3 tags here, elementary audio streams are required
@@ -1371,7 +1995,12 @@ reload:
 
         return ret;
     }
-    ff_format_io_close(v->parent, &v->input);
+    if (v->input) {
+        if (v->seg_bytes > 0 && v->seg_io_time > 0)
+            c->segment_throughput = v->seg_bytes * 8 * 1000000 / v->seg_io_time;
+        ff_format_io_close(v->parent, &v->input);
+    }
+    free_prefetch_job(&v->prefetch_cur);
     v->cur_seq_no++;
 
     c->cur_seq_no = v->cur_seq_no;
@@ -1627,6 +2256,9 @@ static int hls_close(AVFormatContext *s)
 {
     HLSContext *c = s->priv_data;
 
+#if HAVE_THREADS
+    prefetch_stop(c);
+#endif
     free_playlist_list(c);
     free_variant_list(c);
     free_rendition_list(c);
@@ -1636,6 +2268,17 @@ static int hls_close(AVFormatContext *s)
     return 0;
 }
 
+static int playlist_in_variant(struct variant *var, struct playlist *pls)
+{
+    int i;
+
+    for (i = 0; i < var->n_playlists; i++) {
+        if (var->playlists[i] == pls)
+            return 1;
+    }
+    return 0;
+}
+
 static int hls_read_header(AVFormatContext *s)
 {
     void *u = (s->flags & AVFMT_FLAG_CUSTOM_IO) ? NULL : s->pb;
@@ -1727,6 +2370,26 @@ static int hls_read_header(AVFormatContext *s)
         av_dict_set_int(&program->metadata, "variant_bitrate", v->bandwidth, 0);
     }
 
+    /* With abr only the starting variant is opened, its main playlist and
+     * renditions then take the segments of the same parts of whichever
+     * variant abr_variant selects. */
+    for (i = 0; i < c->n_playlists; i++) {
+        struct playlist *pls = c->playlists[i];
+        pls->abr_cur_variant = -1;
+        pls->abr_plays       = pls;
+        pls->abr_list_in     = pls;
+    }
+    if (c->abr && c->n_variants > 1) {
+        struct variant *var;
+
+        c->abr_variant = av_clip(c->abr_variant, 0, c->n_variants - 1);
+        c->cur_variant = c->abr_variant;
+        var            = c->variants[c->cur_variant];
+        c->abr_pls     = var->playlists[0];
+        for (i = 0; i < var->n_playlists; i++)
+            var->playlists[i]->abr_cur_variant = c->cur_variant;
+    }
+
     /* Select the starting segments */
     for (i = 0; i < c->n_playlists; i++) {
         struct playlist *pls = c->playlists[i];
@@ -1751,6 +2414,8 @@ static int hls_read_header(AVFormatContext *s)
 
         if (pls->n_segments == 0)
             continue;
+        if (c->abr_pls && !playlist_in_variant(c->variants[c->cur_variant], pls))
+            continue;
 
         pls->index  = i;
         pls->needed = 1;
@@ -1876,6 +2541,10 @@ static int recheck_discard_flags(AVFormatContext *s, int first)
         } else if (first && !pls->cur_needed && pls->needed) {
             if (pls->input)
                 ff_format_io_close(pls->parent, &pls->input);
+            free_prefetch_job(&pls->prefetch_cur);
+#if HAVE_THREADS
+            prefetch_flush(c, pls);
+#endif
             pls->needed = 0;
             changed = 1;
             av_log(s, AV_LOG_INFO, "No longer receiving playlist %d\n", i);
@@ -2110,6 +2779,7 @@ static int hls_read_seek(AVFormatContext *s, int stream_index,
         struct playlist *pls = c->playlists[i];
         if (pls->input)
             ff_format_io_close(pls->parent, &pls->input);
+        free_prefetch_job(&pls->prefetch_cur);
         av_packet_unref(&pls->pkt);
         reset_packet(&pls->pkt);
         pls->pb.eof_reached = 0;
@@ -2164,6 +2834,16 @@ static const AVOption hls_options[] = {
         INT_MIN, INT_MAX, FLAGS},
     {"max_reload", "Maximum number of times a insufficient list is attempted to be reloaded",
         OFFSET(max_reload), AV_OPT_TYPE_INT, {.i64 = 1000}, 0, INT_MAX, FLAGS},
+    {"prefetch_segments", "Number of upcoming http segments to download in parallel (0 = off)",
+        OFFSET(prefetch_segments), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 8, FLAGS},
+    {"abr", "Switch the main playlist and its renditions between variants at segment boundaries, see abr_variant",
+        OFFSET(abr), AV_OPT_TYPE_BOOL, {.i64 = 0}, 0, 1, FLAGS},
+    {"abr_variant", "Variant to start with, and to switch to when set while reading",
+        OFFSET(abr_variant), AV_OPT_TYPE_INT, {.i64 = 0}, 0, INT_MAX, FLAGS},
+    {"cur_variant", "Variant the segments are currently read from",
+        OFFSET(cur_variant), AV_OPT_TYPE_INT, {.i64 = 0}, 0, INT_MAX, FLAGS | AV_OPT_FLAG_EXPORT | AV_OPT_FLAG_READONLY},
+    {"segment_throughput", "Throughput of the last downloaded segment in bits per second",
+        OFFSET(segment_throughput), AV_OPT_TYPE_INT64, {.i64 = 0}, 0, INT64_MAX, FLAGS | AV_OPT_FLAG_EXPORT | AV_OPT_FLAG_READONLY},
     {NULL}
 };
 
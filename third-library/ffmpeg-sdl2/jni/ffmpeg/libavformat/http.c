@@ -317,6 +317,43 @@ int ff_http_do_new_request(URLContext *h, const char *uri)
     return ret;
 }
 
+int ff_http_do_new_request2(URLContext *h, const char *uri, AVDictionary **opts)
+{
+    HTTPContext *s = h->priv_data;
+    AVDictionary *options = NULL;
+    int ret;
+
+    if (!s->hd || s->willclose)
+        return AVERROR_EOF;
+
+    /* The connection may have been opened by someone else: nothing of the
+     * previous request (range, headers, cookies, credentials, user agent)
+     * may carry over to this one, only what opts sets. */
+    av_opt_set_defaults(s);
+    s->multiple_requests = 1;
+    av_dict_free(&s->cookie_dict);
+    av_freep(&s->post_data);
+    s->post_datalen = 0;
+    memset(&s->auth_state, 0, sizeof(s->auth_state));
+    memset(&s->proxy_auth_state, 0, sizeof(s->proxy_auth_state));
+    if (opts && (ret = av_opt_set_dict(s, opts)) < 0)
+        return ret;
+    /* what is left is for the lower protocols on a redirect */
+    av_dict_free(&s->chained_options);
+    if (opts)
+        av_dict_copy(&s->chained_options, *opts, 0);
+
+    s->icy_data_read = 0;
+    av_free(s->location);
+    s->location = av_strdup(uri);
+    if (!s->location)
+        return AVERROR(ENOMEM);
+
+    ret = http_open_cnx(h, &options);
+    av_dict_free(&options);
+    return ret;
+}
+
 int ff_http_averror(int status_code, int default_averror)
 {
     switch (status_code) {
@@ -47,6 +47,22 @@ void ff_http_init_auth_state(URLContext *dest, const URLContext *src);
  */
 int ff_http_do_new_request(URLContext *h, const char *uri);
 
+/**
+ * Send a new HTTP request on the kept-alive connection of h, which must
+ * have been opened with multiple_requests and have its previous response
+ * fully read. All http options of h are reset to their defaults first,
+ * and cookies and authentication state are dropped, so the request is
+ * made as if h had been opened with opts.
+ *
+ * @param h pointer to the resource
+ * @param uri uri used to perform the request, on the same host and port
+ * @param opts http options of the request, e.g. offset and end_offset;
+ * recognized entries are consumed
+ * @return a negative value if an error condition occurred, AVERROR_EOF if
+ * the server closes the connection, 0 otherwise
+ */
+int ff_http_do_new_request2(URLContext *h, const char *uri, AVDictionary **opts);
+
 int ff_http_averror(int status_code, int default_averror);
 
 #endif /* AVFORMAT_HTTP_H */
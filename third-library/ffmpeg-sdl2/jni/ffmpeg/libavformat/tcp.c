@@ -24,6 +24,7 @@
 #include "libavutil/opt.h"
 #include "libavutil/time.h"
 
+#include "dns_cache.h"
 #include "internal.h"
 #include "network.h"
 #include "os_support.h"
@@ -41,6 +42,8 @@ typedef struct TCPContext {
     int listen_timeout;
     int recv_buffer_size;
     int send_buffer_size;
+    int dns_cache_timeout;
+    int dns_cache_clear;
 } TCPContext;
 
 #define OFFSET(x) offsetof(TCPContext, x)
@@ -52,6 +55,8 @@ static const AVOption options[] = {
     { "listen_timeout",  "Connection awaiting timeout (in milliseconds)",      OFFSET(listen_timeout), AV_OPT_TYPE_INT, { .i64 = -1 },         -1, INT_MAX, .flags = D|E },
     { "send_buffer_size", "Socket send buffer size (in bytes)",                OFFSET(send_buffer_size), AV_OPT_TYPE_INT, { .i64 = -1 },         -1, INT_MAX, .flags = D|E },
     { "recv_buffer_size", "Socket receive buffer size (in bytes)",             OFFSET(recv_buffer_size), AV_OPT_TYPE_INT, { .i64 = -1 },         -1, INT_MAX, .flags = D|E },
+    { "dns_cache_timeout", "Reuse resolved addresses for this long, shared by all contexts (in milliseconds), 0 to disable", OFFSET(dns_cache_timeout), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX, .flags = D|E },
+    { "dns_cache_clear", "Resolve again even if the host is in the cache", OFFSET(dns_cache_clear), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, .flags = D|E },
     { NULL }
 };
 
@@ -73,6 +78,7 @@ static int tcp_open(URLContext *h, const char *uri, int flags)
     int ret;
     char hostname[1024],proto[1024],path[1024];
     char portstr[10];
+    int use_dns_cache, cached = 0;
     s->open_timeout = 5000000;
 
     av_url_split(proto, sizeof(proto), NULL, 0, hostname, sizeof(hostname),
@@ -108,15 +114,25 @@ static int tcp_open(URLContext *h, const char *uri, int flags)
     snprintf(portstr, sizeof(portstr), "%d", port);
     if (s->listen)
         hints.ai_flags |= AI_PASSIVE;
-    if (!hostname[0])
-        ret = getaddrinfo(NULL, portstr, &hints, &ai);
-    else
-        ret = getaddrinfo(hostname, portstr, &hints, &ai);
-    if (ret) {
-        av_log(h, AV_LOG_ERROR,
-               "Failed to resolve hostname %s: %s\n",
-               hostname, gai_strerror(ret));
-        return AVERROR(EIO);
+    use_dns_cache = s->dns_cache_timeout > 0 && !s->listen && hostname[0];
+    if (s->dns_cache_clear)
+        ff_dns_cache_remove(hostname, port, hints.ai_family);
+    ai = use_dns_cache ? ff_dns_cache_get(hostname, port, hints.ai_family) : NULL;
+    if (ai) {
+        cached = 1;
+    } else {
+        if (!hostname[0])
+            ret = getaddrinfo(NULL, portstr, &hints, &ai);
+        else
+            ret = getaddrinfo(hostname, portstr, &hints, &ai);
+        if (ret) {
+            av_log(h, AV_LOG_ERROR,
+                   "Failed to resolve hostname %s: %s\n",
+                   hostname, gai_strerror(ret));
+            return AVERROR(EIO);
+        }
+        if (use_dns_cache)
+            ff_dns_cache_add(hostname, port, hints.ai_family, ai, s->dns_cache_timeout);
     }
 
     cur_ai = ai;
@@ -174,7 +190,10 @@ static int tcp_open(URLContext *h, const char *uri, int flags)
     h->is_streamed = 1;
     s->fd = fd;
 
-    freeaddrinfo(ai);
+    if (cached)
+        ff_dns_cache_free(ai);
+    else
+        freeaddrinfo(ai);
     return 0;
 
  fail:
@@ -189,7 +208,14 @@ static int tcp_open(URLContext *h, const char *uri, int flags)
  fail1:
     if (fd >= 0)
         closesocket(fd);
-    freeaddrinfo(ai);
+    if (cached) {
+        /* the host may have moved, resolve it again next time */
+        if (ret != AVERROR_EXIT)
+            ff_dns_cache_remove(hostname, port, hints.ai_family);
+        ff_dns_cache_free(ai);
+    } else {
+        freeaddrinfo(ai);
+    }
     return ret;
 }
 
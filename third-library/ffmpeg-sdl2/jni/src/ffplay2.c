@@ -198,6 +198,9 @@ typedef struct Decoder {
     int64_t next_pts;
     AVRational next_pts_tb;
     SDL_Thread *decoder_tid;
+    int64_t frames_decoded;
+    int64_t first_frame_time;
+    int64_t last_frame_time;
 } Decoder;
 
 typedef struct VideoState {
@@ -329,6 +332,8 @@ static int64_t duration = AV_NOPTS_VALUE;
 static int fast = 0;
 static int genpts = 0;
 static int lowres = 0;
+static int video_threads = 0;
+static int decode_ahead = VIDEO_PICTURE_QUEUE_SIZE;
 static int decoder_reorder_pts = -1;
 static int autoexit;
 static int exit_on_keydown;
@@ -385,6 +390,7 @@ static const struct TextureFormatEntry {
     { AV_PIX_FMT_BGR32,          SDL_PIXELFORMAT_ABGR8888 },
     { AV_PIX_FMT_BGR32_1,        SDL_PIXELFORMAT_BGRA8888 },
     { AV_PIX_FMT_YUV420P,        SDL_PIXELFORMAT_IYUV },
+    { AV_PIX_FMT_NV12,           SDL_PIXELFORMAT_NV12 },
     { AV_PIX_FMT_YUYV422,        SDL_PIXELFORMAT_YUY2 },
     { AV_PIX_FMT_UYVY422,        SDL_PIXELFORMAT_UYVY },
     { AV_PIX_FMT_NONE,           SDL_PIXELFORMAT_UNKNOWN },
@@ -582,6 +588,15 @@ static void decoder_init(Decoder *d, AVCodecContext *avctx, PacketQueue *queue,
     d->pkt_serial = -1;
 }
 
+static void decoder_account_frame(Decoder *d)
+{
+    int64_t now = av_gettime_relative();
+
+    if (!d->frames_decoded++)
+        d->first_frame_time = now;
+    d->last_frame_time = now;
+}
+
 static int decoder_decode_frame(Decoder *d, AVFrame *frame, AVSubtitle *sub) {
     int ret = AVERROR(EAGAIN);
 
@@ -619,6 +634,8 @@ static int decoder_decode_frame(Decoder *d, AVFrame *frame, AVSubtitle *sub) {
                         }
                         break;
                 }
+                if (ret >= 0)
+                    decoder_account_frame(d);
                 if (ret == AVERROR_EOF) {
                     d->finished = d->pkt_serial;
                     avcodec_flush_buffers(d->avctx);
@@ -942,6 +959,23 @@ static int upload_texture(SDL_Texture **tex, AVFrame *frame, struct SwsContext *
                 return -1;
             }
             break;
+        case SDL_PIXELFORMAT_NV12:
+            if (frame->linesize[0] > 0 && frame->linesize[1] == frame->linesize[0] &&
+                frame->data[1] == frame->data[0] + frame->linesize[0] * frame->height) {
+                /* already laid out the way SDL_UpdateTexture() takes NV12 */
+                ret = SDL_UpdateTexture(*tex, NULL, frame->data[0], frame->linesize[0]);
+            } else {
+                uint8_t *pixels;
+                int pitch;
+                if (!(ret = SDL_LockTexture(*tex, NULL, (void **)&pixels, &pitch))) {
+                    av_image_copy_plane(pixels, pitch, frame->data[0], frame->linesize[0],
+                                        frame->width, frame->height);
+                    av_image_copy_plane(pixels + pitch * frame->height, pitch, frame->data[1], frame->linesize[1],
+                                        2 * AV_CEIL_RSHIFT(frame->width, 1), AV_CEIL_RSHIFT(frame->height, 1));
+                    SDL_UnlockTexture(*tex);
+                }
+            }
+            break;
         default:
             if (frame->linesize[0] < 0) {
                 ret = SDL_UpdateTexture(*tex, NULL, frame->data[0] + frame->linesize[0] * (frame->height - 1), -frame->linesize[0]);
@@ -1181,6 +1215,24 @@ static void video_audio_display(VideoState *s)
     }
 }
 
+static void print_video_decode_stats(VideoState *is)
+{
+    Decoder *d = &is->viddec;
+    AVCodecContext *avctx = d->avctx;
+    double elapsed = (d->last_frame_time - d->first_frame_time) / 1000000.0;
+
+    av_log(NULL, AV_LOG_INFO,
+           "\nvideo: %"PRId64" frames decoded, %.2f fps, "
+           "%d dropped (%d early, %d late), %d thread(s) %s\n",
+           d->frames_decoded,
+           elapsed > 0 ? (d->frames_decoded - 1) / elapsed : 0.0,
+           is->frame_drops_early + is->frame_drops_late,
+           is->frame_drops_early, is->frame_drops_late,
+           avctx->thread_count,
+           avctx->active_thread_type & FF_THREAD_FRAME ? "frame" :
+           avctx->active_thread_type & FF_THREAD_SLICE ? "slice" : "none");
+}
+
 static void stream_component_close(VideoState *is, int stream_index)
 {
     AVFormatContext *ic = is->ic;
@@ -1209,6 +1261,8 @@ static void stream_component_close(VideoState *is, int stream_index)
         break;
     case AVMEDIA_TYPE_VIDEO:
         decoder_abort(&is->viddec, &is->pictq);
+        if (show_status)
+            print_video_decode_stats(is);
         decoder_destroy(&is->viddec);
         break;
     case AVMEDIA_TYPE_SUBTITLE:
@@ -1672,11 +1726,19 @@ display:
     is->force_refresh = 0;
     if (show_status) {
         static int64_t last_time;
+        static int64_t rate_time, rate_frames;
+        static double decode_fps;
         int64_t cur_time;
         int aqsize, vqsize, sqsize;
         double av_diff;
 
         cur_time = av_gettime_relative();
+        if (is->video_st && cur_time - rate_time >= 1000000) {
+            if (rate_time)
+                decode_fps = (is->viddec.frames_decoded - rate_frames) * 1000000.0 / (cur_time - rate_time);
+            rate_time = cur_time;
+            rate_frames = is->viddec.frames_decoded;
+        }
         if (!last_time || (cur_time - last_time) >= 30000) {
             aqsize = 0;
             vqsize = 0;
@@ -1695,11 +1757,12 @@ display:
             else if (is->audio_st)
                 av_diff = get_master_clock(is) - get_clock(&is->audclk);
             av_log(NULL, AV_LOG_INFO,
-                   "%7.2f %s:%7.3f fd=%4d aq=%5dKB vq=%5dKB sq=%5dB f=%"PRId64"/%"PRId64"   \r",
+                   "%7.2f %s:%7.3f fd=%4d dfps=%5.1f aq=%5dKB vq=%5dKB sq=%5dB f=%"PRId64"/%"PRId64"   \r",
                    get_master_clock(is),
                    (is->audio_st && is->video_st) ? "A-V" : (is->video_st ? "M-V" : (is->audio_st ? "M-A" : "   ")),
                    av_diff,
                    is->frame_drops_early + is->frame_drops_late,
+                   decode_fps,
                    aqsize / 1024,
                    vqsize / 1024,
                    sqsize,
@@ -2602,6 +2665,14 @@ static int stream_component_open(VideoState *is, int stream_index)
 #endif
 
     opts = filter_codec_opts(codec_opts, avctx->codec_id, ic, ic->streams[stream_index], codec);
+    if (avctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+        if (video_threads > 0)
+            av_dict_set_int(&opts, "threads", video_threads, 0);
+        /* frame threads keep the cores busy on inter frames, slice threads
+         * cover the intra frames and the decoders without frame threading */
+        if (!av_dict_get(opts, "thread_type", NULL, 0))
+            av_dict_set(&opts, "thread_type", "frame+slice", 0);
+    }
     if (!av_dict_get(opts, "threads", NULL, 0))
         av_dict_set(&opts, "threads", "auto", 0);
     if (stream_lowres)
@@ -3066,7 +3137,7 @@ static VideoState *stream_open(const char *filename, AVInputFormat *iformat)
     is->xleft   = 0;
 
     /* start video display */
-    if (frame_queue_init(&is->pictq, &is->videoq, VIDEO_PICTURE_QUEUE_SIZE, 1) < 0)
+    if (frame_queue_init(&is->pictq, &is->videoq, decode_ahead, 1) < 0)
         goto fail;
     if (frame_queue_init(&is->subpq, &is->subtitleq, SUBPICTURE_QUEUE_SIZE, 0) < 0)
         goto fail;
@@ -3580,6 +3651,8 @@ static const OptionDef options[] = {
     { "genpts", OPT_BOOL | OPT_EXPERT, { &genpts }, "generate pts", "" },
     { "drp", OPT_INT | HAS_ARG | OPT_EXPERT, { &decoder_reorder_pts }, "let decoder reorder pts 0=off 1=on -1=auto", ""},
     { "lowres", OPT_INT | HAS_ARG | OPT_EXPERT, { &lowres }, "", "" },
+    { "vthreads", OPT_INT | HAS_ARG | OPT_EXPERT | OPT_VIDEO, { &video_threads }, "number of video decoding threads (0 = one per core)", "count" },
+    { "decode_ahead", OPT_INT | HAS_ARG | OPT_EXPERT | OPT_VIDEO, { &decode_ahead }, "number of decoded pictures to keep queued ahead of display (2-16)", "count" },
     { "sync", HAS_ARG | OPT_EXPERT, { .func_arg = opt_sync }, "set audio-video sync. type (type=audio/video/ext)", "type" },
     { "autoexit", OPT_BOOL | OPT_EXPERT, { &autoexit }, "exit at the end", "" },
     { "exitonkeydown", OPT_BOOL | OPT_EXPERT, { &exit_on_keydown }, "exit on key down", "" },
@@ -3707,6 +3780,8 @@ int main(int argc, char **argv)
         exit(1);
     }
 
+    decode_ahead = av_clip(decode_ahead, 2, FRAME_QUEUE_SIZE);
+
     if (display_disable) {
         video_disable = 1;
     }
@@ -9,6 +9,7 @@
 #include "libavformat/avformat.h"  
 #include "libswscale/swscale.h"  
 #include "libavutil/imgutils.h"  
+#include "libavutil/time.h"  
 #include "SDL.h"  
 
 #include <jni.h>  
@@ -20,6 +21,41 @@
 //Output YUV420P data as a file   
 #define OUTPUT_YUV420P 1  
 
+//Decoding threads, 0 = one per core; frame and slice threading are both enabled
+#define DECODER_THREADS 0
+
+typedef struct DecodeStats
+{
+	int frames;
+	int dropped;
+	int errors;
+	int64_t decode_time;	//microseconds the render loop spent in the decoder and the conversion
+	int64_t start_time;
+} DecodeStats;
+
+static void print_decode_stats(const DecodeStats *stats)
+{
+	double elapsed = (av_gettime_relative() - stats->start_time) / 1000000.0;
+
+	LOGI("decoded %d frames: %.1f fps, %.2f ms per frame in the decoder, %d dropped, %d decode errors\n",
+		stats->frames,
+		elapsed > 0 ? stats->frames / elapsed : 0.0,
+		stats->frames ? stats->decode_time / 1000.0 / stats->frames : 0.0,
+		stats->dropped, stats->errors);
+}
+
+static void write_yuv420p(FILE *fp, const AVFrame *frame, int width, int height)
+{
+	int i;
+
+	for (i = 0; i < height; i++)
+		fwrite(frame->data[0] + i * frame->linesize[0], 1, width, fp);
+	for (i = 0; i < height / 2; i++)
+		fwrite(frame->data[1] + i * frame->linesize[1], 1, width / 2, fp);
+	for (i = 0; i < height / 2; i++)
+		fwrite(frame->data[2] + i * frame->linesize[2], 1, width / 2, fp);
+}
+
 typedef struct Sprite
 {
 	SDL_Texture* texture;
@@ -118,9 +154,11 @@ int main(int argc, char *argv[])
 	AVFrame *pFrame, *pFrameYUV;
 	unsigned char *out_buffer;
 	AVPacket *packet;
-	int y_size;
 	int ret, got_picture;
-	struct SwsContext *img_convert_ctx;
+	struct SwsContext *img_convert_ctx = NULL;
+	int threads = argc > 1 ? atoi(argv[1]) : DECODER_THREADS;
+	DecodeStats stats = { 0 };
+	int64_t frame_duration, next_present, t;
 
 	char filepath[] = "/storage/sdcard0/test.mp4";
 	//SDL---------------------------  
@@ -161,25 +199,31 @@ int main(int argc, char *argv[])
 		LOGI("Codec not found.\n");
 		return -1;
 	}
+	pCodecCtx->thread_count = threads;
+	pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
 	if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0){
 		LOGI("Could not open codec.\n");
 		return -1;
 	}
 
+	LOGI("decoder %s: %d thread(s), %s threading\n", pCodec->name, pCodecCtx->thread_count,
+		pCodecCtx->active_thread_type & FF_THREAD_FRAME ? "frame" :
+		pCodecCtx->active_thread_type & FF_THREAD_SLICE ? "slice" : "no");
+
 	pFrame = av_frame_alloc();
 	pFrameYUV = av_frame_alloc();
-
-	out_buffer = (unsigned char *)av_malloc(av_image_get_buffer_size(AV_PIX_FMT_YUV420P, pCodecCtx->width, pCodecCtx->height, 1));
-	av_image_fill_arrays(pFrameYUV->data, pFrameYUV->linesize, out_buffer,
-		AV_PIX_FMT_YUV420P, pCodecCtx->width, pCodecCtx->height, 1);
+	out_buffer = NULL;
 
 	packet = (AVPacket *)av_malloc(sizeof(AVPacket));
 	//Output Info-----------------------------  
 	LOGI("--------------- File Information ----------------\n");
 	av_dump_format(pFormatCtx, 0, filepath, 0);
 	LOGI("-------------------------------------------------\n");
-	img_convert_ctx = sws_getContext(pCodecCtx->width, pCodecCtx->height, pCodecCtx->pix_fmt,
-		pCodecCtx->width, pCodecCtx->height, AV_PIX_FMT_YUV420P, SWS_BICUBIC, NULL, NULL, NULL);
+	//Present at the stream frame rate, 25 fps when it is unknown
+	{
+		AVRational fr = av_guess_frame_rate(pFormatCtx, pFormatCtx->streams[videoindex], NULL);
+		frame_duration = fr.num && fr.den ? av_rescale(1000000, fr.den, fr.num) : 40000;
+	}
 
 #if OUTPUT_YUV420P   
 	fp_yuv = fopen("/storage/sdcard0/output.yuv", "wb+");
@@ -221,70 +265,91 @@ int main(int argc, char *argv[])
 	sdlRect.h = screen_h;
 
 	//SDL End----------------------  
-	while (av_read_frame(pFormatCtx, packet) >= 0){
-		if (packet->stream_index == videoindex){
-			ret = avcodec_decode_video2(pCodecCtx, pFrame, &got_picture, packet);
-			if (ret < 0){
-				LOGI("Decode Error.\n");
-				return -1;
-			}
-			if (got_picture){
-				sws_scale(img_convert_ctx, (const unsigned char* const*)pFrame->data, pFrame->linesize, 0, pCodecCtx->height,
-					pFrameYUV->data, pFrameYUV->linesize);
+	stats.start_time = av_gettime_relative();
+	next_present = stats.start_time;
+	for (;;) {
+		int eof = av_read_frame(pFormatCtx, packet) < 0;
+		AVFrame *pOut;
+
+		if (eof) {
+			//FIX: Flush Frames remained in Codec, frame threads hold up to one per thread
+			av_init_packet(packet);
+			packet->data = NULL;
+			packet->size = 0;
+		} else if (packet->stream_index != videoindex) {
+			av_free_packet(packet);
+			continue;
+		}
 
-#if OUTPUT_YUV420P  
-				y_size = pCodecCtx->width*pCodecCtx->height;
-				fwrite(pFrameYUV->data[0], 1, y_size, fp_yuv);    //Y   
-				fwrite(pFrameYUV->data[1], 1, y_size / 4, fp_yuv);  //U  
-				fwrite(pFrameYUV->data[2], 1, y_size / 4, fp_yuv);  //V  
-#endif  
-				//SDL---------------------------  
-#if 0  
-				SDL_UpdateTexture(sdlTexture, NULL, pFrameYUV->data[0], pFrameYUV->linesize[0]);
-#else  
-				SDL_UpdateYUVTexture(sdlTexture, &sdlRect,
-					pFrameYUV->data[0], pFrameYUV->linesize[0],
-					pFrameYUV->data[1], pFrameYUV->linesize[1],
-					pFrameYUV->data[2], pFrameYUV->linesize[2]);
-#endif    
+		t = av_gettime_relative();
+		ret = avcodec_decode_video2(pCodecCtx, pFrame, &got_picture, packet);
+		if (!eof)
+			av_free_packet(packet);
+		if (ret < 0){
+			stats.decode_time += av_gettime_relative() - t;
+			if (eof)
+				break;
+			LOGI("Decode Error.\n");
+			stats.errors++;
+			continue;
+		}
+		if (!got_picture){
+			stats.decode_time += av_gettime_relative() - t;
+			if (eof)
+				break;
+			continue;
+		}
 
-				SDL_RenderClear(sdlRenderer);
-				SDL_RenderCopy(sdlRenderer, sdlTexture, NULL, &sdlRect);
-				SDL_RenderPresent(sdlRenderer);
-				//SDL End-----------------------  
-				//Delay 40ms  
-				SDL_Delay(40);
+		//Decoded YUV420P goes to the texture as is, anything else is converted first
+		pOut = pFrame;
+		if (pFrame->format != AV_PIX_FMT_YUV420P) {
+			if (!out_buffer) {
+				out_buffer = (unsigned char *)av_malloc(av_image_get_buffer_size(AV_PIX_FMT_YUV420P, pCodecCtx->width, pCodecCtx->height, 1));
+				av_image_fill_arrays(pFrameYUV->data, pFrameYUV->linesize, out_buffer,
+					AV_PIX_FMT_YUV420P, pCodecCtx->width, pCodecCtx->height, 1);
 			}
+			img_convert_ctx = sws_getCachedContext(img_convert_ctx, pCodecCtx->width, pCodecCtx->height, pFrame->format,
+				pCodecCtx->width, pCodecCtx->height, AV_PIX_FMT_YUV420P, SWS_BICUBIC, NULL, NULL, NULL);
+			sws_scale(img_convert_ctx, (const unsigned char* const*)pFrame->data, pFrame->linesize, 0, pCodecCtx->height,
+				pFrameYUV->data, pFrameYUV->linesize);
+			pOut = pFrameYUV;
 		}
-		av_free_packet(packet);
-	}
-	//flush decoder  
-	//FIX: Flush Frames remained in Codec  
-	while (1) {
-		ret = avcodec_decode_video2(pCodecCtx, pFrame, &got_picture, packet);
-		if (ret < 0)
-			break;
-		if (!got_picture)
-			break;
-		sws_scale(img_convert_ctx, (const unsigned char* const*)pFrame->data, pFrame->linesize, 0, pCodecCtx->height,
-			pFrameYUV->data, pFrameYUV->linesize);
+		stats.decode_time += av_gettime_relative() - t;
+		stats.frames++;
+
 #if OUTPUT_YUV420P  
-		int y_size = pCodecCtx->width*pCodecCtx->height;
-		fwrite(pFrameYUV->data[0], 1, y_size, fp_yuv);    //Y   
-		fwrite(pFrameYUV->data[1], 1, y_size / 4, fp_yuv);  //U  
-		fwrite(pFrameYUV->data[2], 1, y_size / 4, fp_yuv);  //V  
+		write_yuv420p(fp_yuv, pOut, pCodecCtx->width, pCodecCtx->height);
 #endif  
+		//A frame that is already a whole frame late is not shown
+		t = av_gettime_relative();
+		if (t > next_present + frame_duration) {
+			stats.dropped++;
+			next_present += frame_duration;
+			continue;
+		}
+		if (next_present > t)
+			av_usleep(next_present - t);
+		next_present += frame_duration;
+
 		//SDL---------------------------  
-		SDL_UpdateTexture(sdlTexture, &sdlRect, pFrameYUV->data[0], pFrameYUV->linesize[0]);
+		SDL_UpdateYUVTexture(sdlTexture, &sdlRect,
+			pOut->data[0], pOut->linesize[0],
+			pOut->data[1], pOut->linesize[1],
+			pOut->data[2], pOut->linesize[2]);
+
 		SDL_RenderClear(sdlRenderer);
 		SDL_RenderCopy(sdlRenderer, sdlTexture, NULL, &sdlRect);
 		SDL_RenderPresent(sdlRenderer);
 		//SDL End-----------------------  
-		//Delay 40ms  
-		SDL_Delay(40);
+
+		if (stats.frames % 100 == 0)
+			print_decode_stats(&stats);
 	}
+	print_decode_stats(&stats);
 
 	sws_freeContext(img_convert_ctx);
+	av_free(out_buffer);
+	av_free(packet);
 
 #if OUTPUT_YUV420P   
 	fclose(fp_yuv);
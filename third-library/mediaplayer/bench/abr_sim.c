@@ -0,0 +1,488 @@
+/*
+ * abr_sim.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * ABR simulator: serves a multi-variant HLS directory from a local HTTP
+ * server whose bandwidth follows a recorded trace, reads it through the
+ * hls demuxer with ff_abr.c choosing variants the way read_thread does, and
+ * scores the session. Playback is modelled, not decoded: the buffer fills
+ * with demuxed media time and drains in (scaled) real time.
+ *
+ *   abr_sim [-speed x] [-rtt ms] [-fixed variant] [-prefetch n] [-start variant]
+ *           [-max-buffer ms] [-mu mbps] trace.txt hls_dir [master.m3u8]
+ *
+ * The trace (e.g. bench/abr_trace.txt) has one "<seconds> <kbps>" pair
+ * per line, '#' starts a comment; it is looped. -speed runs trace and
+ * playback x times faster than real time. The score is the linear QoE of Yin et al. (SIGCOMM'15) per second
+ * of media, in Mbps: mean bitrate - mean |bitrate change| - mu * rebuffer
+ * seconds / media seconds. mu defaults to four times the top bitrate, i.e.
+ * the usual "one top-rate 4 s chunk per second of stall".
+ *
+ * The content must have aligned segments, e.g. for each rate:
+ *   ffmpeg -i in.mp4 -b:v 1200k -g 48 -sc_threshold 0 -f hls -hls_time 2 \
+ *          -hls_list_size 0 v1/index.m3u8
+ * and a master.m3u8 listing v0/index.m3u8, v1/index.m3u8, ... with BANDWIDTH.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "libavformat/avformat.h"
+#include "libavutil/opt.h"
+#include "libavutil/time.h"
+
+#include "player/ff_abr.h"
+
+typedef struct Trace {
+    double  *seconds;
+    int64_t *bps;
+    int      n;
+    double   total;
+} Trace;
+
+typedef struct SimServer {
+    int              fd;
+    int              port;
+    const char      *dir;
+    Trace           *trace;
+    double           speed;
+    int64_t          rtt_us;        /* trace time */
+    int64_t          start;         /* wall us */
+
+    pthread_mutex_t  link_mutex;
+    int64_t          link_free_at;  /* wall us, when the shared link is idle again */
+} SimServer;
+
+typedef struct SimConn {
+    SimServer *server;
+    int        fd;
+} SimConn;
+
+static int load_trace(Trace *trace, const char *path)
+{
+    char line[256];
+    FILE *fp = fopen(path, "r");
+
+    if (!fp)
+        return -1;
+    memset(trace, 0, sizeof(*trace));
+    while (fgets(line, sizeof(line), fp)) {
+        double seconds, kbps;
+        char *hash = strchr(line, '#');
+        if (hash)
+            *hash = '\0';
+        if (sscanf(line, "%lf %lf", &seconds, &kbps) != 2 || seconds <= 0)
+            continue;
+        trace->seconds = realloc(trace->seconds, (trace->n + 1) * sizeof(*trace->seconds));
+        trace->bps     = realloc(trace->bps, (trace->n + 1) * sizeof(*trace->bps));
+        trace->seconds[trace->n] = seconds;
+        trace->bps[trace->n]     = (int64_t)(kbps * 1000);
+        trace->total += seconds;
+        trace->n++;
+    }
+    fclose(fp);
+    return trace->n ? 0 : -1;
+}
+
+static int64_t trace_bps_at(Trace *trace, double t)
+{
+    t -= (int64_t)(t / trace->total) * trace->total;
+    for (int i = 0; i < trace->n; i++) {
+        if (t < trace->seconds[i])
+            return trace->bps[i];
+        t -= trace->seconds[i];
+    }
+    return trace->bps[trace->n - 1];
+}
+
+/* holds the shared link for as long as n bytes take at the trace rate */
+static void link_send(SimServer *server, int fd, const uint8_t *buf, int n)
+{
+    pthread_mutex_lock(&server->link_mutex);
+    int64_t now   = av_gettime_relative();
+    int64_t begin = FFMAX(now, server->link_free_at);
+    double  t     = (begin - server->start) * server->speed / 1000000.0;
+    int64_t bps   = FFMAX(trace_bps_at(server->trace, t), 8000) * server->speed;
+    server->link_free_at = begin + (int64_t)n * 8 * 1000000 / bps;
+    int64_t done  = server->link_free_at;
+    pthread_mutex_unlock(&server->link_mutex);
+
+    now = av_gettime_relative();
+    if (done > now)
+        av_usleep((unsigned)(done - now));
+    while (n > 0) {
+        ssize_t sent = send(fd, buf, n, MSG_NOSIGNAL);
+        if (sent <= 0)
+            return;
+        buf += sent;
+        n   -= (int)sent;
+    }
+}
+
+static int read_request(int fd, char *path, int path_size)
+{
+    char req[4096];
+    int len = 0;
+
+    while (len < (int)sizeof(req) - 1) {
+        ssize_t got = recv(fd, req + len, sizeof(req) - 1 - len, 0);
+        if (got <= 0)
+            return -1;
+        len += (int)got;
+        req[len] = '\0';
+        if (strstr(req, "\r\n\r\n"))
+            break;
+    }
+    char fmt[32];
+    snprintf(fmt, sizeof(fmt), "GET %%%ds", path_size - 1);
+    if (sscanf(req, fmt, path) != 1)
+        return -1;
+    return 0;
+}
+
+static void *conn_thread(void *arg)
+{
+    SimConn *conn = arg;
+    SimServer *server = conn->server;
+    char path[1024], file[2048], header[256];
+    uint8_t buf[16384];
+
+    /* keep-alive: serve requests until the client closes */
+    while (read_request(conn->fd, path, sizeof(path)) == 0) {
+        char *query = strchr(path, '?');
+        if (query)
+            *query = '\0';
+        snprintf(file, sizeof(file), "%s%s", server->dir, path);
+
+        av_usleep((unsigned)(server->rtt_us / server->speed));
+        FILE *fp = strstr(path, "..") ? NULL : fopen(file, "rb");
+        if (!fp) {
+            int n = snprintf(header, sizeof(header),
+                             "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n");
+            send(conn->fd, header, n, MSG_NOSIGNAL);
+            continue;
+        }
+        fseek(fp, 0, SEEK_END);
+        long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        int n = snprintf(header, sizeof(header),
+                         "HTTP/1.1 200 OK\r\nContent-Length: %ld\r\nConnection: keep-alive\r\n\r\n", size);
+        send(conn->fd, header, n, MSG_NOSIGNAL);
+        size_t got;
+        while ((got = fread(buf, 1, sizeof(buf), fp)) > 0)
+            link_send(server, conn->fd, buf, (int)got);
+        fclose(fp);
+    }
+    close(conn->fd);
+    free(conn);
+    return NULL;
+}
+
+static void *accept_thread(void *arg)
+{
+    SimServer *server = arg;
+
+    for (;;) {
+        int fd = accept(server->fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+            return NULL;
+        }
+        SimConn *conn = calloc(1, sizeof(SimConn));
+        pthread_t tid;
+        conn->server = server;
+        conn->fd     = fd;
+        if (pthread_create(&tid, NULL, conn_thread, conn)) {
+            close(fd);
+            free(conn);
+            continue;
+        }
+        pthread_detach(tid);
+    }
+}
+
+static int server_start(SimServer *server)
+{
+    struct sockaddr_in addr = { 0 };
+    socklen_t addr_len = sizeof(addr);
+    pthread_t tid;
+    int one = 1;
+
+    server->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (server->fd < 0)
+        return -1;
+    setsockopt(server->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(server->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(server->fd, 16) < 0 ||
+        getsockname(server->fd, (struct sockaddr *)&addr, &addr_len) < 0)
+        return -1;
+    server->port = ntohs(addr.sin_port);
+    pthread_mutex_init(&server->link_mutex, NULL);
+    server->start = av_gettime_relative();
+    if (pthread_create(&tid, NULL, accept_thread, server))
+        return -1;
+    pthread_detach(tid);
+    return 0;
+}
+
+typedef struct Playback {
+    double   speed;
+    int64_t  first_pts;     /* media us */
+    int64_t  buffer_end;    /* media us */
+    int64_t  pos;           /* media us */
+    int64_t  last_wall;
+    int64_t  start_wall;
+    int64_t  startup_us;    /* wall */
+    int      playing;
+    int      stalled;
+    int      rebuffers;
+    int64_t  rebuffer_us;   /* trace time */
+} Playback;
+
+#define STARTUP_BUFFER_US   2000000
+#define REBUFFER_RESUME_US  1000000
+
+static void playback_advance(Playback *pb)
+{
+    int64_t now = av_gettime_relative();
+    int64_t dt  = (int64_t)((now - pb->last_wall) * pb->speed);
+
+    pb->last_wall = now;
+    if (!pb->playing) {
+        if (pb->first_pts != AV_NOPTS_VALUE && pb->buffer_end - pb->first_pts >= STARTUP_BUFFER_US) {
+            pb->playing    = 1;
+            pb->pos        = pb->first_pts;
+            pb->startup_us = now - pb->start_wall;
+        }
+        return;
+    }
+    if (pb->stalled) {
+        pb->rebuffer_us += dt;
+        if (pb->buffer_end - pb->pos >= REBUFFER_RESUME_US)
+            pb->stalled = 0;
+        return;
+    }
+    pb->pos += dt;
+    if (pb->pos > pb->buffer_end) {
+        pb->rebuffer_us += pb->pos - pb->buffer_end;
+        pb->pos = pb->buffer_end;
+        pb->stalled = 1;
+        pb->rebuffers++;
+    }
+}
+
+static void usage(const char *name)
+{
+    printf("usage: %s [-speed x] [-rtt ms] [-fixed variant] [-prefetch n] [-start variant]\n"
+           "          [-max-buffer ms] [-mu mbps] trace.txt hls_dir [master.m3u8]\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    SimServer server = { 0 };
+    Playback pb = { 0 };
+    Trace trace;
+    FFAbr abr;
+    AVFormatContext *ic = NULL;
+    AVDictionary *opts = NULL;
+    const char *trace_path = NULL, *dir = NULL, *master = "master.m3u8";
+    int fixed = -1, prefetch = 0, start_variant = 0, max_buffer_ms = 30000;
+    int64_t rtt_ms = 50, last_bps = 0;
+    double mu = -1;
+    uint8_t *variant_at = NULL;
+    int n_seconds = 0;
+    char url[1024];
+
+    server.speed = 1.0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-speed") && i + 1 < argc) {
+            server.speed = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-rtt") && i + 1 < argc) {
+            rtt_ms = atoll(argv[++i]);
+        } else if (!strcmp(argv[i], "-fixed") && i + 1 < argc) {
+            fixed = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-prefetch") && i + 1 < argc) {
+            prefetch = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-start") && i + 1 < argc) {
+            start_variant = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-max-buffer") && i + 1 < argc) {
+            max_buffer_ms = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-mu") && i + 1 < argc) {
+            mu = atof(argv[++i]);
+        } else if (argv[i][0] != '-' && !trace_path) {
+            trace_path = argv[i];
+        } else if (argv[i][0] != '-' && !dir) {
+            dir = argv[i];
+        } else if (argv[i][0] != '-') {
+            master = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!trace_path || !dir || server.speed <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (load_trace(&trace, trace_path) < 0) {
+        fprintf(stderr, "failed to load trace %s\n", trace_path);
+        return 1;
+    }
+
+    av_register_all();
+    avformat_network_init();
+    av_log_set_level(AV_LOG_ERROR);
+
+    server.dir    = dir;
+    server.trace  = &trace;
+    server.rtt_us = rtt_ms * 1000;
+    if (server_start(&server) < 0) {
+        fprintf(stderr, "failed to start http server: %s\n", strerror(errno));
+        return 1;
+    }
+
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d/%s", server.port, master);
+    av_dict_set(&opts, "abr", "1", 0);
+    av_dict_set_int(&opts, "abr_variant", fixed >= 0 ? fixed : start_variant, 0);
+    av_dict_set_int(&opts, "prefetch_segments", prefetch, 0);
+    pb.speed      = server.speed;
+    pb.first_pts  = AV_NOPTS_VALUE;
+    pb.start_wall = pb.last_wall = av_gettime_relative();
+    if (avformat_open_input(&ic, url, NULL, &opts) < 0) {
+        fprintf(stderr, "failed to open %s\n", url);
+        return 1;
+    }
+    av_dict_free(&opts);
+
+    int n_variants = FFMIN(ic->nb_programs, FFP_ABR_MAX_VARIANTS);
+    int64_t bitrates[FFP_ABR_MAX_VARIANTS] = { 0 };
+    for (int i = 0; i < n_variants; i++) {
+        AVDictionaryEntry *e = av_dict_get(ic->programs[i]->metadata, "variant_bitrate", NULL, 0);
+        bitrates[i] = e ? strtoll(e->value, NULL, 10) : 0;
+    }
+    if (n_variants < 1 || !av_opt_find(ic->priv_data, "abr_variant", NULL, 0, 0)) {
+        fprintf(stderr, "%s: not a multi-variant hls stream, or hls without abr support\n", url);
+        avformat_close_input(&ic);
+        return 1;
+    }
+    int64_t cur_variant = 0;
+    av_opt_get_int(ic->priv_data, "cur_variant", 0, &cur_variant);
+    ffp_abr_init(&abr, bitrates, n_variants, (int)cur_variant);
+
+    /* the clock: first video stream, or the first stream */
+    int clock_index = av_find_best_stream(ic, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    if (clock_index < 0)
+        clock_index = 0;
+
+    AVPacket pkt;
+    av_init_packet(&pkt);
+    while (av_read_frame(ic, &pkt) >= 0) {
+        AVStream *st = ic->streams[pkt.stream_index];
+        int64_t pts  = pkt.pts != AV_NOPTS_VALUE ? pkt.pts : pkt.dts;
+
+        if (pkt.stream_index == clock_index && pts != AV_NOPTS_VALUE) {
+            pts = av_rescale_q(pts, st->time_base, AV_TIME_BASE_Q);
+            if (pb.first_pts == AV_NOPTS_VALUE)
+                pb.first_pts = pb.buffer_end = pts;
+            pb.buffer_end = FFMAX(pb.buffer_end, pts);
+
+            av_opt_get_int(ic->priv_data, "cur_variant", 0, &cur_variant);
+            int second = (int)((pts - pb.first_pts) / 1000000);
+            if (second >= n_seconds) {
+                int n = FFMAX(second + 1, n_seconds * 2);
+                variant_at = realloc(variant_at, n);
+                memset(variant_at + n_seconds, 0xff, n - n_seconds);
+                n_seconds = n;
+            }
+            if (variant_at[second] == 0xff)
+                variant_at[second] = (uint8_t)cur_variant;
+        }
+        av_packet_unref(&pkt);
+
+        playback_advance(&pb);
+        while (pb.playing && pb.buffer_end - pb.pos > (int64_t)max_buffer_ms * 1000) {
+            av_usleep(10000);
+            playback_advance(&pb);
+        }
+
+        /* same inputs as read_thread_abr_update() */
+        int64_t bps = 0;
+        if (av_opt_get_int(ic->priv_data, "segment_throughput", 0, &bps) >= 0 && bps > 0 && bps != last_bps) {
+            /* the server runs the trace speed times faster */
+            ffp_abr_add_sample(&abr, (int64_t)(bps / server.speed));
+            last_bps = bps;
+        }
+        if (fixed < 0) {
+            int buffer_ms = (int)((pb.buffer_end - (pb.playing ? pb.pos : pb.first_pts)) / 1000);
+            int prev = abr.cur;
+            if (ffp_abr_choose(&abr, buffer_ms, (int64_t)(av_gettime_relative() * server.speed)) != prev)
+                av_opt_set_int(ic->priv_data, "abr_variant", abr.cur, 0);
+        }
+    }
+    avformat_close_input(&ic);
+
+    /* score per second of media */
+    int64_t media_us = pb.buffer_end - (pb.first_pts != AV_NOPTS_VALUE ? pb.first_pts : 0);
+    int seconds = 0, switches = 0, prev = -1;
+    double sum_mbps = 0, sum_change = 0, max_mbps = 0;
+    for (int i = 0; i < n_variants; i++)
+        max_mbps = FFMAX(max_mbps, bitrates[i] / 1e6);
+    for (int i = 0; i < n_seconds; i++) {
+        if (variant_at[i] == 0xff)
+            continue;
+        double mbps = bitrates[variant_at[i]] / 1e6;
+        sum_mbps += mbps;
+        if (prev >= 0 && prev != variant_at[i]) {
+            switches++;
+            sum_change += fabs(mbps - bitrates[prev] / 1e6);
+        }
+        prev = variant_at[i];
+        seconds++;
+    }
+    double rebuffer_s = pb.rebuffer_us / 1e6;
+    if (mu < 0)
+        mu = 4 * max_mbps;
+    double qoe = seconds ? (sum_mbps - sum_change - mu * rebuffer_s) / seconds : 0;
+
+    printf("variants      ");
+    for (int i = 0; i < n_variants; i++)
+        printf(" %"PRId64"k", bitrates[i] / 1000);
+    printf("\nmode           %s\n", fixed >= 0 ? "fixed" : "abr");
+    printf("media          %.1f s\n", media_us / 1e6);
+    printf("startup        %.0f ms\n", pb.startup_us * server.speed / 1000.0);
+    printf("mean bitrate   %.0f kbps\n", seconds ? sum_mbps * 1000 / seconds : 0);
+    printf("switches       %d\n", switches);
+    printf("rebuffers      %d, %.2f s\n", pb.rebuffers, rebuffer_s);
+    printf("qoe            %.3f\n", qoe);
+    free(variant_at);
+    return 0;
+}
@@ -0,0 +1,294 @@
+/*
+ * aout_bench.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Plays the audio of a file into the null audio output. As in
+ * sdl_audio_callback, decoding and resampling to S16 happen inside the
+ * callback, so the numbers show how long a callback takes and, in real
+ * time mode, whether the device would have underrun.
+ *
+ *   aout_bench [-fast] [-samples n] [-rate r] [-t seconds]
+ *              [-queue buffers] [-jitter ms] input
+ *
+ * -fast pulls buffers as soon as the previous one is filled, which gives
+ * the decode + resample throughput as a multiple of real time.
+ *
+ * -queue and -jitter set up the simulated device: how many buffers it is
+ * kept ahead by and how late each period may be signalled. The latency
+ * the output reports to the callback, which the player feeds into its
+ * audio clock, is printed next to the one expected from that setup.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/opt.h"
+#include "libavutil/time.h"
+#include "libswresample/swresample.h"
+
+#include "ijksdl/dummy/ijksdl_aout_dummy.h"
+
+typedef struct AudioSource {
+    AVFormatContext *ic;
+    AVCodecContext  *avctx;
+    SwrContext      *swr;
+    AVPacket        *pkt;
+    AVFrame         *frame;
+    int              stream_index;
+    int              channels;
+
+    uint8_t         *buf;
+    unsigned int     buf_alloc;
+    int              buf_size;
+    int              buf_index;
+
+    SDL_Aout        *aout;
+    volatile int     eof;
+
+    /* latency reported to the callback */
+    int64_t          latency_count;
+    double           latency_sum;
+    double           latency_min;
+    double           latency_max;
+} AudioSource;
+
+/* decodes the next frame into src->buf as interleaved S16, or returns <= 0 */
+static int source_decode(AudioSource *src)
+{
+    int ret;
+
+    for (;;) {
+        ret = avcodec_receive_frame(src->avctx, src->frame);
+        if (ret >= 0) {
+            int out_count = swr_get_out_samples(src->swr, src->frame->nb_samples);
+            int out_size  = av_samples_get_buffer_size(NULL, src->channels, out_count, AV_SAMPLE_FMT_S16, 1);
+            av_fast_malloc(&src->buf, &src->buf_alloc, out_size);
+            if (!src->buf)
+                return AVERROR(ENOMEM);
+            ret = swr_convert(src->swr, &src->buf, out_count,
+                              (const uint8_t **)src->frame->extended_data, src->frame->nb_samples);
+            av_frame_unref(src->frame);
+            if (ret < 0)
+                return ret;
+            src->buf_size  = ret * src->channels * 2;
+            src->buf_index = 0;
+            if (src->buf_size > 0)
+                return src->buf_size;
+            continue;
+        }
+        if (ret != AVERROR(EAGAIN))
+            return ret;
+
+        ret = av_read_frame(src->ic, src->pkt);
+        if (ret < 0) {
+            avcodec_send_packet(src->avctx, NULL);
+            continue;
+        }
+        if (src->pkt->stream_index == src->stream_index)
+            avcodec_send_packet(src->avctx, src->pkt);
+        av_packet_unref(src->pkt);
+    }
+}
+
+static void audio_callback(void *opaque, Uint8 *stream, int len)
+{
+    AudioSource *src = opaque;
+    double latency = SDL_AoutGetLatencySeconds(src->aout);
+
+    if (!src->latency_count || latency < src->latency_min)
+        src->latency_min = latency;
+    if (!src->latency_count || latency > src->latency_max)
+        src->latency_max = latency;
+    src->latency_sum += latency;
+    src->latency_count++;
+
+    while (len > 0) {
+        if (src->buf_index >= src->buf_size) {
+            if (src->eof || source_decode(src) <= 0) {
+                /* stop the device so the stats end with the last real buffer */
+                if (!src->eof)
+                    SDL_AoutPauseAudio(src->aout, 1);
+                src->eof = 1;
+                memset(stream, 0, len);
+                return;
+            }
+        }
+        int n = FFMIN(len, src->buf_size - src->buf_index);
+        memcpy(stream, src->buf + src->buf_index, n);
+        src->buf_index += n;
+        stream += n;
+        len    -= n;
+    }
+}
+
+static int source_open(AudioSource *src, const char *filename)
+{
+    AVCodec *codec = NULL;
+    int ret;
+
+    if ((ret = avformat_open_input(&src->ic, filename, NULL, NULL)) < 0 ||
+        (ret = avformat_find_stream_info(src->ic, NULL)) < 0)
+        return ret;
+    src->stream_index = av_find_best_stream(src->ic, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+    if (src->stream_index < 0)
+        return src->stream_index;
+
+    src->avctx = avcodec_alloc_context3(codec);
+    if (!src->avctx)
+        return AVERROR(ENOMEM);
+    avcodec_parameters_to_context(src->avctx, src->ic->streams[src->stream_index]->codecpar);
+    if ((ret = avcodec_open2(src->avctx, codec, NULL)) < 0)
+        return ret;
+
+    /* same target as the player: S16 at the source rate, stereo at most */
+    src->channels = FFMIN(src->avctx->channels, 2);
+    src->swr = swr_alloc_set_opts(NULL,
+                                  av_get_default_channel_layout(src->channels), AV_SAMPLE_FMT_S16, src->avctx->sample_rate,
+                                  src->avctx->channel_layout ? src->avctx->channel_layout : av_get_default_channel_layout(src->avctx->channels),
+                                  src->avctx->sample_fmt, src->avctx->sample_rate, 0, NULL);
+    if (!src->swr || (ret = swr_init(src->swr)) < 0)
+        return src->swr ? ret : AVERROR(ENOMEM);
+
+    src->pkt   = av_packet_alloc();
+    src->frame = av_frame_alloc();
+    if (!src->pkt || !src->frame)
+        return AVERROR(ENOMEM);
+    return 0;
+}
+
+static void source_close(AudioSource *src)
+{
+    swr_free(&src->swr);
+    avcodec_free_context(&src->avctx);
+    avformat_close_input(&src->ic);
+    av_packet_free(&src->pkt);
+    av_frame_free(&src->frame);
+    av_freep(&src->buf);
+}
+
+int main(int argc, char **argv)
+{
+    AudioSource   src      = { 0 };
+    SDL_AudioSpec wanted   = { 0 };
+    SDL_AudioSpec spec;
+    SDL_AoutDummyStats stats;
+    SDL_AoutStats aout_stats;
+    const char   *filename = NULL;
+    int           realtime = 1;
+    int           samples  = 0;
+    double        rate     = 1.0;
+    double        limit    = 0;
+    int           queue    = 2;
+    double        jitter   = 0;
+    int           ret;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-fast")) {
+            realtime = 0;
+        } else if (!strcmp(argv[i], "-samples") && i + 1 < argc) {
+            samples = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-rate") && i + 1 < argc) {
+            rate = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            limit = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-queue") && i + 1 < argc) {
+            queue = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-jitter") && i + 1 < argc) {
+            jitter = atof(argv[++i]);
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            filename = NULL;
+            break;
+        }
+    }
+    if (!filename || rate <= 0 || queue <= 0 || jitter < 0) {
+        fprintf(stderr, "usage: %s [-fast] [-samples n] [-rate r] [-t seconds] [-queue buffers] [-jitter ms] input\n", argv[0]);
+        return 1;
+    }
+
+    av_register_all();
+    if ((ret = source_open(&src, filename)) < 0) {
+        fprintf(stderr, "%s: %s\n", filename, av_err2str(ret));
+        source_close(&src);
+        return 1;
+    }
+
+    wanted.freq     = src.avctx->sample_rate;
+    wanted.format   = AUDIO_S16SYS;
+    wanted.channels = src.channels;
+    wanted.samples  = samples > 0 ? samples :
+                      FFMAX(SDL_AUDIO_MIN_BUFFER_SIZE, 2 << av_log2(wanted.freq / SDL_AUDIO_MAX_CALLBACKS_PER_SEC));
+    wanted.callback = audio_callback;
+    wanted.userdata = &src;
+
+    /* the callback asks for the latency as soon as it runs */
+    SDL_Aout *aout = SDL_AoutDummy_Create(realtime);
+    src.aout = aout;
+    SDL_AoutDummy_SetDevice(aout, queue, (int)(jitter * 1000));
+    if (!aout || SDL_AoutOpenAudio(aout, &wanted, &spec) < 0) {
+        fprintf(stderr, "failed to open the null audio output\n");
+        SDL_AoutFreeP(&aout);
+        source_close(&src);
+        return 1;
+    }
+    SDL_AoutSetPlaybackRate(aout, rate);
+
+    double buffer_ms = spec.samples * 1000.0 / spec.freq;
+    printf("%s: %d Hz, %d channels, %d samples per callback (%.1f ms), %s, rate %.2f\n",
+           filename, spec.freq, spec.channels, spec.samples, buffer_ms,
+           realtime ? "real time" : "fast", rate);
+    if (realtime)
+        printf("device: %d buffers queued, periods up to %.1f ms late\n", queue, jitter);
+
+    SDL_AoutPauseAudio(aout, 0);
+    for (;;) {
+        av_usleep(10000);
+        SDL_AoutDummy_GetStats(aout, &stats);
+        if (src.eof || (limit > 0 && stats.device_seconds >= limit))
+            break;
+    }
+    SDL_AoutCloseAudio(aout);
+    SDL_AoutDummy_GetStats(aout, &stats);
+    SDL_AoutGetStats(aout, &aout_stats);
+    SDL_AoutFreeP(&aout);
+    source_close(&src);
+
+    printf("callbacks       %10"PRId64"\n", aout_stats.callbacks);
+    printf("device seconds  %10.3f\n", stats.device_seconds);
+    printf("wall seconds    %10.3f\n", stats.wall_seconds);
+    printf("x real time     %10.2f\n", stats.wall_seconds > 0 ? stats.device_seconds / stats.wall_seconds : 0);
+    printf("max callback ms %10.3f\n", aout_stats.max_callback_ms);
+    if (!realtime)
+        return 0;
+
+    /* woken on average half the jitter late, one buffer being filled */
+    printf("underruns       %10"PRId64"\n", aout_stats.underruns);
+    printf("latency ms      %10.2f  min %.2f max %.2f, expected ~%.2f\n",
+           src.latency_count ? src.latency_sum * 1000 / src.latency_count : 0,
+           src.latency_min * 1000, src.latency_max * 1000, queue * buffer_ms - jitter * rate / 2);
+    printf("jitter ms       %10.3f  max %.3f over %"PRId64" periods\n",
+           aout_stats.jitter_ms, aout_stats.max_jitter_ms, aout_stats.periods);
+    return 0;
+}
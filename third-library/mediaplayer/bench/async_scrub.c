@@ -0,0 +1,191 @@
+/*
+ * async_scrub.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Scrub session against the async: protocol: a scripted mix of short
+ * forward skips, short and long jumps back to places already played and
+ * long jumps forward, each followed by a read. Reports how many times the
+ * inner protocol had to reconnect and how long seeks took.
+ *
+ *   async_scrub [-n ops] [-seed n] [-cache file] [-stock] [-verify local_copy] url
+ *
+ * -stock runs with the fixed buffer and short seek window of the original
+ * async protocol, for comparison.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavformat/avformat.h"
+#include "libavutil/opt.h"
+#include "libavutil/time.h"
+
+#define MAX_VISITED 256
+
+static uint32_t rand_state;
+
+static uint32_t scrub_rand(void)
+{
+    rand_state = rand_state * 1664525 + 1013904223;
+    return rand_state >> 8;
+}
+
+static int64_t scrub_range(int64_t lo, int64_t hi)
+{
+    if (hi <= lo)
+        return lo;
+    return lo + (int64_t)(((uint64_t)scrub_rand() << 24 | scrub_rand()) % (uint64_t)(hi - lo));
+}
+
+static void usage(const char *name)
+{
+    printf("usage: %s [-n ops] [-seed n] [-cache file] [-stock] [-verify local_copy] url\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    AVIOContext *pb = NULL;
+    AVDictionary *opts = NULL;
+    FILE *verify = NULL;
+    const char *url = NULL, *cache = NULL, *verify_path = NULL;
+    int ops = 60, stock = 0, mismatches = 0;
+    int64_t visited[MAX_VISITED];
+    int n_visited = 0;
+    int64_t seek_time = 0, seek_max = 0, start, reconnects = -1;
+    static uint8_t buf[512 * 1024], ref[512 * 1024];
+    char full_url[4096];
+
+    rand_state = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            ops = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-seed") && i + 1 < argc) {
+            rand_state = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-cache") && i + 1 < argc) {
+            cache = argv[++i];
+        } else if (!strcmp(argv[i], "-verify") && i + 1 < argc) {
+            verify_path = argv[++i];
+        } else if (!strcmp(argv[i], "-stock")) {
+            stock = 1;
+        } else if (argv[i][0] != '-' && !url) {
+            url = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!url) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    av_register_all();
+    avformat_network_init();
+    av_log_set_level(AV_LOG_ERROR);
+
+    if (stock) {
+        av_dict_set(&opts, "async_buffer_time", "0", 0);
+        av_dict_set(&opts, "async_short_seek_time", "0", 0);
+    } else if (cache) {
+        av_dict_set(&opts, "async_cache_file", cache, 0);
+    }
+    snprintf(full_url, sizeof(full_url), "async:%s", url);
+    if (avio_open2(&pb, full_url, AVIO_FLAG_READ, NULL, &opts) < 0) {
+        fprintf(stderr, "failed to open %s\n", full_url);
+        return 1;
+    }
+    av_dict_free(&opts);
+    if (verify_path && !(verify = fopen(verify_path, "rb"))) {
+        fprintf(stderr, "failed to open %s\n", verify_path);
+        return 1;
+    }
+
+    int64_t size = avio_size(pb);
+    if (size <= 0) {
+        fprintf(stderr, "%s: size unknown, cannot scrub\n", url);
+        return 1;
+    }
+
+    start = av_gettime_relative();
+    for (int op = 0; op <= ops; op++) {
+        int64_t cur = avio_tell(pb), target;
+        int kind = op ? (int)(scrub_rand() % 4) : -1;
+
+        switch (kind) {
+        case 0:     /* skip a little forward */
+            target = cur + scrub_range(16 * 1024, 1024 * 1024);
+            break;
+        case 1:     /* step back a little */
+            target = cur - scrub_range(16 * 1024, 2 * 1024 * 1024);
+            break;
+        case 2:     /* back to somewhere already played */
+            target = n_visited ? visited[scrub_rand() % n_visited] + scrub_range(0, 256 * 1024) : 0;
+            break;
+        case 3:     /* far forward */
+            target = scrub_range(cur, size);
+            break;
+        default:
+            target = 0;
+            break;
+        }
+        target = av_clip64(target, 0, size - (int64_t)sizeof(buf));
+
+        int64_t t0 = av_gettime_relative();
+        if (avio_seek(pb, target, SEEK_SET) != target) {
+            fprintf(stderr, "seek to %"PRId64" failed\n", target);
+            break;
+        }
+        int len = (int)scrub_range(128 * 1024, sizeof(buf));
+        int got = avio_read(pb, buf, len);
+        int64_t dt = av_gettime_relative() - t0;
+        if (op) {
+            seek_time += dt;
+            seek_max = FFMAX(seek_max, dt);
+        }
+        if (got != len) {
+            fprintf(stderr, "short read at %"PRId64": %d of %d\n", target, got, len);
+            break;
+        }
+        if (verify) {
+            fseeko(verify, target, SEEK_SET);
+            if (fread(ref, 1, len, verify) != (size_t)len || memcmp(ref, buf, len))
+                mismatches++;
+        }
+        if (n_visited < MAX_VISITED)
+            visited[n_visited++] = target;
+    }
+    int64_t elapsed = av_gettime_relative() - start;
+
+    av_opt_get_int(pb, "async_reconnects", AV_OPT_SEARCH_CHILDREN, &reconnects);
+    printf("mode           %s\n", stock ? "stock" : cache ? "adaptive+cache" : "adaptive");
+    printf("ops            %d\n", ops);
+    printf("reconnects     %"PRId64"\n", reconnects);
+    printf("seek+read avg  %.1f ms, max %.1f ms\n", ops ? seek_time / 1000.0 / ops : 0, seek_max / 1000.0);
+    printf("total          %.1f ms\n", elapsed / 1000.0);
+    if (verify)
+        printf("mismatches     %d\n", mismatches);
+
+    avio_closep(&pb);
+    if (verify)
+        fclose(verify);
+    return mismatches ? 1 : 0;
+}
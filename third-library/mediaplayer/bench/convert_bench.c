@@ -0,0 +1,295 @@
+/*
+ * convert_bench.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Image conversion benchmark: times ijk_image_convert / ijk_image_scale
+ * (libyuv) against the swscale fallback of the FFmpeg overlay
+ * (SWS_BILINEAR) for every format pair the former handles, and reports the
+ * largest per-component difference between the two outputs. Rotation has
+ * no swscale counterpart; it is timed and checked by turning the image back.
+ *
+ *   convert_bench [-s WxH] [-iter n]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/imgutils.h"
+#include "libavutil/parseutils.h"
+#include "libavutil/pixdesc.h"
+#include "libavutil/time.h"
+#include "libswscale/swscale.h"
+
+#include "ijksdl/ffmpeg/ijksdl_image_convert.h"
+
+static const enum AVPixelFormat g_src_formats[] = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUV444P,
+    AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_YUVJ422P,
+    AV_PIX_FMT_NV12, AV_PIX_FMT_NV21,
+    AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_YUV444P10LE, AV_PIX_FMT_P010LE,
+};
+
+static const enum AVPixelFormat g_dst_formats[] = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_RGBA, AV_PIX_FMT_BGRA, AV_PIX_FMT_RGB565LE,
+    AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_P010LE,
+};
+
+static const enum AVPixelFormat g_scale_formats[] = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_RGBA,
+};
+
+typedef struct Image {
+    enum AVPixelFormat format;
+    int                width;
+    int                height;
+    uint8_t           *data[4];
+    int                linesize[4];
+} Image;
+
+static int image_alloc(Image *img, enum AVPixelFormat format, int width, int height)
+{
+    img->format = format;
+    img->width  = width;
+    img->height = height;
+    return av_image_alloc(img->data, img->linesize, width, height, format, 64);
+}
+
+static void image_free(Image *img)
+{
+    av_freep(&img->data[0]);
+}
+
+/* the context is cached across calls, as the overlay does */
+static int sws_convert(const Image *src, Image *dst)
+{
+    static struct SwsContext *sws;
+
+    sws = sws_getCachedContext(sws, src->width, src->height, src->format,
+                               dst->width, dst->height, dst->format,
+                               SWS_BILINEAR, NULL, NULL, NULL);
+    if (!sws)
+        return -1;
+    sws_scale(sws, (const uint8_t **)src->data, src->linesize, 0, src->height,
+              dst->data, dst->linesize);
+    return 0;
+}
+
+/* gradients with some texture, converted to the source format by swscale */
+static int make_source(Image *src, enum AVPixelFormat format, int width, int height)
+{
+    Image pattern;
+    int   ret;
+
+    if (image_alloc(&pattern, AV_PIX_FMT_YUV444P, width, height) < 0)
+        return -1;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            pattern.data[0][y * pattern.linesize[0] + x] = 16 + x * 203 / width + ((x ^ y) & 15);
+            pattern.data[1][y * pattern.linesize[1] + x] = 16 + y * 224 / height;
+            pattern.data[2][y * pattern.linesize[2] + x] = 16 + (x + y) * 224 / (width + height);
+        }
+    }
+
+    ret = image_alloc(src, format, width, height) < 0 ? -1 : sws_convert(&pattern, src);
+    image_free(&pattern);
+    return ret;
+}
+
+/* largest difference of any component, in 8-bit units */
+static int max_diff(const Image *a, const Image *b)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(a->format);
+    int diff = 0;
+
+    for (int c = 0; c < desc->nb_components; c++) {
+        const AVComponentDescriptor *comp = &desc->comp[c];
+        int chroma = c == 1 || c == 2;
+        int w = chroma && !(desc->flags & AV_PIX_FMT_FLAG_RGB) ? AV_CEIL_RSHIFT(a->width,  desc->log2_chroma_w) : a->width;
+        int h = chroma && !(desc->flags & AV_PIX_FMT_FLAG_RGB) ? AV_CEIL_RSHIFT(a->height, desc->log2_chroma_h) : a->height;
+        uint16_t *la = malloc(w * sizeof(*la));
+        uint16_t *lb = malloc(w * sizeof(*lb));
+
+        for (int y = 0; y < h; y++) {
+            av_read_image_line(la, (const uint8_t **)a->data, a->linesize, desc, 0, y, c, w, 0);
+            av_read_image_line(lb, (const uint8_t **)b->data, b->linesize, desc, 0, y, c, w, 0);
+            for (int x = 0; x < w; x++) {
+                int d = abs((int)la[x] - (int)lb[x]);
+                d = comp->depth > 8 ? d >> (comp->depth - 8) : d << (8 - comp->depth);
+                diff = FFMAX(diff, d);
+            }
+        }
+        free(la);
+        free(lb);
+    }
+    return diff;
+}
+
+static double time_ms(int64_t start, int iter)
+{
+    return (av_gettime_relative() - start) / 1000.0 / iter;
+}
+
+static void bench_convert(int width, int height, int iter)
+{
+    printf("convert %dx%d                   ijk ms   sws ms   speedup  maxdiff\n", width, height);
+    for (int s = 0; s < FF_ARRAY_ELEMS(g_src_formats); s++) {
+        Image src;
+
+        if (make_source(&src, g_src_formats[s], width, height) < 0)
+            continue;
+        for (int d = 0; d < FF_ARRAY_ELEMS(g_dst_formats); d++) {
+            Image   ijk, sws;
+            double  ijk_ms, sws_ms;
+            int64_t t;
+
+            image_alloc(&ijk, g_dst_formats[d], width, height);
+            image_alloc(&sws, g_dst_formats[d], width, height);
+
+            if (ijk_image_convert(width, height, ijk.format, ijk.data, ijk.linesize,
+                                  src.format, (const uint8_t **)src.data, src.linesize)) {
+                printf("  %-12s -> %-10s  no libyuv path\n",
+                       av_get_pix_fmt_name(src.format), av_get_pix_fmt_name(ijk.format));
+                goto next;
+            }
+
+            t = av_gettime_relative();
+            for (int i = 0; i < iter; i++)
+                ijk_image_convert(width, height, ijk.format, ijk.data, ijk.linesize,
+                                  src.format, (const uint8_t **)src.data, src.linesize);
+            ijk_ms = time_ms(t, iter);
+
+            t = av_gettime_relative();
+            for (int i = 0; i < iter; i++)
+                sws_convert(&src, &sws);
+            sws_ms = time_ms(t, iter);
+
+            printf("  %-12s -> %-10s %8.2f %8.2f %8.2fx %8d\n",
+                   av_get_pix_fmt_name(src.format), av_get_pix_fmt_name(ijk.format),
+                   ijk_ms, sws_ms, sws_ms / ijk_ms, max_diff(&ijk, &sws));
+next:
+            image_free(&ijk);
+            image_free(&sws);
+        }
+        image_free(&src);
+    }
+}
+
+static void bench_scale(int width, int height, int iter)
+{
+    int dst_width  = FFALIGN(width / 2, 2);
+    int dst_height = FFALIGN(height / 2, 2);
+
+    printf("scale %dx%d -> %dx%d       ijk ms   sws ms   speedup  maxdiff\n",
+           width, height, dst_width, dst_height);
+    for (int f = 0; f < FF_ARRAY_ELEMS(g_scale_formats); f++) {
+        Image   src, ijk, sws;
+        double  ijk_ms, sws_ms;
+        int64_t t;
+
+        if (make_source(&src, g_scale_formats[f], width, height) < 0)
+            continue;
+        image_alloc(&ijk, src.format, dst_width, dst_height);
+        image_alloc(&sws, src.format, dst_width, dst_height);
+
+        t = av_gettime_relative();
+        for (int i = 0; i < iter; i++) {
+            if (ijk_image_scale(src.format, width, height, (const uint8_t **)src.data, src.linesize,
+                                dst_width, dst_height, ijk.data, ijk.linesize))
+                break;
+        }
+        ijk_ms = time_ms(t, iter);
+
+        t = av_gettime_relative();
+        for (int i = 0; i < iter; i++)
+            sws_convert(&src, &sws);
+        sws_ms = time_ms(t, iter);
+
+        printf("  %-25s %8.2f %8.2f %8.2fx %8d\n", av_get_pix_fmt_name(src.format),
+               ijk_ms, sws_ms, sws_ms / ijk_ms, max_diff(&ijk, &sws));
+
+        image_free(&src);
+        image_free(&ijk);
+        image_free(&sws);
+    }
+}
+
+static void bench_rotate(int width, int height, int iter)
+{
+    static const enum AVPixelFormat formats[] = { AV_PIX_FMT_YUV420P, AV_PIX_FMT_RGBA };
+
+    printf("rotate 90 %dx%d            ijk ms   round trip\n", width, height);
+    for (int f = 0; f < FF_ARRAY_ELEMS(formats); f++) {
+        Image   src, rotated, back;
+        int64_t t;
+        double  ijk_ms;
+        int     ret;
+
+        if (make_source(&src, formats[f], width, height) < 0)
+            continue;
+        image_alloc(&rotated, src.format, height, width);
+        image_alloc(&back, src.format, width, height);
+
+        t = av_gettime_relative();
+        for (int i = 0; i < iter; i++)
+            ijk_image_rotate(src.format, width, height, 90, (const uint8_t **)src.data, src.linesize,
+                             rotated.data, rotated.linesize);
+        ijk_ms = time_ms(t, iter);
+
+        ret = ijk_image_rotate(src.format, height, width, 270, (const uint8_t **)rotated.data,
+                               rotated.linesize, back.data, back.linesize);
+        printf("  %-25s %8.2f   %s\n", av_get_pix_fmt_name(src.format), ijk_ms,
+               ret ? "failed" : max_diff(&src, &back) ? "MISMATCH" : "ok");
+
+        image_free(&src);
+        image_free(&rotated);
+        image_free(&back);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const int sizes[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+    int width = 0, height = 0, iter = 10;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            if (av_parse_video_size(&width, &height, argv[++i]) < 0) {
+                fprintf(stderr, "bad size %s\n", argv[i]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "-iter") && i + 1 < argc) {
+            iter = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-s WxH] [-iter n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (int s = 0; s < (width ? 1 : FF_ARRAY_ELEMS(sizes)); s++) {
+        int w = width ? width : sizes[s][0];
+        int h = width ? height : sizes[s][1];
+
+        bench_convert(w, h, iter);
+        bench_scale(w, h, iter);
+        bench_rotate(w, h, iter);
+    }
+    return 0;
+}
@@ -0,0 +1,309 @@
+/*
+ * dict_bench.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Option dictionary microbenchmark: builds a player-like configuration of
+ * n options and times the operations the io layer performs on it (set,
+ * exact and case-insensitive probes, probes for absent options, copy and
+ * merge), for IjkAVDictionary and, as the linear-scan reference, FFmpeg's
+ * AVDictionary. Lookup results of both are cross-checked.
+ *
+ *   dict_bench [-n options] [-iter n]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/dict.h"
+#include "libavutil/time.h"
+
+#include "player/avutil/ijkdict.h"
+
+/* the usual suspects, padded with numbered options up to n */
+static const char *g_option_names[] = {
+    "timeout", "reconnect", "user_agent", "headers", "referer", "cookies",
+    "http-detect-range-support", "dns_cache_timeout", "dns_cache_clear",
+    "multiple_requests", "seekable", "icy", "offset", "end_offset",
+    "ijkapplication", "ijkinject-segment-index", "cache_file_path",
+    "cache_map_path", "auto_save_map", "parse_cache_map", "analyzeduration",
+    "probesize", "fflags", "fpsprobesize", "max_delay", "rtsp_transport",
+    "async_buffer_time", "async_cache_file", "live_start_index", "abr",
+    "skip_loop_filter", "skip_frame", "threads", "refcounted_frames",
+    "lowres", "framedrop", "mediacodec", "opensles", "overlay-format",
+    "start-on-prepared", "packet-buffering", "max-buffer-size", "min-frames",
+    "first-high-water-mark-ms", "next-high-water-mark-ms",
+    "last-high-water-mark-ms", "sync-av-start", "enable-accurate-seek",
+    "soundtouch", "subtitle", "vn", "an", "loop", "infbuf", "gop-join",
+};
+
+#define NB_NAMES (sizeof(g_option_names) / sizeof(g_option_names[0]))
+
+static char **make_keys(int n, const char *fmt)
+{
+    char **keys = calloc(n, sizeof(*keys));
+    char name[32], buf[64];
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (i < NB_NAMES)
+            snprintf(name, sizeof(name), "%s", g_option_names[i]);
+        else
+            snprintf(name, sizeof(name), "opt-%d", i);
+        snprintf(buf, sizeof(buf), fmt, name);
+        keys[i] = strdup(buf);
+    }
+    return keys;
+}
+
+static void free_keys(char **keys, int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+/* every key in another case */
+static char **make_upper_keys(char **keys, int n)
+{
+    char **upper = calloc(n, sizeof(*upper));
+    int i, j;
+
+    for (i = 0; i < n; i++) {
+        upper[i] = strdup(keys[i]);
+        for (j = 0; upper[i][j]; j++) {
+            if (upper[i][j] >= 'a' && upper[i][j] <= 'z')
+                upper[i][j] -= 'a' - 'A';
+        }
+    }
+    return upper;
+}
+
+typedef struct BenchResult {
+    double set, get, get_nocase, miss, copy, merge;     /* ns per operation */
+} BenchResult;
+
+static void bench_ijk(char **keys, char **upper, char **absent, int n, int iter, BenchResult *r)
+{
+    IjkAVDictionary *d = NULL, *c = NULL, *extra = NULL;
+    volatile int sink = 0;
+    int64_t t;
+    int it, i;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            ijk_av_dict_set(&d, keys[i], "1", 0);
+        if (it != iter - 1)
+            ijk_av_dict_free(&d);
+    }
+    r->set = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            sink += !!ijk_av_dict_get(d, keys[i], NULL, IJK_AV_DICT_MATCH_CASE);
+    }
+    r->get = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            sink += !!ijk_av_dict_get(d, upper[i], NULL, 0);
+    }
+    r->get_nocase = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            sink += !!ijk_av_dict_get(d, absent[i], NULL, 0);
+    }
+    r->miss = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        ijk_av_dict_copy(&c, d, 0);
+        ijk_av_dict_free(&c);
+    }
+    r->copy = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    /* half of the extra options override, as when the hook adds its own */
+    for (i = 0; i < n; i++)
+        ijk_av_dict_set(&extra, i & 1 ? keys[i] : absent[i], "2", 0);
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        ijk_av_dict_copy(&c, d, 0);
+        ijk_av_dict_copy(&c, extra, 0);
+        ijk_av_dict_free(&c);
+    }
+    r->merge = (av_gettime_relative() - t) * 1000.0 / iter / (2 * n);
+
+    ijk_av_dict_free(&extra);
+    ijk_av_dict_free(&d);
+}
+
+static void bench_av(char **keys, char **upper, char **absent, int n, int iter, BenchResult *r)
+{
+    AVDictionary *d = NULL, *c = NULL, *extra = NULL;
+    volatile int sink = 0;
+    int64_t t;
+    int it, i;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            av_dict_set(&d, keys[i], "1", 0);
+        if (it != iter - 1)
+            av_dict_free(&d);
+    }
+    r->set = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            sink += !!av_dict_get(d, keys[i], NULL, AV_DICT_MATCH_CASE);
+    }
+    r->get = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            sink += !!av_dict_get(d, upper[i], NULL, 0);
+    }
+    r->get_nocase = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        for (i = 0; i < n; i++)
+            sink += !!av_dict_get(d, absent[i], NULL, 0);
+    }
+    r->miss = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        av_dict_copy(&c, d, 0);
+        av_dict_free(&c);
+    }
+    r->copy = (av_gettime_relative() - t) * 1000.0 / iter / n;
+
+    for (i = 0; i < n; i++)
+        av_dict_set(&extra, i & 1 ? keys[i] : absent[i], "2", 0);
+    t = av_gettime_relative();
+    for (it = 0; it < iter; it++) {
+        av_dict_copy(&c, d, 0);
+        av_dict_copy(&c, extra, 0);
+        av_dict_free(&c);
+    }
+    r->merge = (av_gettime_relative() - t) * 1000.0 / iter / (2 * n);
+
+    av_dict_free(&extra);
+    av_dict_free(&d);
+}
+
+/* same answers as AVDictionary for the operations above, plus deletes */
+static int check(char **keys, char **upper, char **absent, int n)
+{
+    IjkAVDictionary *d = NULL, *c = NULL;
+    AVDictionary *a = NULL;
+    IjkAVDictionaryEntry *t = NULL;
+    int i, errors = 0;
+
+    for (i = 0; i < n; i++) {
+        ijk_av_dict_set(&d, keys[i], keys[i], 0);
+        av_dict_set(&a, keys[i], keys[i], 0);
+    }
+    for (i = 0; i < n; i += 3) {
+        ijk_av_dict_set(&d, upper[i], "x", IJK_AV_DICT_APPEND);
+        av_dict_set(&a, upper[i], "x", AV_DICT_APPEND);
+        ijk_av_dict_set(&d, keys[i + 1 < n ? i + 1 : i], NULL, 0);
+        av_dict_set(&a, keys[i + 1 < n ? i + 1 : i], NULL, 0);
+    }
+    for (i = 0; i < n; i++) {
+        IjkAVDictionaryEntry *e = ijk_av_dict_get(d, upper[i], NULL, 0);
+        AVDictionaryEntry *f = av_dict_get(a, upper[i], NULL, 0);
+        if (!e != !f || (e && strcmp(e->value, f->value)))
+            errors++;
+        e = ijk_av_dict_get(d, upper[i], NULL, IJK_AV_DICT_MATCH_CASE);
+        f = av_dict_get(a, upper[i], NULL, AV_DICT_MATCH_CASE);
+        if (!e != !f || ijk_av_dict_get(d, absent[i], NULL, 0))
+            errors++;
+    }
+    if (ijk_av_dict_count(d) != av_dict_count(a))
+        errors++;
+
+    /* insertion order survives overwrites and copies */
+    ijk_av_dict_copy(&c, d, 0);
+    i = 0;
+    while ((t = ijk_av_dict_get(c, "", t, IJK_AV_DICT_IGNORE_SUFFIX))) {
+        for (; i < n && strcmp(keys[i], t->key) && strcasecmp(keys[i], t->key); i++)
+            ;
+        if (i++ == n)
+            errors++;
+    }
+
+    ijk_av_dict_free(&c);
+    ijk_av_dict_free(&d);
+    av_dict_free(&a);
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    static const int sizes[] = { 10, 50, 100 };
+    int n = 0, iter = 20000, i, s;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-iter") && i + 1 < argc)
+            iter = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [-n options] [-iter n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("ns/op            set     get  get-nocase   miss    copy   merge\n");
+    for (s = 0; s < (n ? 1 : 3); s++) {
+        int nb = n ? n : sizes[s];
+        char **keys   = make_keys(nb, "%s");
+        char **upper  = make_upper_keys(keys, nb);
+        char **absent = make_keys(nb, "no-%s");
+        BenchResult ri, ra;
+        int errors = check(keys, upper, absent, nb);
+
+        bench_ijk(keys, upper, absent, nb, iter, &ri);
+        bench_av(keys, upper, absent, nb, iter, &ra);
+        printf("n=%-4d ijk  %7.1f %7.1f %11.1f %6.1f %7.1f %7.1f%s\n", nb,
+               ri.set, ri.get, ri.get_nocase, ri.miss, ri.copy, ri.merge,
+               errors ? "  MISMATCH" : "");
+        printf("       av   %7.1f %7.1f %11.1f %6.1f %7.1f %7.1f\n",
+               ra.set, ra.get, ra.get_nocase, ra.miss, ra.copy, ra.merge);
+
+        free_keys(keys, nb);
+        free_keys(upper, nb);
+        free_keys(absent, nb);
+        if (errors)
+            return 1;
+    }
+    return 0;
+}
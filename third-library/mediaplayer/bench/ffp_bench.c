@@ -0,0 +1,380 @@
+/*
+ * ffp_bench.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Headless throughput benchmark: runs a file through the same
+ * demux -> decode -> convert steps the player performs, as fast as
+ * possible, and reports where the time goes. Video frames are converted
+ * through the ijksdl FFmpeg overlay (ijk_image_convert / swscale) into a
+ * dummy vout, audio frames are resampled to packed S16 the way
+ * audio_decode_frame() does for the aout.
+ *
+ *   ffp_bench [-f RV32|RV24|RV16|I420|YV12] [-threads n] [-an] [-vn] [-frames n]
+ *             [-trace out.json] file
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavformat/avformat.h"
+#include "libavcodec/avcodec.h"
+#include "libavutil/time.h"
+#include "libswresample/swresample.h"
+
+#include "ijksdl/ijksdl.h"
+#include "ijksdl/dummy/ijksdl_vout_dummy.h"
+
+enum {
+    STAGE_DEMUX,
+    STAGE_VDECODE,
+    STAGE_ADECODE,
+    STAGE_VCONVERT,
+    STAGE_ACONVERT,
+    STAGE_NB
+};
+
+static const char *g_stage_names[STAGE_NB] = {
+    "demux", "video decode", "audio decode", "video convert", "audio convert",
+};
+
+typedef struct BenchStage {
+    int64_t elapsed;    /* us */
+    int64_t count;
+    int64_t bytes;
+} BenchStage;
+
+typedef struct BenchContext {
+    AVFormatContext *ic;
+    AVCodecContext  *vdec;
+    AVCodecContext  *adec;
+    int              vindex;
+    int              aindex;
+    AVFrame         *frame;
+
+    SDL_Vout        *vout;
+    SDL_VoutOverlay *overlay;
+    Uint32           overlay_format;
+
+    SwrContext      *swr;
+    uint8_t         *audio_buf;
+    unsigned int     audio_buf_size;
+
+    int64_t          max_frames;
+    int64_t          video_frames;
+    int64_t          last_pts_us;
+
+    BenchStage       stages[STAGE_NB];
+} BenchContext;
+
+static Uint32 parse_overlay_format(const char *name)
+{
+    if (!strcmp(name, "RV32"))
+        return SDL_FCC_RV32;
+    if (!strcmp(name, "RV24"))
+        return SDL_FCC_RV24;
+    if (!strcmp(name, "RV16"))
+        return SDL_FCC_RV16;
+    if (!strcmp(name, "I420"))
+        return SDL_FCC_I420;
+    if (!strcmp(name, "YV12"))
+        return SDL_FCC_YV12;
+    return 0;
+}
+
+static AVCodecContext *open_decoder(AVFormatContext *ic, int stream_index, int threads)
+{
+    AVStream       *st    = ic->streams[stream_index];
+    AVCodec        *codec = avcodec_find_decoder(st->codecpar->codec_id);
+    AVCodecContext *avctx = NULL;
+    AVDictionary   *opts  = NULL;
+
+    if (!codec) {
+        ALOGE("no decoder for stream %d (%s)\n", stream_index, avcodec_get_name(st->codecpar->codec_id));
+        return NULL;
+    }
+
+    avctx = avcodec_alloc_context3(codec);
+    if (!avctx)
+        return NULL;
+    if (avcodec_parameters_to_context(avctx, st->codecpar) < 0)
+        goto fail;
+    av_codec_set_pkt_timebase(avctx, st->time_base);
+
+    av_dict_set_int(&opts, "threads", threads, 0);
+    av_dict_set(&opts, "refcounted_frames", "1", 0);
+    if (avcodec_open2(avctx, codec, &opts) < 0)
+        goto fail;
+    av_dict_free(&opts);
+    return avctx;
+fail:
+    av_dict_free(&opts);
+    avcodec_free_context(&avctx);
+    return NULL;
+}
+
+static int convert_video(BenchContext *bc, const AVFrame *frame)
+{
+    if (!bc->overlay || bc->overlay->w != frame->width || bc->overlay->h != frame->height) {
+        if (bc->overlay)
+            SDL_VoutFreeYUVOverlay(bc->overlay);
+        bc->overlay = SDL_VoutFFmpeg_CreateOverlay(frame->width, frame->height, frame->format, bc->vout);
+        if (!bc->overlay)
+            return -1;
+    }
+
+    SDL_VoutLockYUVOverlay(bc->overlay);
+    int ret = SDL_VoutFillFrameYUVOverlay(bc->overlay, frame);
+    SDL_VoutUnlockYUVOverlay(bc->overlay);
+    if (ret < 0)
+        return ret;
+    return SDL_VoutDisplayYUVOverlay(bc->vout, bc->overlay);
+}
+
+static int convert_audio(BenchContext *bc, const AVFrame *frame)
+{
+    int channels = FFMIN(av_frame_get_channels(frame), 2);
+    int64_t layout = av_get_default_channel_layout(channels);
+
+    if (!bc->swr) {
+        int64_t src_layout = frame->channel_layout ? frame->channel_layout :
+                             av_get_default_channel_layout(av_frame_get_channels(frame));
+        bc->swr = swr_alloc_set_opts(NULL, layout, AV_SAMPLE_FMT_S16, frame->sample_rate,
+                                     src_layout, frame->format, frame->sample_rate, 0, NULL);
+        if (!bc->swr || swr_init(bc->swr) < 0)
+            return -1;
+    }
+
+    int out_count = frame->nb_samples + 256;
+    int out_size  = av_samples_get_buffer_size(NULL, channels, out_count, AV_SAMPLE_FMT_S16, 0);
+    if (out_size < 0)
+        return -1;
+    av_fast_malloc(&bc->audio_buf, &bc->audio_buf_size, out_size);
+    if (!bc->audio_buf)
+        return AVERROR(ENOMEM);
+
+    uint8_t *out[] = { bc->audio_buf };
+    int len = swr_convert(bc->swr, out, out_count, (const uint8_t **)frame->extended_data, frame->nb_samples);
+    if (len < 0)
+        return len;
+    bc->stages[STAGE_ACONVERT].bytes += len * channels * 2;
+    return 0;
+}
+
+/* feeds pkt (NULL to drain) and converts everything the decoder returns */
+static int decode_packet(BenchContext *bc, AVCodecContext *avctx, AVPacket *pkt)
+{
+    int is_video = avctx == bc->vdec;
+    BenchStage *dec  = &bc->stages[is_video ? STAGE_VDECODE : STAGE_ADECODE];
+    BenchStage *conv = &bc->stages[is_video ? STAGE_VCONVERT : STAGE_ACONVERT];
+    int stream = is_video ? bc->vindex : bc->aindex;
+    int64_t trace_pts = pkt && pkt->pts != AV_NOPTS_VALUE ?
+                        av_rescale_q(pkt->pts, bc->ic->streams[stream]->time_base, AV_TIME_BASE_Q) : -1;
+    int64_t t0 = av_gettime_relative();
+
+    SDL_TRACE_BEGIN("decode", stream, trace_pts);
+    int ret = avcodec_send_packet(avctx, pkt);
+    SDL_TRACE_END("decode", stream, trace_pts);
+
+    if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+        dec->elapsed += av_gettime_relative() - t0;
+        return 0;   /* skip corrupt packets like the player does */
+    }
+
+    for (;;) {
+        ret = avcodec_receive_frame(avctx, bc->frame);
+        int64_t t1 = av_gettime_relative();
+        dec->elapsed += t1 - t0;
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+            return 0;
+        if (ret < 0)
+            return ret;
+        dec->count++;
+
+        int64_t pts = -1;
+        if (bc->frame->best_effort_timestamp != AV_NOPTS_VALUE) {
+            AVStream *st = bc->ic->streams[stream];
+            pts = av_rescale_q(bc->frame->best_effort_timestamp, st->time_base, AV_TIME_BASE_Q);
+            bc->last_pts_us = FFMAX(bc->last_pts_us, pts);
+        }
+
+        SDL_TRACE_BEGIN("convert", stream, pts);
+        ret = is_video ? convert_video(bc, bc->frame) : convert_audio(bc, bc->frame);
+        SDL_TRACE_END("convert", stream, pts);
+        av_frame_unref(bc->frame);
+        t0 = av_gettime_relative();
+        conv->elapsed += t0 - t1;
+        if (ret < 0)
+            return ret;
+        conv->count++;
+
+        if (is_video)
+            bc->video_frames++;
+    }
+}
+
+static void report(BenchContext *bc, int64_t wall)
+{
+    int64_t start_us = bc->ic->start_time != AV_NOPTS_VALUE ? bc->ic->start_time : 0;
+    double media = (bc->last_pts_us - start_us) / 1000000.0;
+
+    printf("%-14s %10s %6s %10s %10s %12s\n", "stage", "time(ms)", "share", "items", "items/s", "us/item");
+    for (int i = 0; i < STAGE_NB; i++) {
+        BenchStage *s = &bc->stages[i];
+        if (!s->count)
+            continue;
+        printf("%-14s %10.1f %5.1f%% %10"PRId64" %10.1f %12.1f\n",
+               g_stage_names[i], s->elapsed / 1000.0, wall ? 100.0 * s->elapsed / wall : 0,
+               s->count, s->elapsed ? s->count * 1000000.0 / s->elapsed : 0,
+               (double)s->elapsed / s->count);
+    }
+    printf("demux %.2f MB/s, %.2f s of media in %.3f s (%.1fx realtime)\n",
+           bc->stages[STAGE_DEMUX].elapsed ?
+               bc->stages[STAGE_DEMUX].bytes / (double)bc->stages[STAGE_DEMUX].elapsed : 0,
+           media, wall / 1000000.0, wall ? media * 1000000.0 / wall : 0);
+}
+
+static void usage(const char *name)
+{
+    printf("usage: %s [-f RV32|RV24|RV16|I420|YV12] [-threads n] [-an] [-vn] [-frames n]\n"
+           "          [-trace out.json] file\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    BenchContext bc = { 0 };
+    const char *filename = NULL;
+    const char *trace_path = NULL;
+    int threads = 0, no_audio = 0, no_video = 0, ret = 1;
+
+    bc.overlay_format = SDL_FCC_RV32;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            bc.overlay_format = parse_overlay_format(argv[++i]);
+            if (!bc.overlay_format) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "-threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-frames") && i + 1 < argc) {
+            bc.max_frames = atoll(argv[++i]);
+        } else if (!strcmp(argv[i], "-trace") && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (!strcmp(argv[i], "-an")) {
+            no_audio = 1;
+        } else if (!strcmp(argv[i], "-vn")) {
+            no_video = 1;
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!filename) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    av_register_all();
+    av_log_set_level(AV_LOG_ERROR);
+    if (trace_path) {
+        SDL_TraceSetThreadName("ffp_bench");
+        SDL_TraceSetEnabled(1);
+    }
+
+    if (avformat_open_input(&bc.ic, filename, NULL, NULL) < 0) {
+        ALOGE("failed to open %s\n", filename);
+        return 1;
+    }
+    if (avformat_find_stream_info(bc.ic, NULL) < 0) {
+        ALOGE("failed to probe %s\n", filename);
+        goto end;
+    }
+
+    bc.vindex = no_video ? -1 : av_find_best_stream(bc.ic, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    bc.aindex = no_audio ? -1 : av_find_best_stream(bc.ic, AVMEDIA_TYPE_AUDIO, -1, bc.vindex, NULL, 0);
+    if (bc.vindex >= 0 && !(bc.vdec = open_decoder(bc.ic, bc.vindex, threads)))
+        goto end;
+    if (bc.aindex >= 0 && !(bc.adec = open_decoder(bc.ic, bc.aindex, threads)))
+        goto end;
+    if (!bc.vdec && !bc.adec) {
+        ALOGE("nothing to decode in %s\n", filename);
+        goto end;
+    }
+
+    bc.vout  = SDL_VoutDummy_Create();
+    bc.frame = av_frame_alloc();
+    if (!bc.vout || !bc.frame)
+        goto end;
+    SDL_VoutSetOverlayFormat(bc.vout, bc.overlay_format);
+
+    AVPacket pkt;
+    av_init_packet(&pkt);
+
+    int64_t start = av_gettime_relative();
+    for (;;) {
+        if (bc.max_frames && bc.video_frames >= bc.max_frames)
+            break;
+
+        int64_t t0 = av_gettime_relative();
+        int err = av_read_frame(bc.ic, &pkt);
+        bc.stages[STAGE_DEMUX].elapsed += av_gettime_relative() - t0;
+        if (err < 0)
+            break;
+        bc.stages[STAGE_DEMUX].count++;
+        bc.stages[STAGE_DEMUX].bytes += pkt.size;
+        SDL_TRACE_INSTANT("read", pkt.stream_index,
+                          pkt.pts == AV_NOPTS_VALUE ? -1 :
+                          av_rescale_q(pkt.pts, bc.ic->streams[pkt.stream_index]->time_base, AV_TIME_BASE_Q));
+
+        if (pkt.stream_index == bc.vindex)
+            err = decode_packet(&bc, bc.vdec, &pkt);
+        else if (pkt.stream_index == bc.aindex)
+            err = decode_packet(&bc, bc.adec, &pkt);
+        av_packet_unref(&pkt);
+        if (err < 0) {
+            ALOGE("decode/convert failed: %s\n", av_err2str(err));
+            goto end;
+        }
+    }
+    if (bc.vdec)
+        decode_packet(&bc, bc.vdec, NULL);
+    if (bc.adec)
+        decode_packet(&bc, bc.adec, NULL);
+
+    report(&bc, av_gettime_relative() - start);
+    ret = 0;
+    if (trace_path && SDL_TraceExportChrome(trace_path) < 0)
+        ret = 1;
+end:
+    if (bc.overlay)
+        SDL_VoutFreeYUVOverlay(bc.overlay);
+    SDL_VoutFreeP(&bc.vout);
+    swr_free(&bc.swr);
+    av_freep(&bc.audio_buf);
+    av_frame_free(&bc.frame);
+    avcodec_free_context(&bc.vdec);
+    avcodec_free_context(&bc.adec);
+    avformat_close_input(&bc.ic);
+    return ret;
+}
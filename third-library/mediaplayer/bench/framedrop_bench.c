@@ -0,0 +1,164 @@
+/*
+ * framedrop_bench.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Decodes the video of a file once per decoder frame drop level, the way
+ * decoder_decode_frame does while ff_framedrop.c holds that level:
+ * disposable packets are skipped before the decoder and skip_frame is set
+ * to match. Prints the decode time and the frames that came out, i.e. how
+ * much CPU each level gives back when the player falls behind.
+ *
+ *   framedrop_bench [-threads n] [-frames n] input
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/time.h"
+
+#include "player/ff_framedrop.h"
+
+static const char *g_level_names[] = { "none", "nonref", "bidir" };
+static const enum AVDiscard g_level_discards[] = { AVDISCARD_DEFAULT, AVDISCARD_NONREF, AVDISCARD_BIDIR };
+
+typedef struct BenchResult {
+    int64_t packets;
+    int64_t skipped;
+    int64_t frames;
+    int64_t elapsed;    /* us spent in the decoder */
+} BenchResult;
+
+static int run_level(const char *filename, int level, int threads, int max_frames, BenchResult *r)
+{
+    AVFormatContext *ic    = NULL;
+    AVCodecContext  *avctx = NULL;
+    AVCodec         *codec = NULL;
+    AVFrame         *frame = av_frame_alloc();
+    AVPacket         pkt;
+    FFFrameDrop      fd;
+    int index, ret;
+
+    memset(r, 0, sizeof(*r));
+    if (!frame)
+        return AVERROR(ENOMEM);
+    if ((ret = avformat_open_input(&ic, filename, NULL, NULL)) < 0 ||
+        (ret = avformat_find_stream_info(ic, NULL)) < 0)
+        goto end;
+    if ((ret = index = av_find_best_stream(ic, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0)) < 0)
+        goto end;
+    if (!(avctx = avcodec_alloc_context3(codec))) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+    avcodec_parameters_to_context(avctx, ic->streams[index]->codecpar);
+    av_codec_set_pkt_timebase(avctx, ic->streams[index]->time_base);
+    avctx->thread_count = threads;
+    if ((ret = avcodec_open2(avctx, codec, NULL)) < 0)
+        goto end;
+
+    ffp_framedrop_init(&fd, 0);
+    ffp_framedrop_set_stream(&fd, avctx->codec_id == AV_CODEC_ID_H264 ? FFP_FRAMEDROP_CODEC_H264 :
+                                  avctx->codec_id == AV_CODEC_ID_HEVC ? FFP_FRAMEDROP_CODEC_HEVC :
+                                  FFP_FRAMEDROP_CODEC_OTHER,
+                             avctx->extradata, avctx->extradata_size);
+    fd.level = level;
+    avctx->skip_frame = g_level_discards[level];
+
+    av_init_packet(&pkt);
+    for (;;) {
+        int eof = av_read_frame(ic, &pkt) < 0;
+
+        if (!eof && pkt.stream_index != index) {
+            av_packet_unref(&pkt);
+            continue;
+        }
+        if (!eof) {
+            r->packets++;
+            if (ffp_framedrop_skip_packet(&fd, pkt.data, pkt.size)) {
+                av_packet_unref(&pkt);
+                continue;
+            }
+        }
+
+        int64_t t0 = av_gettime_relative();
+        avcodec_send_packet(avctx, eof ? NULL : &pkt);
+        while ((ret = avcodec_receive_frame(avctx, frame)) >= 0) {
+            r->frames++;
+            av_frame_unref(frame);
+        }
+        r->elapsed += av_gettime_relative() - t0;
+        av_packet_unref(&pkt);
+        if (eof || ret == AVERROR_EOF || (max_frames && r->packets >= max_frames))
+            break;
+    }
+    r->skipped = fd.skipped_packets;
+    ret = 0;
+
+end:
+    av_frame_free(&frame);
+    avcodec_free_context(&avctx);
+    avformat_close_input(&ic);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    const char *filename   = NULL;
+    int         threads    = 1;
+    int         max_frames = 0;
+    BenchResult r, base = { 0 };
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-frames") && i + 1 < argc) {
+            max_frames = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            filename = NULL;
+            break;
+        }
+    }
+    if (!filename || threads < 0 || max_frames < 0) {
+        fprintf(stderr, "usage: %s [-threads n] [-frames n] input\n", argv[0]);
+        return 1;
+    }
+
+    av_register_all();
+    printf("%-8s %8s %8s %8s %10s %8s\n", "level", "packets", "skipped", "frames", "decode ms", "cpu");
+    for (int level = FFP_FRAMEDROP_NONE; level <= FFP_FRAMEDROP_BIDIR; level++) {
+        int ret = run_level(filename, level, threads, max_frames, &r);
+        if (ret < 0) {
+            fprintf(stderr, "%s: %s\n", filename, av_err2str(ret));
+            return 1;
+        }
+        if (level == FFP_FRAMEDROP_NONE)
+            base = r;
+        printf("%-8s %8"PRId64" %8"PRId64" %8"PRId64" %10.1f %7.0f%%\n",
+               g_level_names[level], r.packets, r.skipped, r.frames, r.elapsed / 1000.0,
+               base.elapsed > 0 ? r.elapsed * 100.0 / base.elapsed : 0);
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+/*
+ * pacing_sim.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Frame pacing simulator: plays frames of a given rate on a display with
+ * a given refresh rate, in simulated time, the way video_refresh_thread
+ * does: sleeps of at most REFRESH_RATE, each woken up to -jitter ms late.
+ * A frame handed to the display becomes visible at the next vsync.
+ *
+ *   free    show each frame once its target time has passed
+ *   paced   show it on the vsync ff_pacer.c picks, handing it over a
+ *           quarter of a period after the vsync before
+ *
+ * and reports the presentation error (visible - target), how many vsyncs
+ * frames were held for, and frames that were replaced before they were
+ * ever visible.
+ *
+ *   pacing_sim [-hz refresh] [-fps rate] [-t seconds] [-jitter ms]
+ *              [-drift ppm] [-seed n] [-v]
+ *
+ * Without -fps the common rates are run in turn. -drift makes the media
+ * clock run that much faster than the display's; -v prints every paced
+ * frame.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "player/ff_pacer.h"
+
+#define REFRESH_US 10000
+
+static const double g_rates[] = { 23.976, 24, 25, 29.97, 30, 50, 59.94, 60 };
+
+typedef struct SimResult {
+    int64_t frames;
+    int64_t error_sum;
+    int64_t error_max;
+    int64_t replaced;
+    int64_t missed;
+    int64_t holds[FFP_PACER_MAX_HOLD + 1];
+} SimResult;
+
+static uint32_t rand_state;
+
+static int64_t sim_jitter(int64_t jitter_us)
+{
+    rand_state = rand_state * 1664525 + 1013904223;
+    return jitter_us > 0 ? (rand_state >> 8) % (jitter_us + 1) : 0;
+}
+
+/* first vsync after t */
+static int64_t next_vsync(int64_t t, int64_t phase, int64_t period)
+{
+    return phase + ((t - phase) / period + 1) * period;
+}
+
+/* sleeps the way video_refresh_thread does until deadline, returns the wake-up time */
+static int64_t sim_sleep_until(int64_t now, int64_t deadline, int64_t jitter_us)
+{
+    while (now < deadline) {
+        int64_t sleep = deadline - now;
+        if (sleep > REFRESH_US)
+            sleep = REFRESH_US;
+        now += sleep + sim_jitter(jitter_us);
+    }
+    return now;
+}
+
+static void sim_account(SimResult *r, int64_t target, int64_t visible, int64_t *last_visible, int64_t period)
+{
+    int64_t error = llabs(visible - target);
+
+    if (*last_visible && visible == *last_visible) {
+        /* the previous frame never made it to the screen */
+        r->replaced++;
+    } else if (*last_visible) {
+        int64_t hold = (visible - *last_visible + period / 2) / period;
+        r->holds[hold < FFP_PACER_MAX_HOLD ? hold : FFP_PACER_MAX_HOLD]++;
+    }
+    *last_visible = visible;
+    r->frames++;
+    r->error_sum += error;
+    if (error > r->error_max)
+        r->error_max = error;
+}
+
+static void sim_run(double hz, double fps, double seconds, int64_t jitter_us, double drift_ppm,
+                    int paced, int verbose, SimResult *r)
+{
+    int64_t period   = llrint(1000000.0 / hz);
+    int64_t phase    = period / 3;  /* vsyncs are not aligned with the start */
+    double  duration = 1000000.0 / fps / (1 + drift_ppm / 1000000.0);
+    int64_t nb       = llrint(seconds * fps);
+    int64_t now      = 0;
+    int64_t last_visible = 0;
+    FFPacer pacer;
+
+    memset(r, 0, sizeof(*r));
+    ffp_pacer_init(&pacer);
+    for (int64_t k = 0; k < nb; k++) {
+        int64_t target = 50000 + llrint(k * duration);
+        int64_t visible;
+
+        if (paced) {
+            int64_t vsync   = next_vsync(now, phase, period) - period;
+            int64_t present = ffp_pacer_schedule(&pacer, target, llrint(duration), vsync, period);
+            now = sim_sleep_until(now, present - period * 3 / 4, jitter_us);
+            visible = next_vsync(now, phase, period);
+            if (visible > present)
+                r->missed++;
+            if (verbose)
+                printf("  frame %6"PRId64"  target %10.3f ms  visible %10.3f ms  error %+7.3f ms\n",
+                       k, target / 1000.0, visible / 1000.0, (visible - target) / 1000.0);
+        } else {
+            now = sim_sleep_until(now, target, jitter_us);
+            visible = next_vsync(now, phase, period);
+        }
+        sim_account(r, target, visible, &last_visible, period);
+    }
+}
+
+static void print_result(const char *name, const SimResult *r)
+{
+    printf("  %-6s error avg %6.2f ms max %6.2f ms, replaced %4"PRId64", missed %4"PRId64", holds",
+           name, r->frames ? r->error_sum / 1000.0 / r->frames : 0, r->error_max / 1000.0,
+           r->replaced, r->missed);
+    for (int i = 1; i <= FFP_PACER_MAX_HOLD; i++) {
+        if (r->holds[i])
+            printf(" %d%s:%"PRId64, i, i == FFP_PACER_MAX_HOLD ? "+" : "", r->holds[i]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    double hz        = 60;
+    double fps       = 0;
+    double seconds   = 60;
+    double jitter_ms = 2;
+    double drift_ppm = 0;
+    int    verbose   = 0;
+    SimResult r;
+
+    rand_state = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-hz") && i + 1 < argc) {
+            hz = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-fps") && i + 1 < argc) {
+            fps = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-jitter") && i + 1 < argc) {
+            jitter_ms = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-drift") && i + 1 < argc) {
+            drift_ppm = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-seed") && i + 1 < argc) {
+            rand_state = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        } else {
+            fprintf(stderr, "usage: %s [-hz refresh] [-fps rate] [-t seconds] [-jitter ms] [-drift ppm] [-seed n] [-v]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (hz <= 0 || fps < 0 || seconds <= 0 || jitter_ms < 0) {
+        fprintf(stderr, "refresh rate, duration and jitter must be positive\n");
+        return 1;
+    }
+
+    printf("%.2f Hz display, %g s, wake-up jitter up to %.1f ms, drift %.0f ppm\n",
+           hz, seconds, jitter_ms, drift_ppm);
+    for (int i = 0; i < (int)(sizeof(g_rates) / sizeof(*g_rates)); i++) {
+        double rate = fps > 0 ? fps : g_rates[i];
+
+        printf("%.3f fps\n", rate);
+        sim_run(hz, rate, seconds, llrint(jitter_ms * 1000), drift_ppm, 0, 0, &r);
+        print_result("free", &r);
+        sim_run(hz, rate, seconds, llrint(jitter_ms * 1000), drift_ppm, 1, verbose, &r);
+        print_result("paced", &r);
+        if (fps > 0)
+            break;
+    }
+    return 0;
+}
@@ -37,6 +37,7 @@ LOCAL_SRC_FILES += ijksdl_mutex.c
 LOCAL_SRC_FILES += ijksdl_stdinc.c
 LOCAL_SRC_FILES += ijksdl_thread.c
 LOCAL_SRC_FILES += ijksdl_timer.c
+LOCAL_SRC_FILES += ijksdl_trace.c
 LOCAL_SRC_FILES += ijksdl_vout.c
 LOCAL_SRC_FILES += ijksdl_extra_log.c
 
@@ -45,15 +46,19 @@ LOCAL_SRC_FILES += ijksdl_extra_log.c
 # LOCAL_SRC_FILES += gles2/renderer.c
 # LOCAL_SRC_FILES += gles2/renderer_rgb.c
 # LOCAL_SRC_FILES += gles2/renderer_yuv420p.c
+# LOCAL_SRC_FILES += gles2/renderer_yuv420sp.c
 # LOCAL_SRC_FILES += gles2/renderer_yuv444p10le.c
 # LOCAL_SRC_FILES += gles2/shader.c
 # LOCAL_SRC_FILES += gles2/fsh/rgb.fsh.c
 # LOCAL_SRC_FILES += gles2/fsh/yuv420p.fsh.c
+# LOCAL_SRC_FILES += gles2/fsh/yuv420sp.fsh.c
 # LOCAL_SRC_FILES += gles2/fsh/yuv444p10le.fsh.c
 # LOCAL_SRC_FILES += gles2/vsh/mvp.vsh.c
 
 LOCAL_SRC_FILES += dummy/ijksdl_vout_dummy.c
+LOCAL_SRC_FILES += dummy/ijksdl_aout_dummy.c
 
+# LOCAL_SRC_FILES += ffmpeg/ijksdl_frame_pool.c
 # LOCAL_SRC_FILES += ffmpeg/ijksdl_vout_overlay_ffmpeg.c
 # LOCAL_SRC_FILES += ffmpeg/abi_all/image_convert.c
 
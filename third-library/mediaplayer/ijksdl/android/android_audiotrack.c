@@ -138,6 +138,26 @@ int audiotrack_get_native_output_sample_rate(JNIEnv *env)
     return retval;
 }
 
+/* bytes the platform mixer wants buffered for 16-bit pcm in this format, -1 if unknown */
+int audiotrack_get_min_buffer_size(JNIEnv *env, int sample_rate_in_hz, int channels)
+{
+    if (!env) {
+        if (JNI_OK != SDL_JNI_SetupThreadEnv(&env)) {
+            ALOGE("%s: SetupThreadEnv failed", __func__);
+            return -1;
+        }
+    }
+
+    jint retval = J4AC_AudioTrack__getMinBufferSize(env,
+        sample_rate_in_hz,
+        channels == 1 ? CHANNEL_OUT_MONO : CHANNEL_OUT_STEREO,
+        ENCODING_PCM_16BIT);
+    if (J4A_ExceptionCheck__catchAll(env) || retval <= 0)
+        return -1;
+
+    return retval;
+}
+
 void SDL_Android_AudioTrack_set_volume(JNIEnv *env, SDL_Android_AudioTrack *atrack, float left_volume, float right_volume)
 {
     J4AC_AudioTrack__setStereoVolume__catchAll(env, atrack->thiz, left_volume, right_volume);
@@ -97,6 +97,7 @@ void SDL_Android_AudioTrack_free(JNIEnv *env, SDL_Android_AudioTrack* atrack);
 void SDL_Android_AudioTrack_get_target_spec(SDL_Android_AudioTrack* atrack, SDL_AudioSpec *spec);
 int SDL_Android_AudioTrack_get_min_buffer_size(SDL_Android_AudioTrack* atrack);
 int audiotrack_get_native_output_sample_rate(JNIEnv *env/* = NULL */);
+int audiotrack_get_min_buffer_size(JNIEnv *env/* = NULL */, int sample_rate_in_hz, int channels);
 
 void SDL_Android_AudioTrack_play(JNIEnv *env, SDL_Android_AudioTrack *atrack);
 void SDL_Android_AudioTrack_pause(JNIEnv *env, SDL_Android_AudioTrack *atrack);
@@ -26,6 +26,7 @@
 #include <assert.h>
 #include <math.h>
 #include <inttypes.h>
+#include <time.h>
 #include <jni.h>
 #include <SLES/OpenSLES.h>
 #include <SLES/OpenSLES_Android.h>
@@ -43,6 +44,8 @@
 
 #define OPENSLES_BUFFERS 255 /* maximum number of buffers */
 #define OPENSLES_BUFLEN  10 /* ms */
+#define OPENSLES_MIN_BUFFERS 4 /* fewest buffers kept queued, raised to what AudioTrack needs */
+#define OPENSLES_DECAY_MS 10000 /* audio played without an underrun before the queue shrinks by one */
 
 static SDL_Class g_opensles_class = {
     .name = "OpenSLES",
@@ -83,6 +86,17 @@ typedef struct SDL_Aout_Opaque {
 
     uint8_t       *buffer;
     size_t         buffer_capacity;
+
+    /* number of buffers kept in the queue, raised on underruns and decaying back to min */
+    int            queue_buffers;
+    int            min_queue_buffers;
+    /* buffers played since the queue length last changed */
+    int            steady_buffers;
+    /* when the device last returned a buffer, 0 after a pause or flush */
+    int64_t        last_complete_us;
+    bool           in_callback;
+    double         callback_latency;
+    SDL_AoutStats  stats;
 } SDL_Aout_Opaque;
 
 #define CHECK_OPENSL_ERROR(ret__, ...) \
@@ -116,6 +130,33 @@ static inline SLmillibel android_amplification_to_sles(float volumeLevel) {
     return mb;
 }
 
+static int64_t aout_now_us()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* audio queued on the device, less what it has played of the buffer at its head */
+static double aout_measure_latency_l(SDL_Aout_Opaque *opaque, int64_t now)
+{
+    SLAndroidSimpleBufferQueueState state = {0};
+    SLresult slRet = (*opaque->slBufferQueueItf)->GetState(opaque->slBufferQueueItf, &state);
+    if (slRet != SL_RESULT_SUCCESS) {
+        ALOGE("%s failed\n", __func__);
+        return ((double)opaque->milli_per_buffer) * opaque->queue_buffers / 1000;
+    }
+
+    int64_t latency_us = (int64_t)opaque->milli_per_buffer * 1000 * state.count;
+    if (state.count > 0 && opaque->last_complete_us > 0) {
+        int64_t played_us = now - opaque->last_complete_us;
+        if (played_us > opaque->milli_per_buffer * 1000)
+            played_us = opaque->milli_per_buffer * 1000;
+        latency_us -= played_us;
+    }
+    return latency_us / 1000000.0;
+}
+
 static int aout_thread_n(SDL_Aout *aout)
 {
     SDL_Aout_Opaque               *opaque           = aout->opaque;
@@ -143,8 +184,8 @@ static int aout_thread_n(SDL_Aout *aout)
         }
 
         SDL_LockMutex(opaque->wakeup_mutex);
-        if (!opaque->abort_request && (opaque->pause_on || slState.count >= OPENSLES_BUFFERS)) {
-            while (!opaque->abort_request && (opaque->pause_on || slState.count >= OPENSLES_BUFFERS)) {
+        if (!opaque->abort_request && (opaque->pause_on || slState.count >= opaque->queue_buffers)) {
+            while (!opaque->abort_request && (opaque->pause_on || slState.count >= opaque->queue_buffers)) {
                 if (!opaque->pause_on) {
                     (*slPlayItf)->SetPlayState(slPlayItf, SL_PLAYSTATE_PLAYING);
                 }
@@ -182,11 +223,24 @@ static int aout_thread_n(SDL_Aout *aout)
                 // just ignore error
             }
         }
+        // the buffer being filled plays after everything already queued
+        opaque->callback_latency = aout_measure_latency_l(opaque, aout_now_us()) + (double)opaque->milli_per_buffer / 1000;
+        opaque->in_callback = true;
         SDL_UnlockMutex(opaque->wakeup_mutex);
 
         next_buffer = opaque->buffer + next_buffer_index * bytes_per_buffer;
         next_buffer_index = (next_buffer_index + 1) % OPENSLES_BUFFERS;
+        int64_t callback_start = aout_now_us();
         audio_cblk(userdata, next_buffer, bytes_per_buffer);
+        double callback_ms = (aout_now_us() - callback_start) / 1000.0;
+
+        SDL_LockMutex(opaque->wakeup_mutex);
+        opaque->in_callback = false;
+        opaque->stats.callbacks++;
+        opaque->stats.latency_seconds = opaque->callback_latency;
+        if (callback_ms > opaque->stats.max_callback_ms)
+            opaque->stats.max_callback_ms = callback_ms;
+        SDL_UnlockMutex(opaque->wakeup_mutex);
         if (opaque->need_flush) {
             (*slBufferQueueItf)->Clear(slBufferQueueItf);
             opaque->need_flush = false;
@@ -229,6 +283,31 @@ static void aout_opensles_callback(SLAndroidSimpleBufferQueueItf caller, void *p
     if (opaque) {
         SDL_LockMutex(opaque->wakeup_mutex);
         opaque->is_running = true;
+
+        int64_t now = aout_now_us();
+        if (opaque->last_complete_us > 0)
+            SDL_Aout_StatsAddPeriod(&opaque->stats, now - opaque->last_complete_us, opaque->milli_per_buffer * 1000);
+        opaque->last_complete_us = now;
+
+        SLAndroidSimpleBufferQueueState state = {0};
+        if ((*caller)->GetState(caller, &state) == SL_RESULT_SUCCESS &&
+            state.count == 0 && !opaque->pause_on && !opaque->need_flush && !opaque->abort_request) {
+            // ran dry: keep one more buffer queued from now on
+            opaque->stats.underruns++;
+            opaque->steady_buffers = 0;
+            if (opaque->queue_buffers < OPENSLES_BUFFERS) {
+                opaque->queue_buffers++;
+                ALOGI("OpenSL-ES: underrun, queue %d buffers (%d ms)\n",
+                      opaque->queue_buffers, opaque->queue_buffers * opaque->milli_per_buffer);
+            }
+        } else if (opaque->queue_buffers > opaque->min_queue_buffers &&
+                   ++opaque->steady_buffers * opaque->milli_per_buffer >= OPENSLES_DECAY_MS) {
+            // a stall that made the queue grow has passed: give the latency back slowly
+            opaque->steady_buffers = 0;
+            opaque->queue_buffers--;
+            ALOGI("OpenSL-ES: no underrun for %d ms, queue %d buffers (%d ms)\n",
+                  OPENSLES_DECAY_MS, opaque->queue_buffers, opaque->queue_buffers * opaque->milli_per_buffer);
+        }
         SDL_CondSignal(opaque->wakeup_cond);
         SDL_UnlockMutex(opaque->wakeup_mutex);
     }
@@ -408,11 +487,27 @@ static int aout_open_audio(SDL_Aout *aout, const SDL_AudioSpec *desired, SDL_Aud
     opaque->buffer          = malloc(opaque->buffer_capacity);
     CHECK_COND_ERROR(opaque->buffer, "%s: failed to alloc buffer %d\n", __func__, (int)opaque->buffer_capacity);
 
+    // start with what the platform mixer asks of an AudioTrack in this format, underruns
+    // make the queue longer and it shrinks back after a while without them
+    int min_buffer_size = audiotrack_get_min_buffer_size(NULL, format_pcm->samplesPerSec / 1000, format_pcm->numChannels);
+    opaque->min_queue_buffers = OPENSLES_MIN_BUFFERS;
+    if (min_buffer_size > 0) {
+        int min_buffers = (min_buffer_size + opaque->bytes_per_buffer - 1) / opaque->bytes_per_buffer;
+        opaque->min_queue_buffers = IJKMAX(min_buffers, OPENSLES_MIN_BUFFERS);
+        opaque->min_queue_buffers = IJKMIN(opaque->min_queue_buffers, OPENSLES_BUFFERS);
+    }
+    ALOGI("OpenSL-ES: AudioTrack min buffer %d bytes, queue %d buffers\n", min_buffer_size, opaque->min_queue_buffers);
+    opaque->queue_buffers    = opaque->min_queue_buffers;
+    opaque->steady_buffers   = 0;
+    opaque->last_complete_us = 0;
+    memset(&opaque->stats, 0, sizeof(opaque->stats));
+    opaque->stats.buffer_frames = opaque->frames_per_buffer;
+
     // (*opaque->slPlayItf)->SetPositionUpdatePeriod(opaque->slPlayItf, 1000);
 
     // enqueue empty buffer to start play
     memset(opaque->buffer, 0, opaque->buffer_capacity);
-    for(int i = 0; i < OPENSLES_BUFFERS; ++i) {
+    for(int i = 0; i < opaque->queue_buffers; ++i) {
         ret = (*opaque->slBufferQueueItf)->Enqueue(opaque->slBufferQueueItf, opaque->buffer + i * opaque->bytes_per_buffer, opaque->bytes_per_buffer);
         CHECK_OPENSL_ERROR(ret, "%s: slBufferQueueItf->Enqueue(000...) failed", __func__);
     }
@@ -422,13 +517,15 @@ static int aout_open_audio(SDL_Aout *aout, const SDL_AudioSpec *desired, SDL_Aud
     opaque->audio_tid = SDL_CreateThreadEx(&opaque->_audio_tid, aout_thread, aout, "ff_aout_opensles");
     CHECK_COND_ERROR(opaque->audio_tid, "%s: failed to SDL_CreateThreadEx", __func__);
 
+    // the callback fills one buffer at a time
     if (obtained) {
-        *obtained      = *desired;
-        obtained->size = opaque->buffer_capacity;
-        obtained->freq = format_pcm->samplesPerSec / 1000;
+        *obtained         = *desired;
+        obtained->size    = opaque->bytes_per_buffer;
+        obtained->samples = opaque->frames_per_buffer;
+        obtained->freq    = format_pcm->samplesPerSec / 1000;
     }
 
-    return opaque->buffer_capacity;
+    return opaque->bytes_per_buffer;
 fail:
     aout_close_audio(aout);
     return -1;
@@ -441,6 +538,7 @@ static void aout_pause_audio(SDL_Aout *aout, int pause_on)
     SDL_LockMutex(opaque->wakeup_mutex);
     SDLTRACE("aout_pause_audio(%d)", pause_on);
     opaque->pause_on = pause_on;
+    opaque->last_complete_us = 0;
     if (!pause_on)
         SDL_CondSignal(opaque->wakeup_cond);
     SDL_UnlockMutex(opaque->wakeup_mutex);
@@ -452,6 +550,7 @@ static void aout_flush_audio(SDL_Aout *aout)
     SDL_LockMutex(opaque->wakeup_mutex);
     SDLTRACE("aout_flush_audio()");
     opaque->need_flush = 1;
+    opaque->last_complete_us = 0;
     SDL_CondSignal(opaque->wakeup_cond);
     SDL_UnlockMutex(opaque->wakeup_mutex);
 }
@@ -471,19 +570,27 @@ static void aout_set_volume(SDL_Aout *aout, float left_volume, float right_volum
 static double aout_get_latency_seconds(SDL_Aout *aout)
 {
     SDL_Aout_Opaque *opaque = aout->opaque;
+    double latency;
 
-    SLAndroidSimpleBufferQueueState state = {0};
-    SLresult slRet = (*opaque->slBufferQueueItf)->GetState(opaque->slBufferQueueItf, &state);
-    if (slRet != SL_RESULT_SUCCESS) {
-        ALOGE("%s failed\n", __func__);
-        return ((double)opaque->milli_per_buffer) * OPENSLES_BUFFERS / 1000;
-    }
-
-    // assume there is always a buffer in coping
-    double latency = ((double)opaque->milli_per_buffer) * state.count / 1000;
+    SDL_LockMutex(opaque->wakeup_mutex);
+    if (opaque->in_callback)
+        latency = opaque->callback_latency;
+    else
+        latency = aout_measure_latency_l(opaque, aout_now_us());
+    SDL_UnlockMutex(opaque->wakeup_mutex);
     return latency;
 }
 
+static void aout_get_stats(SDL_Aout *aout, SDL_AoutStats *stats)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    *stats = opaque->stats;
+    stats->queue_buffers = opaque->queue_buffers;
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+}
+
 SDL_Aout *SDL_AoutAndroid_CreateForOpenSLES()
 {
     SDLTRACE("%s\n", __func__);
@@ -528,6 +635,7 @@ SDL_Aout *SDL_AoutAndroid_CreateForOpenSLES()
     aout->close_audio  = aout_close_audio;
     aout->set_volume   = aout_set_volume;
     aout->func_get_latency_seconds = aout_get_latency_seconds;
+    aout->func_get_stats           = aout_get_stats;
 
     return aout;
 fail:
@@ -0,0 +1,407 @@
+/*****************************************************************************
+ * ijksdl_aout_dummy.c
+ *****************************************************************************
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ijksdl_aout_dummy.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../ijksdl_inc_internal.h"
+#include "../ijksdl_thread.h"
+#include "../ijksdl_aout_internal.h"
+
+static SDL_Class g_dummy_class = {
+    .name = "Dummy",
+};
+
+typedef struct SDL_Aout_Opaque {
+    SDL_cond   *wakeup_cond;
+    SDL_mutex  *wakeup_mutex;
+
+    SDL_Thread *audio_tid;
+    SDL_Thread _audio_tid;
+
+    SDL_AudioSpec spec;
+    int           bytes_per_sec;
+    uint8_t      *buffer;
+
+    bool           realtime;
+    int            queue_buffers;
+    int            jitter_us;
+    uint32_t       rand_state;
+    volatile bool  abort_request;
+    volatile bool  pause_on;
+    volatile float playback_rate;
+
+    /* audio handed to the device and the position it has played to, in
+     * microseconds of audio at rate 1; the position moves at the playback
+     * rate from device_base, taken at wall_base */
+    int64_t        device_time;
+    int64_t        device_base;
+    int64_t        wall_base;
+    /* fast mode: the time the player runs on. It is clock_base while the
+     * thread pulls buffers, and moves by one buffer at the playback rate per
+     * callback; paused or closed it moves with the wall clock from clock_wall */
+    int64_t        clock_base;
+    int64_t        clock_wall;
+    /* wall time played before the current run, and when that run began */
+    int64_t        wall_played;
+    int64_t        play_start;
+
+    bool           in_callback;
+    double         callback_latency;
+    int64_t        last_period_us;
+
+    SDL_AoutStats      stats;
+    SDL_AoutDummyStats dummy_stats;
+} SDL_Aout_Opaque;
+
+static int64_t aout_now_us()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static int64_t aout_played_l(SDL_Aout_Opaque *opaque, int64_t now)
+{
+    return opaque->device_base + (int64_t)((now - opaque->wall_base) * opaque->playback_rate);
+}
+
+/* restart the device position from played, after a pause, a rate change or an underrun */
+static void aout_rebase_l(SDL_Aout_Opaque *opaque, int64_t now, int64_t played)
+{
+    opaque->wall_base      = now;
+    opaque->device_base    = played;
+    opaque->last_period_us = 0;
+}
+
+static int64_t aout_clock_l(SDL_Aout_Opaque *opaque, int64_t now)
+{
+    return opaque->clock_wall ? opaque->clock_base + now - opaque->clock_wall : opaque->clock_base;
+}
+
+/* hand the fast mode clock over to the audio pulled (follow_audio) or to the wall clock */
+static void aout_clock_follow_l(SDL_Aout_Opaque *opaque, int64_t now, bool follow_audio)
+{
+    opaque->clock_base = aout_clock_l(opaque, now);
+    opaque->clock_wall = follow_audio ? 0 : now;
+}
+
+static double aout_measure_latency_l(SDL_Aout_Opaque *opaque, int64_t now)
+{
+    if (!opaque->realtime)
+        return 0;
+    return IJKMAX(opaque->device_time - aout_played_l(opaque, now), 0) / 1000000.0;
+}
+
+static int aout_thread_n(SDL_Aout *aout)
+{
+    SDL_Aout_Opaque   *opaque     = aout->opaque;
+    SDL_AudioCallback  audio_cblk = opaque->spec.callback;
+    void              *userdata   = opaque->spec.userdata;
+    int                len        = opaque->spec.size;
+    int64_t            buffer_us  = (int64_t)opaque->spec.samples * 1000000 / opaque->spec.freq;
+    int64_t            delay_us   = 0;
+    int64_t            now;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    now = aout_now_us();
+    aout_rebase_l(opaque, now, 0);
+    opaque->play_start = now;
+    if (!opaque->realtime)
+        aout_clock_follow_l(opaque, now, true);
+    while (!opaque->abort_request) {
+        if (opaque->pause_on) {
+            now = aout_now_us();
+            int64_t played = IJKMIN(aout_played_l(opaque, now), opaque->device_time);
+            opaque->wall_played += now - opaque->play_start;
+            if (!opaque->realtime)
+                aout_clock_follow_l(opaque, now, false);
+            while (!opaque->abort_request && opaque->pause_on)
+                SDL_CondWaitTimeout(opaque->wakeup_cond, opaque->wakeup_mutex, 1000);
+            now = aout_now_us();
+            aout_rebase_l(opaque, now, played);
+            opaque->play_start = now;
+            if (!opaque->realtime)
+                aout_clock_follow_l(opaque, now, true);
+            continue;
+        }
+
+        now = aout_now_us();
+        if (opaque->realtime) {
+            /* wait for the device to free a buffer, plus this period's delay */
+            int64_t ahead = opaque->device_time - opaque->device_base - (int64_t)(opaque->queue_buffers - 1) * buffer_us;
+            int64_t due   = opaque->wall_base + (int64_t)(ahead / opaque->playback_rate) + delay_us;
+            if (due > now) {
+                SDL_CondWaitTimeout(opaque->wakeup_cond, opaque->wakeup_mutex, (uint32_t)((due - now + 999) / 1000));
+                continue;
+            }
+
+            if (ahead > 0) {
+                if (opaque->last_period_us)
+                    SDL_Aout_StatsAddPeriod(&opaque->stats, now - opaque->last_period_us,
+                                            (int64_t)(buffer_us / opaque->playback_rate));
+                opaque->last_period_us = now;
+            }
+            if (opaque->device_time > opaque->device_base &&
+                aout_played_l(opaque, now) > opaque->device_time) {
+                /* ran dry: the device plays silence until this buffer arrives */
+                opaque->stats.underruns++;
+                aout_rebase_l(opaque, now, opaque->device_time);
+            }
+            if (opaque->jitter_us > 0) {
+                opaque->rand_state = opaque->rand_state * 1664525 + 1013904223;
+                delay_us = (opaque->rand_state >> 8) % (opaque->jitter_us + 1);
+            }
+        }
+        opaque->callback_latency = aout_measure_latency_l(opaque, now) + buffer_us / 1000000.0;
+        opaque->in_callback = true;
+        SDL_UnlockMutex(opaque->wakeup_mutex);
+
+        int64_t start = aout_now_us();
+        audio_cblk(userdata, opaque->buffer, len);
+        int64_t end = aout_now_us();
+        int64_t elapsed = end - start;
+
+        SDL_LockMutex(opaque->wakeup_mutex);
+        opaque->in_callback = false;
+        opaque->device_time += buffer_us;
+        if (!opaque->realtime && !opaque->clock_wall)
+            opaque->clock_base += (int64_t)(buffer_us / opaque->playback_rate);
+        opaque->stats.callbacks++;
+        opaque->stats.latency_seconds = opaque->callback_latency;
+        if (elapsed / 1000.0 > opaque->stats.max_callback_ms)
+            opaque->stats.max_callback_ms = elapsed / 1000.0;
+        opaque->dummy_stats.bytes += len;
+        opaque->dummy_stats.device_seconds = opaque->dummy_stats.bytes / (double)opaque->bytes_per_sec;
+        opaque->dummy_stats.wall_seconds   = (opaque->wall_played + end - opaque->play_start) / 1000000.0;
+    }
+    if (!opaque->realtime && !opaque->clock_wall)
+        aout_clock_follow_l(opaque, aout_now_us(), false);
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+
+    return 0;
+}
+
+static int aout_thread(void *arg)
+{
+    return aout_thread_n(arg);
+}
+
+static void aout_close_audio(SDL_Aout *aout)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+    if (!opaque)
+        return;
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    opaque->abort_request = true;
+    SDL_CondSignal(opaque->wakeup_cond);
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+
+    SDL_WaitThread(opaque->audio_tid, NULL);
+    opaque->audio_tid = NULL;
+
+    freep((void **)&opaque->buffer);
+}
+
+static void aout_free_l(SDL_Aout *aout)
+{
+    if (!aout)
+        return;
+
+    aout_close_audio(aout);
+
+    SDL_Aout_Opaque *opaque = aout->opaque;
+    SDL_DestroyCondP(&opaque->wakeup_cond);
+    SDL_DestroyMutexP(&opaque->wakeup_mutex);
+
+    SDL_Aout_FreeInternal(aout);
+}
+
+static int aout_open_audio(SDL_Aout *aout, const SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+
+    if (desired->freq <= 0 || desired->channels == 0 || desired->samples == 0 ||
+        !SDL_AUDIO_BITSIZE(desired->format) || !desired->callback) {
+        ALOGE("%s: invalid spec %d Hz, %d channels, %d samples\n", __func__,
+              desired->freq, desired->channels, desired->samples);
+        return -1;
+    }
+
+    opaque->spec = *desired;
+    SDL_CalculateAudioSpec(&opaque->spec);
+    opaque->bytes_per_sec = opaque->spec.size / opaque->spec.samples * opaque->spec.freq;
+    opaque->buffer = malloc(opaque->spec.size);
+    if (!opaque->buffer) {
+        ALOGE("%s: failed to alloc buffer %d\n", __func__, (int)opaque->spec.size);
+        return -1;
+    }
+
+    memset(&opaque->stats, 0, sizeof(opaque->stats));
+    memset(&opaque->dummy_stats, 0, sizeof(opaque->dummy_stats));
+    opaque->stats.buffer_frames = opaque->spec.samples;
+    opaque->stats.queue_buffers = opaque->realtime ? opaque->queue_buffers : 1;
+    opaque->device_time   = 0;
+    opaque->wall_played   = 0;
+    opaque->pause_on      = 1;
+    opaque->abort_request = 0;
+    opaque->audio_tid = SDL_CreateThreadEx(&opaque->_audio_tid, aout_thread, aout, "ff_aout_dummy");
+    if (!opaque->audio_tid) {
+        ALOGE("%s: failed to SDL_CreateThreadEx\n", __func__);
+        freep((void **)&opaque->buffer);
+        return -1;
+    }
+
+    if (obtained)
+        *obtained = opaque->spec;
+
+    return opaque->spec.size;
+}
+
+static void aout_pause_audio(SDL_Aout *aout, int pause_on)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    opaque->pause_on = pause_on;
+    SDL_CondSignal(opaque->wakeup_cond);
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+}
+
+static void aout_set_volume(SDL_Aout *aout, float left_volume, float right_volume)
+{
+}
+
+static void aout_set_playback_rate(SDL_Aout *aout, float playbackRate)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+
+    if (playbackRate <= 0)
+        return;
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    int64_t now = aout_now_us();
+    aout_rebase_l(opaque, now, aout_played_l(opaque, now));
+    opaque->playback_rate = playbackRate;
+    SDL_CondSignal(opaque->wakeup_cond);
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+}
+
+/* what the device still has queued, plus the buffer being filled when asked from the callback */
+static double aout_get_latency_seconds(SDL_Aout *aout)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+    double latency;
+
+    if (!opaque->spec.freq)
+        return 0;
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    if (opaque->in_callback)
+        latency = opaque->callback_latency;
+    else
+        latency = aout_measure_latency_l(opaque, aout_now_us());
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+    return latency;
+}
+
+static void aout_get_stats(SDL_Aout *aout, SDL_AoutStats *stats)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    *stats = opaque->stats;
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+}
+
+static int aout_get_time_us(SDL_Aout *aout, int64_t *time_us)
+{
+    SDL_Aout_Opaque *opaque = aout->opaque;
+
+    SDL_LockMutex(opaque->wakeup_mutex);
+    *time_us = aout_clock_l(opaque, aout_now_us());
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+    return 0;
+}
+
+void SDL_AoutDummy_SetDevice(SDL_Aout *aout, int queue_buffers, int jitter_us)
+{
+    if (!aout || aout->opaque_class != &g_dummy_class)
+        return;
+
+    SDL_Aout_Opaque *opaque = aout->opaque;
+    SDL_LockMutex(opaque->wakeup_mutex);
+    opaque->queue_buffers = IJKMAX(queue_buffers, 1);
+    opaque->jitter_us     = IJKMAX(jitter_us, 0);
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+}
+
+void SDL_AoutDummy_GetStats(SDL_Aout *aout, SDL_AoutDummyStats *stats)
+{
+    if (!aout || !stats || aout->opaque_class != &g_dummy_class)
+        return;
+
+    SDL_Aout_Opaque *opaque = aout->opaque;
+    SDL_LockMutex(opaque->wakeup_mutex);
+    *stats = opaque->dummy_stats;
+    SDL_UnlockMutex(opaque->wakeup_mutex);
+}
+
+SDL_Aout *SDL_AoutDummy_Create(int realtime)
+{
+    SDL_Aout *aout = SDL_Aout_CreateInternal(sizeof(SDL_Aout_Opaque));
+    if (!aout)
+        return NULL;
+
+    SDL_Aout_Opaque *opaque = aout->opaque;
+    opaque->wakeup_cond   = SDL_CreateCond();
+    opaque->wakeup_mutex  = SDL_CreateMutex();
+    opaque->realtime      = realtime;
+    opaque->playback_rate = 1.0f;
+    opaque->queue_buffers = 2;
+    opaque->rand_state    = 1;
+    opaque->clock_wall    = aout_now_us();
+    opaque->clock_base    = opaque->clock_wall;
+    if (!opaque->wakeup_cond || !opaque->wakeup_mutex) {
+        aout_free_l(aout);
+        return NULL;
+    }
+
+    aout->free_l       = aout_free_l;
+    aout->opaque_class = &g_dummy_class;
+    aout->open_audio   = aout_open_audio;
+    aout->pause_audio  = aout_pause_audio;
+    aout->close_audio  = aout_close_audio;
+    aout->set_volume   = aout_set_volume;
+    aout->func_get_latency_seconds = aout_get_latency_seconds;
+    aout->func_set_playback_rate   = aout_set_playback_rate;
+    aout->func_get_stats           = aout_get_stats;
+    if (!realtime)
+        aout->func_get_time_us     = aout_get_time_us;
+
+    return aout;
+}
@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * ijksdl_aout_dummy.h
+ *****************************************************************************
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef IJKSDL_DUMMY__IJKSDL_AOUT_DUMMY_H
+#define IJKSDL_DUMMY__IJKSDL_AOUT_DUMMY_H
+
+#include "../ijksdl_stdinc.h"
+#include "../ijksdl_aout.h"
+
+/*
+ * Null audio output: a thread pulls spec.samples frames at a time from the
+ * audio callback and throws them away. In real time mode it plays them on
+ * a simulated device that consumes one buffer per period at the playback
+ * rate and is kept queue_buffers buffers ahead; each period can be
+ * signalled up to jitter_us late, as a real device's would be. Otherwise it
+ * pulls the next buffer at once, and reports through SDL_AoutGetTimeUs a
+ * time that advances by each buffer pulled, at the playback rate, and with
+ * the wall clock while paused or closed.
+ *
+ * Underruns, measured latency and period jitter are reported through
+ * SDL_AoutGetStats, as for a real output.
+ */
+typedef struct SDL_AoutDummyStats {
+    int64_t bytes;
+    double  device_seconds;     /* audio consumed, at the device rate */
+    double  wall_seconds;       /* time spent playing, pauses excluded */
+} SDL_AoutDummyStats;
+
+SDL_Aout *SDL_AoutDummy_Create(int realtime);
+/* real time only, call before opening; defaults to 2 buffers, no jitter */
+void      SDL_AoutDummy_SetDevice(SDL_Aout *aout, int queue_buffers, int jitter_us);
+void      SDL_AoutDummy_GetStats(SDL_Aout *aout, SDL_AoutDummyStats *stats);
+
+#endif
@@ -27,7 +27,7 @@
 
 #include "../ijksdl.h"
 
-// #include "ijksdl_aout_dummy.h"
+#include "ijksdl_aout_dummy.h"
 
 #include "ijksdl_vout_dummy.h"
 
@@ -26,13 +26,15 @@
 
 #include "../ijksdl_vout.h"
 #include "../ijksdl_vout_internal.h"
+#include "libavutil/time.h"
 
 typedef struct SDL_VoutSurface_Opaque {
     SDL_Vout *vout;
 } SDL_VoutSurface_Opaque;
 
 struct SDL_Vout_Opaque {
-    char dummy;
+    int64_t vsync_base;
+    int64_t vsync_period;
 };
 
 static void func_free_l(SDL_Vout *vout)
@@ -60,6 +62,28 @@ static int func_display_overlay(SDL_Vout *vout, SDL_VoutOverlay *overlay)
     return retval;
 }
 
+static int func_get_vsync(SDL_Vout *vout, int64_t *vsync_us, int64_t *period_us)
+{
+    SDL_Vout_Opaque *opaque = vout->opaque;
+    if (opaque->vsync_period <= 0)
+        return -1;
+
+    int64_t now = av_gettime_relative();
+    *vsync_us  = now - (now - opaque->vsync_base) % opaque->vsync_period;
+    *period_us = opaque->vsync_period;
+    return 0;
+}
+
+void SDL_VoutDummy_SetRefreshRate(SDL_Vout *vout, double hz)
+{
+    if (!vout)
+        return;
+
+    SDL_Vout_Opaque *opaque = vout->opaque;
+    opaque->vsync_base   = av_gettime_relative();
+    opaque->vsync_period = hz > 0 ? (int64_t)(1000000 / hz) : 0;
+}
+
 SDL_Vout *SDL_VoutDummy_Create()
 {
     SDL_Vout *vout = SDL_Vout_CreateInternal(sizeof(SDL_Vout_Opaque));
@@ -70,6 +94,7 @@ SDL_Vout *SDL_VoutDummy_Create()
 
     vout->free_l = func_free_l;
     vout->display_overlay = func_display_overlay;
+    vout->func_get_vsync  = func_get_vsync;
 
     return vout;
 }
@@ -29,5 +29,7 @@
 #include "../ijksdl_vout.h"
 
 SDL_Vout *SDL_VoutDummy_Create();
+/* makes the output report vsyncs at hz from now on, 0 to stop */
+void      SDL_VoutDummy_SetRefreshRate(SDL_Vout *vout, double hz);
 
 #endif
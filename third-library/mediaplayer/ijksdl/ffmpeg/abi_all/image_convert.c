@@ -22,41 +22,837 @@
  *****************************************************************************/
 
 #include "../ijksdl_image_convert.h"
-#if defined(__ANDROID__)
+
+#if defined(__ANDROID__) && !defined(IJK_HAVE_LIBYUV)
+#define IJK_HAVE_LIBYUV 1
+#endif
+
+#if IJK_HAVE_LIBYUV
+#include <unistd.h>
+#include "libavutil/pixdesc.h"
 #include "libyuv.h"
+#include "../../ijksdl_mutex.h"
+#include "../../ijksdl_thread.h"
+
+/*
+ * Frames of at least this many pixels are cut into bands of rows which are
+ * converted in parallel; below it the hand-off costs more than it saves.
+ */
+#define IJK_CONVERT_SLICE_MIN_PIXELS    (1920 * 1080)
+#define IJK_CONVERT_MAX_THREADS         8
+/* rows per pass of the two-step conversions, kept small to stay in cache */
+#define IJK_CONVERT_STRIP_ROWS          16
+
+/*****************************************************************************
+ * slice pool
+ ****************************************************************************/
+typedef int (*IjkSliceFunc)(void *arg, int slice);
+
+static struct {
+    pthread_once_t  once;
+    SDL_mutex      *mutex;
+    SDL_cond       *cond_work;
+    SDL_cond       *cond_done;
+    SDL_Thread      threads[IJK_CONVERT_MAX_THREADS - 1];
+    int             nb_threads;
+
+    int             busy;
+    IjkSliceFunc    func;
+    void           *arg;
+    int             nb_slices;
+    int             next_slice;
+    int             pending;
+    int             ret;
+} g_slice_pool = {
+    .once = PTHREAD_ONCE_INIT,
+};
+
+/* called and returns with the pool mutex held */
+static void slice_pool_drain_l(void)
+{
+    while (g_slice_pool.next_slice < g_slice_pool.nb_slices) {
+        int slice = g_slice_pool.next_slice++;
+        int ret;
+
+        SDL_UnlockMutex(g_slice_pool.mutex);
+        ret = g_slice_pool.func(g_slice_pool.arg, slice);
+        SDL_LockMutex(g_slice_pool.mutex);
+
+        if (ret < 0)
+            g_slice_pool.ret = ret;
+        if (--g_slice_pool.pending == 0)
+            SDL_CondSignal(g_slice_pool.cond_done);
+    }
+}
+
+static int slice_pool_worker(void *arg)
+{
+    SDL_LockMutex(g_slice_pool.mutex);
+    for (;;) {
+        while (g_slice_pool.next_slice >= g_slice_pool.nb_slices)
+            SDL_CondWait(g_slice_pool.cond_work, g_slice_pool.mutex);
+        slice_pool_drain_l();
+    }
+    return 0;
+}
+
+static void slice_pool_init(void)
+{
+    long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int  nb_threads = (int)FFMIN(FFMAX(nb_cpus, 1), IJK_CONVERT_MAX_THREADS) - 1;
+    char name[32];
+
+    if (nb_threads <= 0)
+        return;
+
+    /* libyuv detects the CPU lazily on first use; do it here, before any
+     * worker can race on it and pick a different row kernel per slice */
+    TestCpuFlag(kCpuHasSSE2);
+
+    g_slice_pool.mutex     = SDL_CreateMutex();
+    g_slice_pool.cond_work = SDL_CreateCond();
+    g_slice_pool.cond_done = SDL_CreateCond();
+    if (!g_slice_pool.mutex || !g_slice_pool.cond_work || !g_slice_pool.cond_done)
+        return;
+
+    for (int i = 0; i < nb_threads; i++) {
+        snprintf(name, sizeof(name), "ff_convert_%d", i);
+        if (!SDL_CreateThreadEx(&g_slice_pool.threads[i], slice_pool_worker, NULL, name))
+            break;
+        SDL_DetachThread(&g_slice_pool.threads[i]);
+        g_slice_pool.nb_threads++;
+    }
+}
+
+/* threads available to a caller, its own included */
+static int slice_pool_size(void)
+{
+    pthread_once(&g_slice_pool.once, slice_pool_init);
+    return g_slice_pool.nb_threads + 1;
+}
+
+/*
+ * Runs func for every slice and returns the first error, if any. A caller
+ * that finds the pool taken by another one does the work on its own.
+ */
+static int slice_pool_run(IjkSliceFunc func, void *arg, int nb_slices)
+{
+    int ret = 0;
+
+    if (nb_slices > 1 && slice_pool_size() > 1) {
+        SDL_LockMutex(g_slice_pool.mutex);
+        if (!g_slice_pool.busy) {
+            g_slice_pool.busy       = 1;
+            g_slice_pool.func       = func;
+            g_slice_pool.arg        = arg;
+            g_slice_pool.nb_slices  = nb_slices;
+            g_slice_pool.next_slice = 0;
+            g_slice_pool.pending    = nb_slices;
+            g_slice_pool.ret        = 0;
+            SDL_CondBroadcast(g_slice_pool.cond_work);
+
+            slice_pool_drain_l();
+            while (g_slice_pool.pending > 0)
+                SDL_CondWait(g_slice_pool.cond_done, g_slice_pool.mutex);
+
+            ret = g_slice_pool.ret;
+            g_slice_pool.nb_slices = 0;
+            g_slice_pool.busy      = 0;
+            SDL_UnlockMutex(g_slice_pool.mutex);
+            return ret;
+        }
+        SDL_UnlockMutex(g_slice_pool.mutex);
+    }
+
+    for (int i = 0; i < nb_slices; i++) {
+        int slice_ret = func(arg, i);
+        if (slice_ret < 0 && !ret)
+            ret = slice_ret;
+    }
+    return ret;
+}
+
+static int slice_count(int width, int height)
+{
+    if ((int64_t)width * height < IJK_CONVERT_SLICE_MIN_PIXELS)
+        return 1;
+    return av_clip(height / IJK_CONVERT_STRIP_ROWS, 1, slice_pool_size());
+}
+
+/*****************************************************************************
+ * conversions, 8 bits per component
+ ****************************************************************************/
+typedef int (*IjkConvertFunc)(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h);
+
+#define IJK_PLANAR_TO_PACKED(name, func) \
+static int name(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h) \
+{ \
+    return func(s[0], sl[0], s[1], sl[1], s[2], sl[2], d[0], dl[0], w, h); \
+}
+
+#define IJK_PLANAR_TO_PLANAR(name, func) \
+static int name(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h) \
+{ \
+    return func(s[0], sl[0], s[1], sl[1], s[2], sl[2], d[0], dl[0], d[1], dl[1], d[2], dl[2], w, h); \
+}
+
+#define IJK_SEMI_TO_PACKED(name, func) \
+static int name(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h) \
+{ \
+    return func(s[0], sl[0], s[1], sl[1], d[0], dl[0], w, h); \
+}
+
+#define IJK_SEMI_TO_PLANAR(name, func) \
+static int name(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h) \
+{ \
+    return func(s[0], sl[0], s[1], sl[1], d[0], dl[0], d[1], dl[1], d[2], dl[2], w, h); \
+}
+
+/* libyuv has no direct path to ABGR for these: write ARGB and swap R/B in place */
+#define IJK_VIA_ARGB_TO_ABGR(name, to_argb) \
+static int name(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h) \
+{ \
+    int ret = to_argb(s, sl, d, dl, w, h); \
+    if (ret) \
+        return ret; \
+    return ARGBToABGR(d[0], dl[0], d[0], dl[0], w, h); \
+}
+
+IJK_PLANAR_TO_PLANAR(i420_copy,      I420Copy)
+IJK_PLANAR_TO_PLANAR(i422_to_i420,   I422ToI420)
+IJK_PLANAR_TO_PLANAR(i444_to_i420,   I444ToI420)
+IJK_PLANAR_TO_PACKED(i420_to_abgr,   I420ToABGR)
+IJK_PLANAR_TO_PACKED(i420_to_argb,   I420ToARGB)
+IJK_PLANAR_TO_PACKED(i420_to_rgb565, I420ToRGB565)
+IJK_PLANAR_TO_PACKED(i420_to_raw,    I420ToRAW)
+IJK_PLANAR_TO_PACKED(i422_to_abgr,   I422ToABGR)
+IJK_PLANAR_TO_PACKED(i422_to_argb,   I422ToARGB)
+IJK_PLANAR_TO_PACKED(i444_to_argb,   I444ToARGB)
+IJK_PLANAR_TO_PACKED(j420_to_argb,   J420ToARGB)
+IJK_PLANAR_TO_PACKED(j422_to_argb,   J422ToARGB)
+IJK_SEMI_TO_PLANAR(nv12_to_i420,     NV12ToI420)
+IJK_SEMI_TO_PLANAR(nv21_to_i420,     NV21ToI420)
+IJK_SEMI_TO_PACKED(nv12_to_argb,     NV12ToARGB)
+IJK_SEMI_TO_PACKED(nv21_to_argb,     NV21ToARGB)
+IJK_SEMI_TO_PACKED(nv12_to_rgb565,   NV12ToRGB565)
+IJK_SEMI_TO_PACKED(nv21_to_rgb565,   NV21ToRGB565)
+IJK_VIA_ARGB_TO_ABGR(i444_to_abgr,   i444_to_argb)
+IJK_VIA_ARGB_TO_ABGR(nv12_to_abgr,   nv12_to_argb)
+IJK_VIA_ARGB_TO_ABGR(nv21_to_abgr,   nv21_to_argb)
+IJK_VIA_ARGB_TO_ABGR(j420_to_abgr,   j420_to_argb)
+IJK_VIA_ARGB_TO_ABGR(j422_to_abgr,   j422_to_argb)
+
+static int i420_to_nv12(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return I420ToNV12(s[0], sl[0], s[1], sl[1], s[2], sl[2], d[0], dl[0], d[1], dl[1], w, h);
+}
+
+/*
+ * No I422/I444/J420/J422 to RGB565 in libyuv: go through ARGB a strip at a
+ * time. chroma_shift is log2 of the vertical chroma subsampling.
+ */
+static int planar_via_argb_to_rgb565(IjkConvertFunc to_argb, int chroma_shift,
+    const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    int      argb_linesize = FFALIGN(w * 4, 64);
+    uint8_t *argb = av_malloc(argb_linesize * IJK_CONVERT_STRIP_ROWS);
+    int      ret = 0;
+
+    if (!argb)
+        return AVERROR(ENOMEM);
+
+    for (int y = 0; y < h && !ret; y += IJK_CONVERT_STRIP_ROWS) {
+        int            rows = FFMIN(IJK_CONVERT_STRIP_ROWS, h - y);
+        const uint8_t *strip_src[3] = { s[0] + y * sl[0],
+                                        s[1] + (y >> chroma_shift) * sl[1],
+                                        s[2] + (y >> chroma_shift) * sl[2] };
+
+        ret = to_argb(strip_src, sl, &argb, &argb_linesize, w, rows);
+        if (!ret)
+            ret = ARGBToRGB565(argb, argb_linesize, d[0] + y * dl[0], dl[0], w, rows);
+    }
+
+    av_free(argb);
+    return ret;
+}
+
+static int i422_to_rgb565(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return planar_via_argb_to_rgb565(i422_to_argb, 0, s, sl, d, dl, w, h);
+}
+
+static int i444_to_rgb565(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return planar_via_argb_to_rgb565(i444_to_argb, 0, s, sl, d, dl, w, h);
+}
+
+static int j420_to_rgb565(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return planar_via_argb_to_rgb565(j420_to_argb, 1, s, sl, d, dl, w, h);
+}
+
+static int j422_to_rgb565(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return planar_via_argb_to_rgb565(j422_to_argb, 0, s, sl, d, dl, w, h);
+}
+
+typedef struct IjkConvertEntry {
+    enum AVPixelFormat src;
+    enum AVPixelFormat dst;
+    IjkConvertFunc     func;
+} IjkConvertEntry;
+
+/*
+ * libyuv names packed RGB by its 32-bit word, FFmpeg by its bytes in memory:
+ * libyuv ARGB is AV_PIX_FMT_BGRA, ABGR is AV_PIX_FMT_RGBA and RAW is
+ * AV_PIX_FMT_RGB24. Destinations with a padding byte are folded into their
+ * alpha counterparts by normalize_dst_format().
+ */
+static const IjkConvertEntry g_convert_table[] = {
+    { AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV420P,  i420_copy },
+    { AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12,     i420_to_nv12 },
+    { AV_PIX_FMT_YUV420P, AV_PIX_FMT_RGBA,     i420_to_abgr },
+    { AV_PIX_FMT_YUV420P, AV_PIX_FMT_BGRA,     i420_to_argb },
+    { AV_PIX_FMT_YUV420P, AV_PIX_FMT_RGB565LE, i420_to_rgb565 },
+    { AV_PIX_FMT_YUV420P, AV_PIX_FMT_RGB24,    i420_to_raw },
+
+    { AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUV420P,  i422_to_i420 },
+    { AV_PIX_FMT_YUV422P, AV_PIX_FMT_RGBA,     i422_to_abgr },
+    { AV_PIX_FMT_YUV422P, AV_PIX_FMT_BGRA,     i422_to_argb },
+    { AV_PIX_FMT_YUV422P, AV_PIX_FMT_RGB565LE, i422_to_rgb565 },
+
+    { AV_PIX_FMT_YUV444P, AV_PIX_FMT_YUV420P,  i444_to_i420 },
+    { AV_PIX_FMT_YUV444P, AV_PIX_FMT_RGBA,     i444_to_abgr },
+    { AV_PIX_FMT_YUV444P, AV_PIX_FMT_BGRA,     i444_to_argb },
+    { AV_PIX_FMT_YUV444P, AV_PIX_FMT_RGB565LE, i444_to_rgb565 },
+
+    { AV_PIX_FMT_NV12,    AV_PIX_FMT_YUV420P,  nv12_to_i420 },
+    { AV_PIX_FMT_NV12,    AV_PIX_FMT_RGBA,     nv12_to_abgr },
+    { AV_PIX_FMT_NV12,    AV_PIX_FMT_BGRA,     nv12_to_argb },
+    { AV_PIX_FMT_NV12,    AV_PIX_FMT_RGB565LE, nv12_to_rgb565 },
+
+    { AV_PIX_FMT_NV21,    AV_PIX_FMT_YUV420P,  nv21_to_i420 },
+    { AV_PIX_FMT_NV21,    AV_PIX_FMT_RGBA,     nv21_to_abgr },
+    { AV_PIX_FMT_NV21,    AV_PIX_FMT_BGRA,     nv21_to_argb },
+    { AV_PIX_FMT_NV21,    AV_PIX_FMT_RGB565LE, nv21_to_rgb565 },
+
+    /* full range; YUVJ444P has no libyuv path to RGB and goes to swscale */
+    { AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_RGBA,     j420_to_abgr },
+    { AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_BGRA,     j420_to_argb },
+    { AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_RGB565LE, j420_to_rgb565 },
+
+    { AV_PIX_FMT_YUVJ422P, AV_PIX_FMT_RGBA,     j422_to_abgr },
+    { AV_PIX_FMT_YUVJ422P, AV_PIX_FMT_BGRA,     j422_to_argb },
+    { AV_PIX_FMT_YUVJ422P, AV_PIX_FMT_RGB565LE, j422_to_rgb565 },
+};
+
+static IjkConvertFunc find_convert_func(enum AVPixelFormat src, enum AVPixelFormat dst)
+{
+    for (int i = 0; i < FF_ARRAY_ELEMS(g_convert_table); i++) {
+        if (g_convert_table[i].src == src && g_convert_table[i].dst == dst)
+            return g_convert_table[i].func;
+    }
+    return NULL;
+}
+
+/*
+ * The layout of a full range format. Good for copies, scaling and rotation,
+ * which leave the samples as they are, not for conversions to RGB.
+ */
+static enum AVPixelFormat normalize_src_format(enum AVPixelFormat format)
+{
+    switch (format) {
+    case AV_PIX_FMT_YUVJ420P:   return AV_PIX_FMT_YUV420P;
+    case AV_PIX_FMT_YUVJ422P:   return AV_PIX_FMT_YUV422P;
+    case AV_PIX_FMT_YUVJ444P:   return AV_PIX_FMT_YUV444P;
+    default:                    return format;
+    }
+}
+
+static enum AVPixelFormat normalize_dst_format(enum AVPixelFormat format)
+{
+    switch (format) {
+    case AV_PIX_FMT_RGB0:       return AV_PIX_FMT_RGBA;
+    case AV_PIX_FMT_BGR0:       return AV_PIX_FMT_BGRA;
+    default:                    return format;
+    }
+}
+
+/*****************************************************************************
+ * conversions, more than 8 bits per component
+ ****************************************************************************/
+
+/*
+ * 10-bit 4:2:0 has direct libyuv paths; strides of 16-bit planes are in
+ * samples there.
+ */
+#define S16(i)  ((const uint16_t *)s[i]), (sl[i] / 2)
+#define D16(i)  ((uint16_t *)d[i]), (dl[i] / 2)
+
+static int i010_to_i420(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return I010ToI420(S16(0), S16(1), S16(2), d[0], dl[0], d[1], dl[1], d[2], dl[2], w, h);
+}
+
+static int i010_to_abgr(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return I010ToABGR(S16(0), S16(1), S16(2), d[0], dl[0], w, h);
+}
+
+static int i010_to_argb(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return I010ToARGB(S16(0), S16(1), S16(2), d[0], dl[0], w, h);
+}
+
+static int i010_to_p010(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return I010ToP010(S16(0), S16(1), S16(2), D16(0), D16(1), w, h);
+}
+
+static int p010_to_i010(const uint8_t **s, const int *sl, uint8_t **d, const int *dl, int w, int h)
+{
+    return P010ToI010(S16(0), S16(1), D16(0), D16(1), D16(2), w, h);
+}
+
+#undef S16
+#undef D16
+
+static const IjkConvertEntry g_convert16_table[] = {
+    { AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_YUV420P,     i010_to_i420 },
+    { AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_RGBA,        i010_to_abgr },
+    { AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_BGRA,        i010_to_argb },
+    { AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_P010LE,      i010_to_p010 },
+    { AV_PIX_FMT_P010LE,      AV_PIX_FMT_YUV420P10LE, p010_to_i010 },
+};
+
+static IjkConvertFunc find_convert16_func(enum AVPixelFormat src, enum AVPixelFormat dst)
+{
+    for (int i = 0; i < FF_ARRAY_ELEMS(g_convert16_table); i++) {
+        if (g_convert16_table[i].src == src && g_convert16_table[i].dst == dst)
+            return g_convert16_table[i].func;
+    }
+    return NULL;
+}
+
+/*
+ * Everything else is narrowed to 8 bits (ordered dither) a strip at a time
+ * and fed to the 8-bit conversion of the same layout.
+ */
+static enum AVPixelFormat narrow_src_format(enum AVPixelFormat format)
+{
+    switch (format) {
+    case AV_PIX_FMT_YUV420P10LE:    return AV_PIX_FMT_YUV420P;
+    case AV_PIX_FMT_YUV422P10LE:    return AV_PIX_FMT_YUV422P;
+    case AV_PIX_FMT_YUV444P10LE:    return AV_PIX_FMT_YUV444P;
+    case AV_PIX_FMT_P010LE:         return AV_PIX_FMT_NV12;
+    default:                        return AV_PIX_FMT_NONE;
+    }
+}
+
+/*****************************************************************************
+ * slicing
+ ****************************************************************************/
+typedef struct IjkConvertContext {
+    IjkConvertFunc              func;
+    const AVPixFmtDescriptor   *src_desc;
+    const AVPixFmtDescriptor   *dst_desc;
+    int                         src_planes;
+    int                         dst_planes;
+    int                         width;
+    int                         height;
+    int                         slice_rows;
+
+    const uint8_t              *src_data[4];
+    int                         src_linesize[4];
+    uint8_t                    *dst_data[4];
+    int                         dst_linesize[4];
+
+    /* high bit depth sources only */
+    int                         narrow_shift;
+    int                         narrow_bytes[4];
+} IjkConvertContext;
+
+static int plane_row(const AVPixFmtDescriptor *desc, int plane, int y)
+{
+    return (plane == 1 || plane == 2) ? AV_CEIL_RSHIFT(y, desc->log2_chroma_h) : y;
+}
+
+static int convert_narrow_rows(IjkConvertContext *ctx, const uint8_t **src, uint8_t **dst, int rows)
+{
+    const uint8_t *strip_src[4] = { NULL };
+    uint8_t       *strip_dst[4];
+    int            strip_linesize[4] = { 0 };
+    int            strip_bytes = 0;
+    uint8_t       *strip;
+    int            ret = 0;
+
+    for (int p = 0; p < ctx->src_planes; p++) {
+        strip_linesize[p] = FFALIGN(ctx->narrow_bytes[p], 64);
+        strip_bytes += strip_linesize[p] * plane_row(ctx->src_desc, p, IJK_CONVERT_STRIP_ROWS);
+    }
+    strip = av_malloc(strip_bytes);
+    if (!strip)
+        return AVERROR(ENOMEM);
+
+    for (int y = 0; y < rows && !ret; y += IJK_CONVERT_STRIP_ROWS) {
+        int      strip_rows = FFMIN(IJK_CONVERT_STRIP_ROWS, rows - y);
+        uint8_t *ptr = strip;
+
+        for (int p = 0; p < ctx->src_planes; p++) {
+            int row = plane_row(ctx->src_desc, p, y);
+
+            Convert16To8Plane((const uint16_t *)(src[p] + row * ctx->src_linesize[p]),
+                              ctx->src_linesize[p] / 2, ptr, strip_linesize[p],
+                              8 + ctx->narrow_shift, ctx->narrow_bytes[p],
+                              plane_row(ctx->src_desc, p, strip_rows));
+            strip_src[p] = ptr;
+            ptr += strip_linesize[p] * plane_row(ctx->src_desc, p, IJK_CONVERT_STRIP_ROWS);
+        }
+        for (int p = 0; p < ctx->dst_planes; p++)
+            strip_dst[p] = dst[p] + plane_row(ctx->dst_desc, p, y) * ctx->dst_linesize[p];
+
+        ret = ctx->func(strip_src, strip_linesize, strip_dst, ctx->dst_linesize, ctx->width, strip_rows);
+    }
+
+    av_free(strip);
+    return ret;
+}
+
+static int convert_slice(void *arg, int slice)
+{
+    IjkConvertContext *ctx = arg;
+    const uint8_t     *src[4];
+    uint8_t           *dst[4];
+    int                y = slice * ctx->slice_rows;
+    int                rows = FFMIN(ctx->slice_rows, ctx->height - y);
+
+    if (rows <= 0)
+        return 0;
+
+    for (int p = 0; p < ctx->src_planes; p++)
+        src[p] = ctx->src_data[p] + plane_row(ctx->src_desc, p, y) * ctx->src_linesize[p];
+    for (int p = 0; p < ctx->dst_planes; p++)
+        dst[p] = ctx->dst_data[p] + plane_row(ctx->dst_desc, p, y) * ctx->dst_linesize[p];
+
+    if (ctx->narrow_shift)
+        return convert_narrow_rows(ctx, src, dst, rows);
+    return ctx->func(src, ctx->src_linesize, dst, ctx->dst_linesize, ctx->width, rows);
+}
+
+/*****************************************************************************
+ * scaling
+ ****************************************************************************/
+typedef struct IjkScaleContext {
+    const AVPixFmtDescriptor   *desc;
+    int                         src_width;
+    int                         src_height;
+    int                         dst_width;
+    int                         dst_height;
+    int                         slice_rows;
+
+    const uint8_t             **src_data;
+    const int                  *src_linesize;
+    uint8_t                   **dst_data;
+    int                        *dst_linesize;
+} IjkScaleContext;
+
+static int is_packed_32bpp(enum AVPixelFormat format)
+{
+    switch (format) {
+    case AV_PIX_FMT_RGBA:
+    case AV_PIX_FMT_BGRA:
+    case AV_PIX_FMT_ARGB:
+    case AV_PIX_FMT_ABGR:
+    case AV_PIX_FMT_RGB0:
+    case AV_PIX_FMT_BGR0:
+    case AV_PIX_FMT_0RGB:
+    case AV_PIX_FMT_0BGR:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static int is_planar_yuv(enum AVPixelFormat format)
+{
+    switch (normalize_src_format(format)) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUV422P:
+    case AV_PIX_FMT_YUV444P:
+    case AV_PIX_FMT_YUV420P10LE:
+    case AV_PIX_FMT_YUV422P10LE:
+    case AV_PIX_FMT_YUV444P10LE:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static int scale_plane_16(void *arg, int plane)
+{
+    IjkScaleContext *ctx = arg;
+    int chroma = plane == 1 || plane == 2;
+    int sw = chroma ? AV_CEIL_RSHIFT(ctx->src_width,  ctx->desc->log2_chroma_w) : ctx->src_width;
+    int sh = chroma ? AV_CEIL_RSHIFT(ctx->src_height, ctx->desc->log2_chroma_h) : ctx->src_height;
+    int dw = chroma ? AV_CEIL_RSHIFT(ctx->dst_width,  ctx->desc->log2_chroma_w) : ctx->dst_width;
+    int dh = chroma ? AV_CEIL_RSHIFT(ctx->dst_height, ctx->desc->log2_chroma_h) : ctx->dst_height;
+
+    ScalePlane_16((const uint16_t *)ctx->src_data[plane], ctx->src_linesize[plane] / 2, sw, sh,
+                  (uint16_t *)ctx->dst_data[plane], ctx->dst_linesize[plane] / 2, dw, dh,
+                  kFilterBilinear);
+    return 0;
+}
+
+/*
+ * 8-bit planes are cut into bands of destination rows; ScalePlaneClip gives
+ * every band exactly what the whole-plane scale would.
+ */
+static int scale_planar_slice(void *arg, int slice)
+{
+    IjkScaleContext *ctx = arg;
+    int y = slice * ctx->slice_rows;
+    int rows = FFMIN(ctx->slice_rows, ctx->dst_height - y);
+    int ret = 0;
+
+    if (rows <= 0)
+        return 0;
+
+    for (int p = 0; p < 3 && !ret; p++) {
+        int chroma = p == 1 || p == 2;
+        int sw = chroma ? AV_CEIL_RSHIFT(ctx->src_width,  ctx->desc->log2_chroma_w) : ctx->src_width;
+        int sh = plane_row(ctx->desc, p, ctx->src_height);
+        int dw = chroma ? AV_CEIL_RSHIFT(ctx->dst_width,  ctx->desc->log2_chroma_w) : ctx->dst_width;
+        int dh = plane_row(ctx->desc, p, ctx->dst_height);
+        int y0 = plane_row(ctx->desc, p, y);
+        int y1 = plane_row(ctx->desc, p, y + rows);
+
+        ret = ScalePlaneClip(ctx->src_data[p], ctx->src_linesize[p], sw, sh,
+                             ctx->dst_data[p], ctx->dst_linesize[p], dw, dh,
+                             y0, y1 - y0, kFilterBilinear);
+    }
+    return ret;
+}
+
+static int scale_packed_slice(void *arg, int slice)
+{
+    IjkScaleContext *ctx = arg;
+    int y = slice * ctx->slice_rows;
+    int rows = FFMIN(ctx->slice_rows, ctx->dst_height - y);
+
+    if (rows <= 0)
+        return 0;
+    return ARGBScaleClip(ctx->src_data[0], ctx->src_linesize[0], ctx->src_width, ctx->src_height,
+                         ctx->dst_data[0], ctx->dst_linesize[0], ctx->dst_width, ctx->dst_height,
+                         0, y, ctx->dst_width, rows, kFilterBilinear);
+}
+
+/*****************************************************************************
+ * rotation
+ ****************************************************************************/
+typedef struct IjkRotateContext {
+    const AVPixFmtDescriptor   *desc;
+    int                         planes;
+    int                         bytes_per_pixel;
+    int                         width;
+    int                         height;
+    enum RotationMode           mode;
+    int                         slice_rows;
+
+    const uint8_t             **src_data;
+    const int                  *src_linesize;
+    uint8_t                   **dst_data;
+    int                        *dst_linesize;
+} IjkRotateContext;
+
+/*
+ * A band of source rows [y0, y1) lands in a band of destination columns
+ * (90, 270) or rows (0, 180); each is rotated on its own.
+ */
+static int rotate_slice(void *arg, int slice)
+{
+    IjkRotateContext *ctx = arg;
+    int y = slice * ctx->slice_rows;
+    int rows = FFMIN(ctx->slice_rows, ctx->height - y);
+    int ret = 0;
+
+    if (rows <= 0)
+        return 0;
+
+    for (int p = 0; p < ctx->planes && !ret; p++) {
+        int chroma = p == 1 || p == 2;
+        int pw = chroma ? AV_CEIL_RSHIFT(ctx->width, ctx->desc->log2_chroma_w) : ctx->width;
+        int ph = plane_row(ctx->desc, p, ctx->height);
+        int y0 = plane_row(ctx->desc, p, y);
+        int y1 = plane_row(ctx->desc, p, y + rows);
+        const uint8_t *src = ctx->src_data[p] + y0 * ctx->src_linesize[p];
+        uint8_t       *dst = ctx->dst_data[p];
+
+        switch (ctx->mode) {
+        case kRotate90:     dst += (ph - y1) * ctx->bytes_per_pixel;    break;
+        case kRotate180:    dst += (ph - y1) * ctx->dst_linesize[p];    break;
+        case kRotate270:    dst += y0 * ctx->bytes_per_pixel;           break;
+        default:            dst += y0 * ctx->dst_linesize[p];           break;
+        }
+
+        if (ctx->bytes_per_pixel == 4)
+            ret = ARGBRotate(src, ctx->src_linesize[p], dst, ctx->dst_linesize[p], pw, y1 - y0, ctx->mode);
+        else
+            ret = RotatePlane(src, ctx->src_linesize[p], dst, ctx->dst_linesize[p], pw, y1 - y0, ctx->mode);
+    }
+    return ret;
+}
 #endif
 
 int ijk_image_convert(int width, int height,
     enum AVPixelFormat dst_format, uint8_t **dst_data, int *dst_linesize,
     enum AVPixelFormat src_format, const uint8_t **src_data, const int *src_linesize)
 {
-#if defined(__ANDROID__)
-    switch (src_format) {
-        case AV_PIX_FMT_YUV420P:
-        case AV_PIX_FMT_YUVJ420P: // FIXME: 9 not equal to AV_PIX_FMT_YUV420P, but a workaround
-            switch (dst_format) {
-            case AV_PIX_FMT_RGB565:
-                return I420ToRGB565(
-                    src_data[0], src_linesize[0],
-                    src_data[1], src_linesize[1],
-                    src_data[2], src_linesize[2],
-                    dst_data[0], dst_linesize[0],
-                    width, height);
-            case AV_PIX_FMT_0BGR32:
-                return I420ToABGR(
-                    src_data[0], src_linesize[0],
-                    src_data[1], src_linesize[1],
-                    src_data[2], src_linesize[2],
-                    dst_data[0], dst_linesize[0],
-                    width, height);
-            default:
-                break;
-            }
-            break;
-        default:
-            break;
+#if IJK_HAVE_LIBYUV
+    IjkConvertContext ctx = { 0 };
+    enum AVPixelFormat src8_format = src_format;
+    int nb_slices;
+
+    if (width <= 0 || height <= 0)
+        return -1;
+
+    ctx.src_desc = av_pix_fmt_desc_get(src_format);
+    ctx.dst_desc = av_pix_fmt_desc_get(dst_format);
+    if (!ctx.src_desc || !ctx.dst_desc)
+        return -1;
+
+    ctx.func = find_convert16_func(src_format, normalize_dst_format(dst_format));
+    if (!ctx.func && ctx.src_desc->comp[0].depth > 8) {
+        src8_format = narrow_src_format(src_format);
+        if (src8_format == AV_PIX_FMT_NONE)
+            return -1;
+        ctx.narrow_shift = ctx.src_desc->comp[0].depth - 8 + ctx.src_desc->comp[0].shift;
+        av_image_fill_linesizes(ctx.narrow_bytes, src_format, width);
+        for (int p = 0; p < 4; p++)
+            ctx.narrow_bytes[p] /= 2;
+    }
+
+    if (!ctx.func) {
+        if (!(ctx.dst_desc->flags & AV_PIX_FMT_FLAG_RGB))
+            src8_format = normalize_src_format(src8_format);
+        ctx.func = find_convert_func(src8_format, normalize_dst_format(dst_format));
+    }
+    if (!ctx.func)
+        return -1;
+
+    ctx.src_planes = av_pix_fmt_count_planes(src_format);
+    ctx.dst_planes = av_pix_fmt_count_planes(dst_format);
+    ctx.width      = width;
+    ctx.height     = height;
+    for (int p = 0; p < ctx.src_planes; p++) {
+        ctx.src_data[p]     = src_data[p];
+        ctx.src_linesize[p] = src_linesize[p];
+    }
+    for (int p = 0; p < ctx.dst_planes; p++) {
+        ctx.dst_data[p]     = dst_data[p];
+        ctx.dst_linesize[p] = dst_linesize[p];
+    }
+
+    /* even row counts keep every band on a chroma row boundary */
+    nb_slices      = slice_count(width, height);
+    ctx.slice_rows = FFALIGN((height + nb_slices - 1) / nb_slices, 2);
+
+    return slice_pool_run(convert_slice, &ctx, nb_slices) ? -1 : 0;
+#else
+    return -1;
+#endif
+}
+
+int ijk_image_scale(enum AVPixelFormat format,
+    int src_width, int src_height, const uint8_t **src_data, const int *src_linesize,
+    int dst_width, int dst_height, uint8_t **dst_data, int *dst_linesize)
+{
+#if IJK_HAVE_LIBYUV
+    IjkScaleContext ctx = { 0 };
+    int nb_slices;
+
+    if (src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0)
+        return -1;
+
+    ctx.desc         = av_pix_fmt_desc_get(format);
+    ctx.src_width    = src_width;
+    ctx.src_height   = src_height;
+    ctx.dst_width    = dst_width;
+    ctx.dst_height   = dst_height;
+    ctx.src_data     = src_data;
+    ctx.src_linesize = src_linesize;
+    ctx.dst_data     = dst_data;
+    ctx.dst_linesize = dst_linesize;
+
+    /* a downscale costs as much as its source, an upscale as its destination */
+    nb_slices = slice_count(FFMAX(src_width, dst_width), FFMAX(src_height, dst_height));
+    nb_slices = FFMIN(nb_slices, FFMAX(dst_height / IJK_CONVERT_STRIP_ROWS, 1));
+
+    if (is_planar_yuv(format)) {
+        /* 16-bit planes have no banded scaler; they go one plane per thread */
+        if (ctx.desc->comp[0].depth > 8)
+            return slice_pool_run(scale_plane_16, &ctx, 3) ? -1 : 0;
+
+        /* bands of whole 3-row groups of 4:2:0 chroma keep the 3/4 and 3/8 scalers */
+        ctx.slice_rows = ((dst_height + nb_slices - 1) / nb_slices + 11) / 12 * 12;
+        nb_slices      = (dst_height + ctx.slice_rows - 1) / ctx.slice_rows;
+        return slice_pool_run(scale_planar_slice, &ctx, nb_slices) ? -1 : 0;
+    }
+
+    if (is_packed_32bpp(format)) {
+        ctx.slice_rows = (dst_height + nb_slices - 1) / nb_slices;
+        return slice_pool_run(scale_packed_slice, &ctx, nb_slices) ? -1 : 0;
     }
 #endif
     return -1;
 }
 
+int ijk_image_rotate(enum AVPixelFormat format, int width, int height, int degrees,
+    const uint8_t **src_data, const int *src_linesize,
+    uint8_t **dst_data, int *dst_linesize)
+{
+#if IJK_HAVE_LIBYUV
+    IjkRotateContext ctx = { 0 };
+    int nb_slices;
+
+    if (width <= 0 || height <= 0)
+        return -1;
+
+    switch (degrees) {
+    case 0:     ctx.mode = kRotate0;    break;
+    case 90:    ctx.mode = kRotate90;   break;
+    case 180:   ctx.mode = kRotate180;  break;
+    case 270:   ctx.mode = kRotate270;  break;
+    default:    return -1;
+    }
+
+    /* chroma planes must stay square-subsampled to survive a quarter turn */
+    switch (normalize_src_format(format)) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUV444P:
+        ctx.planes          = 3;
+        ctx.bytes_per_pixel = 1;
+        break;
+    default:
+        if (!is_packed_32bpp(format))
+            return -1;
+        ctx.planes          = 1;
+        ctx.bytes_per_pixel = 4;
+        break;
+    }
+
+    ctx.desc         = av_pix_fmt_desc_get(format);
+    ctx.width        = width;
+    ctx.height       = height;
+    ctx.src_data     = src_data;
+    ctx.src_linesize = src_linesize;
+    ctx.dst_data     = dst_data;
+    ctx.dst_linesize = dst_linesize;
+
+    nb_slices      = slice_count(width, height);
+    ctx.slice_rows = FFALIGN((height + nb_slices - 1) / nb_slices, 2);
+
+    return slice_pool_run(rotate_slice, &ctx, nb_slices) ? -1 : 0;
+#else
+    return -1;
+#endif
+}
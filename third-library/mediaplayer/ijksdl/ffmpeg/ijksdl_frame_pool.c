@@ -0,0 +1,151 @@
+/*
+ * ijksdl_frame_pool.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ijksdl_frame_pool.h"
+
+#include "libavutil/pixdesc.h"
+#include "../ijksdl_mutex.h"
+
+/* covers NEON, SSE and AVX loads as well as avcodec's own STRIDE_ALIGN */
+#define FRAME_POOL_ALIGN 64
+
+struct SDL_FFmpegFramePool {
+    SDL_mutex    *mutex;
+
+    AVBufferPool *pool;
+    int           format;
+    int           width;
+    int           height;
+    int           planes;
+    int           linesize[4];
+    int           offset[4];
+};
+
+static int frame_pool_is_linkable(int format)
+{
+    switch (format) {
+        case AV_PIX_FMT_YUV420P:
+        case AV_PIX_FMT_YUVJ420P:
+        case AV_PIX_FMT_YUV444P10LE:
+        case AV_PIX_FMT_NV12:
+        case AV_PIX_FMT_P010LE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int frame_pool_setup(SDL_FFmpegFramePool *fp, AVCodecContext *avctx, const AVFrame *frame)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+    int linesize_align[AV_NUM_DATA_POINTERS];
+    int w     = frame->width;
+    int h     = frame->height;
+    int align = FRAME_POOL_ALIGN;
+    int size  = 0;
+
+    avcodec_align_dimensions2(avctx, &w, &h, linesize_align);
+    for (int i = 0; i < 4; ++i)
+        align = FFMAX(align, linesize_align[i]);
+
+    fp->planes = av_pix_fmt_count_planes(frame->format);
+    // aligned so that the subsampled chroma pitch still is
+    fp->linesize[0] = FFALIGN(w * desc->comp[0].step, align << desc->log2_chroma_w);
+    for (int i = 1; i < fp->planes; ++i)
+        fp->linesize[i] = fp->planes == 2 ? fp->linesize[0] : fp->linesize[0] >> desc->log2_chroma_w;
+    for (int i = 0; i < fp->planes; ++i) {
+        fp->offset[i] = size;
+        size += fp->linesize[i] * (i ? AV_CEIL_RSHIFT(h, desc->log2_chroma_h) : h);
+    }
+
+    av_buffer_pool_uninit(&fp->pool);
+    // same slack for SIMD over-reads as avcodec_default_get_buffer2()
+    fp->pool = av_buffer_pool_init(size + 16 + align - 1, av_buffer_alloc);
+    if (!fp->pool)
+        return AVERROR(ENOMEM);
+
+    fp->format = frame->format;
+    fp->width  = frame->width;
+    fp->height = frame->height;
+    return 0;
+}
+
+static int frame_pool_get_buffer2(AVCodecContext *avctx, AVFrame *frame, int flags)
+{
+    SDL_FFmpegFramePool *fp = avctx->opaque;
+    AVBufferRef *buf = NULL;
+    int ret = 0;
+
+    if (!frame_pool_is_linkable(frame->format))
+        return avcodec_default_get_buffer2(avctx, frame, flags);
+
+    SDL_LockMutex(fp->mutex);
+    if (!fp->pool || fp->format != frame->format || fp->width != frame->width || fp->height != frame->height)
+        ret = frame_pool_setup(fp, avctx, frame);
+    if (ret >= 0)
+        buf = av_buffer_pool_get(fp->pool);
+    if (buf) {
+        for (int i = 0; i < fp->planes; ++i) {
+            frame->data[i]     = buf->data + fp->offset[i];
+            frame->linesize[i] = fp->linesize[i];
+        }
+    }
+    SDL_UnlockMutex(fp->mutex);
+    if (!buf)
+        return ret < 0 ? ret : AVERROR(ENOMEM);
+
+    frame->buf[0]        = buf;
+    frame->extended_data = frame->data;
+    return 0;
+}
+
+SDL_FFmpegFramePool *SDL_FFmpegFramePool_attach(AVCodecContext *avctx, const AVCodec *codec)
+{
+    if (!codec || !(codec->capabilities & AV_CODEC_CAP_DR1))
+        return NULL;
+
+    SDL_FFmpegFramePool *fp = av_mallocz(sizeof(SDL_FFmpegFramePool));
+    if (!fp)
+        return NULL;
+
+    fp->mutex = SDL_CreateMutex();
+    if (!fp->mutex) {
+        av_free(fp);
+        return NULL;
+    }
+
+    avctx->opaque                = fp;
+    avctx->get_buffer2           = frame_pool_get_buffer2;
+    avctx->thread_safe_callbacks = 1;
+    return fp;
+}
+
+void SDL_FFmpegFramePool_freep(SDL_FFmpegFramePool **pool)
+{
+    SDL_FFmpegFramePool *fp = *pool;
+
+    if (!fp)
+        return;
+
+    // outstanding buffers keep the AVBufferPool itself alive
+    av_buffer_pool_uninit(&fp->pool);
+    SDL_DestroyMutex(fp->mutex);
+    av_freep(pool);
+}
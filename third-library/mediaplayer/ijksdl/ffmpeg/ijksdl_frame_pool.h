@@ -0,0 +1,43 @@
+/*
+ * ijksdl_frame_pool.h
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef IJKSDL__FFMPEG__IJKSDL_FRAME_POOL_H
+#define IJKSDL__FFMPEG__IJKSDL_FRAME_POOL_H
+
+#include "ijksdl_inc_ffmpeg.h"
+
+/*
+ * get_buffer2() for decoders whose frames the ffmpeg overlay links instead
+ * of copying (YUV420P, YUVJ420P, YUV444P10LE, NV12, P010LE). Frames come
+ * from a pool, with all planes in one buffer and pitches laid out the way
+ * the GLES2 renderers and SDL textures upload them: chroma pitch exactly
+ * the luma pitch over the horizontal subsampling (semi-planar: equal to
+ * it), planes back to back. Other formats, and decoders without DR1, get
+ * the default allocator.
+ */
+
+typedef struct SDL_FFmpegFramePool SDL_FFmpegFramePool;
+
+/* installs the allocator on avctx, call before avcodec_open2() */
+SDL_FFmpegFramePool *SDL_FFmpegFramePool_attach(AVCodecContext *avctx, const AVCodec *codec);
+/* after the codec context is freed; frames still referenced stay valid */
+void                 SDL_FFmpegFramePool_freep(SDL_FFmpegFramePool **pool);
+
+#endif
@@ -28,8 +28,19 @@
 #include <stdint.h>
 #include "ijksdl_inc_ffmpeg.h"
 
+/* returns -1 when the pair has no libyuv path, the caller then falls back to swscale */
 int ijk_image_convert(int width, int height,
     enum AVPixelFormat dst_format, uint8_t **dst_data, int *dst_linesize,
     enum AVPixelFormat src_format, const uint8_t **src_data, const int *src_linesize);
 
+/* bilinear, planar YUV (8 and 10 bits) and 32-bit packed RGB only */
+int ijk_image_scale(enum AVPixelFormat format,
+    int src_width, int src_height, const uint8_t **src_data, const int *src_linesize,
+    int dst_width, int dst_height, uint8_t **dst_data, int *dst_linesize);
+
+/* clockwise by 0, 90, 180 or 270 degrees; 4:2:0, 4:4:4 and 32-bit packed RGB only */
+int ijk_image_rotate(enum AVPixelFormat format, int width, int height, int degrees,
+    const uint8_t **src_data, const int *src_linesize,
+    uint8_t **dst_data, int *dst_linesize);
+
 #endif
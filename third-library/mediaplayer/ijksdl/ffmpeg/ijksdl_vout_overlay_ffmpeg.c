@@ -192,6 +192,22 @@ static int func_fill_frame(SDL_VoutOverlay *overlay, const AVFrame *frame)
                 dst_format = AV_PIX_FMT_YUV444P10LE;
             }
             break;
+        case SDL_FCC_NV12:
+            if (frame->format == AV_PIX_FMT_NV12) {
+                use_linked_frame = 1;
+                dst_format = frame->format;
+            } else {
+                dst_format = AV_PIX_FMT_NV12;
+            }
+            break;
+        case SDL_FCC_P010:
+            if (frame->format == AV_PIX_FMT_P010LE) {
+                use_linked_frame = 1;
+                dst_format = frame->format;
+            } else {
+                dst_format = AV_PIX_FMT_P010LE;
+            }
+            break;
         case SDL_FCC_RV32:
             dst_format = AV_PIX_FMT_0BGR32;
             break;
@@ -290,6 +306,12 @@ SDL_VoutOverlay *SDL_VoutFFmpeg_CreateOverlay(int width, int height, int frame_f
                 case AV_PIX_FMT_YUV444P10LE:
                     overlay_format = SDL_FCC_I444P10LE;
                     break;
+                case AV_PIX_FMT_NV12:
+                    overlay_format = SDL_FCC_NV12;
+                    break;
+                case AV_PIX_FMT_P010LE:
+                    overlay_format = SDL_FCC_P010;
+                    break;
                 case AV_PIX_FMT_YUV420P:
                 case AV_PIX_FMT_YUVJ420P:
                 default:
@@ -367,6 +389,13 @@ SDL_VoutOverlay *SDL_VoutFFmpeg_CreateOverlay(int width, int height, int frame_f
         opaque->planes = 3;
         break;
     }
+    case SDL_FCC_NV12:
+    case SDL_FCC_P010: {
+        ff_format = overlay_format == SDL_FCC_NV12 ? AV_PIX_FMT_NV12 : AV_PIX_FMT_P010LE;
+        buf_width = IJKALIGN(width, 16);
+        opaque->planes = 2;
+        break;
+    }
     case SDL_FCC_RV16: {
         ff_format = AV_PIX_FMT_RGB565;
         buf_width = IJKALIGN(width, 8); // 2 bytes per pixel
@@ -21,26 +21,72 @@
 
 #include "ijksdl/gles2/internal.h"
 
-static const char g_shader[] = IJK_GLES_STRING(
-    precision highp float;
-    varying   highp vec2 vv2_Texcoord;
-    uniform         mat3 um3_ColorConversion;
-    uniform   lowp  sampler2D us2_SamplerX;
-    uniform   lowp  sampler2D us2_SamplerY;
-
-    void main()
-    {
-        mediump vec3 yuv;
-        lowp    vec3 rgb;
-
-        yuv.x  = (texture2D(us2_SamplerX,  vv2_Texcoord).r  - (16.0 / 255.0));
-        yuv.yz = (texture2D(us2_SamplerY,  vv2_Texcoord).rg - vec2(0.5, 0.5));
-        rgb = um3_ColorConversion * yuv;
-        gl_FragColor = vec4(rgb, 1);
-    }
-);
+/*
+ * Y in one texture and interleaved UV in another. The variants only differ
+ * in yuv420sp_fetch(), which reads Y, U and V back out of the texels.
+ */
+#define IJK_GLES2_YUV420SP_HEAD(sampler_precision) IJK_GLES_STRING(  \
+    precision highp float;                                          \
+    varying   highp vec2 vv2_Texcoord;                              \
+    uniform         mat3 um3_ColorConversion;                       \
+    uniform   sampler_precision sampler2D us2_SamplerX;             \
+    uniform   sampler_precision sampler2D us2_SamplerY;             \
+)
+
+/* 8-bit samples, UV in the channels named by swizzle */
+#define IJK_GLES2_YUV420SP_FETCH8(swizzle) IJK_GLES_STRING(          \
+    mediump vec3 yuv420sp_fetch()                                   \
+    {                                                               \
+        return vec3(texture2D(us2_SamplerX, vv2_Texcoord).r,        \
+                    texture2D(us2_SamplerY, vv2_Texcoord).swizzle); \
+    }                                                               \
+)
+
+#define IJK_GLES2_YUV420SP_MAIN IJK_GLES_STRING(                     \
+    void main()                                                     \
+    {                                                               \
+        highp   vec3 yuv;                                           \
+        lowp    vec3 rgb;                                           \
+                                                                    \
+        yuv = yuv420sp_fetch() - vec3(16.0 / 255.0, 0.5, 0.5);      \
+        rgb = um3_ColorConversion * yuv;                            \
+        gl_FragColor = vec4(rgb, 1);                                \
+    }                                                               \
+)
 
-const char *IJK_GLES2_getFragmentShader_yuv420sp()
+/* GL_EXT_texture_rg: Y as red, UV as red/green */
+static const char g_shader_rg[] =
+    IJK_GLES2_YUV420SP_HEAD(lowp)
+    IJK_GLES2_YUV420SP_FETCH8(rg)
+    IJK_GLES2_YUV420SP_MAIN;
+
+/* luminance textures rather than GL_EXT_texture_rg, which GLES2 devices may lack */
+static const char g_shader_la[] =
+    IJK_GLES2_YUV420SP_HEAD(lowp)
+    IJK_GLES2_YUV420SP_FETCH8(ra)
+    IJK_GLES2_YUV420SP_MAIN;
+
+/* 16-bit samples split in byte pairs: Y as luminance/alpha, UV as rgba (Ulo, Uhi, Vlo, Vhi) */
+static const char g_shader_16[] =
+    IJK_GLES2_YUV420SP_HEAD(mediump)
+    IJK_GLES_STRING(
+        highp vec3 yuv420sp_fetch()
+        {
+            highp vec2 y  = texture2D(us2_SamplerX, vv2_Texcoord).ra;
+            highp vec4 uv = texture2D(us2_SamplerY, vv2_Texcoord);
+            highp vec2 k  = vec2(255.0, 255.0 * 256.0) / 65535.0;
+
+            return vec3(dot(y, k), dot(uv.rg, k), dot(uv.ba, k));
+        }
+    )
+    IJK_GLES2_YUV420SP_MAIN;
+
+const char *IJK_GLES2_getFragmentShader_yuv420sp(Uint32 format)
 {
-    return g_shader;
+    switch (format) {
+        case SDL_FCC__VTB:  return g_shader_rg;
+        case SDL_FCC_NV12:  return g_shader_la;
+        case SDL_FCC_P010:  return g_shader_16;
+        default:            return NULL;
+    }
 }
@@ -86,7 +86,7 @@ void IJK_GLES2_loadOrtho(IJK_GLES_Matrix *matrix, GLfloat left, GLfloat right, G
 const char *IJK_GLES2_getVertexShader_default();
 const char *IJK_GLES2_getFragmentShader_yuv420p();
 const char *IJK_GLES2_getFragmentShader_yuv444p10le();
-const char *IJK_GLES2_getFragmentShader_yuv420sp();
+const char *IJK_GLES2_getFragmentShader_yuv420sp(Uint32 format);
 const char *IJK_GLES2_getFragmentShader_rgb();
 
 const GLfloat *IJK_GLES2_getColorMatrix_bt709();
@@ -95,7 +95,7 @@ const GLfloat *IJK_GLES2_getColorMatrix_bt601();
 IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_base(const char *fragment_shader_source);
 IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420p();
 IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv444p10le();
-IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420sp();
+IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420sp(Uint32 format);
 IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420sp_vtb(SDL_VoutOverlay *overlay);
 IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_rgb565();
 IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_rgb888();
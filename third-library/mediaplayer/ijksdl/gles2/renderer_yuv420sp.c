@@ -25,9 +25,36 @@
 #include "ijksdl_vout_overlay_videotoolbox.h"
 #endif
 
+/*
+ * How each two-plane format is put in textures. 16-bit samples go up as
+ * byte pairs, so a texel of either plane covers twice the bytes.
+ */
+typedef struct YUV420SP_Layout {
+    Uint32      format;
+    const char *name;
+    GLsizei     bytes_per_sample;
+    GLenum      y_format;
+    GLenum      uv_format;
+} YUV420SP_Layout;
+
+static const YUV420SP_Layout g_layouts[] = {
+    { SDL_FCC__VTB, "yuv420sp", 1, GL_RED_EXT,          GL_RG_EXT },
+    { SDL_FCC_NV12, "nv12",     1, GL_LUMINANCE,        GL_LUMINANCE_ALPHA },
+    { SDL_FCC_P010, "p010",     2, GL_LUMINANCE_ALPHA,  GL_RGBA },
+};
+
+static const YUV420SP_Layout *yuv420sp_getLayout(Uint32 format)
+{
+    for (size_t i = 0; i < sizeof(g_layouts) / sizeof(g_layouts[0]); ++i) {
+        if (g_layouts[i].format == format)
+            return &g_layouts[i];
+    }
+    return NULL;
+}
+
 static GLboolean yuv420sp_use(IJK_GLES2_Renderer *renderer)
 {
-    ALOGI("use render yuv420sp\n");
+    ALOGI("use render %s\n", yuv420sp_getLayout(renderer->format)->name);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
     glUseProgram(renderer->program);            IJK_GLES2_checkError_TRACE("glUseProgram");
@@ -57,7 +84,7 @@ static GLsizei yuv420sp_getBufferWidth(IJK_GLES2_Renderer *renderer, SDL_VoutOve
     if (!overlay)
         return 0;
 
-    return overlay->pitches[0] / 1;
+    return overlay->pitches[0] / yuv420sp_getLayout(renderer->format)->bytes_per_sample;
 }
 
 static GLboolean yuv420sp_uploadTexture(IJK_GLES2_Renderer *renderer, SDL_VoutOverlay *overlay)
@@ -65,46 +92,43 @@ static GLboolean yuv420sp_uploadTexture(IJK_GLES2_Renderer *renderer, SDL_VoutOv
     if (!renderer || !overlay)
         return GL_FALSE;
 
-    const GLsizei widths[2]    = { overlay->pitches[0], overlay->pitches[1] / 2 };
-    const GLsizei heights[2]   = { overlay->h,          overlay->h / 2 };
-    const GLubyte *pixels[2]   = { overlay->pixels[0],  overlay->pixels[1] };
-
-    switch (overlay->format) {
-        case SDL_FCC__VTB:
-            break;
-        default:
-            ALOGE("[yuv420sp] unexpected format %x\n", overlay->format);
-            return GL_FALSE;
+    const YUV420SP_Layout *layout = yuv420sp_getLayout(renderer->format);
+    if (overlay->format != layout->format) {
+        ALOGE("[%s] unexpected format %x\n", layout->name, overlay->format);
+        return GL_FALSE;
     }
 
-    glBindTexture(GL_TEXTURE_2D, renderer->plane_textures[0]);
-    glTexImage2D(GL_TEXTURE_2D,
-                 0,
-                 GL_RED_EXT,
-                 widths[0],
-                 heights[0],
-                 0,
-                 GL_RED_EXT,
-                 GL_UNSIGNED_BYTE,
-                 pixels[0]);
-
-    glBindTexture(GL_TEXTURE_2D, renderer->plane_textures[1]);
-    glTexImage2D(GL_TEXTURE_2D,
-                 0,
-                 GL_RG_EXT,
-                 widths[1],
-                 heights[1],
-                 0,
-                 GL_RG_EXT,
-                 GL_UNSIGNED_BYTE,
-                 pixels[1]);
+    const GLsizei  bps         = layout->bytes_per_sample;
+    const GLsizei  widths[2]   = { overlay->pitches[0] / bps, overlay->pitches[1] / (2 * bps) };
+    const GLsizei  heights[2]  = { overlay->h,                (overlay->h + 1) / 2 };
+    const GLenum   formats[2]  = { layout->y_format,          layout->uv_format };
+    const GLubyte *pixels[2]   = { overlay->pixels[0],        overlay->pixels[1] };
+
+    for (int i = 0; i < 2; ++i) {
+        glBindTexture(GL_TEXTURE_2D, renderer->plane_textures[i]);
+        glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     formats[i],
+                     widths[i],
+                     heights[i],
+                     0,
+                     formats[i],
+                     GL_UNSIGNED_BYTE,
+                     pixels[i]);
+    }
 
     return GL_TRUE;
 }
 
-IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420sp()
+/* SDL_FCC__VTB (as a fallback for the VideoToolbox renderer), NV12 or P010 */
+IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420sp(Uint32 format)
 {
-    IJK_GLES2_Renderer *renderer = IJK_GLES2_Renderer_create_base(IJK_GLES2_getFragmentShader_yuv420sp());
+    const YUV420SP_Layout *layout = yuv420sp_getLayout(format);
+    if (!layout)
+        return NULL;
+
+    ALOGI("create render %s\n", layout->name);
+    IJK_GLES2_Renderer *renderer = IJK_GLES2_Renderer_create_base(IJK_GLES2_getFragmentShader_yuv420sp(format));
     if (!renderer)
         goto fail;
 
@@ -117,6 +141,7 @@ IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420sp()
     renderer->func_getBufferWidth = yuv420sp_getBufferWidth;
     renderer->func_uploadTexture  = yuv420sp_uploadTexture;
 
+    renderer->format = format;
     return renderer;
 fail:
     IJK_GLES2_Renderer_free(renderer);
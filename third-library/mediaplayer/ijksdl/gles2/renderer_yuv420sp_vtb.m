@@ -203,21 +203,21 @@ IJK_GLES2_Renderer *IJK_GLES2_Renderer_create_yuv420sp_vtb(SDL_VoutOverlay *over
 
     if (!overlay) {
         ALOGW("invalid overlay, fall back to yuv420sp renderer\n");
-        return IJK_GLES2_Renderer_create_yuv420sp();
+        return IJK_GLES2_Renderer_create_yuv420sp(SDL_FCC__VTB);
     }
 
     if (!overlay) {
         ALOGW("non-private overlay, fall back to yuv420sp renderer\n");
-        return IJK_GLES2_Renderer_create_yuv420sp();
+        return IJK_GLES2_Renderer_create_yuv420sp(SDL_FCC__VTB);
     }
 
     if (!context) {
         ALOGW("nil EAGLContext, fall back to yuv420sp renderer\n");
-        return IJK_GLES2_Renderer_create_yuv420sp();
+        return IJK_GLES2_Renderer_create_yuv420sp(SDL_FCC__VTB);
     }
 
     ALOGI("create render yuv420sp_vtb\n");
-    IJK_GLES2_Renderer *renderer = IJK_GLES2_Renderer_create_base(IJK_GLES2_getFragmentShader_yuv420sp());
+    IJK_GLES2_Renderer *renderer = IJK_GLES2_Renderer_create_base(IJK_GLES2_getFragmentShader_yuv420sp(SDL_FCC__VTB));
     if (!renderer)
         goto fail;
 
@@ -34,9 +34,11 @@
 #include "ijksdl_mutex.h"
 #include "ijksdl_thread.h"
 #include "ijksdl_timer.h"
+#include "ijksdl_trace.h"
 #include "ijksdl_video.h"
 #include "ijksdl_vout.h"
 
+#include "ffmpeg/ijksdl_frame_pool.h"
 #include "ffmpeg/ijksdl_vout_overlay_ffmpeg.h"
 
 #endif
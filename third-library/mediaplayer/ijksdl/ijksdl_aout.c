@@ -24,7 +24,6 @@
 
 #include "ijksdl_aout.h"
 #include <stdlib.h>
-#include "player/ff_ffplay_def.h"
 
 int SDL_AoutOpenAudio(SDL_Aout *aout, const SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 {
@@ -114,6 +113,26 @@ void SDL_AoutSetPlaybackVolume(SDL_Aout *aout, float volume)
     }
 }
 
+int SDL_AoutGetStats(SDL_Aout *aout, SDL_AoutStats *stats)
+{
+    if (aout && stats) {
+        if (aout->func_get_stats) {
+            aout->func_get_stats(aout, stats);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int SDL_AoutGetTimeUs(SDL_Aout *aout, int64_t *time_us)
+{
+    if (aout && time_us) {
+        if (aout->func_get_time_us)
+            return aout->func_get_time_us(aout, time_us);
+    }
+    return -1;
+}
+
 int SDL_AoutGetAudioSessionId(SDL_Aout *aout)
 {
     if (aout) {
@@ -29,6 +29,24 @@
 #include "ijksdl_class.h"
 #include "ijksdl_mutex.h"
 
+/* Minimum SDL audio buffer size, in samples. */
+#define SDL_AUDIO_MIN_BUFFER_SIZE 512
+/* Calculate actual buffer size keeping in mind not cause too frequent audio callbacks */
+#define SDL_AUDIO_MAX_CALLBACKS_PER_SEC 30
+
+/* Timing of an opened output, for outputs that measure it */
+typedef struct SDL_AoutStats {
+    int     buffer_frames;      /* frames per callback */
+    int     queue_buffers;      /* buffers currently kept queued on the device */
+    double  latency_seconds;    /* output latency measured at the last callback */
+    int64_t callbacks;
+    int64_t underruns;          /* the device ran out of queued audio */
+    int64_t periods;            /* device periods timed for jitter */
+    double  jitter_ms;          /* mean distance of a period from its nominal length */
+    double  max_jitter_ms;
+    double  max_callback_ms;    /* longest time spent in the audio callback */
+} SDL_AoutStats;
+
 typedef struct SDL_Aout_Opaque SDL_Aout_Opaque;
 typedef struct SDL_Aout SDL_Aout;
 struct SDL_Aout {
@@ -51,6 +69,13 @@ struct SDL_Aout {
     void   (*func_set_playback_rate)(SDL_Aout *aout, float playbackRate);
     void   (*func_set_playback_volume)(SDL_Aout *aout, float playbackVolume);
     int    (*func_get_audio_persecond_callbacks)(SDL_Aout *aout);
+    void   (*func_get_stats)(SDL_Aout *aout, SDL_AoutStats *stats);
+    /*
+     * Outputs that do not play in real time report the time they play on, in
+     * microseconds on the av_gettime_relative() scale; the player runs its
+     * clocks on it instead of the wall clock.
+     */
+    int    (*func_get_time_us)(SDL_Aout *aout, int64_t *time_us);
 
     // Android only
     int    (*func_get_audio_session_id)(SDL_Aout *aout);
@@ -71,6 +96,9 @@ int    SDL_AoutGetAudioPerSecondCallBacks(SDL_Aout *aout);
 // optional
 void   SDL_AoutSetPlaybackRate(SDL_Aout *aout, float playbackRate);
 void   SDL_AoutSetPlaybackVolume(SDL_Aout *aout, float volume);
+int    SDL_AoutGetStats(SDL_Aout *aout, SDL_AoutStats *stats);
+/* < 0 if the output plays in real time */
+int    SDL_AoutGetTimeUs(SDL_Aout *aout, int64_t *time_us);
 
 // android only
 int    SDL_AoutGetAudioSessionId(SDL_Aout *aout);
@@ -25,6 +25,7 @@
 #ifndef IJKSDL__IJKSDL_AOUT_INTERNAL_H
 #define IJKSDL__IJKSDL_AOUT_INTERNAL_H
 
+#include <stdlib.h>
 #include "ijksdl_mutex.h"
 #include "ijksdl_aout.h"
 
@@ -64,4 +65,15 @@ inline static void SDL_Aout_FreeInternal(SDL_Aout *aout)
     free(aout);
 }
 
+/* accounts one device period of interval_us against its nominal length */
+inline static void SDL_Aout_StatsAddPeriod(SDL_AoutStats *stats, int64_t interval_us, int64_t period_us)
+{
+    double jitter_ms = llabs(interval_us - period_us) / 1000.0;
+
+    stats->periods++;
+    stats->jitter_ms += (jitter_ms - stats->jitter_ms) / stats->periods;
+    if (jitter_ms > stats->max_jitter_ms)
+        stats->max_jitter_ms = jitter_ms;
+}
+
 #endif
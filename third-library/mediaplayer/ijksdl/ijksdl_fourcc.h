@@ -56,7 +56,8 @@
 #define SDL_FCC_UYVY    SDL_FOURCC('U', 'Y', 'V', 'Y')  /**< bpp=16, Packed mode: U0+Y0+V0+Y1 (1 plane) */
 #define SDL_FCC_YVYU    SDL_FOURCC('Y', 'V', 'Y', 'U')  /**< bpp=16, Packed mode: Y0+V0+Y1+U0 (1 plane) */
 
-#define SDL_FCC_NV12    SDL_FOURCC('N', 'V', '1', '2')
+#define SDL_FCC_NV12    SDL_FOURCC('N', 'V', '1', '2')  /**< bpp=12, Semi-planar mode: Y + UV interleaved (2 planes) */
+#define SDL_FCC_P010    SDL_FOURCC('P', '0', '1', '0')  /**< bpp=24, NV12 layout, 16-bit little-endian samples, 10 bits MSB aligned */
 
 // RGB formats
 #define SDL_FCC_RV16    SDL_FOURCC('R', 'V', '1', '6')    /**< bpp=16, RGB565 */
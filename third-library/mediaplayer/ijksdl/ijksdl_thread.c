@@ -22,11 +22,16 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* gettid, pthread_setname_np on glibc */
+#endif
 #include <errno.h>
 #include <assert.h>
+#include <stdio.h>
 #include <unistd.h>
 #include "ijksdl_inc_internal.h"
 #include "ijksdl_thread.h"
+#include "ijksdl_trace.h"
 #ifdef __ANDROID__
 #include "android/ijksdl_android_jni.h"
 #endif
@@ -38,6 +43,7 @@ static void *SDL_RunThread(void *data)
     SDL_Thread *thread = data;
     ALOGI("SDL_RunThread: [%d] %s\n", (int)gettid(), thread->name);
     pthread_setname_np(pthread_self(), thread->name);
+    SDL_TraceSetThreadName(thread->name);
     thread->retval = thread->func(thread->data);
 #ifdef __ANDROID__
     SDL_JNI_DetachThreadEnv();
@@ -49,7 +55,7 @@ SDL_Thread *SDL_CreateThreadEx(SDL_Thread *thread, int (*fn)(void *), void *data
 {
     thread->func = fn;
     thread->data = data;
-    strlcpy(thread->name, name, sizeof(thread->name) - 1);
+    snprintf(thread->name, sizeof(thread->name), "%s", name);
     int retval = pthread_create(&thread->id, NULL, SDL_RunThread, thread);
     if (retval)
         return NULL;
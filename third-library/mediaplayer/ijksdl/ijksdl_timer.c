@@ -81,6 +81,10 @@ Uint64 SDL_GetTickHR(void)
         gettimeofday(&now, NULL);
         clock = now.tv_sec  * 1000 + now.tv_usec / 1000;
     }
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    clock = (Uint64)now.tv_sec * 1000 + now.tv_nsec / 1000000;
 #endif
     return (clock);
 }
@@ -225,3 +229,56 @@ int64_t SDL_SpeedSampler2GetSpeed(SDL_SpeedSampler2 *sampler)
 
     return new_quantity * 1000 / new_duration;
 }
+
+static int histogram_index(uint64_t value)
+{
+    if (value < (1 << SDL_HISTOGRAM_SUB_BITS))
+        return (int)value;
+    if (value > UINT32_MAX)
+        return SDL_HISTOGRAM_BUCKETS - 1;
+
+    int shift = 63 - __builtin_clzll(value) - SDL_HISTOGRAM_SUB_BITS;
+    return ((shift + 1) << SDL_HISTOGRAM_SUB_BITS) + (int)(value >> shift) - (1 << SDL_HISTOGRAM_SUB_BITS);
+}
+
+/* middle of the bucket */
+static int64_t histogram_value(int index)
+{
+    if (index < (1 << SDL_HISTOGRAM_SUB_BITS))
+        return index;
+
+    int shift = (index >> SDL_HISTOGRAM_SUB_BITS) - 1;
+    int64_t sub = (index & ((1 << SDL_HISTOGRAM_SUB_BITS) - 1)) + (1 << SDL_HISTOGRAM_SUB_BITS);
+    return (sub << shift) + ((1LL << shift) >> 1);
+}
+
+void SDL_HistogramAdd(SDL_Histogram *histogram, int64_t value)
+{
+    if (value < 0)
+        value = 0;
+    histogram->buckets[histogram_index((uint64_t)value)]++;
+    histogram->count++;
+    if (value > histogram->max)
+        histogram->max = value;
+}
+
+int64_t SDL_HistogramGetPercentile(SDL_Histogram *histogram, double percentile)
+{
+    int64_t count = histogram->count;
+    if (count <= 0)
+        return 0;
+
+    int64_t target = (int64_t)(count * percentile / 100.0 + 0.5);
+    if (target < 1)
+        target = 1;
+
+    int64_t seen = 0;
+    for (int i = 0; i < SDL_HISTOGRAM_BUCKETS; ++i) {
+        seen += histogram->buckets[i];
+        if (seen >= target) {
+            int64_t value = histogram_value(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
@@ -82,4 +82,27 @@ void    SDL_SpeedSampler2Reset(SDL_SpeedSampler2 *sampler, int sample_range);
 int64_t SDL_SpeedSampler2Add(SDL_SpeedSampler2 *sampler, int quantity);
 int64_t SDL_SpeedSampler2GetSpeed(SDL_SpeedSampler2 *sampler);
 
+
+
+/*
+ * Log-linear histogram (HDR histogram style): 32 sub-buckets per power of
+ * two, so any recorded value is reported within ~3%. Covers 0 .. 2^32-1,
+ * larger values land in the last bucket. Add is O(1) without allocation;
+ * a single writer and racy readers are fine for statistics. A zeroed
+ * histogram is empty, so ffp_reset_statistic() clears it with the rest.
+ */
+#define SDL_HISTOGRAM_SUB_BITS  5
+#define SDL_HISTOGRAM_BUCKETS   ((32 - SDL_HISTOGRAM_SUB_BITS + 1) << SDL_HISTOGRAM_SUB_BITS)
+
+typedef struct SDL_Histogram
+{
+    Uint32  buckets[SDL_HISTOGRAM_BUCKETS];
+    int64_t count;
+    int64_t max;
+} SDL_Histogram;
+
+void    SDL_HistogramAdd(SDL_Histogram *histogram, int64_t value);
+// percentile in [0, 100], returns 0 if empty
+int64_t SDL_HistogramGetPercentile(SDL_Histogram *histogram, double percentile);
+
 #endif
@@ -0,0 +1,266 @@
+/*****************************************************************************
+ * ijksdl_trace.c
+ *****************************************************************************
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ijksdl_trace.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#include "ijksdl_log.h"
+#include "ijksdl_misc.h"
+
+typedef struct SDL_TraceEvent {
+    int64_t     time;       /* us, monotonic */
+    int64_t     ts;
+    const char *name;
+    int         stream;
+    char        phase;
+} SDL_TraceEvent;
+
+/*
+ * Single writer (the owning thread) publishes events by bumping head with
+ * release semantics; the exporter copies and then re-reads head to discard
+ * anything that was overwritten while it was copying.
+ */
+typedef struct SDL_TraceRing {
+    struct SDL_TraceRing *next;
+    int             tid;
+    char            name[16];
+    int             in_use;     /* owned by a live thread */
+    uint32_t        capacity;   /* power of two */
+    uint64_t        head;       /* events ever written */
+    uint64_t        base;       /* first event still wanted, see SDL_TraceReset() */
+    uint64_t        exported;   /* head as of the last export */
+    SDL_TraceEvent  events[];
+} SDL_TraceRing;
+
+volatile int g_sdl_trace_enabled = 0;
+
+static pthread_mutex_t  g_ring_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t   g_key_once   = PTHREAD_ONCE_INIT;
+static pthread_key_t    g_ring_key;
+static SDL_TraceRing   *g_rings;
+static uint32_t         g_capacity   = SDL_TRACE_DEFAULT_CAPACITY;
+
+static __thread SDL_TraceRing *tls_ring;
+static __thread char           tls_name[16];
+
+static int64_t trace_now_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static int trace_gettid(void)
+{
+#if defined(__linux__)
+    return (int)syscall(__NR_gettid);
+#else
+    return (int)(intptr_t)pthread_self();
+#endif
+}
+
+/*
+ * threads come and go with every player; hand their rings to the next
+ * thread, but only once whatever the last one recorded has been exported
+ * or reset away, the ring's tid and name only describe one owner
+ */
+static void ring_release(void *opaque)
+{
+    SDL_TraceRing *ring = opaque;
+
+    pthread_mutex_lock(&g_ring_mutex);
+    ring->in_use = 0;
+    pthread_mutex_unlock(&g_ring_mutex);
+}
+
+static void ring_key_init(void)
+{
+    pthread_key_create(&g_ring_key, ring_release);
+}
+
+static SDL_TraceRing *ring_acquire(void)
+{
+    SDL_TraceRing *ring;
+
+    pthread_once(&g_key_once, ring_key_init);
+    pthread_mutex_lock(&g_ring_mutex);
+    for (ring = g_rings; ring; ring = ring->next) {
+        if (!ring->in_use && ring->capacity == g_capacity &&
+            ring->head <= IJKMAX(ring->base, ring->exported))
+            break;
+    }
+    if (ring) {
+        ring->base = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    } else {
+        ring = calloc(1, sizeof(SDL_TraceRing) + g_capacity * sizeof(SDL_TraceEvent));
+        if (ring) {
+            ring->capacity = g_capacity;
+            ring->next = g_rings;
+            g_rings = ring;
+        }
+    }
+    if (ring) {
+        ring->in_use = 1;
+        ring->tid = trace_gettid();
+        memcpy(ring->name, tls_name, sizeof(ring->name));
+        pthread_setspecific(g_ring_key, ring);
+    }
+    pthread_mutex_unlock(&g_ring_mutex);
+    return ring;
+}
+
+void SDL_TraceSetEnabled(int enabled)
+{
+    g_sdl_trace_enabled = enabled ? 1 : 0;
+}
+
+void SDL_TraceSetCapacity(int events_per_thread)
+{
+    uint32_t capacity = 64;
+
+    while (capacity < (uint32_t)events_per_thread && capacity < (1u << 24))
+        capacity <<= 1;
+    pthread_mutex_lock(&g_ring_mutex);
+    g_capacity = capacity;
+    pthread_mutex_unlock(&g_ring_mutex);
+}
+
+void SDL_TraceSetThreadName(const char *name)
+{
+    snprintf(tls_name, sizeof(tls_name), "%s", name ? name : "");
+    if (tls_ring) {
+        pthread_mutex_lock(&g_ring_mutex);
+        memcpy(tls_ring->name, tls_name, sizeof(tls_ring->name));
+        pthread_mutex_unlock(&g_ring_mutex);
+    }
+}
+
+void SDL_TraceEmit(char phase, const char *name, int stream, int64_t ts)
+{
+    SDL_TraceRing *ring = tls_ring;
+
+    if (!ring) {
+        ring = tls_ring = ring_acquire();
+        if (!ring)
+            return;
+    }
+
+    uint64_t head = ring->head;
+    SDL_TraceEvent *event = &ring->events[head & (ring->capacity - 1)];
+    event->time   = trace_now_us();
+    event->ts     = ts;
+    event->name   = name;
+    event->stream = stream;
+    event->phase  = phase;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void SDL_TraceReset(void)
+{
+    SDL_TraceRing *ring;
+
+    pthread_mutex_lock(&g_ring_mutex);
+    for (ring = g_rings; ring; ring = ring->next)
+        ring->base = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    pthread_mutex_unlock(&g_ring_mutex);
+}
+
+static void export_name(FILE *fp, const char *name)
+{
+    for (; *name; name++)
+        fputc((*name == '"' || *name == '\\' || (unsigned char)*name < 0x20) ? '_' : *name, fp);
+}
+
+static void export_ring(FILE *fp, SDL_TraceRing *ring, SDL_TraceEvent *copy, int first)
+{
+    uint64_t head  = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t start = ring->base;
+    uint64_t i;
+
+    if (head > ring->capacity && head - ring->capacity > start)
+        start = head - ring->capacity;
+    for (i = start; i < head; i++)
+        copy[i - start] = ring->events[i & (ring->capacity - 1)];
+
+    /* the writer may have lapped us while copying, and may be in the middle
+     * of writing event head2 over head2 - capacity */
+    uint64_t head2 = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t valid = head2 + 1 > ring->capacity ? head2 + 1 - ring->capacity : 0;
+
+    fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+            first ? "" : ",", ring->tid);
+    export_name(fp, ring->name[0] ? ring->name : "thread");
+    fprintf(fp, "\"}}");
+
+    for (i = IJKMAX(start, valid); i < head; i++) {
+        SDL_TraceEvent *event = &copy[i - start];
+        fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%"PRId64",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"stream\":%d,\"pts_us\":%"PRId64"}}",
+                event->name, event->phase,
+                event->phase == SDL_TRACE_PHASE_INSTANT ? "\"s\":\"t\"," : "",
+                event->time, ring->tid, event->stream, event->ts);
+    }
+    ring->exported = head;
+}
+
+int SDL_TraceExportChrome(const char *path)
+{
+    SDL_TraceEvent *copy;
+    SDL_TraceRing *ring;
+    uint32_t capacity = 0;
+    int first = 1;
+    FILE *fp;
+
+    fp = fopen(path, "w");
+    if (!fp) {
+        ALOGE("SDL_TraceExportChrome: failed to open %s\n", path);
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_ring_mutex);
+    for (ring = g_rings; ring; ring = ring->next)
+        capacity = IJKMAX(capacity, ring->capacity);
+    copy = malloc(IJKMAX(capacity, 1) * sizeof(SDL_TraceEvent));
+    if (!copy) {
+        pthread_mutex_unlock(&g_ring_mutex);
+        fclose(fp);
+        return -1;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (ring = g_rings; ring; ring = ring->next) {
+        export_ring(fp, ring, copy, first);
+        first = 0;
+    }
+    fprintf(fp, "\n]}\n");
+    pthread_mutex_unlock(&g_ring_mutex);
+
+    free(copy);
+    return fclose(fp) ? -1 : 0;
+}
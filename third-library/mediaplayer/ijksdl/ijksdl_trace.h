@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * ijksdl_trace.h
+ *****************************************************************************
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef IJKSDL__IJKSDL_TRACE_H
+#define IJKSDL__IJKSDL_TRACE_H
+
+#include "ijksdl_stdinc.h"
+
+/*
+ * Process wide event tracer. Always compiled in; while disabled an event
+ * costs one load and branch. Each thread appends to its own ring buffer
+ * without locking, older events are overwritten when a ring is full.
+ * Rings are exported as Chrome trace-event JSON (chrome://tracing, Perfetto).
+ * The ring of a thread that has exited goes to a new thread only once its
+ * events have been exported or reset, until then new threads get new rings.
+ *
+ * Event names must be string literals, they are stored by pointer.
+ */
+
+#define SDL_TRACE_PHASE_BEGIN   'B'
+#define SDL_TRACE_PHASE_END     'E'
+#define SDL_TRACE_PHASE_INSTANT 'i'
+
+#define SDL_TRACE_DEFAULT_CAPACITY  (8 * 1024)  /* events per thread */
+
+extern volatile int g_sdl_trace_enabled;
+
+void    SDL_TraceSetEnabled(int enabled);
+/* takes effect for threads that have not traced yet */
+void    SDL_TraceSetCapacity(int events_per_thread);
+/* names the calling thread in exported traces */
+void    SDL_TraceSetThreadName(const char *name);
+void    SDL_TraceEmit(char phase, const char *name, int stream, int64_t ts);
+/* drops all recorded events */
+void    SDL_TraceReset(void);
+int     SDL_TraceExportChrome(const char *path);
+
+/* ts is the media timestamp of the packet/frame in microseconds, or -1 */
+#define SDL_TRACE(phase, name, stream, ts) \
+    do { \
+        if (g_sdl_trace_enabled) \
+            SDL_TraceEmit(phase, name, stream, ts); \
+    } while (0)
+
+#define SDL_TRACE_BEGIN(name, stream, ts)   SDL_TRACE(SDL_TRACE_PHASE_BEGIN, name, stream, ts)
+#define SDL_TRACE_END(name, stream, ts)     SDL_TRACE(SDL_TRACE_PHASE_END, name, stream, ts)
+#define SDL_TRACE_INSTANT(name, stream, ts) SDL_TRACE(SDL_TRACE_PHASE_INSTANT, name, stream, ts)
+
+#endif
@@ -68,6 +68,14 @@ int SDL_VoutSetOverlayFormat(SDL_Vout *vout, Uint32 overlay_format)
     return 0;
 }
 
+int SDL_VoutGetVsync(SDL_Vout *vout, int64_t *vsync_us, int64_t *period_us)
+{
+    if (vout && vout->func_get_vsync)
+        return vout->func_get_vsync(vout, vsync_us, period_us);
+
+    return -1;
+}
+
 SDL_VoutOverlay *SDL_Vout_CreateOverlay(int width, int height, int frame_format, SDL_Vout *vout)
 {
     if (vout && vout->create_overlay)
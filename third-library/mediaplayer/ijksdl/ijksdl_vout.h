@@ -67,6 +67,12 @@ struct SDL_Vout {
     SDL_VoutOverlay *(*create_overlay)(int width, int height, int frame_format, SDL_Vout *vout);
     void (*free_l)(SDL_Vout *vout);
     int (*display_overlay)(SDL_Vout *vout, SDL_VoutOverlay *overlay);
+    /*
+     * optional: a recent vsync on the av_gettime_relative() clock and the refresh period, us.
+     * Only the dummy vout has it so far; without it the player keeps its frame_timer
+     * deadlines and the vsync-pacing option has no effect.
+     */
+    int (*func_get_vsync)(SDL_Vout *vout, int64_t *vsync_us, int64_t *period_us);
 
     Uint32 overlay_format;
 };
@@ -75,6 +81,8 @@ void SDL_VoutFree(SDL_Vout *vout);
 void SDL_VoutFreeP(SDL_Vout **pvout);
 int  SDL_VoutDisplayYUVOverlay(SDL_Vout *vout, SDL_VoutOverlay *overlay);
 int  SDL_VoutSetOverlayFormat(SDL_Vout *vout, Uint32 overlay_format);
+/* < 0 if the output does not know its vsync timing */
+int  SDL_VoutGetVsync(SDL_Vout *vout, int64_t *vsync_us, int64_t *period_us);
 
 SDL_VoutOverlay *SDL_Vout_CreateOverlay(int width, int height, int frame_format, SDL_Vout *vout);
 int     SDL_VoutLockYUVOverlay(SDL_VoutOverlay *overlay);
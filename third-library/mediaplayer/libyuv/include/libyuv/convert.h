@@ -63,6 +63,26 @@ int I420Copy(const uint8* src_y, int src_stride_y,
              uint8* dst_v, int dst_stride_v,
              int width, int height);
 
+// Convert I010 (10 bit 4:2:0, lsb aligned 16 bit samples) to I420.
+// Strides of 16 bit planes are in samples.
+LIBYUV_API
+int I010ToI420(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_u, int dst_stride_u,
+               uint8* dst_v, int dst_stride_v,
+               int width, int height);
+
+// Convert P010 (10 bit 4:2:0, msb aligned, interleaved UV) to I010.
+LIBYUV_API
+int P010ToI010(const uint16* src_y, int src_stride_y,
+               const uint16* src_uv, int src_stride_uv,
+               uint16* dst_y, int dst_stride_y,
+               uint16* dst_u, int dst_stride_u,
+               uint16* dst_v, int dst_stride_v,
+               int width, int height);
+
 // Convert I400 (grey) to I420.
 LIBYUV_API
 int I400ToI420(const uint8* src_y, int src_stride_y,
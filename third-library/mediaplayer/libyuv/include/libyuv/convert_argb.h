@@ -60,6 +60,31 @@ int I444ToARGB(const uint8* src_y, int src_stride_y,
                uint8* dst_argb, int dst_stride_argb,
                int width, int height);
 
+// Convert I010 (10 bit 4:2:0, lsb aligned 16 bit samples) to AR30.
+// Strides of 16 bit planes are in samples.
+LIBYUV_API
+int I010ToAR30(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_ar30, int dst_stride_ar30,
+               int width, int height);
+
+// Convert I010 to ARGB.
+LIBYUV_API
+int I010ToARGB(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_argb, int dst_stride_argb,
+               int width, int height);
+
+// Convert I010 to ABGR.
+LIBYUV_API
+int I010ToABGR(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_abgr, int dst_stride_abgr,
+               int width, int height);
+
 // Convert I411 to ARGB.
 LIBYUV_API
 int I411ToARGB(const uint8* src_y, int src_stride_y,
@@ -58,6 +58,16 @@ int I400Copy(const uint8* src_y, int src_stride_y,
 
 // TODO(fbarchard): I420ToM420
 
+// Convert I010 (10 bit 4:2:0, lsb aligned) to P010 (msb aligned,
+// interleaved UV). Strides of 16 bit planes are in samples.
+LIBYUV_API
+int I010ToP010(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint16* dst_y, int dst_stride_y,
+               uint16* dst_uv, int dst_stride_uv,
+               int width, int height);
+
 LIBYUV_API
 int I420ToNV12(const uint8* src_y, int src_stride_y,
                const uint8* src_u, int src_stride_u,
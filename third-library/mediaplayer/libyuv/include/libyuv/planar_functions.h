@@ -33,6 +33,34 @@ void CopyPlane_16(const uint16* src_y, int src_stride_y,
                   uint16* dst_y, int dst_stride_y,
                   int width, int height);
 
+// Split interleaved 16 bit UV into U and V planes, shifting right by 'shift'.
+// Strides of 16 bit planes are in samples.
+LIBYUV_API
+void SplitUVPlane_16(const uint16* src_uv, int src_stride_uv,
+                     uint16* dst_u, int dst_stride_u,
+                     uint16* dst_v, int dst_stride_v,
+                     int shift, int width, int height);
+
+// Interleave 16 bit U and V planes, shifting left by 'shift'.
+LIBYUV_API
+void MergeUVPlane_16(const uint16* src_u, int src_stride_u,
+                     const uint16* src_v, int src_stride_v,
+                     uint16* dst_uv, int dst_stride_uv,
+                     int shift, int width, int height);
+
+// Shift a plane of 16 bit samples left (shift > 0) or right (shift < 0).
+LIBYUV_API
+void ShiftPlane_16(const uint16* src_y, int src_stride_y,
+                   uint16* dst_y, int dst_stride_y,
+                   int shift, int width, int height);
+
+// Convert a plane of 16 bit samples with 'depth' significant bits (9 to 16;
+// 16 for msb aligned formats such as P010) to 8 bits with ordered dither.
+LIBYUV_API
+int Convert16To8Plane(const uint16* src_y, int src_stride_y,
+                      uint8* dst_y, int dst_stride_y,
+                      int depth, int width, int height);
+
 // Set a plane of data to a 32 bit value.
 LIBYUV_API
 void SetPlane(uint8* dst_y, int dst_stride_y,
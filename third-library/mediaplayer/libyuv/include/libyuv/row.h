@@ -258,6 +258,31 @@ extern "C" {
 #define HAS_MIRRORROW_SSE2
 #endif
 
+// The following are available for gcc/clang x86 platforms:
+#if !defined(LIBYUV_DISABLE_X86) && \
+    (defined(__x86_64__) || (defined(__i386__) && !defined(_MSC_VER)))
+#define HAS_CONVERT16TO8ROW_SSE2
+#define HAS_DIVIDEROW_16_SSE2
+#define HAS_I210TOAR30ROW_SSE2
+#define HAS_INTERPOLATEROW_16_SSE2
+#define HAS_MERGEUVROW_16_SSE2
+#define HAS_MULTIPLYROW_16_SSE2
+#define HAS_SPLITUVROW_16_SSE2
+#endif
+
+// The following are available for AVX2 gcc/clang x86 platforms:
+#if !defined(LIBYUV_DISABLE_X86) && \
+    (defined(__x86_64__) || (defined(__i386__) && !defined(_MSC_VER))) && \
+    (defined(CLANG_HAS_AVX2) || defined(GCC_HAS_AVX2))
+#define HAS_CONVERT16TO8ROW_AVX2
+#define HAS_DIVIDEROW_16_AVX2
+#define HAS_I210TOAR30ROW_AVX2
+#define HAS_INTERPOLATEROW_16_AVX2
+#define HAS_MERGEUVROW_16_AVX2
+#define HAS_MULTIPLYROW_16_AVX2
+#define HAS_SPLITUVROW_16_AVX2
+#endif
+
 // The following are available on Neon platforms:
 #if !defined(LIBYUV_DISABLE_NEON) && \
     (defined(__aarch64__) || defined(__ARM_NEON__) || defined(LIBYUV_NEON))
@@ -330,6 +355,14 @@ extern "C" {
 #define HAS_YUY2TOYROW_NEON
 #define HAS_ARGBTORGB565DITHERROW_NEON
 
+// 16 bit planes:
+#define HAS_CONVERT16TO8ROW_NEON
+#define HAS_DIVIDEROW_16_NEON
+#define HAS_INTERPOLATEROW_16_NEON
+#define HAS_MERGEUVROW_16_NEON
+#define HAS_MULTIPLYROW_16_NEON
+#define HAS_SPLITUVROW_16_NEON
+
 // Effects:
 #define HAS_ARGBADDROW_NEON
 #define HAS_ARGBATTENUATEROW_NEON
@@ -802,6 +835,89 @@ void MergeUVRow_Any_AVX2(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
 void MergeUVRow_Any_NEON(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
                          int width);
 
+// 16 bit UV planes.  SplitUVRow_16 shifts the samples right and MergeUVRow_16
+// shifts them left, as between msb aligned P010 and lsb aligned I010.
+void SplitUVRow_16_C(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                     int shift, int width);
+void SplitUVRow_16_SSE2(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                        int shift, int width);
+void SplitUVRow_16_AVX2(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                        int shift, int width);
+void SplitUVRow_16_NEON(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                        int shift, int width);
+void SplitUVRow_16_Any_SSE2(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                            int shift, int width);
+void SplitUVRow_16_Any_AVX2(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                            int shift, int width);
+void SplitUVRow_16_Any_NEON(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                            int shift, int width);
+
+void MergeUVRow_16_C(const uint16* src_u, const uint16* src_v, uint16* dst_uv,
+                     int shift, int width);
+void MergeUVRow_16_SSE2(const uint16* src_u, const uint16* src_v,
+                        uint16* dst_uv, int shift, int width);
+void MergeUVRow_16_AVX2(const uint16* src_u, const uint16* src_v,
+                        uint16* dst_uv, int shift, int width);
+void MergeUVRow_16_NEON(const uint16* src_u, const uint16* src_v,
+                        uint16* dst_uv, int shift, int width);
+void MergeUVRow_16_Any_SSE2(const uint16* src_u, const uint16* src_v,
+                            uint16* dst_uv, int shift, int width);
+void MergeUVRow_16_Any_AVX2(const uint16* src_u, const uint16* src_v,
+                            uint16* dst_uv, int shift, int width);
+void MergeUVRow_16_Any_NEON(const uint16* src_u, const uint16* src_v,
+                            uint16* dst_uv, int shift, int width);
+
+// dst = src * scale, keeping the low 16 bits.  A scale of 64 turns 10 bit
+// lsb aligned samples into msb aligned ones.
+void MultiplyRow_16_C(const uint16* src_y, uint16* dst_y, int scale,
+                      int width);
+void MultiplyRow_16_SSE2(const uint16* src_y, uint16* dst_y, int scale,
+                         int width);
+void MultiplyRow_16_AVX2(const uint16* src_y, uint16* dst_y, int scale,
+                         int width);
+void MultiplyRow_16_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                         int width);
+void MultiplyRow_16_Any_SSE2(const uint16* src_y, uint16* dst_y, int scale,
+                             int width);
+void MultiplyRow_16_Any_AVX2(const uint16* src_y, uint16* dst_y, int scale,
+                             int width);
+void MultiplyRow_16_Any_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                             int width);
+
+// dst = (src * scale) >> 16.  A scale of 1024 turns msb aligned 10 bit
+// samples into lsb aligned ones.
+void DivideRow_16_C(const uint16* src_y, uint16* dst_y, int scale, int width);
+void DivideRow_16_SSE2(const uint16* src_y, uint16* dst_y, int scale,
+                       int width);
+void DivideRow_16_AVX2(const uint16* src_y, uint16* dst_y, int scale,
+                       int width);
+void DivideRow_16_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                       int width);
+void DivideRow_16_Any_SSE2(const uint16* src_y, uint16* dst_y, int scale,
+                           int width);
+void DivideRow_16_Any_AVX2(const uint16* src_y, uint16* dst_y, int scale,
+                           int width);
+void DivideRow_16_Any_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                           int width);
+
+// dst = clamp255(saturate(src + dither[x & 15]) >> shift), 1 <= shift <= 8.
+// The dither row holds 16 values; all zero truncates, all 1 << (shift - 1)
+// rounds.
+void Convert16To8Row_C(const uint16* src_y, uint8* dst_y,
+                       const uint16* dither, int shift, int width);
+void Convert16To8Row_SSE2(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width);
+void Convert16To8Row_AVX2(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width);
+void Convert16To8Row_NEON(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width);
+void Convert16To8Row_Any_SSE2(const uint16* src_y, uint8* dst_y,
+                              const uint16* dither, int shift, int width);
+void Convert16To8Row_Any_AVX2(const uint16* src_y, uint8* dst_y,
+                              const uint16* dither, int shift, int width);
+void Convert16To8Row_Any_NEON(const uint16* src_y, uint8* dst_y,
+                              const uint16* dither, int shift, int width);
+
 void CopyRow_SSE2(const uint8* src, uint8* dst, int count);
 void CopyRow_AVX(const uint8* src, uint8* dst, int count);
 void CopyRow_ERMS(const uint8* src, uint8* dst, int count);
@@ -944,6 +1060,33 @@ void J400ToARGBRow_Any_SSE2(const uint8* src_y, uint8* dst_argb, int pix);
 void J400ToARGBRow_Any_AVX2(const uint8* src_y, uint8* dst_argb, int pix);
 void J400ToARGBRow_Any_NEON(const uint8* src_y, uint8* dst_argb, int pix);
 
+// 10 bit 4:2:2 to AR30: 2:10:10:10 little endian words, blue in the low bits.
+void I210ToAR30Row_C(const uint16* src_y,
+                     const uint16* src_u,
+                     const uint16* src_v,
+                     uint8* dst_ar30,
+                     int width);
+void I210ToAR30Row_SSE2(const uint16* src_y,
+                        const uint16* src_u,
+                        const uint16* src_v,
+                        uint8* dst_ar30,
+                        int width);
+void I210ToAR30Row_AVX2(const uint16* src_y,
+                        const uint16* src_u,
+                        const uint16* src_v,
+                        uint8* dst_ar30,
+                        int width);
+void I210ToAR30Row_Any_SSE2(const uint16* src_y,
+                            const uint16* src_u,
+                            const uint16* src_v,
+                            uint8* dst_ar30,
+                            int width);
+void I210ToAR30Row_Any_AVX2(const uint16* src_y,
+                            const uint16* src_u,
+                            const uint16* src_v,
+                            uint8* dst_ar30,
+                            int width);
+
 void I444ToARGBRow_C(const uint8* src_y,
                      const uint8* src_u,
                      const uint8* src_v,
@@ -1788,6 +1931,24 @@ void InterpolateRow_Any_MIPS_DSPR2(uint8* dst_ptr, const uint8* src_ptr,
 void InterpolateRow_16_C(uint16* dst_ptr, const uint16* src_ptr,
                          ptrdiff_t src_stride_ptr,
                          int width, int source_y_fraction);
+void InterpolateRow_16_SSE2(uint16* dst_ptr, const uint16* src_ptr,
+                            ptrdiff_t src_stride_ptr,
+                            int width, int source_y_fraction);
+void InterpolateRow_16_AVX2(uint16* dst_ptr, const uint16* src_ptr,
+                            ptrdiff_t src_stride_ptr,
+                            int width, int source_y_fraction);
+void InterpolateRow_16_NEON(uint16* dst_ptr, const uint16* src_ptr,
+                            ptrdiff_t src_stride_ptr,
+                            int width, int source_y_fraction);
+void InterpolateRow_Any_16_SSE2(uint16* dst_ptr, const uint16* src_ptr,
+                                ptrdiff_t src_stride_ptr,
+                                int width, int source_y_fraction);
+void InterpolateRow_Any_16_AVX2(uint16* dst_ptr, const uint16* src_ptr,
+                                ptrdiff_t src_stride_ptr,
+                                int width, int source_y_fraction);
+void InterpolateRow_Any_16_NEON(uint16* dst_ptr, const uint16* src_ptr,
+                                ptrdiff_t src_stride_ptr,
+                                int width, int source_y_fraction);
 
 // Sobel images.
 void SobelXRow_C(const uint8* src_y0, const uint8* src_y1, const uint8* src_y2,
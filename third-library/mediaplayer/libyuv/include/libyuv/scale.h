@@ -34,6 +34,19 @@ void ScalePlane(const uint8* src, int src_stride,
                 int dst_width, int dst_height,
                 enum FilterMode filtering);
 
+// Scale rows [clip_y, clip_y + clip_height) of the destination only, with
+// the same result a full ScalePlane gives for those rows.  dst points at
+// row 0 of the full destination.  Lets a frame be scaled in bands on
+// several threads; keep clip_y and clip_height multiples of 3 so the 3/4
+// and 3/8 scalers are used as they would be for the whole plane.
+LIBYUV_API
+int ScalePlaneClip(const uint8* src, int src_stride,
+                   int src_width, int src_height,
+                   uint8* dst, int dst_stride,
+                   int dst_width, int dst_height,
+                   int clip_y, int clip_height,
+                   enum FilterMode filtering);
+
 LIBYUV_API
 void ScalePlane_16(const uint16* src, int src_stride,
                    int src_width, int src_height,
@@ -48,6 +48,12 @@ extern "C" {
 #define HAS_SCALEROWDOWN4_SSE2
 #endif
 
+// The following are available for gcc/clang x86 platforms:
+#if !defined(LIBYUV_DISABLE_X86) && \
+    (defined(__x86_64__) || (defined(__i386__) && !defined(_MSC_VER)))
+#define HAS_SCALEROWDOWN2_16_SSE2
+#endif
+
 // The following are available on VS2012:
 #if !defined(LIBYUV_DISABLE_X86) && defined(VISUALC_HAS_AVX2)
 #define HAS_SCALEADDROW_AVX2
@@ -72,6 +78,7 @@ extern "C" {
 #define HAS_SCALEROWDOWN38_NEON
 #define HAS_SCALEROWDOWN4_NEON
 #define HAS_SCALEARGBFILTERCOLS_NEON
+#define HAS_SCALEROWDOWN2_16_NEON
 #endif
 
 // The following are available on Mips platforms:
@@ -220,6 +227,12 @@ void ScaleRowDown2Linear_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
                               uint8* dst_ptr, int dst_width);
 void ScaleRowDown2Box_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
                            uint8* dst_ptr, int dst_width);
+void ScaleRowDown2_16_SSE2(const uint16* src_ptr, ptrdiff_t src_stride,
+                           uint16* dst_ptr, int dst_width);
+void ScaleRowDown2Linear_16_SSE2(const uint16* src_ptr, ptrdiff_t src_stride,
+                                 uint16* dst_ptr, int dst_width);
+void ScaleRowDown2Box_16_SSE2(const uint16* src_ptr, ptrdiff_t src_stride,
+                              uint16* dst_ptr, int dst_width);
 void ScaleRowDown2_AVX2(const uint8* src_ptr, ptrdiff_t src_stride,
                         uint8* dst_ptr, int dst_width);
 void ScaleRowDown2Linear_AVX2(const uint8* src_ptr, ptrdiff_t src_stride,
@@ -374,6 +387,10 @@ void ScaleARGBRowDownEvenBox_Any_NEON(const uint8* src_argb,
 // NEON downscalers with interpolation.
 
 // Note - not static due to reuse in convert for 444 to 420.
+void ScaleRowDown2_16_NEON(const uint16* src_ptr, ptrdiff_t src_stride,
+                           uint16* dst, int dst_width);
+void ScaleRowDown2Box_16_NEON(const uint16* src_ptr, ptrdiff_t src_stride,
+                              uint16* dst, int dst_width);
 void ScaleRowDown2_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
                         uint8* dst, int dst_width);
 void ScaleRowDown2Linear_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
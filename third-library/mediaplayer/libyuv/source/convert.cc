@@ -157,6 +157,72 @@ int I411ToI420(const uint8* src_y, int src_stride_y,
                     src_uv_width, height);
 }
 
+// Convert 10 bit I010 (lsb aligned in 16 bit samples) to I420.
+// The dropped bits are dithered; see Convert16To8Plane.
+LIBYUV_API
+int I010ToI420(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_u, int dst_stride_u,
+               uint8* dst_v, int dst_stride_v,
+               int width, int height) {
+  int halfwidth = (width + 1) >> 1;
+  int halfheight = (height + 1) >> 1;
+  if (!src_y || !src_u || !src_v || !dst_y || !dst_u || !dst_v ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    halfheight = (height + 1) >> 1;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_u = src_u + (halfheight - 1) * src_stride_u;
+    src_v = src_v + (halfheight - 1) * src_stride_v;
+    src_stride_y = -src_stride_y;
+    src_stride_u = -src_stride_u;
+    src_stride_v = -src_stride_v;
+  }
+  Convert16To8Plane(src_y, src_stride_y, dst_y, dst_stride_y,
+                    10, width, height);
+  Convert16To8Plane(src_u, src_stride_u, dst_u, dst_stride_u,
+                    10, halfwidth, halfheight);
+  Convert16To8Plane(src_v, src_stride_v, dst_v, dst_stride_v,
+                    10, halfwidth, halfheight);
+  return 0;
+}
+
+// Convert P010 (msb aligned, interleaved UV) to I010 (lsb aligned, planar).
+LIBYUV_API
+int P010ToI010(const uint16* src_y, int src_stride_y,
+               const uint16* src_uv, int src_stride_uv,
+               uint16* dst_y, int dst_stride_y,
+               uint16* dst_u, int dst_stride_u,
+               uint16* dst_v, int dst_stride_v,
+               int width, int height) {
+  int halfwidth = (width + 1) >> 1;
+  int halfheight = (height + 1) >> 1;
+  if (!src_y || !src_uv || !dst_y || !dst_u || !dst_v ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    halfheight = (height + 1) >> 1;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_uv = src_uv + (halfheight - 1) * src_stride_uv;
+    src_stride_y = -src_stride_y;
+    src_stride_uv = -src_stride_uv;
+  }
+  ShiftPlane_16(src_y, src_stride_y, dst_y, dst_stride_y,
+                -6, width, height);
+  SplitUVPlane_16(src_uv, src_stride_uv, dst_u, dst_stride_u,
+                  dst_v, dst_stride_v, 6, halfwidth, halfheight);
+  return 0;
+}
+
 // I400 is greyscale typically used in MJPG
 LIBYUV_API
 int I400ToI420(const uint8* src_y, int src_stride_y,
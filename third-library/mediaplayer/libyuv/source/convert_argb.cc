@@ -189,6 +189,222 @@ int I422ToARGB(const uint8* src_y, int src_stride_y,
   return 0;
 }
 
+// Convert I010 (10 bit 4:2:0) to AR30 (2:10:10:10 little endian, B lowest).
+LIBYUV_API
+int I010ToAR30(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_ar30, int dst_stride_ar30,
+               int width, int height) {
+  int y;
+  void (*I210ToAR30Row)(const uint16* y_buf,
+                        const uint16* u_buf,
+                        const uint16* v_buf,
+                        uint8* rgb_buf,
+                        int width) = I210ToAR30Row_C;
+  if (!src_y || !src_u || !src_v || !dst_ar30 ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_ar30 = dst_ar30 + (height - 1) * dst_stride_ar30;
+    dst_stride_ar30 = -dst_stride_ar30;
+  }
+#if defined(HAS_I210TOAR30ROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    I210ToAR30Row = I210ToAR30Row_Any_SSE2;
+    if (IS_ALIGNED(width, 8)) {
+      I210ToAR30Row = I210ToAR30Row_SSE2;
+    }
+  }
+#endif
+#if defined(HAS_I210TOAR30ROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    I210ToAR30Row = I210ToAR30Row_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      I210ToAR30Row = I210ToAR30Row_AVX2;
+    }
+  }
+#endif
+
+  for (y = 0; y < height; ++y) {
+    I210ToAR30Row(src_y, src_u, src_v, dst_ar30, width);
+    dst_ar30 += dst_stride_ar30;
+    src_y += src_stride_y;
+    if (y & 1) {
+      src_u += src_stride_u;
+      src_v += src_stride_v;
+    }
+  }
+  return 0;
+}
+
+// Rounds 10 bit samples to 8 bits: (v + 2) >> 2.
+static const uint16 kRound10To8[16] = {
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
+};
+
+// Narrow each I010 row to 8 bits and hand it to an I422 to RGB row function.
+static int I010ToRGBInternal(const uint16* src_y, int src_stride_y,
+                             const uint16* src_u, int src_stride_u,
+                             const uint16* src_v, int src_stride_v,
+                             uint8* dst_argb, int dst_stride_argb,
+                             int width, int height,
+                             void (*I422ToRGBRow)(const uint8* y_buf,
+                                                  const uint8* u_buf,
+                                                  const uint8* v_buf,
+                                                  uint8* rgb_buf,
+                                                  int width)) {
+  int y;
+  int halfwidth = (width + 1) >> 1;
+  void (*Convert16To8Row)(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width) =
+      Convert16To8Row_C;
+  // Row buffer: Y, then U and V, each rounded up for SIMD overreads.
+  const int kRowSize = (width + 31) & ~31;
+  const int kUVSize = (halfwidth + 31) & ~31;
+  align_buffer_64(row, kRowSize + kUVSize * 2);
+  uint8* row_y = row;
+  uint8* row_u = row + kRowSize;
+  uint8* row_v = row + kRowSize + kUVSize;
+#if defined(HAS_CONVERT16TO8ROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    Convert16To8Row = Convert16To8Row_Any_SSE2;
+  }
+#endif
+#if defined(HAS_CONVERT16TO8ROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    Convert16To8Row = Convert16To8Row_Any_AVX2;
+  }
+#endif
+#if defined(HAS_CONVERT16TO8ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    Convert16To8Row = Convert16To8Row_Any_NEON;
+  }
+#endif
+
+  for (y = 0; y < height; ++y) {
+    Convert16To8Row(src_y, row_y, kRound10To8, 2, width);
+    if (!(y & 1)) {
+      Convert16To8Row(src_u, row_u, kRound10To8, 2, halfwidth);
+      Convert16To8Row(src_v, row_v, kRound10To8, 2, halfwidth);
+    }
+    I422ToRGBRow(row_y, row_u, row_v, dst_argb, width);
+    dst_argb += dst_stride_argb;
+    src_y += src_stride_y;
+    if (y & 1) {
+      src_u += src_stride_u;
+      src_v += src_stride_v;
+    }
+  }
+  free_aligned_buffer_64(row);
+  return 0;
+}
+
+// Convert I010 to ARGB.
+LIBYUV_API
+int I010ToARGB(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_argb, int dst_stride_argb,
+               int width, int height) {
+  void (*I422ToARGBRow)(const uint8* y_buf,
+                        const uint8* u_buf,
+                        const uint8* v_buf,
+                        uint8* rgb_buf,
+                        int width) = I422ToARGBRow_C;
+  if (!src_y || !src_u || !src_v || !dst_argb ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_argb = dst_argb + (height - 1) * dst_stride_argb;
+    dst_stride_argb = -dst_stride_argb;
+  }
+#if defined(HAS_I422TOARGBROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    I422ToARGBRow = I422ToARGBRow_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToARGBRow = I422ToARGBRow_SSSE3;
+    }
+  }
+#endif
+#if defined(HAS_I422TOARGBROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    I422ToARGBRow = I422ToARGBRow_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      I422ToARGBRow = I422ToARGBRow_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_I422TOARGBROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    I422ToARGBRow = I422ToARGBRow_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToARGBRow = I422ToARGBRow_NEON;
+    }
+  }
+#endif
+  return I010ToRGBInternal(src_y, src_stride_y, src_u, src_stride_u,
+                           src_v, src_stride_v, dst_argb, dst_stride_argb,
+                           width, height, I422ToARGBRow);
+}
+
+// Convert I010 to ABGR.
+LIBYUV_API
+int I010ToABGR(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint8* dst_abgr, int dst_stride_abgr,
+               int width, int height) {
+  void (*I422ToABGRRow)(const uint8* y_buf,
+                        const uint8* u_buf,
+                        const uint8* v_buf,
+                        uint8* rgb_buf,
+                        int width) = I422ToABGRRow_C;
+  if (!src_y || !src_u || !src_v || !dst_abgr ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_abgr = dst_abgr + (height - 1) * dst_stride_abgr;
+    dst_stride_abgr = -dst_stride_abgr;
+  }
+#if defined(HAS_I422TOABGRROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    I422ToABGRRow = I422ToABGRRow_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToABGRRow = I422ToABGRRow_SSSE3;
+    }
+  }
+#endif
+#if defined(HAS_I422TOABGRROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    I422ToABGRRow = I422ToABGRRow_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      I422ToABGRRow = I422ToABGRRow_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_I422TOABGRROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    I422ToABGRRow = I422ToABGRRow_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToABGRRow = I422ToABGRRow_NEON;
+    }
+  }
+#endif
+  return I010ToRGBInternal(src_y, src_stride_y, src_u, src_stride_u,
+                           src_v, src_stride_v, dst_abgr, dst_stride_abgr,
+                           width, height, I422ToABGRRow);
+}
+
 // Convert I411 to ARGB.
 LIBYUV_API
 int I411ToARGB(const uint8* src_y, int src_stride_y,
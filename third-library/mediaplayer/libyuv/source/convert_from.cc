@@ -359,6 +359,36 @@ int I420ToUYVY(const uint8* src_y, int src_stride_y,
   return 0;
 }
 
+// Convert I010 (lsb aligned, planar) to P010 (msb aligned, interleaved UV).
+LIBYUV_API
+int I010ToP010(const uint16* src_y, int src_stride_y,
+               const uint16* src_u, int src_stride_u,
+               const uint16* src_v, int src_stride_v,
+               uint16* dst_y, int dst_stride_y,
+               uint16* dst_uv, int dst_stride_uv,
+               int width, int height) {
+  int halfwidth = (width + 1) >> 1;
+  int halfheight = (height + 1) >> 1;
+  if (!src_y || !src_u || !src_v || !dst_y || !dst_uv ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    halfheight = (height + 1) >> 1;
+    dst_y = dst_y + (height - 1) * dst_stride_y;
+    dst_uv = dst_uv + (halfheight - 1) * dst_stride_uv;
+    dst_stride_y = -dst_stride_y;
+    dst_stride_uv = -dst_stride_uv;
+  }
+  ShiftPlane_16(src_y, src_stride_y, dst_y, dst_stride_y,
+                6, width, height);
+  MergeUVPlane_16(src_u, src_stride_u, src_v, src_stride_v,
+                  dst_uv, dst_stride_uv, 6, halfwidth, halfheight);
+  return 0;
+}
+
 LIBYUV_API
 int I420ToNV12(const uint8* src_y, int src_stride_y,
                const uint8* src_u, int src_stride_u,
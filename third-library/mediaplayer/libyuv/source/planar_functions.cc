@@ -117,6 +117,250 @@ void CopyPlane_16(const uint16* src_y, int src_stride_y,
   }
 }
 
+// Split interleaved 16 bit UV into U and V planes, shifting the samples right
+// by 'shift': 6 turns msb aligned P010 chroma into lsb aligned I010 chroma.
+LIBYUV_API
+void SplitUVPlane_16(const uint16* src_uv, int src_stride_uv,
+                     uint16* dst_u, int dst_stride_u,
+                     uint16* dst_v, int dst_stride_v,
+                     int shift, int width, int height) {
+  int y;
+  void (*SplitUVRow)(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                     int shift, int width) = SplitUVRow_16_C;
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_u = dst_u + (height - 1) * dst_stride_u;
+    dst_v = dst_v + (height - 1) * dst_stride_v;
+    dst_stride_u = -dst_stride_u;
+    dst_stride_v = -dst_stride_v;
+  }
+  // Coalesce rows.
+  if (src_stride_uv == width * 2 &&
+      dst_stride_u == width &&
+      dst_stride_v == width) {
+    width *= height;
+    height = 1;
+    src_stride_uv = dst_stride_u = dst_stride_v = 0;
+  }
+#if defined(HAS_SPLITUVROW_16_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    SplitUVRow = SplitUVRow_16_Any_SSE2;
+    if (IS_ALIGNED(width, 8)) {
+      SplitUVRow = SplitUVRow_16_SSE2;
+    }
+  }
+#endif
+#if defined(HAS_SPLITUVROW_16_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    SplitUVRow = SplitUVRow_16_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      SplitUVRow = SplitUVRow_16_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_SPLITUVROW_16_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    SplitUVRow = SplitUVRow_16_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      SplitUVRow = SplitUVRow_16_NEON;
+    }
+  }
+#endif
+
+  for (y = 0; y < height; ++y) {
+    SplitUVRow(src_uv, dst_u, dst_v, shift, width);
+    src_uv += src_stride_uv;
+    dst_u += dst_stride_u;
+    dst_v += dst_stride_v;
+  }
+}
+
+// Interleave 16 bit U and V planes, shifting the samples left by 'shift'.
+LIBYUV_API
+void MergeUVPlane_16(const uint16* src_u, int src_stride_u,
+                     const uint16* src_v, int src_stride_v,
+                     uint16* dst_uv, int dst_stride_uv,
+                     int shift, int width, int height) {
+  int y;
+  void (*MergeUVRow)(const uint16* src_u, const uint16* src_v,
+                     uint16* dst_uv, int shift, int width) = MergeUVRow_16_C;
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_uv = dst_uv + (height - 1) * dst_stride_uv;
+    dst_stride_uv = -dst_stride_uv;
+  }
+  // Coalesce rows.
+  if (src_stride_u == width &&
+      src_stride_v == width &&
+      dst_stride_uv == width * 2) {
+    width *= height;
+    height = 1;
+    src_stride_u = src_stride_v = dst_stride_uv = 0;
+  }
+#if defined(HAS_MERGEUVROW_16_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    MergeUVRow = MergeUVRow_16_Any_SSE2;
+    if (IS_ALIGNED(width, 8)) {
+      MergeUVRow = MergeUVRow_16_SSE2;
+    }
+  }
+#endif
+#if defined(HAS_MERGEUVROW_16_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    MergeUVRow = MergeUVRow_16_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      MergeUVRow = MergeUVRow_16_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_MERGEUVROW_16_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    MergeUVRow = MergeUVRow_16_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      MergeUVRow = MergeUVRow_16_NEON;
+    }
+  }
+#endif
+
+  for (y = 0; y < height; ++y) {
+    MergeUVRow(src_u, src_v, dst_uv, shift, width);
+    src_u += src_stride_u;
+    src_v += src_stride_v;
+    dst_uv += dst_stride_uv;
+  }
+}
+
+// Shift a plane of 16 bit samples left (shift > 0) or right (shift < 0).
+LIBYUV_API
+void ShiftPlane_16(const uint16* src_y, int src_stride_y,
+                   uint16* dst_y, int dst_stride_y,
+                   int shift, int width, int height) {
+  int y;
+  int scale = shift >= 0 ? 1 << shift : 65536 >> -shift;
+  void (*ShiftRow)(const uint16* src_y, uint16* dst_y, int scale,
+                   int width) = shift >= 0 ? MultiplyRow_16_C : DivideRow_16_C;
+  if (shift == 0) {
+    CopyPlane_16(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+    return;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_y = dst_y + (height - 1) * dst_stride_y;
+    dst_stride_y = -dst_stride_y;
+  }
+  // Coalesce rows.
+  if (src_stride_y == width &&
+      dst_stride_y == width) {
+    width *= height;
+    height = 1;
+    src_stride_y = dst_stride_y = 0;
+  }
+#if defined(HAS_MULTIPLYROW_16_SSE2) && defined(HAS_DIVIDEROW_16_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    ShiftRow = shift > 0 ? MultiplyRow_16_Any_SSE2 : DivideRow_16_Any_SSE2;
+    if (IS_ALIGNED(width, 16)) {
+      ShiftRow = shift > 0 ? MultiplyRow_16_SSE2 : DivideRow_16_SSE2;
+    }
+  }
+#endif
+#if defined(HAS_MULTIPLYROW_16_AVX2) && defined(HAS_DIVIDEROW_16_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    ShiftRow = shift > 0 ? MultiplyRow_16_Any_AVX2 : DivideRow_16_Any_AVX2;
+    if (IS_ALIGNED(width, 32)) {
+      ShiftRow = shift > 0 ? MultiplyRow_16_AVX2 : DivideRow_16_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_MULTIPLYROW_16_NEON) && defined(HAS_DIVIDEROW_16_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    ShiftRow = shift > 0 ? MultiplyRow_16_Any_NEON : DivideRow_16_Any_NEON;
+    if (IS_ALIGNED(width, 16)) {
+      ShiftRow = shift > 0 ? MultiplyRow_16_NEON : DivideRow_16_NEON;
+    }
+  }
+#endif
+
+  for (y = 0; y < height; ++y) {
+    ShiftRow(src_y, dst_y, scale, width);
+    src_y += src_stride_y;
+    dst_y += dst_stride_y;
+  }
+}
+
+// 4x4 ordered dither thresholds, 0 to 15.
+static const uint8 kDither4x4[16] = {
+  0, 8, 2, 10,
+  12, 4, 14, 6,
+  3, 11, 1, 9,
+  15, 7, 13, 5
+};
+
+// Convert a plane of 16 bit samples holding 'depth' significant bits to 8
+// bits.  The dropped bits are replaced by a 4x4 ordered dither, which keeps
+// gradients free of the banding plain truncation leaves.
+LIBYUV_API
+int Convert16To8Plane(const uint16* src_y, int src_stride_y,
+                      uint8* dst_y, int dst_stride_y,
+                      int depth, int width, int height) {
+  int x, y;
+  int shift = depth - 8;
+  uint16 dither[4][16];
+  void (*Convert16To8Row)(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width) =
+      Convert16To8Row_C;
+  if (!src_y || !dst_y || width <= 0 || height == 0 ||
+      shift < 1 || shift > 8) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_stride_y = -src_stride_y;
+  }
+  for (y = 0; y < 4; ++y) {
+    for (x = 0; x < 16; ++x) {
+      int d = kDither4x4[y * 4 + (x & 3)];
+      dither[y][x] = shift >= 4 ? d << (shift - 4) : d >> (4 - shift);
+    }
+  }
+#if defined(HAS_CONVERT16TO8ROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    Convert16To8Row = Convert16To8Row_Any_SSE2;
+    if (IS_ALIGNED(width, 16)) {
+      Convert16To8Row = Convert16To8Row_SSE2;
+    }
+  }
+#endif
+#if defined(HAS_CONVERT16TO8ROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    Convert16To8Row = Convert16To8Row_Any_AVX2;
+    if (IS_ALIGNED(width, 32)) {
+      Convert16To8Row = Convert16To8Row_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_CONVERT16TO8ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    Convert16To8Row = Convert16To8Row_Any_NEON;
+    if (IS_ALIGNED(width, 16)) {
+      Convert16To8Row = Convert16To8Row_NEON;
+    }
+  }
+#endif
+
+  // The dither pattern follows the rows, so rows are not coalesced.
+  for (y = 0; y < height; ++y) {
+    Convert16To8Row(src_y, dst_y, dither[y & 3], shift, width);
+    src_y += src_stride_y;
+    dst_y += dst_stride_y;
+  }
+  return 0;
+}
+
 // Copy I422.
 LIBYUV_API
 int I422Copy(const uint8* src_y, int src_stride_y,
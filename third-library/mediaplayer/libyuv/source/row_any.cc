@@ -122,6 +122,28 @@ YANY(I422ToUYVYRow_Any_NEON, I422ToUYVYRow_NEON, I422ToUYVYRow_C, 1, 2, 15)
 #endif
 #undef YANY
 
+// 10 bit YUV to AR30 does multiple of 8 or 16 with SIMD and remainder with C.
+#define Y16ANY(NAMEANY, I210TORGB_SIMD, I210TORGB_C, UV_SHIFT, BPP, MASK)      \
+    void NAMEANY(const uint16* y_buf, const uint16* u_buf,                     \
+                 const uint16* v_buf, uint8* rgb_buf, int width) {             \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        I210TORGB_SIMD(y_buf, u_buf, v_buf, rgb_buf, n);                       \
+      }                                                                        \
+      I210TORGB_C(y_buf + n,                                                   \
+                  u_buf + (n >> UV_SHIFT),                                     \
+                  v_buf + (n >> UV_SHIFT),                                     \
+                  rgb_buf + n * BPP, width & MASK);                            \
+    }
+
+#ifdef HAS_I210TOAR30ROW_SSE2
+Y16ANY(I210ToAR30Row_Any_SSE2, I210ToAR30Row_SSE2, I210ToAR30Row_C, 1, 4, 7)
+#endif
+#ifdef HAS_I210TOAR30ROW_AVX2
+Y16ANY(I210ToAR30Row_Any_AVX2, I210ToAR30Row_AVX2, I210ToAR30Row_C, 1, 4, 15)
+#endif
+#undef Y16ANY
+
 // Wrappers to handle odd width
 #define NV2NY(NAMEANY, NV12TORGB_SIMD, NV12TORGB_C, UV_SHIFT, BPP, MASK)       \
     void NAMEANY(const uint8* y_buf, const uint8* uv_buf,                      \
@@ -558,6 +580,115 @@ MERGEUVROW_ANY(MergeUVRow_Any_NEON, MergeUVRow_NEON, MergeUVRow_C, 15)
 #endif
 #undef MERGEUVROW_ANY
 
+#define SPLITUVROW16_ANY(NAMEANY, ANYTOUV_SIMD, ANYTOUV_C, MASK)               \
+    void NAMEANY(const uint16* src_uv, uint16* dst_u, uint16* dst_v,           \
+                 int shift, int width) {                                       \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        ANYTOUV_SIMD(src_uv, dst_u, dst_v, shift, n);                          \
+      }                                                                        \
+      ANYTOUV_C(src_uv + n * 2,                                                \
+                dst_u + n,                                                     \
+                dst_v + n,                                                     \
+                shift, width & MASK);                                          \
+    }
+
+#ifdef HAS_SPLITUVROW_16_SSE2
+SPLITUVROW16_ANY(SplitUVRow_16_Any_SSE2, SplitUVRow_16_SSE2, SplitUVRow_16_C,
+                 7)
+#endif
+#ifdef HAS_SPLITUVROW_16_AVX2
+SPLITUVROW16_ANY(SplitUVRow_16_Any_AVX2, SplitUVRow_16_AVX2, SplitUVRow_16_C,
+                 15)
+#endif
+#ifdef HAS_SPLITUVROW_16_NEON
+SPLITUVROW16_ANY(SplitUVRow_16_Any_NEON, SplitUVRow_16_NEON, SplitUVRow_16_C,
+                 7)
+#endif
+#undef SPLITUVROW16_ANY
+
+#define MERGEUVROW16_ANY(NAMEANY, ANYTOUV_SIMD, ANYTOUV_C, MASK)               \
+    void NAMEANY(const uint16* src_u, const uint16* src_v,                     \
+                 uint16* dst_uv, int shift, int width) {                       \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        ANYTOUV_SIMD(src_u, src_v, dst_uv, shift, n);                          \
+      }                                                                        \
+      ANYTOUV_C(src_u + n,                                                     \
+                src_v + n,                                                     \
+                dst_uv + n * 2,                                                \
+                shift, width & MASK);                                          \
+    }
+
+#ifdef HAS_MERGEUVROW_16_SSE2
+MERGEUVROW16_ANY(MergeUVRow_16_Any_SSE2, MergeUVRow_16_SSE2, MergeUVRow_16_C,
+                 7)
+#endif
+#ifdef HAS_MERGEUVROW_16_AVX2
+MERGEUVROW16_ANY(MergeUVRow_16_Any_AVX2, MergeUVRow_16_AVX2, MergeUVRow_16_C,
+                 15)
+#endif
+#ifdef HAS_MERGEUVROW_16_NEON
+MERGEUVROW16_ANY(MergeUVRow_16_Any_NEON, MergeUVRow_16_NEON, MergeUVRow_16_C,
+                 7)
+#endif
+#undef MERGEUVROW16_ANY
+
+// Any 1 to 1 16 bit rows with a parameter.
+#define ANY11P16(NAMEANY, ANY_SIMD, ANY_C, T, MASK)                            \
+    void NAMEANY(const uint16* src_y, T* dst_y, int param, int width) {        \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        ANY_SIMD(src_y, dst_y, param, n);                                      \
+      }                                                                        \
+      ANY_C(src_y + n, dst_y + n, param, width & MASK);                        \
+    }
+
+#ifdef HAS_MULTIPLYROW_16_SSE2
+ANY11P16(MultiplyRow_16_Any_SSE2, MultiplyRow_16_SSE2, MultiplyRow_16_C,
+         uint16, 15)
+#endif
+#ifdef HAS_MULTIPLYROW_16_AVX2
+ANY11P16(MultiplyRow_16_Any_AVX2, MultiplyRow_16_AVX2, MultiplyRow_16_C,
+         uint16, 31)
+#endif
+#ifdef HAS_MULTIPLYROW_16_NEON
+ANY11P16(MultiplyRow_16_Any_NEON, MultiplyRow_16_NEON, MultiplyRow_16_C,
+         uint16, 15)
+#endif
+#ifdef HAS_DIVIDEROW_16_SSE2
+ANY11P16(DivideRow_16_Any_SSE2, DivideRow_16_SSE2, DivideRow_16_C, uint16, 15)
+#endif
+#ifdef HAS_DIVIDEROW_16_AVX2
+ANY11P16(DivideRow_16_Any_AVX2, DivideRow_16_AVX2, DivideRow_16_C, uint16, 31)
+#endif
+#ifdef HAS_DIVIDEROW_16_NEON
+ANY11P16(DivideRow_16_Any_NEON, DivideRow_16_NEON, DivideRow_16_C, uint16, 15)
+#endif
+#undef ANY11P16
+
+// Convert16To8 keeps the dither phase: SIMD widths are multiples of 16.
+#define ANY11D16(NAMEANY, ANY_SIMD, ANY_C, MASK)                               \
+    void NAMEANY(const uint16* src_y, uint8* dst_y, const uint16* dither,      \
+                 int shift, int width) {                                       \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        ANY_SIMD(src_y, dst_y, dither, shift, n);                              \
+      }                                                                        \
+      ANY_C(src_y + n, dst_y + n, dither, shift, width & MASK);                \
+    }
+
+#ifdef HAS_CONVERT16TO8ROW_SSE2
+ANY11D16(Convert16To8Row_Any_SSE2, Convert16To8Row_SSE2, Convert16To8Row_C, 15)
+#endif
+#ifdef HAS_CONVERT16TO8ROW_AVX2
+ANY11D16(Convert16To8Row_Any_AVX2, Convert16To8Row_AVX2, Convert16To8Row_C, 31)
+#endif
+#ifdef HAS_CONVERT16TO8ROW_NEON
+ANY11D16(Convert16To8Row_Any_NEON, Convert16To8Row_NEON, Convert16To8Row_C, 15)
+#endif
+#undef ANY11D16
+
 #define MATHROW_ANY(NAMEANY, ARGBMATH_SIMD, ARGBMATH_C, SBPP, DBPP, MASK)      \
     void NAMEANY(const uint8* src_argb0, const uint8* src_argb1,               \
                  uint8* dst_argb, int width) {                                 \
@@ -688,6 +819,32 @@ NANY(InterpolateRow_Any_MIPS_DSPR2, InterpolateRow_MIPS_DSPR2, InterpolateRow_C,
 #endif
 #undef NANY
 
+#define NANY16(NAMEANY, TERP_SIMD, TERP_C, MASK)                               \
+    void NAMEANY(uint16* dst_ptr, const uint16* src_ptr,                       \
+                 ptrdiff_t src_stride_ptr, int width,                          \
+                 int source_y_fraction) {                                      \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        TERP_SIMD(dst_ptr, src_ptr, src_stride_ptr, n, source_y_fraction);     \
+      }                                                                        \
+      TERP_C(dst_ptr + n, src_ptr + n, src_stride_ptr,                         \
+             width & MASK, source_y_fraction);                                 \
+    }
+
+#ifdef HAS_INTERPOLATEROW_16_AVX2
+NANY16(InterpolateRow_Any_16_AVX2, InterpolateRow_16_AVX2, InterpolateRow_16_C,
+       15)
+#endif
+#ifdef HAS_INTERPOLATEROW_16_SSE2
+NANY16(InterpolateRow_Any_16_SSE2, InterpolateRow_16_SSE2, InterpolateRow_16_C,
+       7)
+#endif
+#ifdef HAS_INTERPOLATEROW_16_NEON
+NANY16(InterpolateRow_Any_16_NEON, InterpolateRow_16_NEON, InterpolateRow_16_C,
+       7)
+#endif
+#undef NANY16
+
 #define MANY(NAMEANY, MIRROR_SIMD, MIRROR_C, BPP, MASK)                        \
     void NAMEANY(const uint8* src_y, uint8* dst_y, int width) {                \
       int n = width & ~MASK;                                                   \
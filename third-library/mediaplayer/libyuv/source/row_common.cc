@@ -1154,6 +1154,55 @@ void I422ToARGBRow_C(const uint8* src_y,
   }
 }
 
+// BT.601 10 bit YUV to 10 bit RGB.  Samples are masked to 10 bits, biased,
+// scaled by 32 and multiplied keeping the high 16 bits, as pmulhw does, so
+// the SIMD versions produce identical results.
+#define YG10 2384 /* round(1.164 * 2048) */
+#define UB10 4133 /* round(2.018 * 2048) */
+#define UG10 801 /* round(0.391 * 2048) */
+#define VG10 1665 /* round(0.813 * 2048) */
+#define VR10 3269 /* round(1.596 * 2048) */
+
+static __inline int32 Clamp10(int32 v) {
+  return v < 0 ? 0 : (v > 1023 ? 1023 : v);
+}
+
+static __inline void YuvPixel10(uint16 y, uint16 u, uint16 v,
+                                uint8* dst_ar30) {
+  int32 y1 = ((((y & 0x3ff) - 64) * 32) * YG10) >> 16;
+  int32 u1 = ((u & 0x3ff) - 512) * 32;
+  int32 v1 = ((v & 0x3ff) - 512) * 32;
+  int32 b = Clamp10(y1 + ((u1 * UB10) >> 16));
+  int32 g = Clamp10(y1 - ((u1 * UG10) >> 16) - ((v1 * VG10) >> 16));
+  int32 r = Clamp10(y1 + ((v1 * VR10) >> 16));
+  *(uint32*)(dst_ar30) = (uint32)(b | (g << 10) | (r << 20)) | 0xc0000000u;
+}
+
+#undef YG10
+#undef UB10
+#undef UG10
+#undef VG10
+#undef VR10
+
+void I210ToAR30Row_C(const uint16* src_y,
+                     const uint16* src_u,
+                     const uint16* src_v,
+                     uint8* dst_ar30,
+                     int width) {
+  int x;
+  for (x = 0; x < width - 1; x += 2) {
+    YuvPixel10(src_y[0], src_u[0], src_v[0], dst_ar30 + 0);
+    YuvPixel10(src_y[1], src_u[0], src_v[0], dst_ar30 + 4);
+    src_y += 2;
+    src_u += 1;
+    src_v += 1;
+    dst_ar30 += 8;  // Advance 2 pixels.
+  }
+  if (width & 1) {
+    YuvPixel10(src_y[0], src_u[0], src_v[0], dst_ar30);
+  }
+}
+
 void J422ToARGBRow_C(const uint8* src_y,
                      const uint8* src_u,
                      const uint8* src_v,
@@ -1703,6 +1752,53 @@ void MergeUVRow_C(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
   }
 }
 
+void SplitUVRow_16_C(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                     int shift, int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    dst_u[x] = src_uv[0] >> shift;
+    dst_v[x] = src_uv[1] >> shift;
+    src_uv += 2;
+  }
+}
+
+void MergeUVRow_16_C(const uint16* src_u, const uint16* src_v, uint16* dst_uv,
+                     int shift, int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    dst_uv[0] = (uint16)(src_u[x] << shift);
+    dst_uv[1] = (uint16)(src_v[x] << shift);
+    dst_uv += 2;
+  }
+}
+
+void MultiplyRow_16_C(const uint16* src_y, uint16* dst_y, int scale,
+                      int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    dst_y[x] = (uint16)(src_y[x] * scale);
+  }
+}
+
+void DivideRow_16_C(const uint16* src_y, uint16* dst_y, int scale, int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    dst_y[x] = (uint16)(((uint32)(src_y[x]) * (uint32)(scale)) >> 16);
+  }
+}
+
+void Convert16To8Row_C(const uint16* src_y, uint8* dst_y,
+                       const uint16* dither, int shift, int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    int v = src_y[x] + dither[x & 15];
+    if (v > 65535) {
+      v = 65535;
+    }
+    dst_y[x] = clamp255(v >> shift);
+  }
+}
+
 void CopyRow_C(const uint8* src, uint8* dst, int count) {
   memcpy(dst, src, count);
 }
@@ -5533,6 +5533,678 @@ void ARGBLumaColorTableRow_SSSE3(const uint8* src_argb, uint8* dst_argb,
 }
 #endif  // HAS_ARGBLUMACOLORTABLEROW_SSSE3
 
+#ifdef HAS_SPLITUVROW_16_SSE2
+void SplitUVRow_16_SSE2(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                        int shift, int width) {
+  asm volatile (
+    "movd      %4,%%xmm4                       \n"
+    "sub       %1,%2                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    "movdqu    " MEMACCESS2(0x10,0) ",%%xmm1   \n"
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "pshuflw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufhw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufd    $0xd8,%%xmm0,%%xmm0             \n"
+    "pshuflw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufhw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufd    $0xd8,%%xmm1,%%xmm1             \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "punpcklqdq %%xmm1,%%xmm0                  \n"
+    "punpckhqdq %%xmm1,%%xmm2                  \n"
+    "psrlw     %%xmm4,%%xmm0                   \n"
+    "psrlw     %%xmm4,%%xmm2                   \n"
+    "movdqu    %%xmm0," MEMACCESS(1) "         \n"
+    MEMOPMEM(movdqu,xmm2,0x00,1,2,1)           //  movdqu  %%xmm2,(%1,%2)
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x8,%3                         \n"
+    "jg        1b                              \n"
+  : "+r"(src_uv),     // %0
+    "+r"(dst_u),      // %1
+    "+r"(dst_v),      // %2
+    "+r"(width)       // %3
+  : "r"(shift)        // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm4"
+  );
+}
+#endif  // HAS_SPLITUVROW_16_SSE2
+
+#ifdef HAS_SPLITUVROW_16_AVX2
+void SplitUVRow_16_AVX2(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                        int shift, int width) {
+  asm volatile (
+    "vmovd     %4,%%xmm4                       \n"
+    "sub       %1,%2                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "vmovdqu   " MEMACCESS(0) ",%%ymm0         \n"
+    "vmovdqu   " MEMACCESS2(0x20,0) ",%%ymm1   \n"
+    "lea       " MEMLEA(0x40,0) ",%0           \n"
+    "vpshuflw  $0xd8,%%ymm0,%%ymm0             \n"
+    "vpshufhw  $0xd8,%%ymm0,%%ymm0             \n"
+    "vpshufd   $0xd8,%%ymm0,%%ymm0             \n"
+    "vpshuflw  $0xd8,%%ymm1,%%ymm1             \n"
+    "vpshufhw  $0xd8,%%ymm1,%%ymm1             \n"
+    "vpshufd   $0xd8,%%ymm1,%%ymm1             \n"
+    "vpunpckhqdq %%ymm1,%%ymm0,%%ymm2          \n"
+    "vpunpcklqdq %%ymm1,%%ymm0,%%ymm0          \n"
+    "vpermq    $0xd8,%%ymm0,%%ymm0             \n"
+    "vpermq    $0xd8,%%ymm2,%%ymm2             \n"
+    "vpsrlw    %%xmm4,%%ymm0,%%ymm0            \n"
+    "vpsrlw    %%xmm4,%%ymm2,%%ymm2            \n"
+    "vmovdqu   %%ymm0," MEMACCESS(1) "         \n"
+    MEMOPMEM(vmovdqu,ymm2,0x00,1,2,1)          //  vmovdqu %%ymm2,(%1,%2)
+    "lea       " MEMLEA(0x20,1) ",%1           \n"
+    "sub       $0x10,%3                        \n"
+    "jg        1b                              \n"
+    "vzeroupper                                \n"
+  : "+r"(src_uv),     // %0
+    "+r"(dst_u),      // %1
+    "+r"(dst_v),      // %2
+    "+r"(width)       // %3
+  : "r"(shift)        // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm4"
+  );
+}
+#endif  // HAS_SPLITUVROW_16_AVX2
+
+#ifdef HAS_MERGEUVROW_16_SSE2
+void MergeUVRow_16_SSE2(const uint16* src_u, const uint16* src_v,
+                        uint16* dst_uv, int shift, int width) {
+  asm volatile (
+    "movd      %4,%%xmm3                       \n"
+    "sub       %0,%1                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    MEMOPREG(movdqu,0x00,0,1,1,xmm1)           //  movdqu  (%0,%1,1),%%xmm1
+    "lea       " MEMLEA(0x10,0) ",%0           \n"
+    "psllw     %%xmm3,%%xmm0                   \n"
+    "psllw     %%xmm3,%%xmm1                   \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "punpcklwd %%xmm1,%%xmm0                   \n"
+    "punpckhwd %%xmm1,%%xmm2                   \n"
+    "movdqu    %%xmm0," MEMACCESS(2) "         \n"
+    "movdqu    %%xmm2," MEMACCESS2(0x10,2) "   \n"
+    "lea       " MEMLEA(0x20,2) ",%2           \n"
+    "sub       $0x8,%3                         \n"
+    "jg        1b                              \n"
+  : "+r"(src_u),      // %0
+    "+r"(src_v),      // %1
+    "+r"(dst_uv),     // %2
+    "+r"(width)       // %3
+  : "r"(shift)        // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm3"
+  );
+}
+#endif  // HAS_MERGEUVROW_16_SSE2
+
+#ifdef HAS_MERGEUVROW_16_AVX2
+void MergeUVRow_16_AVX2(const uint16* src_u, const uint16* src_v,
+                        uint16* dst_uv, int shift, int width) {
+  asm volatile (
+    "vmovd     %4,%%xmm3                       \n"
+    "sub       %0,%1                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "vmovdqu   " MEMACCESS(0) ",%%ymm0         \n"
+    MEMOPREG(vmovdqu,0x00,0,1,1,ymm1)          //  vmovdqu (%0,%1,1),%%ymm1
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "vpsllw    %%xmm3,%%ymm0,%%ymm0            \n"
+    "vpsllw    %%xmm3,%%ymm1,%%ymm1            \n"
+    "vpunpcklwd %%ymm1,%%ymm0,%%ymm2           \n"
+    "vpunpckhwd %%ymm1,%%ymm0,%%ymm0           \n"
+    "vextractf128 $0x0,%%ymm2," MEMACCESS(2) "   \n"
+    "vextractf128 $0x0,%%ymm0," MEMACCESS2(0x10,2) "\n"
+    "vextractf128 $0x1,%%ymm2," MEMACCESS2(0x20,2) "\n"
+    "vextractf128 $0x1,%%ymm0," MEMACCESS2(0x30,2) "\n"
+    "lea       " MEMLEA(0x40,2) ",%2           \n"
+    "sub       $0x10,%3                        \n"
+    "jg        1b                              \n"
+    "vzeroupper                                \n"
+  : "+r"(src_u),      // %0
+    "+r"(src_v),      // %1
+    "+r"(dst_uv),     // %2
+    "+r"(width)       // %3
+  : "r"(shift)        // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm3"
+  );
+}
+#endif  // HAS_MERGEUVROW_16_AVX2
+
+#ifdef HAS_MULTIPLYROW_16_SSE2
+void MultiplyRow_16_SSE2(const uint16* src_y, uint16* dst_y, int scale,
+                         int width) {
+  asm volatile (
+    "movd      %3,%%xmm3                       \n"
+    "punpcklwd %%xmm3,%%xmm3                   \n"
+    "pshufd    $0x0,%%xmm3,%%xmm3              \n"
+    "sub       %0,%1                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    "movdqu    " MEMACCESS2(0x10,0) ",%%xmm1   \n"
+    "pmullw    %%xmm3,%%xmm0                   \n"
+    "pmullw    %%xmm3,%%xmm1                   \n"
+    MEMOPMEM(movdqu,xmm0,0x00,0,1,1)           //  movdqu  %%xmm0,(%0,%1)
+    MEMOPMEM(movdqu,xmm1,0x10,0,1,1)           //  movdqu  %%xmm1,0x10(%0,%1)
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "sub       $0x10,%2                        \n"
+    "jg        1b                              \n"
+  : "+r"(src_y),      // %0
+    "+r"(dst_y),      // %1
+    "+r"(width)       // %2
+  : "r"(scale)        // %3
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm3"
+  );
+}
+#endif  // HAS_MULTIPLYROW_16_SSE2
+
+#ifdef HAS_MULTIPLYROW_16_AVX2
+void MultiplyRow_16_AVX2(const uint16* src_y, uint16* dst_y, int scale,
+                         int width) {
+  asm volatile (
+    "vmovd     %3,%%xmm3                       \n"
+    "vpbroadcastw %%xmm3,%%ymm3                \n"
+    "sub       %0,%1                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "vmovdqu   " MEMACCESS(0) ",%%ymm0         \n"
+    "vmovdqu   " MEMACCESS2(0x20,0) ",%%ymm1   \n"
+    "vpmullw   %%ymm3,%%ymm0,%%ymm0            \n"
+    "vpmullw   %%ymm3,%%ymm1,%%ymm1            \n"
+    MEMOPMEM(vmovdqu,ymm0,0x00,0,1,1)          //  vmovdqu %%ymm0,(%0,%1)
+    MEMOPMEM(vmovdqu,ymm1,0x20,0,1,1)          //  vmovdqu %%ymm1,0x20(%0,%1)
+    "lea       " MEMLEA(0x40,0) ",%0           \n"
+    "sub       $0x20,%2                        \n"
+    "jg        1b                              \n"
+    "vzeroupper                                \n"
+  : "+r"(src_y),      // %0
+    "+r"(dst_y),      // %1
+    "+r"(width)       // %2
+  : "r"(scale)        // %3
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm3"
+  );
+}
+#endif  // HAS_MULTIPLYROW_16_AVX2
+
+#ifdef HAS_DIVIDEROW_16_SSE2
+void DivideRow_16_SSE2(const uint16* src_y, uint16* dst_y, int scale,
+                       int width) {
+  asm volatile (
+    "movd      %3,%%xmm3                       \n"
+    "punpcklwd %%xmm3,%%xmm3                   \n"
+    "pshufd    $0x0,%%xmm3,%%xmm3              \n"
+    "sub       %0,%1                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    "movdqu    " MEMACCESS2(0x10,0) ",%%xmm1   \n"
+    "pmulhuw   %%xmm3,%%xmm0                   \n"
+    "pmulhuw   %%xmm3,%%xmm1                   \n"
+    MEMOPMEM(movdqu,xmm0,0x00,0,1,1)           //  movdqu  %%xmm0,(%0,%1)
+    MEMOPMEM(movdqu,xmm1,0x10,0,1,1)           //  movdqu  %%xmm1,0x10(%0,%1)
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "sub       $0x10,%2                        \n"
+    "jg        1b                              \n"
+  : "+r"(src_y),      // %0
+    "+r"(dst_y),      // %1
+    "+r"(width)       // %2
+  : "r"(scale)        // %3
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm3"
+  );
+}
+#endif  // HAS_DIVIDEROW_16_SSE2
+
+#ifdef HAS_DIVIDEROW_16_AVX2
+void DivideRow_16_AVX2(const uint16* src_y, uint16* dst_y, int scale,
+                       int width) {
+  asm volatile (
+    "vmovd     %3,%%xmm3                       \n"
+    "vpbroadcastw %%xmm3,%%ymm3                \n"
+    "sub       %0,%1                           \n"
+    LABELALIGN
+  "1:                                          \n"
+    "vmovdqu   " MEMACCESS(0) ",%%ymm0         \n"
+    "vmovdqu   " MEMACCESS2(0x20,0) ",%%ymm1   \n"
+    "vpmulhuw  %%ymm3,%%ymm0,%%ymm0            \n"
+    "vpmulhuw  %%ymm3,%%ymm1,%%ymm1            \n"
+    MEMOPMEM(vmovdqu,ymm0,0x00,0,1,1)          //  vmovdqu %%ymm0,(%0,%1)
+    MEMOPMEM(vmovdqu,ymm1,0x20,0,1,1)          //  vmovdqu %%ymm1,0x20(%0,%1)
+    "lea       " MEMLEA(0x40,0) ",%0           \n"
+    "sub       $0x20,%2                        \n"
+    "jg        1b                              \n"
+    "vzeroupper                                \n"
+  : "+r"(src_y),      // %0
+    "+r"(dst_y),      // %1
+    "+r"(width)       // %2
+  : "r"(scale)        // %3
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm3"
+  );
+}
+#endif  // HAS_DIVIDEROW_16_AVX2
+
+#ifdef HAS_CONVERT16TO8ROW_SSE2
+// Add dither, shift down and pack 16 pixels.  The shift is at least 1, so the
+// words are positive when packuswb saturates them to bytes.
+void Convert16To8Row_SSE2(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width) {
+  asm volatile (
+    "movd      %4,%%xmm2                       \n"
+    "movdqu    " MEMACCESS(3) ",%%xmm3         \n"
+    "movdqu    " MEMACCESS2(0x10,3) ",%%xmm4   \n"
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    "movdqu    " MEMACCESS2(0x10,0) ",%%xmm1   \n"
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "paddusw   %%xmm3,%%xmm0                   \n"
+    "paddusw   %%xmm4,%%xmm1                   \n"
+    "psrlw     %%xmm2,%%xmm0                   \n"
+    "psrlw     %%xmm2,%%xmm1                   \n"
+    "packuswb  %%xmm1,%%xmm0                   \n"
+    "movdqu    %%xmm0," MEMACCESS(1) "         \n"
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x10,%2                        \n"
+    "jg        1b                              \n"
+  : "+r"(src_y),      // %0
+    "+r"(dst_y),      // %1
+    "+r"(width)       // %2
+  : "r"(dither),      // %3
+    "r"(shift)        // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4"
+  );
+}
+#endif  // HAS_CONVERT16TO8ROW_SSE2
+
+#ifdef HAS_CONVERT16TO8ROW_AVX2
+void Convert16To8Row_AVX2(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width) {
+  asm volatile (
+    "vmovd     %4,%%xmm2                       \n"
+    "vmovdqu   " MEMACCESS(3) ",%%ymm3         \n"
+    LABELALIGN
+  "1:                                          \n"
+    "vmovdqu   " MEMACCESS(0) ",%%ymm0         \n"
+    "vmovdqu   " MEMACCESS2(0x20,0) ",%%ymm1   \n"
+    "lea       " MEMLEA(0x40,0) ",%0           \n"
+    "vpaddusw  %%ymm3,%%ymm0,%%ymm0            \n"
+    "vpaddusw  %%ymm3,%%ymm1,%%ymm1            \n"
+    "vpsrlw    %%xmm2,%%ymm0,%%ymm0            \n"
+    "vpsrlw    %%xmm2,%%ymm1,%%ymm1            \n"
+    "vpackuswb %%ymm1,%%ymm0,%%ymm0            \n"
+    "vpermq    $0xd8,%%ymm0,%%ymm0             \n"
+    "vmovdqu   %%ymm0," MEMACCESS(1) "         \n"
+    "lea       " MEMLEA(0x20,1) ",%1           \n"
+    "sub       $0x20,%2                        \n"
+    "jg        1b                              \n"
+    "vzeroupper                                \n"
+  : "+r"(src_y),      // %0
+    "+r"(dst_y),      // %1
+    "+r"(width)       // %2
+  : "r"(dither),      // %3
+    "r"(shift)        // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm3"
+  );
+}
+#endif  // HAS_CONVERT16TO8ROW_AVX2
+
+#if defined(HAS_I210TOAR30ROW_SSE2) || defined(HAS_I210TOAR30ROW_AVX2)
+struct AR30Constants {
+  lvec16 kMask10;   // 0
+  lvec16 kYBias;    // 32
+  lvec16 kUVBias;   // 64
+  lvec16 kYToRgb;   // 96
+  lvec16 kUToB;     // 128
+  lvec16 kUToG;     // 160
+  lvec16 kVToG;     // 192
+  lvec16 kVToR;     // 224
+  lvec16 kMax10;    // 256
+  lvec16 kAlpha;    // 288
+};
+
+// BT.601 10 bit YUV to 10 bit RGB.  Biased samples are scaled by 32 and
+// multiplied with pmulhw, so the coefficients are 2048 times the reference:
+//  R = (Y - 64) * 1.164              + (V - 512) * 1.596
+//  G = (Y - 64) * 1.164 - (U - 512) * 0.391 - (V - 512) * 0.813
+//  B = (Y - 64) * 1.164 + (U - 512) * 2.018
+#define YG10 2384 /* round(1.164 * 2048) */
+#define UB10 4133 /* round(2.018 * 2048) */
+#define UG10 801 /* round(0.391 * 2048) */
+#define VG10 1665 /* round(0.813 * 2048) */
+#define VR10 3269 /* round(1.596 * 2048) */
+#define LVEC16(v) { v, v, v, v, v, v, v, v, v, v, v, v, v, v, v, v }
+
+static AR30Constants SIMD_ALIGNED(kAR30Constants) = {
+  LVEC16(0x3ff),
+  LVEC16(64),
+  LVEC16(512),
+  LVEC16(YG10),
+  LVEC16(UB10),
+  LVEC16(UG10),
+  LVEC16(VG10),
+  LVEC16(VR10),
+  LVEC16(1023),
+  LVEC16(-16384)  // 0xc000: 2 bit alpha in the top word.
+};
+
+#undef LVEC16
+#undef YG10
+#undef UB10
+#undef UG10
+#undef VG10
+#undef VR10
+#endif  // HAS_I210TOAR30ROW_SSE2 || HAS_I210TOAR30ROW_AVX2
+
+#ifdef HAS_I210TOAR30ROW_SSE2
+// 8 pixels of 10 bit 4:2:2 to AR30.
+void OMITFP I210ToAR30Row_SSE2(const uint16* y_buf,
+                               const uint16* u_buf,
+                               const uint16* v_buf,
+                               uint8* dst_ar30,
+                               int width) {
+  asm volatile (
+    "sub       %[u_buf],%[v_buf]               \n"
+    "pxor      %%xmm7,%%xmm7                   \n"
+    LABELALIGN
+  "1:                                          \n"
+    "movq      " MEMACCESS([u_buf]) ",%%xmm1   \n"
+    MEMOPREG(movq, 0x00, [u_buf], [v_buf], 1, xmm2)
+    "lea       " MEMLEA(0x8, [u_buf]) ",%[u_buf] \n"
+    "movdqu    " MEMACCESS([y_buf]) ",%%xmm0   \n"
+    "lea       " MEMLEA(0x10, [y_buf]) ",%[y_buf] \n"
+    "punpcklwd %%xmm1,%%xmm1                   \n"
+    "punpcklwd %%xmm2,%%xmm2                   \n"
+    "pand      " MEMACCESS([c]) ",%%xmm0       \n"
+    "pand      " MEMACCESS([c]) ",%%xmm1       \n"
+    "pand      " MEMACCESS([c]) ",%%xmm2       \n"
+    "psubw     " MEMACCESS2(32, [c]) ",%%xmm0  \n"
+    "psubw     " MEMACCESS2(64, [c]) ",%%xmm1  \n"
+    "psubw     " MEMACCESS2(64, [c]) ",%%xmm2  \n"
+    "psllw     $0x5,%%xmm0                     \n"
+    "psllw     $0x5,%%xmm1                     \n"
+    "psllw     $0x5,%%xmm2                     \n"
+    "pmulhw    " MEMACCESS2(96, [c]) ",%%xmm0  \n"
+    "movdqa    %%xmm1,%%xmm3                   \n"
+    "pmulhw    " MEMACCESS2(128, [c]) ",%%xmm1 \n"
+    "pmulhw    " MEMACCESS2(160, [c]) ",%%xmm3 \n"
+    "movdqa    %%xmm2,%%xmm4                   \n"
+    "pmulhw    " MEMACCESS2(192, [c]) ",%%xmm2 \n"
+    "pmulhw    " MEMACCESS2(224, [c]) ",%%xmm4 \n"
+    "paddw     %%xmm0,%%xmm1                   \n"  // B
+    "paddw     %%xmm0,%%xmm4                   \n"  // R
+    "psubw     %%xmm3,%%xmm0                   \n"
+    "psubw     %%xmm2,%%xmm0                   \n"  // G
+    "pmaxsw    %%xmm7,%%xmm0                   \n"
+    "pmaxsw    %%xmm7,%%xmm1                   \n"
+    "pmaxsw    %%xmm7,%%xmm4                   \n"
+    "pminsw    " MEMACCESS2(256, [c]) ",%%xmm0 \n"
+    "pminsw    " MEMACCESS2(256, [c]) ",%%xmm1 \n"
+    "pminsw    " MEMACCESS2(256, [c]) ",%%xmm4 \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "psllw     $0xa,%%xmm0                     \n"
+    "por       %%xmm0,%%xmm1                   \n"  // B | G << 10
+    "psrlw     $0x6,%%xmm2                     \n"
+    "psllw     $0x4,%%xmm4                     \n"
+    "por       %%xmm2,%%xmm4                   \n"
+    "por       " MEMACCESS2(288, [c]) ",%%xmm4 \n"  // G >> 6 | R << 4 | A
+    "movdqa    %%xmm1,%%xmm0                   \n"
+    "punpcklwd %%xmm4,%%xmm0                   \n"
+    "punpckhwd %%xmm4,%%xmm1                   \n"
+    "movdqu    %%xmm0," MEMACCESS([dst_ar30]) "\n"
+    "movdqu    %%xmm1," MEMACCESS2(0x10, [dst_ar30]) "\n"
+    "lea       " MEMLEA(0x20, [dst_ar30]) ",%[dst_ar30] \n"
+    "sub       $0x8,%[width]                   \n"
+    "jg        1b                              \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [u_buf]"+r"(u_buf),    // %[u_buf]
+    [v_buf]"+r"(v_buf),    // %[v_buf]
+    [dst_ar30]"+r"(dst_ar30),  // %[dst_ar30]
+    [width]"+rm"(width)    // %[width]
+  : [c]"r"(&kAR30Constants.kMask10)  // %[c]
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm7"
+  );
+}
+#endif  // HAS_I210TOAR30ROW_SSE2
+
+#ifdef HAS_I210TOAR30ROW_AVX2
+// 16 pixels of 10 bit 4:2:2 to AR30.
+void OMITFP I210ToAR30Row_AVX2(const uint16* y_buf,
+                               const uint16* u_buf,
+                               const uint16* v_buf,
+                               uint8* dst_ar30,
+                               int width) {
+  asm volatile (
+    "sub       %[u_buf],%[v_buf]               \n"
+    "vpxor     %%ymm7,%%ymm7,%%ymm7            \n"
+    LABELALIGN
+  "1:                                          \n"
+    "vmovdqu   " MEMACCESS([u_buf]) ",%%xmm1   \n"
+    MEMOPREG(vmovdqu, 0x00, [u_buf], [v_buf], 1, xmm2)
+    "lea       " MEMLEA(0x10, [u_buf]) ",%[u_buf] \n"
+    "vpermq    $0xd8,%%ymm1,%%ymm1             \n"
+    "vpermq    $0xd8,%%ymm2,%%ymm2             \n"
+    "vpunpcklwd %%ymm1,%%ymm1,%%ymm1           \n"
+    "vpunpcklwd %%ymm2,%%ymm2,%%ymm2           \n"
+    "vmovdqu   " MEMACCESS([y_buf]) ",%%ymm0   \n"
+    "lea       " MEMLEA(0x20, [y_buf]) ",%[y_buf] \n"
+    "vpand     " MEMACCESS([c]) ",%%ymm0,%%ymm0 \n"
+    "vpand     " MEMACCESS([c]) ",%%ymm1,%%ymm1 \n"
+    "vpand     " MEMACCESS([c]) ",%%ymm2,%%ymm2 \n"
+    "vpsubw    " MEMACCESS2(32, [c]) ",%%ymm0,%%ymm0 \n"
+    "vpsubw    " MEMACCESS2(64, [c]) ",%%ymm1,%%ymm1 \n"
+    "vpsubw    " MEMACCESS2(64, [c]) ",%%ymm2,%%ymm2 \n"
+    "vpsllw    $0x5,%%ymm0,%%ymm0              \n"
+    "vpsllw    $0x5,%%ymm1,%%ymm1              \n"
+    "vpsllw    $0x5,%%ymm2,%%ymm2              \n"
+    "vpmulhw   " MEMACCESS2(96, [c]) ",%%ymm0,%%ymm0 \n"
+    "vpmulhw   " MEMACCESS2(160, [c]) ",%%ymm1,%%ymm3 \n"
+    "vpmulhw   " MEMACCESS2(128, [c]) ",%%ymm1,%%ymm1 \n"
+    "vpmulhw   " MEMACCESS2(224, [c]) ",%%ymm2,%%ymm4 \n"
+    "vpmulhw   " MEMACCESS2(192, [c]) ",%%ymm2,%%ymm2 \n"
+    "vpaddw    %%ymm0,%%ymm1,%%ymm1            \n"  // B
+    "vpaddw    %%ymm0,%%ymm4,%%ymm4            \n"  // R
+    "vpsubw    %%ymm3,%%ymm0,%%ymm0            \n"
+    "vpsubw    %%ymm2,%%ymm0,%%ymm0            \n"  // G
+    "vpmaxsw   %%ymm7,%%ymm0,%%ymm0            \n"
+    "vpmaxsw   %%ymm7,%%ymm1,%%ymm1            \n"
+    "vpmaxsw   %%ymm7,%%ymm4,%%ymm4            \n"
+    "vpminsw   " MEMACCESS2(256, [c]) ",%%ymm0,%%ymm0 \n"
+    "vpminsw   " MEMACCESS2(256, [c]) ",%%ymm1,%%ymm1 \n"
+    "vpminsw   " MEMACCESS2(256, [c]) ",%%ymm4,%%ymm4 \n"
+    "vpsllw    $0xa,%%ymm0,%%ymm2              \n"
+    "vpor      %%ymm2,%%ymm1,%%ymm1            \n"  // B | G << 10
+    "vpsrlw    $0x6,%%ymm0,%%ymm0              \n"
+    "vpsllw    $0x4,%%ymm4,%%ymm4              \n"
+    "vpor      %%ymm0,%%ymm4,%%ymm4            \n"
+    "vpor      " MEMACCESS2(288, [c]) ",%%ymm4,%%ymm4 \n"  // G >> 6 | R << 4 | A
+    "vpunpcklwd %%ymm4,%%ymm1,%%ymm0           \n"
+    "vpunpckhwd %%ymm4,%%ymm1,%%ymm1           \n"
+    "vperm2i128 $0x20,%%ymm1,%%ymm0,%%ymm2     \n"
+    "vperm2i128 $0x31,%%ymm1,%%ymm0,%%ymm0     \n"
+    "vmovdqu   %%ymm2," MEMACCESS([dst_ar30]) "\n"
+    "vmovdqu   %%ymm0," MEMACCESS2(0x20, [dst_ar30]) "\n"
+    "lea       " MEMLEA(0x40, [dst_ar30]) ",%[dst_ar30] \n"
+    "sub       $0x10,%[width]                  \n"
+    "jg        1b                              \n"
+    "vzeroupper                                \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [u_buf]"+r"(u_buf),    // %[u_buf]
+    [v_buf]"+r"(v_buf),    // %[v_buf]
+    [dst_ar30]"+r"(dst_ar30),  // %[dst_ar30]
+    [width]"+rm"(width)    // %[width]
+  : [c]"r"(&kAR30Constants.kMask10)  // %[c]
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm7"
+  );
+}
+#endif  // HAS_I210TOAR30ROW_AVX2
+
+#ifdef HAS_INTERPOLATEROW_16_SSE2
+// Bilinear filter 8x2 -> 8x1.  Samples are biased by 0x8000 so pmaddwd can
+// weight them as signed words; the bias is a multiple of 256 and drops out
+// exactly after the shift.
+void InterpolateRow_16_SSE2(uint16* dst_ptr, const uint16* src_ptr,
+                            ptrdiff_t src_stride, int dst_width,
+                            int source_y_fraction) {
+  asm volatile (
+    "sub       %1,%0                           \n"
+    "cmp       $0x0,%3                         \n"
+    "je        100f                            \n"
+    "cmp       $0x80,%3                        \n"
+    "je        50f                             \n"
+
+    "movd      %3,%%xmm5                       \n"
+    "neg       %3                              \n"
+    "add       $0x100,%3                       \n"
+    "movd      %3,%%xmm4                       \n"
+    "punpcklwd %%xmm5,%%xmm4                   \n"
+    "pshufd    $0x0,%%xmm4,%%xmm4              \n"
+    "pcmpeqb   %%xmm5,%%xmm5                   \n"
+    "psllw     $0xf,%%xmm5                     \n"
+
+    // General purpose row blend.
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(1) ",%%xmm0         \n"
+    MEMOPREG(movdqu,0x00,1,4,2,xmm1)           //  movdqu  (%1,%4,2),%%xmm1
+    "pxor      %%xmm5,%%xmm0                   \n"
+    "pxor      %%xmm5,%%xmm1                   \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "punpcklwd %%xmm1,%%xmm0                   \n"
+    "punpckhwd %%xmm1,%%xmm2                   \n"
+    "pmaddwd   %%xmm4,%%xmm0                   \n"
+    "pmaddwd   %%xmm4,%%xmm2                   \n"
+    "psrad     $0x8,%%xmm0                     \n"
+    "psrad     $0x8,%%xmm2                     \n"
+    "packssdw  %%xmm2,%%xmm0                   \n"
+    "pxor      %%xmm5,%%xmm0                   \n"
+    MEMOPMEM(movdqu,xmm0,0x00,1,0,1)           //  movdqu  %%xmm0,(%1,%0,1)
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x8,%2                         \n"
+    "jg        1b                              \n"
+    "jmp       99f                             \n"
+
+    // Blend 50 / 50.
+    LABELALIGN
+  "50:                                         \n"
+    "movdqu    " MEMACCESS(1) ",%%xmm0         \n"
+    MEMOPREG(movdqu,0x00,1,4,2,xmm1)           //  movdqu  (%1,%4,2),%%xmm1
+    "pavgw     %%xmm1,%%xmm0                   \n"
+    MEMOPMEM(movdqu,xmm0,0x00,1,0,1)           //  movdqu  %%xmm0,(%1,%0,1)
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x8,%2                         \n"
+    "jg        50b                             \n"
+    "jmp       99f                             \n"
+
+    // Blend 100 / 0 - Copy row unchanged.
+    LABELALIGN
+  "100:                                        \n"
+    "movdqu    " MEMACCESS(1) ",%%xmm0         \n"
+    MEMOPMEM(movdqu,xmm0,0x00,1,0,1)           //  movdqu  %%xmm0,(%1,%0,1)
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x8,%2                         \n"
+    "jg        100b                            \n"
+
+  "99:                                         \n"
+  : "+r"(dst_ptr),    // %0
+    "+r"(src_ptr),    // %1
+    "+r"(dst_width),  // %2
+    "+r"(source_y_fraction)  // %3
+  : "r"((intptr_t)(src_stride))  // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm4", "xmm5"
+  );
+}
+#endif  // HAS_INTERPOLATEROW_16_SSE2
+
+#ifdef HAS_INTERPOLATEROW_16_AVX2
+// Bilinear filter 16x2 -> 16x1
+void InterpolateRow_16_AVX2(uint16* dst_ptr, const uint16* src_ptr,
+                            ptrdiff_t src_stride, int dst_width,
+                            int source_y_fraction) {
+  asm volatile (
+    "sub       %1,%0                           \n"
+    "cmp       $0x0,%3                         \n"
+    "je        100f                            \n"
+    "cmp       $0x80,%3                        \n"
+    "je        50f                             \n"
+
+    "vmovd     %3,%%xmm5                       \n"
+    "neg       %3                              \n"
+    "add       $0x100,%3                       \n"
+    "vmovd     %3,%%xmm4                       \n"
+    "vpunpcklwd %%xmm5,%%xmm4,%%xmm4           \n"
+    "vpbroadcastd %%xmm4,%%ymm4                \n"
+    "vpcmpeqb  %%ymm5,%%ymm5,%%ymm5            \n"
+    "vpsllw    $0xf,%%ymm5,%%ymm5              \n"
+
+    // General purpose row blend.
+    LABELALIGN
+  "1:                                          \n"
+    "vmovdqu   " MEMACCESS(1) ",%%ymm0         \n"
+    MEMOPREG(vmovdqu,0x00,1,4,2,ymm1)          //  vmovdqu (%1,%4,2),%%ymm1
+    "vpxor     %%ymm5,%%ymm0,%%ymm0            \n"
+    "vpxor     %%ymm5,%%ymm1,%%ymm1            \n"
+    "vpunpckhwd %%ymm1,%%ymm0,%%ymm2           \n"
+    "vpunpcklwd %%ymm1,%%ymm0,%%ymm0           \n"
+    "vpmaddwd  %%ymm4,%%ymm0,%%ymm0            \n"
+    "vpmaddwd  %%ymm4,%%ymm2,%%ymm2            \n"
+    "vpsrad    $0x8,%%ymm0,%%ymm0              \n"
+    "vpsrad    $0x8,%%ymm2,%%ymm2              \n"
+    "vpackssdw %%ymm2,%%ymm0,%%ymm0            \n"
+    "vpxor     %%ymm5,%%ymm0,%%ymm0            \n"
+    MEMOPMEM(vmovdqu,ymm0,0x00,1,0,1)          //  vmovdqu %%ymm0,(%1,%0,1)
+    "lea       " MEMLEA(0x20,1) ",%1           \n"
+    "sub       $0x10,%2                        \n"
+    "jg        1b                              \n"
+    "jmp       99f                             \n"
+
+    // Blend 50 / 50.
+    LABELALIGN
+  "50:                                         \n"
+    "vmovdqu   " MEMACCESS(1) ",%%ymm0         \n"
+    VMEMOPREG(vpavgw,0x00,1,4,2,ymm0,ymm0)     // vpavgw (%1,%4,2),%%ymm0,%%ymm0
+    MEMOPMEM(vmovdqu,ymm0,0x00,1,0,1)          //  vmovdqu %%ymm0,(%1,%0,1)
+    "lea       " MEMLEA(0x20,1) ",%1           \n"
+    "sub       $0x10,%2                        \n"
+    "jg        50b                             \n"
+    "jmp       99f                             \n"
+
+    // Blend 100 / 0 - Copy row unchanged.
+    LABELALIGN
+  "100:                                        \n"
+    "vmovdqu   " MEMACCESS(1) ",%%ymm0         \n"
+    MEMOPMEM(vmovdqu,ymm0,0x00,1,0,1)          //  vmovdqu %%ymm0,(%1,%0,1)
+    "lea       " MEMLEA(0x20,1) ",%1           \n"
+    "sub       $0x10,%2                        \n"
+    "jg        100b                            \n"
+
+  "99:                                         \n"
+    "vzeroupper                                \n"
+  : "+r"(dst_ptr),    // %0
+    "+r"(src_ptr),    // %1
+    "+r"(dst_width),  // %2
+    "+r"(source_y_fraction)  // %3
+  : "r"((intptr_t)(src_stride))  // %4
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm4", "xmm5"
+  );
+}
+#endif  // HAS_INTERPOLATEROW_16_AVX2
+
 #endif  // defined(__x86_64__) || defined(__i386__)
 
 #ifdef __cplusplus
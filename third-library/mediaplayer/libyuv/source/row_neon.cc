@@ -3076,6 +3076,205 @@ void SobelYRow_NEON(const uint8* src_y0, const uint8* src_y1,
   : "cc", "memory", "q0", "q1"  // Clobber List
   );
 }
+// Split 8 16 bit UV pairs, shifting right by shift.
+void SplitUVRow_16_NEON(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                        int shift, int width) {
+  int neg_shift = -shift;
+  asm volatile (
+    "vdup.16    q2, %4                         \n"
+    ".p2align   2                              \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "vld2.16    {q0, q1}, [%0]!                \n"  // load 8 UV pairs
+    "subs       %3, %3, #8                     \n"  // 8 processed per loop
+    "vshl.u16   q0, q0, q2                     \n"
+    "vshl.u16   q1, q1, q2                     \n"
+    MEMACCESS(1)
+    "vst1.16    {q0}, [%1]!                    \n"  // store U
+    MEMACCESS(2)
+    "vst1.16    {q1}, [%2]!                    \n"  // store V
+    "bgt        1b                             \n"
+    : "+r"(src_uv),  // %0
+      "+r"(dst_u),   // %1
+      "+r"(dst_v),   // %2
+      "+r"(width)    // %3  // Output registers
+    : "r"(neg_shift) // %4  // Input registers
+    : "cc", "memory", "q0", "q1", "q2"  // Clobber List
+  );
+}
+
+// Interleave 8 U and V samples, shifting left by shift.
+void MergeUVRow_16_NEON(const uint16* src_u, const uint16* src_v,
+                        uint16* dst_uv, int shift, int width) {
+  asm volatile (
+    "vdup.16    q2, %4                         \n"
+    ".p2align   2                              \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "vld1.16    {q0}, [%0]!                    \n"  // load U
+    MEMACCESS(1)
+    "vld1.16    {q1}, [%1]!                    \n"  // load V
+    "subs       %3, %3, #8                     \n"  // 8 processed per loop
+    "vshl.u16   q0, q0, q2                     \n"
+    "vshl.u16   q1, q1, q2                     \n"
+    MEMACCESS(2)
+    "vst2.16    {q0, q1}, [%2]!                \n"  // store 8 pairs of UV
+    "bgt        1b                             \n"
+    : "+r"(src_u),   // %0
+      "+r"(src_v),   // %1
+      "+r"(dst_uv),  // %2
+      "+r"(width)    // %3  // Output registers
+    : "r"(shift)     // %4  // Input registers
+    : "cc", "memory", "q0", "q1", "q2"  // Clobber List
+  );
+}
+
+void MultiplyRow_16_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                         int width) {
+  asm volatile (
+    "vdup.16    q2, %3                         \n"
+    ".p2align   2                              \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "vld1.16    {q0, q1}, [%0]!                \n"
+    "subs       %2, %2, #16                    \n"  // 16 processed per loop
+    "vmul.i16   q0, q0, q2                     \n"
+    "vmul.i16   q1, q1, q2                     \n"
+    MEMACCESS(1)
+    "vst1.16    {q0, q1}, [%1]!                \n"
+    "bgt        1b                             \n"
+    : "+r"(src_y),   // %0
+      "+r"(dst_y),   // %1
+      "+r"(width)    // %2  // Output registers
+    : "r"(scale)     // %3  // Input registers
+    : "cc", "memory", "q0", "q1", "q2"  // Clobber List
+  );
+}
+
+void DivideRow_16_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                       int width) {
+  asm volatile (
+    "vdup.16    d4, %3                         \n"
+    ".p2align   2                              \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "vld1.16    {q0, q1}, [%0]!                \n"
+    "subs       %2, %2, #16                    \n"  // 16 processed per loop
+    "vmull.u16  q8, d0, d4                     \n"
+    "vmull.u16  q9, d1, d4                     \n"
+    "vmull.u16  q10, d2, d4                    \n"
+    "vmull.u16  q11, d3, d4                    \n"
+    "vshrn.u32  d0, q8, #16                    \n"
+    "vshrn.u32  d1, q9, #16                    \n"
+    "vshrn.u32  d2, q10, #16                   \n"
+    "vshrn.u32  d3, q11, #16                   \n"
+    MEMACCESS(1)
+    "vst1.16    {q0, q1}, [%1]!                \n"
+    "bgt        1b                             \n"
+    : "+r"(src_y),   // %0
+      "+r"(dst_y),   // %1
+      "+r"(width)    // %2  // Output registers
+    : "r"(scale)     // %3  // Input registers
+    : "cc", "memory", "q0", "q1", "q2", "q8", "q9", "q10", "q11"
+  );
+}
+
+// Add dither, shift down and saturate 16 pixels to bytes.
+void Convert16To8Row_NEON(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width) {
+  int neg_shift = -shift;
+  asm volatile (
+    "vdup.16    q2, %4                         \n"
+    MEMACCESS(3)
+    "vld1.16    {q8, q9}, [%3]                 \n"  // load dither row
+    ".p2align   2                              \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "vld1.16    {q0, q1}, [%0]!                \n"
+    "subs       %2, %2, #16                    \n"  // 16 processed per loop
+    "vqadd.u16  q0, q0, q8                     \n"
+    "vqadd.u16  q1, q1, q9                     \n"
+    "vshl.u16   q0, q0, q2                     \n"
+    "vshl.u16   q1, q1, q2                     \n"
+    "vqmovn.u16 d0, q0                         \n"
+    "vqmovn.u16 d1, q1                         \n"
+    MEMACCESS(1)
+    "vst1.8     {q0}, [%1]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(src_y),   // %0
+      "+r"(dst_y),   // %1
+      "+r"(width)    // %2  // Output registers
+    : "r"(dither),   // %3
+      "r"(neg_shift) // %4  // Input registers
+    : "cc", "memory", "q0", "q1", "q2", "q8", "q9"  // Clobber List
+  );
+}
+
+// Bilinear filter 8x2 -> 8x1.  The stride is in pixels.
+void InterpolateRow_16_NEON(uint16* dst_ptr,
+                            const uint16* src_ptr, ptrdiff_t src_stride,
+                            int dst_width, int source_y_fraction) {
+  asm volatile (
+    "cmp        %4, #0                         \n"
+    "beq        100f                           \n"
+    "add        %2, %1, %2, lsl #1             \n"
+    "cmp        %4, #128                       \n"
+    "beq        50f                            \n"
+
+    "vdup.16    d5, %4                         \n"
+    "rsb        %4, #256                       \n"
+    "vdup.16    d4, %4                         \n"
+    // General purpose row blend.
+  "1:                                          \n"
+    MEMACCESS(1)
+    "vld1.16    {q0}, [%1]!                    \n"
+    MEMACCESS(2)
+    "vld1.16    {q1}, [%2]!                    \n"
+    "subs       %3, %3, #8                     \n"
+    "vmull.u16  q13, d0, d4                    \n"
+    "vmull.u16  q14, d1, d4                    \n"
+    "vmlal.u16  q13, d2, d5                    \n"
+    "vmlal.u16  q14, d3, d5                    \n"
+    "vshrn.u32  d0, q13, #8                    \n"
+    "vshrn.u32  d1, q14, #8                    \n"
+    MEMACCESS(0)
+    "vst1.16    {q0}, [%0]!                    \n"
+    "bgt        1b                             \n"
+    "b          99f                            \n"
+
+    // Blend 50 / 50.
+  "50:                                         \n"
+    MEMACCESS(1)
+    "vld1.16    {q0}, [%1]!                    \n"
+    MEMACCESS(2)
+    "vld1.16    {q1}, [%2]!                    \n"
+    "subs       %3, %3, #8                     \n"
+    "vrhadd.u16 q0, q0, q1                     \n"
+    MEMACCESS(0)
+    "vst1.16    {q0}, [%0]!                    \n"
+    "bgt        50b                            \n"
+    "b          99f                            \n"
+
+    // Blend 100 / 0 - Copy row unchanged.
+  "100:                                        \n"
+    MEMACCESS(1)
+    "vld1.16    {q0}, [%1]!                    \n"
+    "subs       %3, %3, #8                     \n"
+    MEMACCESS(0)
+    "vst1.16    {q0}, [%0]!                    \n"
+    "bgt        100b                           \n"
+
+  "99:                                         \n"
+  : "+r"(dst_ptr),          // %0
+    "+r"(src_ptr),          // %1
+    "+r"(src_stride),       // %2
+    "+r"(dst_width),        // %3
+    "+r"(source_y_fraction) // %4
+  :
+  : "cc", "memory", "q0", "q1", "d4", "d5", "q13", "q14"
+  );
+}
+
 #endif  // defined(__ARM_NEON__) && !defined(__aarch64__)
 
 #ifdef __cplusplus
@@ -3079,6 +3079,214 @@ void SobelYRow_NEON(const uint8* src_y0, const uint8* src_y1,
   );
 }
 #endif  // HAS_SOBELYROW_NEON
+#ifdef HAS_SPLITUVROW_16_NEON
+// Split 8 16 bit UV pairs, shifting right by shift.
+void SplitUVRow_16_NEON(const uint16* src_uv, uint16* dst_u, uint16* dst_v,
+                        int shift, int width) {
+  int neg_shift = -shift;
+  asm volatile (
+    "dup        v2.8h, %w4                     \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "ld2        {v0.8h, v1.8h}, [%0], #32      \n"  // load 8 UV pairs
+    "subs       %w3, %w3, #8                   \n"  // 8 processed per loop
+    "ushl       v0.8h, v0.8h, v2.8h            \n"
+    "ushl       v1.8h, v1.8h, v2.8h            \n"
+    MEMACCESS(1)
+    "st1        {v0.8h}, [%1], #16             \n"  // store U
+    MEMACCESS(2)
+    "st1        {v1.8h}, [%2], #16             \n"  // store V
+    "b.gt       1b                             \n"
+  : "+r"(src_uv),    // %0
+    "+r"(dst_u),     // %1
+    "+r"(dst_v),     // %2
+    "+r"(width)      // %3
+  : "r"(neg_shift)   // %4
+  : "cc", "memory", "v0", "v1", "v2"  // Clobber List
+  );
+}
+#endif  // HAS_SPLITUVROW_16_NEON
+
+#ifdef HAS_MERGEUVROW_16_NEON
+// Interleave 8 U and V samples, shifting left by shift.
+void MergeUVRow_16_NEON(const uint16* src_u, const uint16* src_v,
+                        uint16* dst_uv, int shift, int width) {
+  asm volatile (
+    "dup        v2.8h, %w4                     \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "ld1        {v0.8h}, [%0], #16             \n"  // load U
+    MEMACCESS(1)
+    "ld1        {v1.8h}, [%1], #16             \n"  // load V
+    "subs       %w3, %w3, #8                   \n"  // 8 processed per loop
+    "ushl       v0.8h, v0.8h, v2.8h            \n"
+    "ushl       v1.8h, v1.8h, v2.8h            \n"
+    MEMACCESS(2)
+    "st2        {v0.8h, v1.8h}, [%2], #32      \n"  // store 8 pairs of UV
+    "b.gt       1b                             \n"
+  : "+r"(src_u),     // %0
+    "+r"(src_v),     // %1
+    "+r"(dst_uv),    // %2
+    "+r"(width)      // %3
+  : "r"(shift)       // %4
+  : "cc", "memory", "v0", "v1", "v2"  // Clobber List
+  );
+}
+#endif  // HAS_MERGEUVROW_16_NEON
+
+#ifdef HAS_MULTIPLYROW_16_NEON
+void MultiplyRow_16_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                         int width) {
+  asm volatile (
+    "dup        v2.8h, %w3                     \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "ld1        {v0.8h, v1.8h}, [%0], #32      \n"
+    "subs       %w2, %w2, #16                  \n"  // 16 processed per loop
+    "mul        v0.8h, v0.8h, v2.8h            \n"
+    "mul        v1.8h, v1.8h, v2.8h            \n"
+    MEMACCESS(1)
+    "st1        {v0.8h, v1.8h}, [%1], #32      \n"
+    "b.gt       1b                             \n"
+  : "+r"(src_y),     // %0
+    "+r"(dst_y),     // %1
+    "+r"(width)      // %2
+  : "r"(scale)       // %3
+  : "cc", "memory", "v0", "v1", "v2"  // Clobber List
+  );
+}
+#endif  // HAS_MULTIPLYROW_16_NEON
+
+#ifdef HAS_DIVIDEROW_16_NEON
+void DivideRow_16_NEON(const uint16* src_y, uint16* dst_y, int scale,
+                       int width) {
+  asm volatile (
+    "dup        v2.8h, %w3                     \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "ld1        {v0.8h, v1.8h}, [%0], #32      \n"
+    "subs       %w2, %w2, #16                  \n"  // 16 processed per loop
+    "umull      v3.4s, v0.4h, v2.4h            \n"
+    "umull2     v4.4s, v0.8h, v2.8h            \n"
+    "umull      v5.4s, v1.4h, v2.4h            \n"
+    "umull2     v6.4s, v1.8h, v2.8h            \n"
+    "shrn       v0.4h, v3.4s, #16              \n"
+    "shrn2      v0.8h, v4.4s, #16              \n"
+    "shrn       v1.4h, v5.4s, #16              \n"
+    "shrn2      v1.8h, v6.4s, #16              \n"
+    MEMACCESS(1)
+    "st1        {v0.8h, v1.8h}, [%1], #32      \n"
+    "b.gt       1b                             \n"
+  : "+r"(src_y),     // %0
+    "+r"(dst_y),     // %1
+    "+r"(width)      // %2
+  : "r"(scale)       // %3
+  : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6"  // Clobber List
+  );
+}
+#endif  // HAS_DIVIDEROW_16_NEON
+
+#ifdef HAS_CONVERT16TO8ROW_NEON
+// Add dither, shift down and saturate 16 pixels to bytes.
+void Convert16To8Row_NEON(const uint16* src_y, uint8* dst_y,
+                          const uint16* dither, int shift, int width) {
+  int neg_shift = -shift;
+  asm volatile (
+    "dup        v2.8h, %w4                     \n"
+    MEMACCESS(3)
+    "ld1        {v3.8h, v4.8h}, [%3]           \n"  // load dither row
+  "1:                                          \n"
+    MEMACCESS(0)
+    "ld1        {v0.8h, v1.8h}, [%0], #32      \n"
+    "subs       %w2, %w2, #16                  \n"  // 16 processed per loop
+    "uqadd      v0.8h, v0.8h, v3.8h            \n"
+    "uqadd      v1.8h, v1.8h, v4.8h            \n"
+    "ushl       v0.8h, v0.8h, v2.8h            \n"
+    "ushl       v1.8h, v1.8h, v2.8h            \n"
+    "uqxtn      v0.8b, v0.8h                   \n"
+    "uqxtn2     v0.16b, v1.8h                  \n"
+    MEMACCESS(1)
+    "st1        {v0.16b}, [%1], #16            \n"
+    "b.gt       1b                             \n"
+  : "+r"(src_y),     // %0
+    "+r"(dst_y),     // %1
+    "+r"(width)      // %2
+  : "r"(dither),     // %3
+    "r"(neg_shift)   // %4
+  : "cc", "memory", "v0", "v1", "v2", "v3", "v4"  // Clobber List
+  );
+}
+#endif  // HAS_CONVERT16TO8ROW_NEON
+
+#ifdef HAS_INTERPOLATEROW_16_NEON
+// Bilinear filter 8x2 -> 8x1.  The stride is in pixels.
+void InterpolateRow_16_NEON(uint16* dst_ptr,
+                            const uint16* src_ptr, ptrdiff_t src_stride,
+                            int dst_width, int source_y_fraction) {
+  int y1_fraction = source_y_fraction;
+  int y0_fraction = 256 - y1_fraction;
+  const uint16* src_ptr1 = src_ptr + src_stride;
+  asm volatile (
+    "cmp        %w4, #0                        \n"
+    "b.eq       100f                           \n"
+    "cmp        %w4, #128                      \n"
+    "b.eq       50f                            \n"
+
+    "dup        v5.8h, %w4                     \n"
+    "dup        v4.8h, %w5                     \n"
+    // General purpose row blend.
+  "1:                                          \n"
+    MEMACCESS(1)
+    "ld1        {v0.8h}, [%1], #16             \n"
+    MEMACCESS(2)
+    "ld1        {v1.8h}, [%2], #16             \n"
+    "subs       %w3, %w3, #8                   \n"
+    "umull      v2.4s, v0.4h, v4.4h            \n"
+    "umull2     v3.4s, v0.8h, v4.8h            \n"
+    "umlal      v2.4s, v1.4h, v5.4h            \n"
+    "umlal2     v3.4s, v1.8h, v5.8h            \n"
+    "shrn       v0.4h, v2.4s, #8               \n"
+    "shrn2      v0.8h, v3.4s, #8               \n"
+    MEMACCESS(0)
+    "st1        {v0.8h}, [%0], #16             \n"
+    "b.gt       1b                             \n"
+    "b          99f                            \n"
+
+    // Blend 50 / 50.
+  "50:                                         \n"
+    MEMACCESS(1)
+    "ld1        {v0.8h}, [%1], #16             \n"
+    MEMACCESS(2)
+    "ld1        {v1.8h}, [%2], #16             \n"
+    "subs       %w3, %w3, #8                   \n"
+    "urhadd     v0.8h, v0.8h, v1.8h            \n"
+    MEMACCESS(0)
+    "st1        {v0.8h}, [%0], #16             \n"
+    "b.gt       50b                            \n"
+    "b          99f                            \n"
+
+    // Blend 100 / 0 - Copy row unchanged.
+  "100:                                        \n"
+    MEMACCESS(1)
+    "ld1        {v0.8h}, [%1], #16             \n"
+    "subs       %w3, %w3, #8                   \n"
+    MEMACCESS(0)
+    "st1        {v0.8h}, [%0], #16             \n"
+    "b.gt       100b                           \n"
+
+  "99:                                         \n"
+  : "+r"(dst_ptr),          // %0
+    "+r"(src_ptr),          // %1
+    "+r"(src_ptr1),         // %2
+    "+r"(dst_width),        // %3
+    "+r"(y1_fraction),      // %4
+    "+r"(y0_fraction)       // %5
+  :
+  : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5"
+  );
+}
+#endif  // HAS_INTERPOLATEROW_16_NEON
+
 #endif  // !defined(LIBYUV_DISABLE_NEON) && defined(__aarch64__)
 
 #ifdef __cplusplus
@@ -29,6 +29,13 @@ static __inline int Abs(int v) {
 
 #define SUBSAMPLE(v, a, s) (v < 0) ? (-((-v + a) >> s)) : ((v + a) >> s)
 
+// Source y of destination row clip_y, for scalers that step y by dy and
+// clamp it to max_y.  Matches the y reached by stepping from row 0.
+static __inline int ClipStartY(int y, int dy, int clip_y, int max_y) {
+  int64 clipf = (int64)(y) + (int64)(clip_y) * dy;
+  return clipf > max_y ? max_y : (int)(clipf);
+}
+
 // Scale plane, 1/2
 // This is an optimized version for scaling down a plane to 1/2 of
 // its original size.
@@ -732,7 +739,8 @@ static void ScaleAddCols1_16_C(int dst_width, int boxheight, int x, int dx,
 static void ScalePlaneBox(int src_width, int src_height,
                           int dst_width, int dst_height,
                           int src_stride, int dst_stride,
-                          const uint8* src_ptr, uint8* dst_ptr) {
+                          const uint8* src_ptr, uint8* dst_ptr,
+                          int clip_y, int clip_height) {
   int j, k;
   // Initial source x/y coordinate and step values as 16.16 fixed point.
   int x = 0;
@@ -743,6 +751,9 @@ static void ScalePlaneBox(int src_width, int src_height,
   ScaleSlope(src_width, src_height, dst_width, dst_height, kFilterBox,
              &x, &y, &dx, &dy);
   src_width = Abs(src_width);
+  if (clip_y) {
+    y = ClipStartY(y, dy, clip_y, max_y);
+  }
   {
     // Allocate a row buffer of uint16.
     align_buffer_64(row16, src_width * 2);
@@ -777,7 +788,7 @@ static void ScalePlaneBox(int src_width, int src_height,
     }
 #endif
 
-    for (j = 0; j < dst_height; ++j) {
+    for (j = 0; j < clip_height; ++j) {
       int boxheight;
       int iy = y >> 16;
       const uint8* src = src_ptr + iy * src_stride;
@@ -853,6 +864,7 @@ void ScalePlaneBilinearDown(int src_width, int src_height,
                             int dst_width, int dst_height,
                             int src_stride, int dst_stride,
                             const uint8* src_ptr, uint8* dst_ptr,
+                            int clip_y, int clip_height,
                             enum FilterMode filtering) {
   // Initial source x/y coordinate and step values as 16.16 fixed point.
   int x = 0;
@@ -933,8 +945,11 @@ void ScalePlaneBilinearDown(int src_width, int src_height,
   if (y > max_y) {
     y = max_y;
   }
+  if (clip_y) {
+    y = ClipStartY(y, dy, clip_y, max_y);
+  }
 
-  for (j = 0; j < dst_height; ++j) {
+  for (j = 0; j < clip_height; ++j) {
     int yi = y >> 16;
     const uint8* src = src_ptr + yi * src_stride;
     if (filtering == kFilterLinear) {
@@ -1054,6 +1069,7 @@ void ScalePlaneBilinearUp(int src_width, int src_height,
                           int dst_width, int dst_height,
                           int src_stride, int dst_stride,
                           const uint8* src_ptr, uint8* dst_ptr,
+                          int clip_y, int clip_height,
                           enum FilterMode filtering) {
   int j;
   // Initial source x/y coordinate and step values as 16.16 fixed point.
@@ -1141,6 +1157,9 @@ void ScalePlaneBilinearUp(int src_width, int src_height,
   if (y > max_y) {
     y = max_y;
   }
+  if (clip_y) {
+    y = ClipStartY(y, dy, clip_y, max_y);
+  }
   {
     int yi = y >> 16;
     const uint8* src = src_ptr + yi * src_stride;
@@ -1160,7 +1179,7 @@ void ScalePlaneBilinearUp(int src_width, int src_height,
     ScaleFilterCols(rowptr + rowstride, src, dst_width, x, dx);
     src += src_stride;
 
-    for (j = 0; j < dst_height; ++j) {
+    for (j = 0; j < clip_height; ++j) {
       yi = y >> 16;
       if (yi != lasty) {
         if (y > max_y) {
@@ -1328,7 +1347,8 @@ void ScalePlaneBilinearUp_16(int src_width, int src_height,
 static void ScalePlaneSimple(int src_width, int src_height,
                              int dst_width, int dst_height,
                              int src_stride, int dst_stride,
-                             const uint8* src_ptr, uint8* dst_ptr) {
+                             const uint8* src_ptr, uint8* dst_ptr,
+                             int clip_y, int clip_height) {
   int i;
   void (*ScaleCols)(uint8* dst_ptr, const uint8* src_ptr,
       int dst_width, int x, int dx) = ScaleCols_C;
@@ -1350,7 +1370,8 @@ static void ScalePlaneSimple(int src_width, int src_height,
 #endif
   }
 
-  for (i = 0; i < dst_height; ++i) {
+  y += clip_y * dy;
+  for (i = 0; i < clip_height; ++i) {
     ScaleCols(dst_ptr, src_ptr + (y >> 16) * src_stride, dst_width, x, dx);
     dst_ptr += dst_stride;
     y += dy;
@@ -1393,12 +1414,14 @@ static void ScalePlaneSimple_16(int src_width, int src_height,
 // Scale a plane.
 // This function dispatches to a specialized scaler based on scale factor.
 
-LIBYUV_API
-void ScalePlane(const uint8* src, int src_stride,
-                int src_width, int src_height,
-                uint8* dst, int dst_stride,
-                int dst_width, int dst_height,
-                enum FilterMode filtering) {
+// Scale rows [clip_y, clip_y + clip_height) of the destination, exactly as
+// a full ScalePlane would produce them.  dst points at row 0.
+static void ScalePlaneClipRows(const uint8* src, int src_stride,
+                               int src_width, int src_height,
+                               uint8* dst, int dst_stride,
+                               int dst_width, int dst_height,
+                               int clip_y, int clip_height,
+                               enum FilterMode filtering) {
   // Simplify filtering when possible.
   filtering = ScaleFilterReduce(src_width, src_height,
                                 dst_width, dst_height, filtering);
@@ -1414,66 +1437,116 @@ void ScalePlane(const uint8* src, int src_stride,
   // For example, all the 1/2 scalings will use ScalePlaneDown2()
   if (dst_width == src_width && dst_height == src_height) {
     // Straight copy.
-    CopyPlane(src, src_stride, dst, dst_stride, dst_width, dst_height);
+    CopyPlane(src + clip_y * src_stride, src_stride,
+              dst + clip_y * dst_stride, dst_stride, dst_width, clip_height);
     return;
   }
   if (dst_width == src_width && filtering != kFilterBox) {
     int dy = FixedDiv(src_height, dst_height);
     // Arbitrary scale vertically, but unscaled horizontally.
     ScalePlaneVertical(src_height,
-                       dst_width, dst_height,
-                       src_stride, dst_stride, src, dst,
-                       0, 0, dy, 1, filtering);
+                       dst_width, clip_height,
+                       src_stride, dst_stride,
+                       src, dst + clip_y * dst_stride,
+                       0, clip_y * dy, dy, 1, filtering);
     return;
   }
   if (dst_width <= Abs(src_width) && dst_height <= src_height) {
+    // The 3/4 and 3/8 scalers work in groups of 3 rows and filter the last
+    // rows of the image differently, so a clip that splits a group takes
+    // the general path below.
+    const int clip_groups = (clip_y % 3) == 0 &&
+        ((clip_height % 3) == 0 || clip_y + clip_height == dst_height);
     // Scale down.
     if (4 * dst_width == 3 * src_width &&
-        4 * dst_height == 3 * src_height) {
+        4 * dst_height == 3 * src_height &&
+        clip_groups) {
       // optimized, 3/4
-      ScalePlaneDown34(src_width, src_height, dst_width, dst_height,
-                       src_stride, dst_stride, src, dst, filtering);
+      ScalePlaneDown34(src_width, src_height, dst_width, clip_height,
+                       src_stride, dst_stride,
+                       src + clip_y / 3 * 4 * src_stride,
+                       dst + clip_y * dst_stride, filtering);
       return;
     }
     if (2 * dst_width == src_width && 2 * dst_height == src_height) {
       // optimized, 1/2
-      ScalePlaneDown2(src_width, src_height, dst_width, dst_height,
-                      src_stride, dst_stride, src, dst, filtering);
+      ScalePlaneDown2(src_width, src_height, dst_width, clip_height,
+                      src_stride, dst_stride,
+                      src + clip_y * 2 * src_stride,
+                      dst + clip_y * dst_stride, filtering);
       return;
     }
     // 3/8 rounded up for odd sized chroma height.
     if (8 * dst_width == 3 * src_width &&
-        dst_height == ((src_height * 3 + 7) / 8)) {
+        dst_height == ((src_height * 3 + 7) / 8) &&
+        clip_groups) {
       // optimized, 3/8
-      ScalePlaneDown38(src_width, src_height, dst_width, dst_height,
-                       src_stride, dst_stride, src, dst, filtering);
+      ScalePlaneDown38(src_width, src_height, dst_width, clip_height,
+                       src_stride, dst_stride,
+                       src + clip_y / 3 * 8 * src_stride,
+                       dst + clip_y * dst_stride, filtering);
       return;
     }
     if (4 * dst_width == src_width && 4 * dst_height == src_height &&
         (filtering == kFilterBox || filtering == kFilterNone)) {
       // optimized, 1/4
-      ScalePlaneDown4(src_width, src_height, dst_width, dst_height,
-                      src_stride, dst_stride, src, dst, filtering);
+      ScalePlaneDown4(src_width, src_height, dst_width, clip_height,
+                      src_stride, dst_stride,
+                      src + clip_y * 4 * src_stride,
+                      dst + clip_y * dst_stride, filtering);
       return;
     }
   }
+  dst += clip_y * dst_stride;
   if (filtering == kFilterBox && dst_height * 2 < src_height) {
     ScalePlaneBox(src_width, src_height, dst_width, dst_height,
-                  src_stride, dst_stride, src, dst);
+                  src_stride, dst_stride, src, dst, clip_y, clip_height);
     return;
   }
   if (filtering && dst_height > src_height) {
     ScalePlaneBilinearUp(src_width, src_height, dst_width, dst_height,
-                         src_stride, dst_stride, src, dst, filtering);
+                         src_stride, dst_stride, src, dst,
+                         clip_y, clip_height, filtering);
     return;
   }
   if (filtering) {
     ScalePlaneBilinearDown(src_width, src_height, dst_width, dst_height,
-                           src_stride, dst_stride, src, dst, filtering);
+                           src_stride, dst_stride, src, dst,
+                           clip_y, clip_height, filtering);
     return;
   }
   ScalePlaneSimple(src_width, src_height, dst_width, dst_height,
-                   src_stride, dst_stride, src, dst);
+                   src_stride, dst_stride, src, dst, clip_y, clip_height);
+}
+
+LIBYUV_API
+void ScalePlane(const uint8* src, int src_stride,
+                int src_width, int src_height,
+                uint8* dst, int dst_stride,
+                int dst_width, int dst_height,
+                enum FilterMode filtering) {
+  ScalePlaneClipRows(src, src_stride, src_width, src_height,
+                     dst, dst_stride, dst_width, dst_height,
+                     0, dst_height, filtering);
+}
+
+LIBYUV_API
+int ScalePlaneClip(const uint8* src, int src_stride,
+                   int src_width, int src_height,
+                   uint8* dst, int dst_stride,
+                   int dst_width, int dst_height,
+                   int clip_y, int clip_height,
+                   enum FilterMode filtering) {
+  if (!src || src_width == 0 || src_height == 0 ||
+      !dst || dst_width <= 0 || dst_height <= 0 ||
+      clip_y < 0 || clip_height <= 0 ||
+      (clip_y + clip_height) > dst_height) {
+    return -1;
+  }
+  ScalePlaneClipRows(src, src_stride, src_width, src_height,
+                     dst, dst_stride, dst_width, dst_height,
+                     clip_y, clip_height, filtering);
+  return 0;
 }
 
 LIBYUV_API
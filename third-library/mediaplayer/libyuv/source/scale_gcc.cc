@@ -9,6 +9,7 @@
  */
 
 #include "libyuv/row.h"
+#include "libyuv/scale_row.h"
 
 #ifdef __cplusplus
 namespace libyuv {
@@ -186,6 +187,114 @@ void ScaleRowDown2Box_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
   );
 }
 
+#ifdef HAS_SCALEROWDOWN2_16_SSE2
+// Read 16x1 words, keep the odd ones and write 8x1.
+void ScaleRowDown2_16_SSE2(const uint16* src_ptr, ptrdiff_t src_stride,
+                           uint16* dst_ptr, int dst_width) {
+  asm volatile (
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    "movdqu    " MEMACCESS2(0x10,0) ",%%xmm1   \n"
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "pshuflw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufhw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufd    $0xd8,%%xmm0,%%xmm0             \n"
+    "pshuflw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufhw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufd    $0xd8,%%xmm1,%%xmm1             \n"
+    "punpckhqdq %%xmm1,%%xmm0                  \n"
+    "movdqu    %%xmm0," MEMACCESS(1) "         \n"
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x8,%2                         \n"
+    "jg        1b                              \n"
+  : "+r"(src_ptr),    // %0
+    "+r"(dst_ptr),    // %1
+    "+r"(dst_width)   // %2
+  :: "memory", "cc", "xmm0", "xmm1"
+  );
+}
+
+void ScaleRowDown2Linear_16_SSE2(const uint16* src_ptr, ptrdiff_t src_stride,
+                                 uint16* dst_ptr, int dst_width) {
+  asm volatile (
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    "movdqu    " MEMACCESS2(0x10,0) ",%%xmm1   \n"
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "pshuflw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufhw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufd    $0xd8,%%xmm0,%%xmm0             \n"
+    "pshuflw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufhw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufd    $0xd8,%%xmm1,%%xmm1             \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "punpcklqdq %%xmm1,%%xmm0                  \n"
+    "punpckhqdq %%xmm1,%%xmm2                  \n"
+    "pavgw     %%xmm2,%%xmm0                   \n"
+    "movdqu    %%xmm0," MEMACCESS(1) "         \n"
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x8,%2                         \n"
+    "jg        1b                              \n"
+  : "+r"(src_ptr),    // %0
+    "+r"(dst_ptr),    // %1
+    "+r"(dst_width)   // %2
+  :: "memory", "cc", "xmm0", "xmm1", "xmm2"
+  );
+}
+
+// Sums are formed with pmaddwd on words biased by 0x8000; the bias of the
+// 4 samples is 4 * 0x8000, which the shift turns back into 0x8000 exactly.
+// The stride is in pixels.
+void ScaleRowDown2Box_16_SSE2(const uint16* src_ptr, ptrdiff_t src_stride,
+                              uint16* dst_ptr, int dst_width) {
+  asm volatile (
+    "pcmpeqb   %%xmm5,%%xmm5                   \n"
+    "psllw     $0xf,%%xmm5                     \n"
+    "pcmpeqb   %%xmm4,%%xmm4                   \n"
+    "psrlw     $0xf,%%xmm4                     \n"
+    "pcmpeqb   %%xmm3,%%xmm3                   \n"
+    "psrld     $0x1f,%%xmm3                    \n"
+    "pslld     $0x1,%%xmm3                     \n"
+
+    LABELALIGN
+  "1:                                          \n"
+    "movdqu    " MEMACCESS(0) ",%%xmm0         \n"
+    "movdqu    " MEMACCESS2(0x10,0) ",%%xmm1   \n"
+    "pxor      %%xmm5,%%xmm0                   \n"
+    "pxor      %%xmm5,%%xmm1                   \n"
+    "pmaddwd   %%xmm4,%%xmm0                   \n"
+    "pmaddwd   %%xmm4,%%xmm1                   \n"
+    MEMOPREG(movdqu,0x00,0,3,2,xmm2)           //  movdqu  (%0,%3,2),%%xmm2
+    "pxor      %%xmm5,%%xmm2                   \n"
+    "pmaddwd   %%xmm4,%%xmm2                   \n"
+    "paddd     %%xmm2,%%xmm0                   \n"
+    MEMOPREG(movdqu,0x10,0,3,2,xmm2)           //  movdqu  0x10(%0,%3,2),%%xmm2
+    "lea       " MEMLEA(0x20,0) ",%0           \n"
+    "pxor      %%xmm5,%%xmm2                   \n"
+    "pmaddwd   %%xmm4,%%xmm2                   \n"
+    "paddd     %%xmm2,%%xmm1                   \n"
+    "paddd     %%xmm3,%%xmm0                   \n"
+    "paddd     %%xmm3,%%xmm1                   \n"
+    "psrad     $0x2,%%xmm0                     \n"
+    "psrad     $0x2,%%xmm1                     \n"
+    "packssdw  %%xmm1,%%xmm0                   \n"
+    "pxor      %%xmm5,%%xmm0                   \n"
+    "movdqu    %%xmm0," MEMACCESS(1) "         \n"
+    "lea       " MEMLEA(0x10,1) ",%1           \n"
+    "sub       $0x8,%2                         \n"
+    "jg        1b                              \n"
+  : "+r"(src_ptr),    // %0
+    "+r"(dst_ptr),    // %1
+    "+r"(dst_width)   // %2
+  : "r"((intptr_t)(src_stride))   // %3
+  : "memory", "cc", NACL_R14
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+  );
+}
+#endif  // HAS_SCALEROWDOWN2_16_SSE2
+
 void ScaleRowDown4_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
                         uint8* dst_ptr, int dst_width) {
   asm volatile (
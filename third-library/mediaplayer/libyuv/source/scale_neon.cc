@@ -98,6 +98,58 @@ void ScaleRowDown2Box_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
   );
 }
 
+// Read 16x1 throw away even pixels, and write 8x1.
+void ScaleRowDown2_16_NEON(const uint16* src_ptr, ptrdiff_t src_stride,
+                           uint16* dst, int dst_width) {
+  asm volatile (
+    ".p2align   2                              \n"
+  "1:                                          \n"
+    // load even pixels into q0, odd into q1
+    MEMACCESS(0)
+    "vld2.16    {q0, q1}, [%0]!                \n"
+    "subs       %2, %2, #8                     \n"  // 8 processed per loop
+    MEMACCESS(1)
+    "vst1.16    {q1}, [%1]!                    \n"  // store odd pixels
+    "bgt        1b                             \n"
+  : "+r"(src_ptr),          // %0
+    "+r"(dst),              // %1
+    "+r"(dst_width)         // %2
+  :
+  : "q0", "q1", "memory", "cc"  // Clobber List
+  );
+}
+
+// Read 16x2 average down and write 8x1.  The stride is in pixels.
+void ScaleRowDown2Box_16_NEON(const uint16* src_ptr, ptrdiff_t src_stride,
+                              uint16* dst, int dst_width) {
+  asm volatile (
+    // change the stride to row 2 pointer
+    "add        %1, %0, %1, lsl #1             \n"
+    ".p2align   2                              \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "vld1.16    {q0, q1}, [%0]!                \n"  // load row 1 and post inc
+    MEMACCESS(1)
+    "vld1.16    {q2, q3}, [%1]!                \n"  // load row 2 and post inc
+    "subs       %3, %3, #8                     \n"  // 8 processed per loop
+    "vpaddl.u16 q0, q0                         \n"  // row 1 add adjacent
+    "vpaddl.u16 q1, q1                         \n"
+    "vpadal.u16 q0, q2                         \n"  // row 2 add adjacent + row1
+    "vpadal.u16 q1, q3                         \n"
+    "vrshrn.u32 d0, q0, #2                     \n"  // downshift, round and pack
+    "vrshrn.u32 d1, q1, #2                     \n"
+    MEMACCESS(2)
+    "vst1.16    {q0}, [%2]!                    \n"
+    "bgt        1b                             \n"
+  : "+r"(src_ptr),          // %0
+    "+r"(src_stride),       // %1
+    "+r"(dst),              // %2
+    "+r"(dst_width)         // %3
+  :
+  : "q0", "q1", "q2", "q3", "memory", "cc"  // Clobber List
+  );
+}
+
 void ScaleRowDown4_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
                         uint8* dst_ptr, int dst_width) {
   asm volatile (
@@ -93,6 +93,56 @@ void ScaleRowDown2Box_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
   );
 }
 
+// Read 16x1 throw away even pixels, and write 8x1.
+void ScaleRowDown2_16_NEON(const uint16* src_ptr, ptrdiff_t src_stride,
+                           uint16* dst, int dst_width) {
+  asm volatile (
+  "1:                                          \n"
+    // load even pixels into v0, odd into v1
+    MEMACCESS(0)
+    "ld2        {v0.8h,v1.8h}, [%0], #32       \n"
+    "subs       %w2, %w2, #8                   \n"  // 8 processed per loop
+    MEMACCESS(1)
+    "st1        {v1.8h}, [%1], #16             \n"  // store odd pixels
+    "b.gt       1b                             \n"
+  : "+r"(src_ptr),          // %0
+    "+r"(dst),              // %1
+    "+r"(dst_width)         // %2
+  :
+  : "v0", "v1", "memory", "cc"  // Clobber List
+  );
+}
+
+// Read 16x2 average down and write 8x1.  The stride is in pixels.
+void ScaleRowDown2Box_16_NEON(const uint16* src_ptr, ptrdiff_t src_stride,
+                              uint16* dst, int dst_width) {
+  asm volatile (
+    // change the stride to row 2 pointer
+    "add        %1, %0, %1, lsl #1             \n"
+  "1:                                          \n"
+    MEMACCESS(0)
+    "ld1        {v0.8h,v1.8h}, [%0], #32       \n"  // load row 1 and post inc
+    MEMACCESS(1)
+    "ld1        {v2.8h, v3.8h}, [%1], #32      \n"  // load row 2 and post inc
+    "subs       %w3, %w3, #8                   \n"  // 8 processed per loop
+    "uaddlp     v0.4s, v0.8h                   \n"  // row 1 add adjacent
+    "uaddlp     v1.4s, v1.8h                   \n"
+    "uadalp     v0.4s, v2.8h                   \n"  // row 2 add adjacent + row1
+    "uadalp     v1.4s, v3.8h                   \n"
+    "rshrn      v0.4h, v0.4s, #2               \n"  // downshift, round and pack
+    "rshrn2     v0.8h, v1.4s, #2               \n"
+    MEMACCESS(2)
+    "st1        {v0.8h}, [%2], #16             \n"
+    "b.gt       1b                             \n"
+  : "+r"(src_ptr),          // %0
+    "+r"(src_stride),       // %1
+    "+r"(dst),              // %2
+    "+r"(dst_width)         // %3
+  :
+  : "v0", "v1", "v2", "v3", "memory", "cc"  // Clobber List
+  );
+}
+
 void ScaleRowDown4_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
                         uint8* dst_ptr, int dst_width) {
   asm volatile (
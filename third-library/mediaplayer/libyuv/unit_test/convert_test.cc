@@ -1529,4 +1529,206 @@ TEST_F(libyuvTest, FMT_PLANAR##To##FMT_B##Dither##N) {                         \
 
 TESTPLANARTOBD(I420, 2, 2, RGB565, 2, 2, 1, 9, ARGB, 4)
 
+#define TESTI010TOBI(FMT_B, BPP_B, W1280, DIFF, N, NEG, OFF)                    \
+TEST_F(libyuvTest, I010To##FMT_B##N) {                                         \
+  const int kWidth = ((W1280) > 0) ? (W1280) : 1;                              \
+  const int kHeight = benchmark_height_;                                       \
+  const int kStrideB = kWidth * BPP_B;                                         \
+  const int kStrideUV = SUBSAMPLE(kWidth, 2);                                  \
+  const int kSizeUV = kStrideUV * SUBSAMPLE(kHeight, 2);                       \
+  align_buffer_64(src_y, (kWidth * kHeight + OFF) * 2);                        \
+  align_buffer_64(src_u, (kSizeUV + OFF) * 2);                                 \
+  align_buffer_64(src_v, (kSizeUV + OFF) * 2);                                 \
+  align_buffer_64(dst_argb_c, kStrideB * kHeight);                             \
+  align_buffer_64(dst_argb_opt, kStrideB * kHeight);                           \
+  uint16* p_src_y = reinterpret_cast<uint16*>(src_y) + OFF;                    \
+  uint16* p_src_u = reinterpret_cast<uint16*>(src_u) + OFF;                    \
+  uint16* p_src_v = reinterpret_cast<uint16*>(src_v) + OFF;                    \
+  srandom(time(NULL));                                                         \
+  for (int i = 0; i < kWidth * kHeight; ++i) {                                 \
+    p_src_y[i] = (random() & 0x3ff);                                           \
+  }                                                                            \
+  for (int i = 0; i < kSizeUV; ++i) {                                          \
+    p_src_u[i] = (random() & 0x3ff);                                           \
+    p_src_v[i] = (random() & 0x3ff);                                           \
+  }                                                                            \
+  memset(dst_argb_c, 1, kStrideB * kHeight);                                   \
+  memset(dst_argb_opt, 101, kStrideB * kHeight);                               \
+  MaskCpuFlags(disable_cpu_flags_);                                            \
+  I010To##FMT_B(p_src_y, kWidth, p_src_u, kStrideUV, p_src_v, kStrideUV,       \
+                dst_argb_c, kStrideB, kWidth, NEG kHeight);                    \
+  MaskCpuFlags(-1);                                                            \
+  for (int i = 0; i < benchmark_iterations_; ++i) {                            \
+    I010To##FMT_B(p_src_y, kWidth, p_src_u, kStrideUV, p_src_v, kStrideUV,     \
+                  dst_argb_opt, kStrideB, kWidth, NEG kHeight);                \
+  }                                                                            \
+  int max_diff = 0;                                                            \
+  for (int i = 0; i < kStrideB * kHeight; ++i) {                               \
+    int abs_diff =                                                             \
+        abs(static_cast<int>(dst_argb_c[i]) -                                  \
+            static_cast<int>(dst_argb_opt[i]));                                \
+    if (abs_diff > max_diff) {                                                 \
+      max_diff = abs_diff;                                                     \
+    }                                                                          \
+  }                                                                            \
+  EXPECT_LE(max_diff, DIFF);                                                   \
+  free_aligned_buffer_64(src_y);                                               \
+  free_aligned_buffer_64(src_u);                                               \
+  free_aligned_buffer_64(src_v);                                               \
+  free_aligned_buffer_64(dst_argb_c);                                          \
+  free_aligned_buffer_64(dst_argb_opt);                                        \
+}
+
+#define TESTI010TOB(FMT_B, BPP_B, DIFF)                                        \
+    TESTI010TOBI(FMT_B, BPP_B, benchmark_width_ - 4, DIFF, _Any, +, 0)         \
+    TESTI010TOBI(FMT_B, BPP_B, benchmark_width_, DIFF, _Unaligned, +, 1)       \
+    TESTI010TOBI(FMT_B, BPP_B, benchmark_width_, DIFF, _Invert, -, 0)          \
+    TESTI010TOBI(FMT_B, BPP_B, benchmark_width_, DIFF, _Opt, +, 0)
+
+// AR30 is compared bytewise, so it has to be exact.
+TESTI010TOB(AR30, 4, 0)
+TESTI010TOB(ARGB, 4, 2)
+TESTI010TOB(ABGR, 4, 2)
+
+static uint32 ReadAR30(const uint8* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32>(p[3]) << 24);
+}
+
+TEST_F(libyuvTest, TestI010ToAR30) {
+  SIMD_ALIGNED(uint16 orig_y[2][32]);
+  SIMD_ALIGNED(uint16 orig_u[16]);
+  SIMD_ALIGNED(uint16 orig_v[16]);
+  SIMD_ALIGNED(uint8 dst_ar30[2][32 * 4]);
+  SIMD_ALIGNED(uint8 dst_argb[2][32 * 4]);
+
+  // A ramp from black to white with neutral chroma.
+  for (int i = 0; i < 32; ++i) {
+    orig_y[0][i] = orig_y[1][i] = 64 + i * (940 - 64) / 31;
+  }
+  for (int i = 0; i < 16; ++i) {
+    orig_u[i] = orig_v[i] = 512;
+  }
+  I010ToAR30(&orig_y[0][0], 32, orig_u, 16, orig_v, 16,
+             &dst_ar30[0][0], 32 * 4, 32, 2);
+  I010ToARGB(&orig_y[0][0], 32, orig_u, 16, orig_v, 16,
+             &dst_argb[0][0], 32 * 4, 32, 2);
+
+  EXPECT_EQ(0xc0000000u, ReadAR30(&dst_ar30[0][0]));
+  int last = -1;
+  for (int i = 0; i < 32; ++i) {
+    uint32 ar30 = ReadAR30(&dst_ar30[1][i * 4]);
+    int b = ar30 & 0x3ff;
+    int g = (ar30 >> 10) & 0x3ff;
+    int r = (ar30 >> 20) & 0x3ff;
+    EXPECT_EQ(3u, ar30 >> 30);
+    EXPECT_EQ(b, g);
+    EXPECT_EQ(b, r);
+    EXPECT_LT(last, b);
+    last = b;
+    // 10 bit output agrees with the 8 bit path to within rounding.
+    EXPECT_NEAR(dst_argb[1][i * 4 + 0], b >> 2, 2);
+    EXPECT_NEAR(dst_argb[1][i * 4 + 2], r >> 2, 2);
+  }
+  EXPECT_LE(1016, last);
+}
+
+TEST_F(libyuvTest, I010ToI420_Opt) {
+  const int kWidth = benchmark_width_;
+  const int kHeight = benchmark_height_;
+  const int kSizeUV = SUBSAMPLE(kWidth, 2) * SUBSAMPLE(kHeight, 2);
+  align_buffer_64(src_y, kWidth * kHeight * 2);
+  align_buffer_64(src_u, kSizeUV * 2);
+  align_buffer_64(src_v, kSizeUV * 2);
+  align_buffer_64(dst_c, kWidth * kHeight + kSizeUV * 2);
+  align_buffer_64(dst_opt, kWidth * kHeight + kSizeUV * 2);
+  uint16* p_src_y = reinterpret_cast<uint16*>(src_y);
+  uint16* p_src_u = reinterpret_cast<uint16*>(src_u);
+  uint16* p_src_v = reinterpret_cast<uint16*>(src_v);
+  srandom(time(NULL));
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    p_src_y[i] = random() & 0x3ff;
+  }
+  for (int i = 0; i < kSizeUV; ++i) {
+    p_src_u[i] = random() & 0x3ff;
+    p_src_v[i] = random() & 0x3ff;
+  }
+  memset(dst_c, 1, kWidth * kHeight + kSizeUV * 2);
+  memset(dst_opt, 101, kWidth * kHeight + kSizeUV * 2);
+  MaskCpuFlags(disable_cpu_flags_);
+  I010ToI420(p_src_y, kWidth, p_src_u, SUBSAMPLE(kWidth, 2),
+             p_src_v, SUBSAMPLE(kWidth, 2),
+             dst_c, kWidth,
+             dst_c + kWidth * kHeight, SUBSAMPLE(kWidth, 2),
+             dst_c + kWidth * kHeight + kSizeUV, SUBSAMPLE(kWidth, 2),
+             kWidth, kHeight);
+  MaskCpuFlags(-1);
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    I010ToI420(p_src_y, kWidth, p_src_u, SUBSAMPLE(kWidth, 2),
+               p_src_v, SUBSAMPLE(kWidth, 2),
+               dst_opt, kWidth,
+               dst_opt + kWidth * kHeight, SUBSAMPLE(kWidth, 2),
+               dst_opt + kWidth * kHeight + kSizeUV, SUBSAMPLE(kWidth, 2),
+               kWidth, kHeight);
+  }
+  for (int i = 0; i < kWidth * kHeight + kSizeUV * 2; ++i) {
+    EXPECT_EQ(dst_c[i], dst_opt[i]);
+  }
+  // Dither only ever rounds up, by less than one 8 bit step.
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    EXPECT_LE(p_src_y[i] >> 2, dst_opt[i]);
+    EXPECT_GE((p_src_y[i] + 3) >> 2, dst_opt[i]);
+  }
+  free_aligned_buffer_64(src_y);
+  free_aligned_buffer_64(src_u);
+  free_aligned_buffer_64(src_v);
+  free_aligned_buffer_64(dst_c);
+  free_aligned_buffer_64(dst_opt);
+}
+
+TEST_F(libyuvTest, P010ToI010ToP010) {
+  const int kWidth = benchmark_width_;
+  const int kHeight = benchmark_height_;
+  const int kStrideUV = SUBSAMPLE(kWidth, 2);
+  const int kSizeUV = kStrideUV * SUBSAMPLE(kHeight, 2);
+  align_buffer_64(src_y, kWidth * kHeight * 2);
+  align_buffer_64(src_uv, kSizeUV * 4);
+  align_buffer_64(i010, (kWidth * kHeight + kSizeUV * 2) * 2);
+  align_buffer_64(dst_y, kWidth * kHeight * 2);
+  align_buffer_64(dst_uv, kSizeUV * 4);
+  uint16* p_src_y = reinterpret_cast<uint16*>(src_y);
+  uint16* p_src_uv = reinterpret_cast<uint16*>(src_uv);
+  uint16* p_i010_y = reinterpret_cast<uint16*>(i010);
+  uint16* p_i010_u = p_i010_y + kWidth * kHeight;
+  uint16* p_i010_v = p_i010_u + kSizeUV;
+  srandom(time(NULL));
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    p_src_y[i] = (random() & 0x3ff) << 6;
+  }
+  for (int i = 0; i < kSizeUV * 2; ++i) {
+    p_src_uv[i] = (random() & 0x3ff) << 6;
+  }
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    P010ToI010(p_src_y, kWidth, p_src_uv, kStrideUV * 2,
+               p_i010_y, kWidth, p_i010_u, kStrideUV, p_i010_v, kStrideUV,
+               kWidth, kHeight);
+    I010ToP010(p_i010_y, kWidth, p_i010_u, kStrideUV, p_i010_v, kStrideUV,
+               reinterpret_cast<uint16*>(dst_y), kWidth,
+               reinterpret_cast<uint16*>(dst_uv), kStrideUV * 2,
+               kWidth, kHeight);
+  }
+  EXPECT_EQ(p_src_y[0] >> 6, p_i010_y[0]);
+  EXPECT_EQ(p_src_uv[1] >> 6, p_i010_v[0]);
+  for (int i = 0; i < kWidth * kHeight * 2; ++i) {
+    EXPECT_EQ(src_y[i], dst_y[i]);
+  }
+  for (int i = 0; i < kSizeUV * 4; ++i) {
+    EXPECT_EQ(src_uv[i], dst_uv[i]);
+  }
+  free_aligned_buffer_64(src_y);
+  free_aligned_buffer_64(src_uv);
+  free_aligned_buffer_64(i010);
+  free_aligned_buffer_64(dst_y);
+  free_aligned_buffer_64(dst_uv);
+}
+
 }  // namespace libyuv
@@ -2198,4 +2198,212 @@ TEST_F(libyuvTest, SetPlane_Opt) {
   EXPECT_EQ(0, max_diff);
 }
 
+// Convert16To8Plane with C vs optimized rows.  Returns the maximum difference.
+static int TestConvert16To8Plane(int width, int height,
+                                 int benchmark_iterations,
+                                 int disable_cpu_flags, int invert, int off,
+                                 int depth) {
+  if (width < 1) {
+    width = 1;
+  }
+  const int kSize = width * height;
+  align_buffer_64(src, kSize * 2 + off);
+  align_buffer_64(dst_c, kSize);
+  align_buffer_64(dst_opt, kSize);
+  uint16* p_src = reinterpret_cast<uint16*>(src + off);
+
+  for (int i = 0; i < kSize; ++i) {
+    p_src[i] = random() & ((1 << depth) - 1);
+  }
+  memset(dst_c, 1, kSize);
+  memset(dst_opt, 2, kSize);
+
+  MaskCpuFlags(disable_cpu_flags);
+  Convert16To8Plane(p_src, width, dst_c, width, depth,
+                    width, invert * height);
+  MaskCpuFlags(-1);
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    Convert16To8Plane(p_src, width, dst_opt, width, depth,
+                      width, invert * height);
+  }
+  int max_diff = 0;
+  for (int i = 0; i < kSize; ++i) {
+    int abs_diff = abs(static_cast<int>(dst_c[i]) -
+                       static_cast<int>(dst_opt[i]));
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+  }
+  free_aligned_buffer_64(src);
+  free_aligned_buffer_64(dst_c);
+  free_aligned_buffer_64(dst_opt);
+  return max_diff;
+}
+
+TEST_F(libyuvTest, Convert16To8Plane_Any) {
+  int max_diff = TestConvert16To8Plane(benchmark_width_ - 1, benchmark_height_,
+                                       benchmark_iterations_,
+                                       disable_cpu_flags_, +1, 0, 10);
+  EXPECT_EQ(0, max_diff);
+}
+
+TEST_F(libyuvTest, Convert16To8Plane_Unaligned) {
+  int max_diff = TestConvert16To8Plane(benchmark_width_, benchmark_height_,
+                                       benchmark_iterations_,
+                                       disable_cpu_flags_, +1, 2, 10);
+  EXPECT_EQ(0, max_diff);
+}
+
+TEST_F(libyuvTest, Convert16To8Plane_Invert) {
+  int max_diff = TestConvert16To8Plane(benchmark_width_, benchmark_height_,
+                                       benchmark_iterations_,
+                                       disable_cpu_flags_, -1, 0, 10);
+  EXPECT_EQ(0, max_diff);
+}
+
+TEST_F(libyuvTest, Convert16To8Plane_Opt) {
+  int max_diff = TestConvert16To8Plane(benchmark_width_, benchmark_height_,
+                                       benchmark_iterations_,
+                                       disable_cpu_flags_, +1, 0, 10);
+  EXPECT_EQ(0, max_diff);
+}
+
+TEST_F(libyuvTest, Convert16To8Plane_16Bit) {
+  int max_diff = TestConvert16To8Plane(benchmark_width_, benchmark_height_,
+                                       benchmark_iterations_,
+                                       disable_cpu_flags_, +1, 0, 16);
+  EXPECT_EQ(0, max_diff);
+}
+
+TEST_F(libyuvTest, TestConvert16To8Plane) {
+  SIMD_ALIGNED(uint16 orig_pixels[4][64]);
+  SIMD_ALIGNED(uint8 dst_pixels[4][64]);
+
+  // A flat 10 bit area a quarter of the way between two 8 bit codes dithers
+  // to the higher code for 4 of each 16 pixels.
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      orig_pixels[y][x] = 100 * 4 + 1;
+    }
+  }
+  orig_pixels[0][63] = 1023u;
+  orig_pixels[1][63] = 0u;
+  EXPECT_EQ(0, Convert16To8Plane(&orig_pixels[0][0], 64,
+                                 &dst_pixels[0][0], 64, 10, 64, 4));
+  int high = 0;
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 60; ++x) {
+      EXPECT_LE(100u, dst_pixels[y][x]);
+      EXPECT_GE(101u, dst_pixels[y][x]);
+      high += dst_pixels[y][x] - 100;
+    }
+  }
+  EXPECT_EQ(60, high);
+  EXPECT_EQ(255u, dst_pixels[0][63]);
+  EXPECT_EQ(0u, dst_pixels[1][63]);
+
+  // Depth outside 9 to 16 is rejected.
+  EXPECT_EQ(-1, Convert16To8Plane(&orig_pixels[0][0], 64,
+                                  &dst_pixels[0][0], 64, 8, 64, 4));
+}
+
+static int MaxDiff_16(const uint16* a, const uint16* b, int count) {
+  int max_diff = 0;
+  for (int i = 0; i < count; ++i) {
+    int abs_diff = abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+  }
+  return max_diff;
+}
+
+// Split, shift and merge 16 bit planes with C vs optimized rows and check
+// the P010 style round trip is lossless.
+static int TestSplitMergeUVPlane_16(int width, int height,
+                                    int benchmark_iterations,
+                                    int disable_cpu_flags, int invert) {
+  if (width < 1) {
+    width = 1;
+  }
+  const int kSize = width * height;
+  align_buffer_64(src_uv, kSize * 4);
+  align_buffer_64(dst_u_c, kSize * 2);
+  align_buffer_64(dst_v_c, kSize * 2);
+  align_buffer_64(dst_u_opt, kSize * 2);
+  align_buffer_64(dst_v_opt, kSize * 2);
+  align_buffer_64(dst_uv, kSize * 4);
+  align_buffer_64(dst_y_c, kSize * 2);
+  align_buffer_64(dst_y_opt, kSize * 2);
+  uint16* p_src_uv = reinterpret_cast<uint16*>(src_uv);
+  uint16* p_u_c = reinterpret_cast<uint16*>(dst_u_c);
+  uint16* p_v_c = reinterpret_cast<uint16*>(dst_v_c);
+  uint16* p_u_opt = reinterpret_cast<uint16*>(dst_u_opt);
+  uint16* p_v_opt = reinterpret_cast<uint16*>(dst_v_opt);
+  uint16* p_dst_uv = reinterpret_cast<uint16*>(dst_uv);
+  uint16* p_y_c = reinterpret_cast<uint16*>(dst_y_c);
+  uint16* p_y_opt = reinterpret_cast<uint16*>(dst_y_opt);
+
+  // 10 bit samples in the upper bits, as P010 stores them.
+  for (int i = 0; i < kSize * 2; ++i) {
+    p_src_uv[i] = (random() & 0x3ff) << 6;
+  }
+
+  MaskCpuFlags(disable_cpu_flags);
+  SplitUVPlane_16(p_src_uv, width * 2, p_u_c, width, p_v_c, width,
+                  6, width, invert * height);
+  ShiftPlane_16(p_src_uv, width, p_y_c, width, -6, width, invert * height);
+  MaskCpuFlags(-1);
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    SplitUVPlane_16(p_src_uv, width * 2, p_u_opt, width, p_v_opt, width,
+                    6, width, invert * height);
+    ShiftPlane_16(p_src_uv, width, p_y_opt, width, -6, width,
+                  invert * height);
+  }
+  int max_diff = MaxDiff_16(p_u_c, p_u_opt, kSize);
+  max_diff += MaxDiff_16(p_v_c, p_v_opt, kSize);
+  max_diff += MaxDiff_16(p_y_c, p_y_opt, kSize);
+
+  // Back to the source layout; inverting twice restores the row order.
+  MergeUVPlane_16(p_u_opt, width, p_v_opt, width, p_dst_uv, width * 2,
+                  6, width, invert * height);
+  max_diff += MaxDiff_16(p_src_uv, p_dst_uv, kSize * 2);
+  ShiftPlane_16(p_y_opt, width, p_y_c, width, 6, width, invert * height);
+  max_diff += MaxDiff_16(p_src_uv, p_y_c, kSize);
+
+  free_aligned_buffer_64(src_uv);
+  free_aligned_buffer_64(dst_u_c);
+  free_aligned_buffer_64(dst_v_c);
+  free_aligned_buffer_64(dst_u_opt);
+  free_aligned_buffer_64(dst_v_opt);
+  free_aligned_buffer_64(dst_uv);
+  free_aligned_buffer_64(dst_y_c);
+  free_aligned_buffer_64(dst_y_opt);
+  return max_diff;
+}
+
+TEST_F(libyuvTest, SplitMergeUVPlane_16_Any) {
+  int max_diff = TestSplitMergeUVPlane_16(benchmark_width_ - 1,
+                                          benchmark_height_,
+                                          benchmark_iterations_,
+                                          disable_cpu_flags_, +1);
+  EXPECT_EQ(0, max_diff);
+}
+
+TEST_F(libyuvTest, SplitMergeUVPlane_16_Invert) {
+  int max_diff = TestSplitMergeUVPlane_16(benchmark_width_,
+                                          benchmark_height_,
+                                          benchmark_iterations_,
+                                          disable_cpu_flags_, -1);
+  EXPECT_EQ(0, max_diff);
+}
+
+TEST_F(libyuvTest, SplitMergeUVPlane_16_Opt) {
+  int max_diff = TestSplitMergeUVPlane_16(benchmark_width_,
+                                          benchmark_height_,
+                                          benchmark_iterations_,
+                                          disable_cpu_flags_, +1);
+  EXPECT_EQ(0, max_diff);
+}
+
 }  // namespace libyuv
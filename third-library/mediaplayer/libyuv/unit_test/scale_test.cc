@@ -363,4 +363,135 @@ TEST_SCALETO(Scale, 1280, 720)
 #undef TEST_SCALETO1
 #undef TEST_SCALETO
 
+// Test 16 bit plane scaling with C vs optimized code on 10 bit samples and
+// return the maximum sample difference.  0 = exact.
+static int TestPlane_16(int src_width, int src_height,
+                        int dst_width, int dst_height,
+                        FilterMode f, int benchmark_iterations,
+                        int disable_cpu_flags) {
+  int i;
+  const int src_size = src_width * src_height;
+  const int dst_size = dst_width * dst_height;
+  align_buffer_page_end(src, src_size * 2)
+  align_buffer_page_end(dst_c, dst_size * 2)
+  align_buffer_page_end(dst_opt, dst_size * 2)
+  uint16* p_src = reinterpret_cast<uint16*>(src);
+  uint16* p_dst_c = reinterpret_cast<uint16*>(dst_c);
+  uint16* p_dst_opt = reinterpret_cast<uint16*>(dst_opt);
+
+  srandom(time(NULL));
+  for (i = 0; i < src_size; ++i) {
+    p_src[i] = random() & 0x3ff;
+  }
+  memset(dst_c, 1, dst_size * 2);
+  memset(dst_opt, 2, dst_size * 2);
+
+  MaskCpuFlags(disable_cpu_flags);  // Disable all CPU optimization.
+  ScalePlane_16(p_src, src_width, src_width, src_height,
+                p_dst_c, dst_width, dst_width, dst_height, f);
+  MaskCpuFlags(-1);  // Enable all CPU optimization.
+  for (i = 0; i < benchmark_iterations; ++i) {
+    ScalePlane_16(p_src, src_width, src_width, src_height,
+                  p_dst_opt, dst_width, dst_width, dst_height, f);
+  }
+
+  int max_diff = 0;
+  for (i = 0; i < dst_size; ++i) {
+    int abs_diff = Abs(p_dst_c[i] - p_dst_opt[i]);
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+  }
+
+  free_aligned_buffer_page_end(src)
+  free_aligned_buffer_page_end(dst_c)
+  free_aligned_buffer_page_end(dst_opt)
+  return max_diff;
+}
+
+// The 16 bit row functions are bit exact with C.
+#define TEST_PLANE16(name, nom, denom, filter)                                 \
+    TEST_F(libyuvTest, ScalePlaneDownBy##name##_##filter##_16) {               \
+      int src_width = (Abs(benchmark_width_) / nom / 2) * denom * 2;           \
+      int src_height = (Abs(benchmark_height_) / nom / 2) * denom * 2;         \
+      int diff = TestPlane_16(src_width, src_height,                           \
+                              src_width * nom / denom,                         \
+                              src_height * nom / denom,                        \
+                              kFilter##filter, benchmark_iterations_,          \
+                              disable_cpu_flags_);                             \
+      EXPECT_EQ(0, diff);                                                      \
+    }
+
+TEST_PLANE16(2, 1, 2, None)
+TEST_PLANE16(2, 1, 2, Linear)
+TEST_PLANE16(2, 1, 2, Box)
+TEST_PLANE16(3by4, 3, 4, Bilinear)
+#undef TEST_PLANE16
+
+// Scale a plane in bands of band_rows with ScalePlaneClip and compare with
+// a single ScalePlane.  Returns the maximum difference; 0 = exact.
+static int TestPlaneClip(int src_width, int src_height,
+                         int dst_width, int dst_height,
+                         FilterMode f, int band_rows) {
+  int i;
+  const int src_size = src_width * src_height;
+  const int dst_size = dst_width * dst_height;
+  align_buffer_page_end(src, src_size)
+  align_buffer_page_end(dst_full, dst_size)
+  align_buffer_page_end(dst_bands, dst_size)
+
+  srandom(time(NULL));
+  for (i = 0; i < src_size; ++i) {
+    src[i] = random() & 0xff;
+  }
+  memset(dst_full, 1, dst_size);
+  memset(dst_bands, 2, dst_size);
+
+  ScalePlane(src, src_width, src_width, src_height,
+             dst_full, dst_width, dst_width, dst_height, f);
+  for (i = 0; i < dst_height; i += band_rows) {
+    int rows = (dst_height - i) < band_rows ? (dst_height - i) : band_rows;
+    ScalePlaneClip(src, src_width, src_width, src_height,
+                   dst_bands, dst_width, dst_width, dst_height,
+                   i, rows, f);
+  }
+
+  int max_diff = 0;
+  for (i = 0; i < dst_size; ++i) {
+    int abs_diff = Abs(dst_full[i] - dst_bands[i]);
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+  }
+
+  free_aligned_buffer_page_end(src)
+  free_aligned_buffer_page_end(dst_full)
+  free_aligned_buffer_page_end(dst_bands)
+  return max_diff;
+}
+
+// 3/4 and 3/8 are only exact for bands that are a multiple of 3 rows.
+#define TEST_PLANECLIP1(name, sw, sh, dw, dh, band, filter)                    \
+    TEST_F(libyuvTest, ScalePlaneClip##name##_##filter) {                      \
+      EXPECT_EQ(0, TestPlaneClip(sw, sh, dw, dh, kFilter##filter, 6));         \
+      EXPECT_EQ(0, TestPlaneClip(sw, sh, dw, dh, kFilter##filter, band));      \
+    }
+
+#define TEST_PLANECLIP(name, sw, sh, dw, dh, band)                             \
+    TEST_PLANECLIP1(name, sw, sh, dw, dh, band, None)                          \
+    TEST_PLANECLIP1(name, sw, sh, dw, dh, band, Linear)                        \
+    TEST_PLANECLIP1(name, sw, sh, dw, dh, band, Bilinear)                      \
+    TEST_PLANECLIP1(name, sw, sh, dw, dh, band, Box)
+
+TEST_PLANECLIP(Down2, 640, 360, 320, 180, 7)
+TEST_PLANECLIP(Down4, 640, 360, 160, 90, 7)
+TEST_PLANECLIP(Down34, 640, 360, 480, 270, 33)
+TEST_PLANECLIP(Down38, 640, 360, 240, 135, 33)
+TEST_PLANECLIP(Down, 1280, 720, 854, 480, 7)
+TEST_PLANECLIP(DownBox, 1280, 720, 320, 170, 7)
+TEST_PLANECLIP(Up, 320, 180, 853, 481, 7)
+TEST_PLANECLIP(Vertical, 320, 360, 320, 203, 7)
+#undef TEST_PLANECLIP1
+#undef TEST_PLANECLIP
+
 }  // namespace libyuv
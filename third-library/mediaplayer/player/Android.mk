@@ -52,11 +52,26 @@ LOCAL_SRC_FILES += avformat/ijkioapplication.c
 LOCAL_SRC_FILES += avformat/ijkiocache.c
 LOCAL_SRC_FILES += avformat/ijkioprotocol.c
 LOCAL_SRC_FILES += avformat/ijklongurl.c
-
+# uses libavformat internals (url.h, http.h), which the ffmpeg module exports
+LOCAL_SRC_FILES += avformat/ijkhttppool.c
+
+# the player core needs an FFmpeg with libavutil/application.h, the one in
+# ffmpeg-sdl2/jni/ffmpeg has none; see ../CMakeLists.txt
+# LOCAL_SRC_FILES += ff_cmdutils.c
+# LOCAL_SRC_FILES += ff_abr.c
+# LOCAL_SRC_FILES += ff_pacer.c
+# LOCAL_SRC_FILES += ff_framedrop.c
+# LOCAL_SRC_FILES += ff_ffplay.c
+# LOCAL_SRC_FILES += ff_probe_cache.c
+# LOCAL_SRC_FILES += ff_ffpipeline.c
+# LOCAL_SRC_FILES += ff_ffpipenode.c
+# LOCAL_SRC_FILES += ijkmeta.c
+# LOCAL_SRC_FILES += ijkplayer.c
+# LOCAL_SRC_FILES += ijkplayer_pool.c
 # LOCAL_SRC_FILES += pipeline/ffpipeline_ffplay.c
 # LOCAL_SRC_FILES += pipeline/ffpipenode_ffplay_vdec.c
-
 # LOCAL_SRC_FILES += avformat/ijkurlhook.c
+
 # LOCAL_SRC_FILES +=. avformat/ijkioandroidio.c
 # LOCAL_SRC_FILES += avformat/ijkiourlhook.c
 # LOCAL_SRC_FILES += avformat/ijklivehook.c
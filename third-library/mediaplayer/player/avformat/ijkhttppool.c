@@ -0,0 +1,210 @@
+/*
+ * ijkhttppool.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ijkhttppool.h"
+#include <pthread.h>
+#include <string.h>
+#include "libavformat/avformat.h"
+#include "libavformat/http.h"
+#include "libavutil/avstring.h"
+#include "libavutil/log.h"
+#include "libavutil/time.h"
+
+#define IJKHTTPPOOL_MAX_IDLE        8
+/* most servers keep idle connections for 15s or more */
+#define IJKHTTPPOOL_IDLE_TIMEOUT    (10 * 1000 * 1000)
+
+static pthread_mutex_t    g_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static IjkHttpConnection *g_pool_idle;      // most recently released first
+
+static int ijkhttppool_interrupt_cb(void *opaque)
+{
+    IjkHttpConnection *conn = opaque;
+
+    if (!conn->interrupt_callback.callback)
+        return 0;
+    return conn->interrupt_callback.callback(conn->interrupt_callback.opaque);
+}
+
+/* options fixed when the connection is set up, a connection is only reused
+ * by opens that ask for the same; http.c resets everything else per request */
+static const char *const g_conn_options[] = {
+    "http_proxy", "timeout",
+    "ca_file", "cafile", "tls_verify", "cert_file", "key_file", "verifyhost",
+};
+
+static void conn_key(char *key, int key_size, const char *url, AVDictionary *options)
+{
+    char proto[16], auth[256], host[256];
+    int port;
+
+    av_url_split(proto, sizeof(proto), auth, sizeof(auth), host, sizeof(host), &port, NULL, 0, url);
+    snprintf(key, key_size, "%s://%s@%s:%d", proto, auth, host, port);
+    for (int i = 0; i < sizeof(g_conn_options) / sizeof(*g_conn_options); i++) {
+        AVDictionaryEntry *e = av_dict_get(options, g_conn_options[i], NULL, 0);
+        if (e)
+            av_strlcatf(key, key_size, "\n%s=%s", e->key, e->value);
+    }
+}
+
+static void conn_free(IjkHttpConnection *conn)
+{
+    while (conn) {
+        IjkHttpConnection *next = conn->next;
+        ffurl_closep(&conn->url);
+        av_free(conn);
+        conn = next;
+    }
+}
+
+/* takes the most recent idle connection for key, drops the expired ones */
+static IjkHttpConnection *pool_take(const char *key)
+{
+    IjkHttpConnection *conn = NULL, *expired = NULL;
+    IjkHttpConnection **p;
+    int64_t now = av_gettime_relative();
+
+    pthread_mutex_lock(&g_pool_mutex);
+    p = &g_pool_idle;
+    while (*p) {
+        IjkHttpConnection *c = *p;
+        if (now - c->idle_since > IJKHTTPPOOL_IDLE_TIMEOUT) {
+            *p = c->next;
+            c->next = expired;
+            expired = c;
+        } else if (!conn && !strcmp(c->key, key)) {
+            *p = c->next;
+            c->next = NULL;
+            conn = c;
+        } else {
+            p = &c->next;
+        }
+    }
+    pthread_mutex_unlock(&g_pool_mutex);
+
+    conn_free(expired);
+    return conn;
+}
+
+int ijkhttppool_open(IjkHttpConnection **pconn, const char *url, int flags,
+                     const AVIOInterruptCB *int_cb, AVDictionary **options,
+                     const char *whitelist, const char *blacklist, URLContext *parent)
+{
+    IjkHttpConnection *conn;
+    AVIOInterruptCB pool_cb;
+    char key[sizeof(conn->key)];
+    int ret;
+
+    *pconn = NULL;
+    conn_key(key, sizeof(key), url, options ? *options : NULL);
+    if (!(flags & AVIO_FLAG_WRITE) && (av_strstart(url, "http:", NULL) || av_strstart(url, "https:", NULL))) {
+        while ((conn = pool_take(key)) != NULL) {
+            /* a failed attempt must not consume the options of the next one */
+            AVDictionary *request_options = NULL;
+
+            if (options)
+                av_dict_copy(&request_options, *options, 0);
+            conn->interrupt_callback = int_cb ? *int_cb : (AVIOInterruptCB){ NULL, NULL };
+            ret = ff_http_do_new_request2(conn->url, url, &request_options);
+            if (ret >= 0) {
+                av_log(parent, AV_LOG_DEBUG, "ijkhttppool: reused connection to %s\n", conn->url->filename);
+                if (options) {
+                    av_dict_free(options);
+                    *options = request_options;
+                } else {
+                    av_dict_free(&request_options);
+                }
+                *pconn = conn;
+                return 0;
+            }
+            /* closed by the server while idle, try the next one */
+            av_dict_free(&request_options);
+            conn_free(conn);
+            if (ret == AVERROR_EXIT)
+                return ret;
+        }
+        if (options)
+            av_dict_set(options, "multiple_requests", "1", 0);
+    }
+
+    conn = av_mallocz(sizeof(IjkHttpConnection));
+    if (!conn)
+        return AVERROR(ENOMEM);
+    conn->interrupt_callback = int_cb ? *int_cb : (AVIOInterruptCB){ NULL, NULL };
+    av_strlcpy(conn->key, key, sizeof(conn->key));
+
+    pool_cb.callback = ijkhttppool_interrupt_cb;
+    pool_cb.opaque   = conn;
+    ret = ffurl_open_whitelist(&conn->url, url, flags, &pool_cb, options,
+                               whitelist, blacklist, parent);
+    if (ret < 0) {
+        av_free(conn);
+        return ret;
+    }
+    *pconn = conn;
+    return 0;
+}
+
+void ijkhttppool_release(IjkHttpConnection **pconn, int reusable)
+{
+    IjkHttpConnection *conn, *evicted = NULL;
+    int n = 0;
+
+    if (!pconn || !*pconn)
+        return;
+    conn   = *pconn;
+    *pconn = NULL;
+
+    if (!reusable || !conn->url || !conn->url->prot ||
+        (strcmp(conn->url->prot->name, "http") && strcmp(conn->url->prot->name, "https"))) {
+        conn_free(conn);
+        return;
+    }
+
+    conn->interrupt_callback.callback = NULL;
+    conn->interrupt_callback.opaque   = NULL;
+    conn->idle_since = av_gettime_relative();
+
+    pthread_mutex_lock(&g_pool_mutex);
+    conn->next  = g_pool_idle;
+    g_pool_idle = conn;
+    for (conn = g_pool_idle; conn; conn = conn->next) {
+        if (++n == IJKHTTPPOOL_MAX_IDLE) {
+            evicted    = conn->next;
+            conn->next = NULL;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_pool_mutex);
+
+    conn_free(evicted);
+}
+
+void ijkhttppool_clear(void)
+{
+    IjkHttpConnection *idle;
+
+    pthread_mutex_lock(&g_pool_mutex);
+    idle = g_pool_idle;
+    g_pool_idle = NULL;
+    pthread_mutex_unlock(&g_pool_mutex);
+
+    conn_free(idle);
+}
@@ -0,0 +1,58 @@
+/*
+ * ijkhttppool.h
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef IJKAVFORMAT_IJKHTTPPOOL_H
+#define IJKAVFORMAT_IJKHTTPPOOL_H
+
+#include <stdint.h>
+#include "libavformat/url.h"
+
+/*
+ * Process-wide pool of idle keep-alive http:/https: connections, shared by
+ * every player. A connection goes back to the pool once its response has
+ * been read to the end; the next open of a url on the same origin, with the
+ * same credentials, proxy and TLS options, sends its request on it instead
+ * of paying DNS, TCP and TLS setup again. Headers, cookies and the rest of
+ * the per-request state do not carry over, see ff_http_do_new_request2().
+ *
+ * Pooled connections outlive the player that opened them, so they are
+ * opened with an interrupt callback of their own that forwards to the
+ * callback of the current owner.
+ */
+
+typedef struct IjkHttpConnection {
+    URLContext      *url;
+
+    /* private */
+    AVIOInterruptCB  interrupt_callback;
+    char             key[1024];     // origin and connection options
+    int64_t          idle_since;
+    struct IjkHttpConnection *next;
+} IjkHttpConnection;
+
+/* same arguments as ffurl_open_whitelist(), reuses an idle connection if it can */
+int  ijkhttppool_open(IjkHttpConnection **pconn, const char *url, int flags,
+                      const AVIOInterruptCB *int_cb, AVDictionary **options,
+                      const char *whitelist, const char *blacklist, URLContext *parent);
+/* reusable: the response has been read to its end */
+void ijkhttppool_release(IjkHttpConnection **pconn, int reusable);
+void ijkhttppool_clear(void);
+
+#endif
@@ -27,10 +27,15 @@
 #include "libavutil/opt.h"
 
 #include "libavutil/application.h"
+#include "ijkhttppool.h"
+
+/* resolved addresses are shared by all players for this long */
+#define IJKURLHOOK_DNS_CACHE_TIMEOUT_MS (60 * 1000)
 
 typedef struct Context {
     AVClass        *class;
     URLContext     *inner;
+    IjkHttpConnection *conn;    // owns inner for ijkhttphook
 
     int64_t         logical_pos;
     int64_t         logical_size;
@@ -88,6 +93,20 @@ fail:
     return ret;
 }
 
+/* a connection whose response was read to the end can serve the next request */
+static void ijkurlhook_release_inner(URLContext *h)
+{
+    Context *c = h->priv_data;
+
+    if (c->conn) {
+        c->inner = NULL;
+        ijkhttppool_release(&c->conn, (c->io_error >= 0 || c->io_error == AVERROR_EOF) &&
+                                      c->logical_size > 0 && c->logical_pos >= c->logical_size);
+        return;
+    }
+    ffurl_closep(&c->inner);
+}
+
 static int ijkurlhook_reconnect(URLContext *h, AVDictionary *extra)
 {
     Context *c = h->priv_data;
@@ -102,7 +121,10 @@ static int ijkurlhook_reconnect(URLContext *h, AVDictionary *extra)
     if (extra)
         av_dict_copy(&inner_options, extra, 0);
 
-    ret = ffurl_open_whitelist(&new_url,
+    if (!strcmp(c->scheme, "ijkhttphook:")) {
+        IjkHttpConnection *new_conn = NULL;
+
+        ret = ijkhttppool_open(&new_conn,
                                c->app_io_ctrl.url,
                                c->inner_flags,
                                &h->interrupt_callback,
@@ -110,10 +132,26 @@ static int ijkurlhook_reconnect(URLContext *h, AVDictionary *extra)
                                h->protocol_whitelist,
                                h->protocol_blacklist,
                                h);
-    if (ret)
-        goto fail;
+        if (ret)
+            goto fail;
 
-    ffurl_closep(&c->inner);
+        ijkurlhook_release_inner(h);
+        c->conn = new_conn;
+        new_url = new_conn->url;
+    } else {
+        ret = ffurl_open_whitelist(&new_url,
+                                   c->app_io_ctrl.url,
+                                   c->inner_flags,
+                                   &h->interrupt_callback,
+                                   &inner_options,
+                                   h->protocol_whitelist,
+                                   h->protocol_blacklist,
+                                   h);
+        if (ret)
+            goto fail;
+
+        ffurl_closep(&c->inner);
+    }
 
     c->inner        = new_url;
     h->is_streamed  = c->inner->is_streamed;
@@ -143,6 +181,7 @@ static int ijkurlhook_init(URLContext *h, const char *arg, int flags, AVDictiona
 
     av_dict_set_int(&c->inner_options, "ijkapplication", c->app_ctx_intptr, 0);
     av_dict_set_int(&c->inner_options, "ijkinject-segment-index", c->segment_index, 0);
+    av_dict_set_int(&c->inner_options, "dns_cache_timeout", IJKURLHOOK_DNS_CACHE_TIMEOUT_MS, AV_DICT_DONT_OVERWRITE);
 
     c->app_io_ctrl.size = sizeof(c->app_io_ctrl);
     c->app_io_ctrl.segment_index = c->segment_index;
@@ -182,7 +221,8 @@ static int ijkurlhook_close(URLContext *h)
     Context *c = h->priv_data;
 
     av_dict_free(&c->inner_options);
-    return ffurl_closep(&c->inner);
+    ijkurlhook_release_inner(h);
+    return 0;
 }
 
 static int ijkurlhook_read(URLContext *h, unsigned char *buf, int size)
@@ -236,11 +276,14 @@ static int64_t ijkurlhook_seek(URLContext *h, int64_t pos, int whence)
 
 static int ijkhttphook_reconnect_at(URLContext *h, int64_t offset)
 {
+    Context      *c          = h->priv_data;
     int           ret        = 0;
     AVDictionary *extra_opts = NULL;
 
     av_dict_set_int(&extra_opts, "offset", offset, 0);
-    av_dict_set_int(&extra_opts, "dns_cache_clear", 1, 0);
+    /* a plain seek keeps the cached address, a retry after an error does not */
+    if (c->app_io_ctrl.retry_counter > 0)
+        av_dict_set_int(&extra_opts, "dns_cache_clear", 1, 0);
     ret = ijkurlhook_reconnect(h, extra_opts);
     av_dict_free(&extra_opts);
     return ret;
@@ -24,14 +24,143 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <inttypes.h>
 
+/* below this many entries a scan is cheaper than hashing */
+#define DICT_INDEX_MIN 16
+
 struct IjkAVDictionary {
     int count;
-    IjkAVDictionaryEntry *elems;
+    IjkAVDictionaryEntry *elems;    /* in insertion order */
+    uint32_t *hashes;               /* case-folded key hash of each entry */
+    int capacity;                   /* of elems and hashes */
+    int *index;                     /* open addressing, entry + 1, 0 if empty */
+    unsigned index_mask;            /* index size - 1 */
 };
 
+static inline int dict_fold(int c)
+{
+    return c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c;
+}
+
+/* FNV-1a of the upper-cased key, so both matching modes can use the index */
+static uint32_t dict_hash(const char *key)
+{
+    uint32_t h = 2166136261u;
+
+    while (*key)
+        h = (h ^ (uint32_t)dict_fold((unsigned char)*key++)) * 16777619u;
+    return h;
+}
+
+static int dict_key_equal(const char *s, const char *key, int flags)
+{
+    if (flags & IJK_AV_DICT_MATCH_CASE)
+        return !strcmp(s, key);
+    for (; dict_fold((unsigned char)*s) == dict_fold((unsigned char)*key); s++, key++) {
+        if (!*key)
+            return 1;
+    }
+    return 0;
+}
+
+static void dict_index_insert(IjkAVDictionary *m, int i)
+{
+    unsigned slot = m->hashes[i] & m->index_mask;
+
+    while (m->index[slot])
+        slot = (slot + 1) & m->index_mask;
+    m->index[slot] = i + 1;
+}
+
+/* sizes the index for at least n entries at half load, dropped below DICT_INDEX_MIN */
+static int dict_index_rebuild(IjkAVDictionary *m, int n)
+{
+    unsigned size = 16;
+    int i;
+
+    ijk_av_freep(&m->index);
+    m->index_mask = 0;
+    if (n < DICT_INDEX_MIN)
+        return 0;
+
+    while (size < (unsigned)n * 2)
+        size <<= 1;
+    m->index = (int *)calloc(size, sizeof(*m->index));
+    if (!m->index)
+        return -1;
+    m->index_mask = size - 1;
+    for (i = 0; i < m->count; i++)
+        dict_index_insert(m, i);
+    return 0;
+}
+
+static int dict_reserve(IjkAVDictionary *m, int n)
+{
+    if (n > m->capacity) {
+        int capacity = FFMAX(n, FFMAX(m->capacity * 2, 4));
+        IjkAVDictionaryEntry *elems;
+        uint32_t *hashes;
+
+        elems = (IjkAVDictionaryEntry *)realloc(m->elems, capacity * sizeof(*m->elems));
+        if (!elems)
+            return -1;
+        m->elems = elems;
+        hashes = (uint32_t *)realloc(m->hashes, capacity * sizeof(*m->hashes));
+        if (!hashes)
+            return -1;
+        m->hashes = hashes;
+        m->capacity = capacity;
+    }
+    if (n >= DICT_INDEX_MIN && (!m->index || (unsigned)n * 2 > m->index_mask + 1))
+        return dict_index_rebuild(m, n);
+    return 0;
+}
+
+/* lowest entry index after prev matching key, -1 if none */
+static int dict_find(const IjkAVDictionary *m, const char *key, uint32_t hash,
+                     int prev, int flags)
+{
+    int i;
+
+    if (flags & IJK_AV_DICT_IGNORE_SUFFIX) {
+        unsigned int j;
+
+        for (i = prev + 1; i < m->count; i++) {
+            const char *s = m->elems[i].key;
+            if (flags & IJK_AV_DICT_MATCH_CASE)
+                for (j = 0; s[j] == key[j] && key[j]; j++)
+                    ;
+            else
+                for (j = 0; dict_fold((unsigned char)s[j]) == dict_fold((unsigned char)key[j]) && key[j]; j++)
+                    ;
+            if (!key[j])
+                return i;
+        }
+        return -1;
+    }
+
+    if (m->index) {
+        unsigned slot = hash & m->index_mask;
+        int found = -1;
+
+        /* equal keys may sit anywhere in the run when MULTIKEY is used */
+        for (; m->index[slot]; slot = (slot + 1) & m->index_mask) {
+            i = m->index[slot] - 1;
+            if (i > prev && (found < 0 || i < found) && m->hashes[i] == hash &&
+                dict_key_equal(m->elems[i].key, key, flags))
+                found = i;
+        }
+        return found;
+    }
+
+    for (i = prev + 1; i < m->count; i++) {
+        if (m->hashes[i] == hash && dict_key_equal(m->elems[i].key, key, flags))
+            return i;
+    }
+    return -1;
+}
+
 int ijk_av_dict_count(const IjkAVDictionary *m)
 {
     return m ? m->count : 0;
@@ -40,110 +169,114 @@ int ijk_av_dict_count(const IjkAVDictionary *m)
 IjkAVDictionaryEntry *ijk_av_dict_get(const IjkAVDictionary *m, const char *key,
                                const IjkAVDictionaryEntry *prev, int flags)
 {
-    unsigned int i, j;
+    uint32_t hash = 0;
+    int i;
 
     if (!m)
         return NULL;
 
-    if (prev)
-        i = prev - m->elems + 1;
-    else
-        i = 0;
-
-    for (; i < m->count; i++) {
-        const char *s = m->elems[i].key;
-        if (flags & IJK_AV_DICT_MATCH_CASE)
-            for (j = 0; s[j] == key[j] && key[j]; j++)
-                ;
-        else
-            for (j = 0; toupper(s[j]) == toupper(key[j]) && key[j]; j++)
-                ;
-        if (key[j])
-            continue;
-        if (s[j] && !(flags & IJK_AV_DICT_IGNORE_SUFFIX))
-            continue;
-        return &m->elems[i];
+    if (!(flags & IJK_AV_DICT_IGNORE_SUFFIX))
+        hash = dict_hash(key);
+    i = dict_find(m, key, hash, prev ? (int)(prev - m->elems) : -1, flags);
+    return i >= 0 ? &m->elems[i] : NULL;
+}
+
+static void dict_remove(IjkAVDictionary *m, int i)
+{
+    m->count--;
+    memmove(&m->elems[i], &m->elems[i + 1], (m->count - i) * sizeof(*m->elems));
+    memmove(&m->hashes[i], &m->hashes[i + 1], (m->count - i) * sizeof(*m->hashes));
+    /* cannot fail, the index only shrinks or goes away */
+    if (m->index && m->count >= DICT_INDEX_MIN) {
+        memset(m->index, 0, (m->index_mask + 1) * sizeof(*m->index));
+        for (i = 0; i < m->count; i++)
+            dict_index_insert(m, i);
+    } else {
+        dict_index_rebuild(m, m->count);
     }
-    return NULL;
 }
 
-int ijk_av_dict_set(IjkAVDictionary **pm, const char *key, const char *value,
-                int flags)
+static int dict_set(IjkAVDictionary **pm, const char *key, uint32_t hash,
+                    const char *value, int flags)
 {
     IjkAVDictionary *m = *pm;
-    IjkAVDictionaryEntry *tag = NULL;
-    char *oldval = NULL, *copy_key = NULL, *copy_value = NULL;
+    int found = -1;
+    char *copy_key = NULL, *copy_value = NULL;
 
-    if (!(flags & IJK_AV_DICT_MULTIKEY)) {
-        tag = ijk_av_dict_get(m, key, NULL, flags);
-    }
+    if (m && !(flags & IJK_AV_DICT_MULTIKEY))
+        found = dict_find(m, key, hash, -1, flags);
     if (flags & IJK_AV_DICT_DONT_STRDUP_KEY)
         copy_key = (void *)key;
     else
         copy_key = strdup(key);
     if (flags & IJK_AV_DICT_DONT_STRDUP_VAL)
         copy_value = (void *)value;
-    else if (copy_key)
+    else if (copy_key && value)
         copy_value = strdup(value);
     if (!m)
         m = *pm = (IjkAVDictionary *)calloc(1, sizeof(*m));
     if (!m || (key && !copy_key) || (value && !copy_value))
         goto err_out;
 
-    if (tag) {
+    if (found >= 0) {
+        IjkAVDictionaryEntry *tag = &m->elems[found];
+
         if (flags & IJK_AV_DICT_DONT_OVERWRITE) {
             free(copy_key);
             free(copy_value);
             return 0;
         }
-        if (flags & IJK_AV_DICT_APPEND)
-            oldval = tag->value;
-        else
-            free(tag->value);
-            free(tag->key);
-        *tag = m->elems[--m->count];
-    } else if (copy_value) {
-        IjkAVDictionaryEntry *tmp = (IjkAVDictionaryEntry *)realloc(m->elems,
-                                            (m->count + 1) * sizeof(*m->elems));
-        if (!tmp)
-            goto err_out;
-        m->elems = tmp;
-    }
-    if (copy_value) {
-        m->elems[m->count].key = copy_key;
-        m->elems[m->count].value = copy_value;
-        if (oldval && flags & IJK_AV_DICT_APPEND) {
-            size_t len = strlen(oldval) + strlen(copy_value) + 1;
+        if (copy_value && (flags & IJK_AV_DICT_APPEND)) {
+            size_t len = strlen(tag->value) + strlen(copy_value) + 1;
             char *newval = (char *)calloc(1, len);
             if (!newval)
                 goto err_out;
-            strlcat(newval, oldval, len);
-            ijk_av_freep(&oldval);
-            strlcat(newval, copy_value, len);
-            m->elems[m->count].value = newval;
+            snprintf(newval, len, "%s%s", tag->value, copy_value);
             ijk_av_freep(&copy_value);
+            copy_value = newval;
+        }
+        free(tag->key);
+        free(tag->value);
+        if (copy_value) {
+            /* overwritten in place, the entry keeps its position */
+            tag->key   = copy_key;
+            tag->value = copy_value;
+            m->hashes[found] = hash;
+        } else {
+            ijk_av_freep(&copy_key);
+            dict_remove(m, found);
         }
+    } else if (copy_value) {
+        if (dict_reserve(m, m->count + 1) < 0)
+            goto err_out;
+        m->elems[m->count].key   = copy_key;
+        m->elems[m->count].value = copy_value;
+        m->hashes[m->count]      = hash;
+        if (m->index)
+            dict_index_insert(m, m->count);
         m->count++;
     } else {
         ijk_av_freep(&copy_key);
     }
-    if (!m->count) {
-        ijk_av_freep(&m->elems);
-        ijk_av_freep(pm);
-    }
+    if (!m->count)
+        ijk_av_dict_free(pm);
 
     return 0;
 
 err_out:
-    if (m && !m->count) {
-        ijk_av_freep(&m->elems);
-        ijk_av_freep(pm);
-    }
+    if (m && !m->count)
+        ijk_av_dict_free(pm);
     free(copy_key);
     free(copy_value);
     return -1;
 }
 
+int ijk_av_dict_set(IjkAVDictionary **pm, const char *key, const char *value,
+                int flags)
+{
+    return dict_set(pm, key, key ? dict_hash(key) : 0, value, flags);
+}
+
 int ijk_av_dict_set_int(IjkAVDictionary **pm, const char *key, int64_t value,
                 int flags)
 {
@@ -163,19 +296,29 @@ void ijk_av_dict_free(IjkAVDictionary **pm)
             ijk_av_freep(&m->elems[m->count].value);
         }
         ijk_av_freep(&m->elems);
+        ijk_av_freep(&m->hashes);
+        ijk_av_freep(&m->index);
     }
     ijk_av_freep(pm);
 }
 
 int ijk_av_dict_copy(IjkAVDictionary **dst, const IjkAVDictionary *src, int flags)
 {
-    IjkAVDictionaryEntry *t = NULL;
+    int i, ret;
 
-    while ((t = ijk_av_dict_get(src, "", t, IJK_AV_DICT_IGNORE_SUFFIX))) {
-        int ret = ijk_av_dict_set(dst, t->key, t->value, flags);
-        if (ret < 0)
-            return ret;
-    }
+    if (!src || !src->count)
+        return 0;
 
-    return 0;
+    /* one allocation and one index build for the whole merge */
+    if (!*dst && !(*dst = (IjkAVDictionary *)calloc(1, sizeof(**dst))))
+        return -1;
+    ret = dict_reserve(*dst, (*dst)->count + src->count);
+
+    /* the keys come hashed already */
+    for (i = 0; ret >= 0 && i < src->count; i++)
+        ret = dict_set(dst, src->elems[i].key, src->hashes[i], src->elems[i].value, flags);
+
+    if (ret < 0 && *dst && !(*dst)->count)
+        ijk_av_dict_free(dst);
+    return ret;
 }
@@ -19,12 +19,11 @@
 /**
  * @file
  * Public dictionary API.
- * @deprecated
- *  AVDictionary is provided for compatibility with libav. It is both in
- *  implementation as well as API inefficient. It does not scale and is
- *  extremely slow with large dictionaries.
- *  It is recommended that new code uses our tree container from tree.c/h
- *  where applicable, which uses AVL trees to achieve O(log n) performance.
+ *
+ * Entries are kept in insertion order; an overwritten entry keeps its
+ * position. Beyond a handful of entries exact-key lookups go through a hash
+ * index of the case-folded keys, prefix (IJK_AV_DICT_IGNORE_SUFFIX) lookups
+ * still scan.
  */
 
 #ifndef IJKAVUTIL_IJKDICT_H
@@ -109,7 +108,7 @@ int ijk_av_dict_set_int(IjkAVDictionary **pm, const char *key, int64_t value, in
  *            this function will allocate a struct for you and put it in *dst
  * @param src pointer to source AVDictionary struct
  * @param flags flags to use when setting entries in *dst
- * @note metadata is read using the AV_DICT_IGNORE_SUFFIX flag
+ * @note entries are merged in source order, reusing their key hashes
  * @return 0 on success, negative AVERROR code on failure. If dst was allocated
  *           by this function, callers should free the associated memory.
  */
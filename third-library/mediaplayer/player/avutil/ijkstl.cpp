@@ -17,6 +17,8 @@
  * License along with ijkPlayer; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
+#include <stddef.h>
+#include <stdint.h>
 #include <map>
 
 using namespace std;
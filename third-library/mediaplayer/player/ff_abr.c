@@ -0,0 +1,138 @@
+/*
+ * ff_abr.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ff_abr.h"
+#include <string.h>
+
+/* per-sample decay, half-lives of 2 and 5 segments */
+#define ABR_FAST_ALPHA 0.7071
+#define ABR_SLOW_ALPHA 0.8706
+
+void ffp_abr_init(FFAbr *abr, const int64_t *bitrates, int n_variants, int start_variant)
+{
+    int i, j;
+
+    memset(abr, 0, sizeof(*abr));
+    if (n_variants > FFP_ABR_MAX_VARIANTS)
+        n_variants = FFP_ABR_MAX_VARIANTS;
+    abr->n_variants = n_variants;
+    for (i = 0; i < n_variants; i++) {
+        abr->bitrates[i] = bitrates[i];
+        abr->order[i]    = i;
+    }
+    /* insertion sort, there are only a handful */
+    for (i = 1; i < n_variants; i++) {
+        int v = abr->order[i];
+        for (j = i; j > 0 && abr->bitrates[abr->order[j - 1]] > abr->bitrates[v]; j--)
+            abr->order[j] = abr->order[j - 1];
+        abr->order[j] = v;
+    }
+    abr->cur = (start_variant >= 0 && start_variant < n_variants) ? start_variant : 0;
+
+    abr->panic_ms               = 2000;
+    abr->low_ms                 = 6000;
+    abr->high_ms                = 15000;
+    abr->min_switch_interval_ms = 5000;
+}
+
+void ffp_abr_add_sample(FFAbr *abr, int64_t bps)
+{
+    if (bps <= 0)
+        return;
+    abr->fast_ewma   = ABR_FAST_ALPHA * abr->fast_ewma + (1 - ABR_FAST_ALPHA) * bps;
+    abr->fast_weight = ABR_FAST_ALPHA * abr->fast_weight + (1 - ABR_FAST_ALPHA);
+    abr->slow_ewma   = ABR_SLOW_ALPHA * abr->slow_ewma + (1 - ABR_SLOW_ALPHA) * bps;
+    abr->slow_weight = ABR_SLOW_ALPHA * abr->slow_weight + (1 - ABR_SLOW_ALPHA);
+    abr->n_samples++;
+}
+
+int64_t ffp_abr_get_estimate(FFAbr *abr)
+{
+    double fast, slow;
+
+    if (!abr->n_samples)
+        return 0;
+    /* dividing by the weight removes the bias towards the initial zero */
+    fast = abr->fast_ewma / abr->fast_weight;
+    slow = abr->slow_ewma / abr->slow_weight;
+    return (int64_t)(fast < slow ? fast : slow);
+}
+
+/* position of variant in order[] */
+static int abr_rank(FFAbr *abr, int variant)
+{
+    int i;
+
+    for (i = 0; i < abr->n_variants; i++) {
+        if (abr->order[i] == variant)
+            return i;
+    }
+    return 0;
+}
+
+/* rank of the best variant within budget, the lowest one if none fits */
+static int abr_best_rank(FFAbr *abr, double budget)
+{
+    int i;
+
+    for (i = abr->n_variants - 1; i > 0; i--) {
+        if (abr->bitrates[abr->order[i]] <= budget)
+            break;
+    }
+    return i;
+}
+
+int ffp_abr_choose(FFAbr *abr, int buffer_ms, int64_t now_us)
+{
+    int64_t estimate = ffp_abr_get_estimate(abr);
+    int cur_rank, rank;
+
+    if (abr->n_variants < 2 || !estimate)
+        return abr->cur;
+
+    cur_rank = abr_rank(abr, abr->cur);
+    if (buffer_ms < abr->panic_ms) {
+        rank = abr_best_rank(abr, estimate * 0.5);
+    } else if (buffer_ms < abr->low_ms) {
+        rank = abr_best_rank(abr, estimate * 0.7);
+        if (rank > cur_rank)
+            rank = cur_rank;
+    } else if (buffer_ms < abr->high_ms) {
+        rank = abr_best_rank(abr, estimate * 0.85);
+        if (rank > cur_rank + 1)
+            rank = cur_rank + 1;
+    } else {
+        /* a full buffer rides out a throughput dip without dropping quality */
+        rank = abr_best_rank(abr, estimate);
+        if (rank < cur_rank)
+            rank = cur_rank;
+    }
+
+    if (rank > cur_rank &&
+        abr->last_switch_time &&
+        now_us - abr->last_switch_time < (int64_t)abr->min_switch_interval_ms * 1000)
+        rank = cur_rank;
+
+    if (rank != cur_rank) {
+        abr->cur = abr->order[rank];
+        abr->last_switch_time = now_us;
+    }
+    return abr->cur;
+}
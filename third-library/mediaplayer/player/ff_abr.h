@@ -0,0 +1,70 @@
+/*
+ * ff_abr.h
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef FFPLAY__FF_ABR_H
+#define FFPLAY__FF_ABR_H
+
+#include <stdint.h>
+
+/*
+ * Variant selection for adaptive streams, independent of FFmpeg so that
+ * bench/abr_sim.c can drive it with the same inputs as read_thread:
+ * throughput samples (one per downloaded segment) and the buffered
+ * duration. Throughput is tracked by a fast and a slow EWMA and the lower
+ * one is trusted. The buffer level decides how much of it may be spent:
+ *
+ *   buffer < panic_ms       lowest variant that fits in half the estimate
+ *   buffer < low_ms         no up-switch, spend 70% of the estimate
+ *   buffer < high_ms        up one variant at a time, spend 85%
+ *   otherwise               best variant that fits in the estimate, no
+ *                           down-switch
+ *
+ * Up-switches are at least min_switch_interval_ms apart; down-switches are
+ * immediate.
+ */
+
+#define FFP_ABR_MAX_VARIANTS 16
+
+typedef struct FFAbr {
+    int     n_variants;
+    int64_t bitrates[FFP_ABR_MAX_VARIANTS];   /* bps, by variant index */
+    int     order[FFP_ABR_MAX_VARIANTS];      /* variant indexes by ascending bitrate */
+    int     cur;                              /* variant index */
+
+    double  fast_ewma, fast_weight;
+    double  slow_ewma, slow_weight;
+    int     n_samples;
+    int64_t last_switch_time;                 /* us */
+
+    int     panic_ms;
+    int     low_ms;
+    int     high_ms;
+    int     min_switch_interval_ms;
+} FFAbr;
+
+void    ffp_abr_init(FFAbr *abr, const int64_t *bitrates, int n_variants, int start_variant);
+/* bps measured over a segment download */
+void    ffp_abr_add_sample(FFAbr *abr, int64_t bps);
+/* bps, 0 until the first sample */
+int64_t ffp_abr_get_estimate(FFAbr *abr);
+/* returns the variant index to use from the next segment on */
+int     ffp_abr_choose(FFAbr *abr, int buffer_ms, int64_t now_us);
+
+#endif
@@ -41,6 +41,7 @@
 #define FFP_MSG_COMPONENT_OPEN              409
 #define FFP_MSG_VIDEO_SEEK_RENDERING_START  410
 #define FFP_MSG_AUDIO_SEEK_RENDERING_START  411
+#define FFP_MSG_PRELOAD_READY               412     /* preload standby holds a keyframe, see ffp_promote_l() */
 
 #define FFP_MSG_BUFFERING_START             500
 #define FFP_MSG_BUFFERING_END               501
@@ -106,4 +107,21 @@
 #define FFP_PROP_INT64_SHARE_CACHE_DATA                 20210
 #define FFP_PROP_INT64_IMMEDIATE_RECONNECT              20211
 
+// demux -> display latency of video frames, milliseconds
+#define FFP_PROP_INT64_DISPLAY_LATENCY_P50              20212
+#define FFP_PROP_INT64_DISPLAY_LATENCY_P95              20213
+#define FFP_PROP_INT64_DISPLAY_LATENCY_P99              20214
+#define FFP_PROP_INT64_DISPLAY_LATENCY_MAX              20215
+#define FFP_PROP_INT64_DISPLAY_LATENCY_COUNT            20216
+
+// hls abr, bits per second
+#define FFP_PROP_INT64_ABR_BANDWIDTH                    20217
+#define FFP_PROP_INT64_ABR_BITRATE                      20218
+
+// distance of video frames from their target time on screen, microseconds
+#define FFP_PROP_INT64_PRESENT_ERROR_P50                20219
+#define FFP_PROP_INT64_PRESENT_ERROR_P95                20220
+#define FFP_PROP_INT64_PRESENT_ERROR_MAX                20221
+#define FFP_PROP_INT64_PRESENT_ERROR_COUNT              20222
+
 #endif
@@ -64,12 +64,17 @@
 #endif
 
 #include "ijksdl/ijksdl_log.h"
+#include "ijksdl/ijksdl_trace.h"
 #include "ijkavformat/ijkavformat.h"
 #include "ff_cmdutils.h"
 #include "ff_fferror.h"
 #include "ff_ffpipeline.h"
 #include "ff_ffpipenode.h"
 #include "ff_ffplay_debug.h"
+#include "ff_probe_cache.h"
+#include "ff_abr.h"
+#include "ff_pacer.h"
+#include "ff_framedrop.h"
 #include "ijkmeta.h"
 #include "ijkversion.h"
 #include "ijkplayer.h"
@@ -140,6 +145,14 @@ int64_t get_valid_channel_layout(int64_t channel_layout, int channels)
 
 static void free_picture(Frame *vp);
 
+/* media timestamp carried by trace events */
+static int64_t trace_pts_us(AVRational tb, int64_t ts)
+{
+    if (ts == AV_NOPTS_VALUE || !tb.den)
+        return -1;
+    return av_rescale_q(ts, tb, AV_TIME_BASE_Q);
+}
+
 static int packet_queue_put_private(PacketQueue *q, AVPacket *pkt)
 {
     MyAVPacketList *pkt1;
@@ -172,6 +185,7 @@ static int packet_queue_put_private(PacketQueue *q, AVPacket *pkt)
     if (pkt == &flush_pkt)
         q->serial++;
     pkt1->serial = q->serial;
+    pkt1->recv_time = av_gettime_relative();
 
     if (!q->last_pkt)
         q->first_pkt = pkt1;
@@ -183,6 +197,9 @@ static int packet_queue_put_private(PacketQueue *q, AVPacket *pkt)
 
     q->duration += FFMAX(pkt1->pkt.duration, MIN_PKT_DURATION);
 
+    if (pkt != &flush_pkt)
+        SDL_TRACE_INSTANT("enqueue", pkt->stream_index, trace_pts_us(q->time_base, pkt->pts));
+
     /* XXX: should duplicate packet data in DV case */
     SDL_CondSignal(q->cond);
     return 0;
@@ -289,6 +306,92 @@ static void packet_queue_start(PacketQueue *q)
     SDL_UnlockMutex(q->mutex);
 }
 
+static void packet_queue_hold(PacketQueue *q, int hold)
+{
+    SDL_LockMutex(q->mutex);
+    q->hold = hold;
+    SDL_CondSignal(q->cond);
+    SDL_UnlockMutex(q->mutex);
+}
+
+static int64_t packet_ts(const AVPacket *pkt)
+{
+    return pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts;
+}
+
+static void packet_queue_drop_l(PacketQueue *q, MyAVPacketList *pkt1)
+{
+    q->nb_packets--;
+    q->size -= pkt1->pkt.size + sizeof(*pkt1);
+    q->duration -= FFMAX(pkt1->pkt.duration, MIN_PKT_DURATION);
+    av_packet_unref(&pkt1->pkt);
+    pkt1->next = q->recycle_pkt;
+    q->recycle_pkt = pkt1;
+}
+
+/*
+ * Drop the video packets before the last keyframe of the current serial,
+ * and the audio packets older than that keyframe. Flush packets are kept so
+ * the decoders still see every serial change.
+ */
+static void packet_queue_trim_to_keyframe(FFPlayer *ffp, PacketQueue *videoq, PacketQueue *audioq)
+{
+    MyAVPacketList *pkt1, *next, *key = NULL, **link;
+    int64_t key_ts = AV_NOPTS_VALUE;
+    int dropped_video = 0, dropped_audio = 0;
+
+    SDL_LockMutex(videoq->mutex);
+    for (pkt1 = videoq->first_pkt; pkt1; pkt1 = pkt1->next) {
+        if (pkt1->pkt.data == flush_pkt.data)
+            key = NULL;
+        else if (pkt1->pkt.flags & AV_PKT_FLAG_KEY)
+            key = pkt1;
+    }
+    if (key) {
+        key_ts = packet_ts(&key->pkt);
+        link = &videoq->first_pkt;
+        for (pkt1 = videoq->first_pkt; pkt1 != key; pkt1 = next) {
+            next = pkt1->next;
+            if (pkt1->pkt.data == flush_pkt.data) {
+                *link = pkt1;
+                link = &pkt1->next;
+                continue;
+            }
+            packet_queue_drop_l(videoq, pkt1);
+            dropped_video++;
+        }
+        *link = key;
+    }
+    SDL_UnlockMutex(videoq->mutex);
+
+    if (audioq && key_ts != AV_NOPTS_VALUE) {
+        SDL_LockMutex(audioq->mutex);
+        link = &audioq->first_pkt;
+        for (pkt1 = audioq->first_pkt; pkt1; pkt1 = next) {
+            int64_t ts = packet_ts(&pkt1->pkt);
+            next = pkt1->next;
+            if (pkt1->pkt.data != flush_pkt.data && ts != AV_NOPTS_VALUE &&
+                pkt1->serial == audioq->serial &&
+                av_compare_ts(ts, audioq->time_base, key_ts, videoq->time_base) < 0) {
+                packet_queue_drop_l(audioq, pkt1);
+                dropped_audio++;
+                continue;
+            }
+            *link = pkt1;
+            link = &pkt1->next;
+        }
+        *link = NULL;
+        audioq->last_pkt = NULL;
+        for (pkt1 = audioq->first_pkt; pkt1; pkt1 = pkt1->next)
+            audioq->last_pkt = pkt1;
+        SDL_UnlockMutex(audioq->mutex);
+    }
+
+    if (dropped_video || dropped_audio)
+        av_log(ffp, AV_LOG_INFO, "gop-join: dropped %d video, %d audio packets before keyframe\n",
+               dropped_video, dropped_audio);
+}
+
 /* return < 0 if aborted, 0 if no packet and > 0 if packet.  */
 static int packet_queue_get(PacketQueue *q, AVPacket *pkt, int block, int *serial)
 {
@@ -303,7 +406,7 @@ static int packet_queue_get(PacketQueue *q, AVPacket *pkt, int block, int *seria
             break;
         }
 
-        pkt1 = q->first_pkt;
+        pkt1 = q->hold ? NULL : q->first_pkt;
         if (pkt1) {
             q->first_pkt = pkt1->next;
             if (!q->first_pkt)
@@ -314,6 +417,7 @@ static int packet_queue_get(PacketQueue *q, AVPacket *pkt, int block, int *seria
             *pkt = pkt1->pkt;
             if (serial)
                 *serial = pkt1->serial;
+            q->last_recv_time = pkt1->recv_time;
 #ifdef FFP_MERGE
             av_free(pkt1);
 #else
@@ -368,6 +472,8 @@ static void decoder_init(Decoder *d, AVCodecContext *avctx, PacketQueue *queue,
     d->queue = queue;
     d->empty_queue_cond = empty_queue_cond;
     d->start_pts = AV_NOPTS_VALUE;
+    if (avctx)
+        queue->time_base = av_codec_get_pkt_timebase(avctx);
 
     d->first_frame_decoded_time = SDL_GetTickHR();
     d->first_frame_decoded = 0;
@@ -563,6 +669,22 @@ fail0:
     return ret;
 }
 
+static const enum AVDiscard framedrop_discards[] = { AVDISCARD_DEFAULT, AVDISCARD_NONREF, AVDISCARD_BIDIR };
+
+/* sets skip_frame for the level is->framedrop is at, called on the video decoder thread */
+static void decoder_apply_framedrop(FFPlayer *ffp, AVCodecContext *avctx, int old_level)
+{
+    VideoState *is = ffp->is;
+    int level = is->framedrop.level;
+
+    if (old_level == FFP_FRAMEDROP_NONE)
+        is->video_skip_frame = avctx->skip_frame;
+    if (level == FFP_FRAMEDROP_NONE)
+        avctx->skip_frame = is->video_skip_frame;
+    else
+        avctx->skip_frame = FFMAX(is->video_skip_frame, framedrop_discards[level]);
+}
+
 static int decoder_decode_frame(FFPlayer *ffp, Decoder *d, AVFrame *frame, AVSubtitle *sub) {
     int ret = AVERROR(EAGAIN);
 
@@ -578,6 +700,8 @@ static int decoder_decode_frame(FFPlayer *ffp, Decoder *d, AVFrame *frame, AVSub
                     case AVMEDIA_TYPE_VIDEO:
                         ret = avcodec_receive_frame(d->avctx, frame);
                         if (ret >= 0) {
+                            SDL_TRACE_INSTANT("decoded", ffp->is->video_stream,
+                                              trace_pts_us(d->queue->time_base, frame->best_effort_timestamp));
                             ffp->stat.vdps = SDL_SpeedSamplerAdd(&ffp->vdps_sampler, FFP_SHOW_VDPS_AVCODEC, "vdps[avcodec]");
                             if (ffp->decoder_reorder_pts == -1) {
                                 frame->pts = frame->best_effort_timestamp;
@@ -630,6 +754,18 @@ static int decoder_decode_frame(FFPlayer *ffp, Decoder *d, AVFrame *frame, AVSub
             d->finished = 0;
             d->next_pts = d->start_pts;
             d->next_pts_tb = d->start_pts_tb;
+            if (d->avctx->codec_type == AVMEDIA_TYPE_VIDEO && ffp->is->framedrop.level != FFP_FRAMEDROP_NONE) {
+                int old_level = ffp->is->framedrop.level;
+                ffp_framedrop_reset(&ffp->is->framedrop);
+                decoder_apply_framedrop(ffp, d->avctx, old_level);
+            }
+        } else if (d->avctx->codec_type == AVMEDIA_TYPE_VIDEO &&
+                   ffp_framedrop_skip_packet(&ffp->is->framedrop, pkt.data, pkt.size)) {
+            /* nothing refers to it, the decoder never needs to see it */
+            ffp->stat.decode_frame_count++;
+            ffp->stat.drop_frame_count++;
+            ffp->stat.drop_frame_rate = (float)(ffp->stat.drop_frame_count) / (float)(ffp->stat.decode_frame_count);
+            av_packet_unref(&pkt);
         } else {
             if (d->avctx->codec_type == AVMEDIA_TYPE_SUBTITLE) {
                 int got_frame = 0;
@@ -644,7 +780,15 @@ static int decoder_decode_frame(FFPlayer *ffp, Decoder *d, AVFrame *frame, AVSub
                     ret = got_frame ? 0 : (pkt.data ? AVERROR(EAGAIN) : AVERROR_EOF);
                 }
             } else {
-                if (avcodec_send_packet(d->avctx, &pkt) == AVERROR(EAGAIN)) {
+                int64_t trace_pts = trace_pts_us(d->queue->time_base, pkt.pts);
+                int send_ret;
+
+                /* carried through decoder reordering to the frame */
+                d->avctx->reordered_opaque = d->queue->last_recv_time;
+                SDL_TRACE_BEGIN("decode", pkt.stream_index, trace_pts);
+                send_ret = avcodec_send_packet(d->avctx, &pkt);
+                SDL_TRACE_END("decode", pkt.stream_index, trace_pts);
+                if (send_ret == AVERROR(EAGAIN)) {
                     av_log(d->avctx, AV_LOG_ERROR, "Receive_frame and send_packet both returned EAGAIN, which is an API violation.\n");
                     d->packet_pending = 1;
                     av_packet_move_ref(&d->pkt, &pkt);
@@ -658,6 +802,7 @@ static int decoder_decode_frame(FFPlayer *ffp, Decoder *d, AVFrame *frame, AVSub
 static void decoder_destroy(Decoder *d) {
     av_packet_unref(&d->pkt);
     avcodec_free_context(&d->avctx);
+    SDL_FFmpegFramePool_freep(&d->frame_pool);
 }
 
 static void frame_queue_unref_item(Frame *vp)
@@ -909,6 +1054,7 @@ static void video_image_display2(FFPlayer *ffp)
             }
         }
         SDL_VoutDisplayYUVOverlay(ffp->vout, vp->bmp);
+        SDL_TRACE_INSTANT("display", is->video_stream, isnan(vp->pts) ? -1 : (int64_t)(vp->pts * 1000000));
         ffp->stat.vfps = SDL_SpeedSamplerAdd(&ffp->vfps_sampler, FFP_SHOW_VFPS_FFPLAY, "vfps[ffplay]");
         if (!ffp->first_video_frame_rendered) {
             ffp->first_video_frame_rendered = 1;
@@ -932,6 +1078,39 @@ static void video_image_display2(FFPlayer *ffp)
 // FFP_MERGE: compute_mod
 // FFP_MERGE: video_audio_display
 
+static void log_aout_stats(FFPlayer *ffp)
+{
+    SDL_AoutStats stats;
+
+    if (SDL_AoutGetStats(ffp->aout, &stats) < 0 || !stats.callbacks)
+        return;
+
+    av_log(ffp, AV_LOG_INFO, "aout: %d x %d frames queued, latency %.1f ms, %"PRId64" underruns, "
+           "jitter %.2f ms (max %.2f), callback max %.2f ms\n",
+           stats.queue_buffers, stats.buffer_frames, stats.latency_seconds * 1000, stats.underruns,
+           stats.jitter_ms, stats.max_jitter_ms, stats.max_callback_ms);
+}
+
+static void log_pacer_stats(FFPlayer *ffp)
+{
+    FFPacer *pacer = &ffp->is->pacer;
+    char holds[256] = "";
+    int len = 0;
+
+    if (pacer->frames < 2)
+        return;
+
+    for (int i = 1; i <= FFP_PACER_MAX_HOLD && len < sizeof(holds); i++) {
+        if (pacer->holds[i])
+            len += snprintf(holds + len, sizeof(holds) - len, " %d%s:%"PRId64,
+                            i, i == FFP_PACER_MAX_HOLD ? "+" : "", pacer->holds[i]);
+    }
+    av_log(ffp, AV_LOG_INFO, "pacer: %"PRId64" frames on a %.2f ms vsync, error avg %.2f ms max %.2f ms, "
+           "%"PRId64" relocks, holds%s\n",
+           pacer->frames, pacer->period / 1000.0, pacer->error_sum / 1000.0 / pacer->frames,
+           pacer->error_max / 1000.0, pacer->relocks, holds);
+}
+
 static void stream_component_close(FFPlayer *ffp, int stream_index)
 {
     VideoState *is = ffp->is;
@@ -945,6 +1124,7 @@ static void stream_component_close(FFPlayer *ffp, int stream_index)
     switch (codecpar->codec_type) {
     case AVMEDIA_TYPE_AUDIO:
         decoder_abort(&is->auddec, &is->sampq);
+        log_aout_stats(ffp);
         SDL_AoutCloseAudio(ffp->aout);
 
         decoder_destroy(&is->auddec);
@@ -965,6 +1145,10 @@ static void stream_component_close(FFPlayer *ffp, int stream_index)
     case AVMEDIA_TYPE_VIDEO:
         decoder_abort(&is->viddec, &is->pictq);
         decoder_destroy(&is->viddec);
+        if (is->framedrop.level_changes)
+            av_log(ffp, AV_LOG_INFO, "framedrop: %"PRId64" packets skipped before decode, "
+                   "%d decoder level changes, up to level %d\n",
+                   is->framedrop.skipped_packets, is->framedrop.level_changes, is->framedrop.max_level);
         break;
     case AVMEDIA_TYPE_SUBTITLE:
         decoder_abort(&is->subdec, &is->subpq);
@@ -1015,6 +1199,7 @@ static void stream_close(FFPlayer *ffp)
 
     av_log(NULL, AV_LOG_DEBUG, "wait for video_refresh_tid\n");
     SDL_WaitThread(is->video_refresh_tid, NULL);
+    log_pacer_stats(ffp);
 
     packet_queue_destroy(&is->videoq);
     packet_queue_destroy(&is->audioq);
@@ -1069,6 +1254,15 @@ static void video_display2(FFPlayer *ffp)
         video_image_display2(ffp);
 }
 
+/* the time clocks run on: the audio output's, if it plays faster than real time, else the wall clock */
+static int64_t clock_time_us(SDL_Aout *aout)
+{
+    int64_t time_us;
+    if (SDL_AoutGetTimeUs(aout, &time_us) < 0)
+        time_us = av_gettime_relative();
+    return time_us;
+}
+
 static double get_clock(Clock *c)
 {
     if (*c->queue_serial != c->serial)
@@ -1076,7 +1270,7 @@ static double get_clock(Clock *c)
     if (c->paused) {
         return c->pts;
     } else {
-        double time = av_gettime_relative() / 1000000.0;
+        double time = clock_time_us(c->aout) / 1000000.0;
         return c->pts_drift + time - (time - c->last_updated) * (1.0 - c->speed);
     }
 }
@@ -1091,7 +1285,7 @@ static void set_clock_at(Clock *c, double pts, int serial, double time)
 
 static void set_clock(Clock *c, double pts, int serial)
 {
-    double time = av_gettime_relative() / 1000000.0;
+    double time = clock_time_us(c->aout) / 1000000.0;
     set_clock_at(c, pts, serial, time);
 }
 
@@ -1101,11 +1295,12 @@ static void set_clock_speed(Clock *c, double speed)
     c->speed = speed;
 }
 
-static void init_clock(Clock *c, int *queue_serial)
+static void init_clock(Clock *c, int *queue_serial, SDL_Aout *aout)
 {
     c->speed = 1.0;
     c->paused = 0;
     c->queue_serial = queue_serial;
+    c->aout = aout;
     set_clock(c, NAN, -1);
 }
 
@@ -1185,7 +1380,8 @@ static void stream_toggle_pause_l(FFPlayer *ffp, int pause_on)
 {
     VideoState *is = ffp->is;
     if (is->paused && !pause_on) {
-        is->frame_timer += av_gettime_relative() / 1000000.0 - is->vidclk.last_updated;
+        is->frame_timer += clock_time_us(ffp->aout) / 1000000.0 - is->vidclk.last_updated;
+        is->pacer_reset_req = 1;
 
 #ifdef FFP_MERGE
         if (is->read_pause_return != AVERROR(ENOSYS)) {
@@ -1302,6 +1498,33 @@ static void update_video_pts(VideoState *is, double pts, int64_t pos, int serial
     sync_clock_to_slave(&is->extclk, &is->vidclk);
 }
 
+/* counts each frame once, on its first display */
+static void update_display_latency(FFPlayer *ffp)
+{
+    VideoState *is = ffp->is;
+    Frame *vp = frame_queue_peek_last(&is->pictq);
+
+    if (vp->recv_time > 0 && vp->serial == is->videoq.serial)
+        SDL_HistogramAdd(&ffp->stat.display_latency, av_gettime_relative() - vp->recv_time);
+    vp->recv_time = 0;
+}
+
+/* how far from its target time the frame about to be displayed reaches the screen */
+static void update_present_error(FFPlayer *ffp, double target_time)
+{
+    int64_t vsync, period, now, visible, target;
+
+    if (SDL_VoutGetVsync(ffp->vout, &vsync, &period) < 0 || period <= 0)
+        return;
+
+    now     = av_gettime_relative();
+    visible = vsync + ((now - vsync) / period + 1) * period;
+    target  = llrint(target_time * 1000000.0);
+    SDL_HistogramAdd(&ffp->stat.present_error, llabs(visible - target));
+    av_log(ffp, AV_LOG_TRACE, "present: target %"PRId64" visible %"PRId64" error %+"PRId64" us\n",
+           target, visible, visible - target);
+}
+
 /* called to display each frame */
 static void video_refresh(FFPlayer *opaque, double *remaining_time)
 {
@@ -1315,7 +1538,7 @@ static void video_refresh(FFPlayer *opaque, double *remaining_time)
         check_external_clock_speed(is);
 
     if (!ffp->display_disable && is->show_mode != SHOW_MODE_VIDEO && is->audio_st) {
-        time = av_gettime_relative() / 1000000.0;
+        time = clock_time_us(ffp->aout) / 1000000.0;
         if (is->force_refresh || is->last_vis_time + ffp->rdftspeed < time) {
             video_display2(ffp);
             is->last_vis_time = time;
@@ -1324,11 +1547,16 @@ static void video_refresh(FFPlayer *opaque, double *remaining_time)
     }
 
     if (is->video_st) {
+        if (is->pacer_reset_req) {
+            is->pacer_reset_req = 0;
+            ffp_pacer_reset(&is->pacer);
+        }
 retry:
         if (frame_queue_nb_remaining(&is->pictq) == 0) {
             // nothing to do, no picture to display in the queue
         } else {
-            double last_duration, duration, delay;
+            double last_duration, duration, delay, target_time, deadline;
+            int64_t vsync, period;
             Frame *vp, *lastvp;
 
             /* dequeue the picture */
@@ -1340,8 +1568,10 @@ retry:
                 goto retry;
             }
 
-            if (lastvp->serial != vp->serial)
-                is->frame_timer = av_gettime_relative() / 1000000.0;
+            if (lastvp->serial != vp->serial) {
+                is->frame_timer = clock_time_us(ffp->aout) / 1000000.0;
+                ffp_pacer_reset(&is->pacer);
+            }
 
             if (is->paused)
                 goto display;
@@ -1350,11 +1580,21 @@ retry:
             last_duration = vp_duration(is, lastvp, vp);
             delay = compute_target_delay(ffp, last_duration, is);
 
-            time= av_gettime_relative()/1000000.0;
+            time= clock_time_us(ffp->aout)/1000000.0;
             if (isnan(is->frame_timer) || time < is->frame_timer)
                 is->frame_timer = time;
-            if (time < is->frame_timer + delay) {
-                *remaining_time = FFMIN(is->frame_timer + delay - time, *remaining_time);
+            target_time = is->frame_timer + delay;
+            deadline    = target_time;
+            if (ffp->vsync_pacing && !is->step && SDL_VoutGetVsync(ffp->vout, &vsync, &period) >= 0) {
+                /* pick the vsync once per frame, again only if the cadence was restarted meanwhile */
+                if (!vp->present_time || !is->pacer.locked)
+                    vp->present_time = ffp_pacer_schedule(&is->pacer, llrint(target_time * 1000000.0),
+                                                          llrint(last_duration * 1000000.0), vsync, period);
+                /* hand it over early enough to make that vsync, but not the one before */
+                deadline = (vp->present_time - period * 3 / 4) / 1000000.0;
+            }
+            if (time < deadline) {
+                *remaining_time = FFMIN(deadline - time, *remaining_time);
                 goto display;
             }
 
@@ -1399,6 +1639,9 @@ retry:
                 }
             }
 
+            if (!ffp->display_disable)
+                update_present_error(ffp, target_time);
+
             frame_queue_next(&is->pictq);
             is->force_refresh = 1;
 
@@ -1412,8 +1655,10 @@ retry:
         }
 display:
         /* display picture */
-        if (!ffp->display_disable && is->force_refresh && is->show_mode == SHOW_MODE_VIDEO && is->pictq.rindex_shown)
+        if (!ffp->display_disable && is->force_refresh && is->show_mode == SHOW_MODE_VIDEO && is->pictq.rindex_shown) {
             video_display2(ffp);
+            update_display_latency(ffp);
+        }
     }
     is->force_refresh = 0;
     if (ffp->show_status) {
@@ -1667,6 +1912,8 @@ static int queue_picture(FFPlayer *ffp, AVFrame *src_frame, double pts, double d
         vp->duration = duration;
         vp->pos = pos;
         vp->serial = serial;
+        vp->recv_time = src_frame->reordered_opaque > 0 ? src_frame->reordered_opaque : 0;
+        vp->present_time = 0;
         vp->sar = src_frame->sample_aspect_ratio;
         vp->bmp->sar_num = vp->sar.num;
         vp->bmp->sar_den = vp->sar.den;
@@ -1675,6 +1922,7 @@ static int queue_picture(FFPlayer *ffp, AVFrame *src_frame, double pts, double d
         av_frame_move_ref(vp->frame, src_frame);
 #endif
         frame_queue_push(&is->pictq);
+        SDL_TRACE_INSTANT("queue_picture", is->video_stream, isnan(pts) ? -1 : (int64_t)(pts * 1000000));
         if (!is->viddec.first_frame_decoded) {
             ALOGD("Video: first frame decoded\n");
             ffp_notify_msg1(ffp, FFP_MSG_VIDEO_DECODED_START);
@@ -1706,6 +1954,15 @@ static int get_video_frame(FFPlayer *ffp, AVFrame *frame)
             ffp->stat.decode_frame_count++;
             if (frame->pts != AV_NOPTS_VALUE) {
                 double diff = dpts - get_master_clock(is);
+                if (!isnan(diff) && fabs(diff) < AV_NOSYNC_THRESHOLD &&
+                    is->viddec.pkt_serial == is->vidclk.serial) {
+                    int old_level = is->framedrop.level;
+                    if (ffp_framedrop_update(&is->framedrop, -diff) != old_level) {
+                        decoder_apply_framedrop(ffp, is->viddec.avctx, old_level);
+                        av_log(ffp, AV_LOG_INFO, "framedrop: decoder level %d -> %d, video %.3f s late\n",
+                               old_level, is->framedrop.level, -diff);
+                    }
+                }
                 if (!isnan(diff) && fabs(diff) < AV_NOSYNC_THRESHOLD &&
                     diff - is->frame_last_filter_delay < 0 &&
                     is->viddec.pkt_serial == is->vidclk.serial &&
@@ -2633,12 +2890,14 @@ static void sdl_audio_callback(void *opaque, Uint8 *stream, int len)
     FFPlayer *ffp = opaque;
     VideoState *is = ffp->is;
     int audio_size, len1;
+    double callback_time;
     if (!ffp || !is) {
         memset(stream, 0, len);
         return;
     }
 
     ffp->audio_callback_time = av_gettime_relative();
+    callback_time = clock_time_us(ffp->aout) / 1000000.0;
 
     if (ffp->pf_playback_rate_changed) {
         ffp->pf_playback_rate_changed = 0;
@@ -2692,9 +2951,9 @@ static void sdl_audio_callback(void *opaque, Uint8 *stream, int len)
         is->audio_buf_index += len1;
     }
     is->audio_write_buf_size = is->audio_buf_size - is->audio_buf_index;
-    /* Let's assume the audio driver that is used by SDL has two periods. */
+    /* Outputs that can measure it report the latency at the start of this callback; the rest are assumed to have two periods. */
     if (!isnan(is->audio_clock)) {
-        set_clock_at(&is->audclk, is->audio_clock - (double)(is->audio_write_buf_size) / is->audio_tgt.bytes_per_sec - SDL_AoutGetLatencySeconds(ffp->aout), is->audio_clock_serial, ffp->audio_callback_time / 1000000.0);
+        set_clock_at(&is->audclk, is->audio_clock - (double)(is->audio_write_buf_size) / is->audio_tgt.bytes_per_sec - SDL_AoutGetLatencySeconds(ffp->aout), is->audio_clock_serial, callback_time);
         sync_clock_to_slave(&is->extclk, &is->audclk);
     }
     if (!ffp->first_audio_frame_rendered) {
@@ -2813,6 +3072,7 @@ static int stream_component_open(FFPlayer *ffp, int stream_index)
     const char *forced_codec_name = NULL;
     AVDictionary *opts = NULL;
     AVDictionaryEntry *t = NULL;
+    SDL_FFmpegFramePool *frame_pool = NULL;
     int sample_rate, nb_channels;
     int64_t channel_layout;
     int ret = 0;
@@ -2873,6 +3133,8 @@ static int stream_component_open(FFPlayer *ffp, int stream_index)
         av_dict_set_int(&opts, "lowres", stream_lowres, 0);
     if (avctx->codec_type == AVMEDIA_TYPE_VIDEO || avctx->codec_type == AVMEDIA_TYPE_AUDIO)
         av_dict_set(&opts, "refcounted_frames", "1", 0);
+    if (avctx->codec_type == AVMEDIA_TYPE_VIDEO && ffp->direct_rendering)
+        frame_pool = SDL_FFmpegFramePool_attach(avctx, codec);
     if ((ret = avcodec_open2(avctx, codec, &opts)) < 0) {
         goto fail;
     }
@@ -2946,6 +3208,13 @@ static int stream_component_open(FFPlayer *ffp, int stream_index)
         is->video_stream = stream_index;
         is->video_st = ic->streams[stream_index];
 
+        ffp_framedrop_init(&is->framedrop, ffp->framedrop_decoder / 1000.0);
+        ffp_framedrop_set_stream(&is->framedrop,
+                                 avctx->codec_id == AV_CODEC_ID_H264 ? FFP_FRAMEDROP_CODEC_H264 :
+                                 avctx->codec_id == AV_CODEC_ID_HEVC ? FFP_FRAMEDROP_CODEC_HEVC :
+                                 FFP_FRAMEDROP_CODEC_OTHER,
+                                 avctx->extradata, avctx->extradata_size);
+
         if (ffp->async_init_decoder) {
             while (!is->initialized_decoder) {
                 SDL_Delay(5);
@@ -2966,6 +3235,8 @@ static int stream_component_open(FFPlayer *ffp, int stream_index)
             if (!ffp->node_vdec)
                 goto fail;
         }
+        is->viddec.frame_pool = frame_pool;
+        frame_pool = NULL;
         if ((ret = decoder_start(&is->viddec, video_thread, ffp, "ff_video_dec")) < 0)
             goto out;
 
@@ -3020,6 +3291,7 @@ static int stream_component_open(FFPlayer *ffp, int stream_index)
 fail:
     avcodec_free_context(&avctx);
 out:
+    SDL_FFmpegFramePool_freep(&frame_pool);
     av_dict_free(&opts);
 
     return ret;
@@ -3057,6 +3329,142 @@ static int is_realtime(AVFormatContext *s)
     return 0;
 }
 
+/*
+ * preload standby: keep reading, but hold only the packets from the latest
+ * video keyframe on, so that promotion can start decoding right away. The
+ * held packets are returned in *pkts and fed through the normal read path;
+ * *eof tells it the input ended, or broke, while standing by.
+ */
+static int read_thread_standby(FFPlayer *ffp, AVFormatContext *ic, int *st_index,
+                               AVPacketList **pkts, int *eof_out, SDL_mutex *wait_mutex)
+{
+    VideoState *is = ffp->is;
+    AVPacketList *pending = *pkts;
+    AVPacketList *gop = NULL, **gop_tail = &gop;
+    AVPacketList *pktl;
+    AVPacket pkt1, *pkt = &pkt1;
+    int video = st_index[AVMEDIA_TYPE_VIDEO];
+    int audio = st_index[AVMEDIA_TYPE_AUDIO];
+    int64_t gop_size = 0;
+    int eof = 0;
+    int ready = 0;
+    int ret = 0;
+
+    *pkts = NULL;
+    if (video >= 0)
+        ic->streams[video]->discard = AVDISCARD_DEFAULT;
+    if (audio >= 0)
+        ic->streams[audio]->discard = AVDISCARD_DEFAULT;
+
+    av_log(ffp, AV_LOG_INFO, "preload: standby\n");
+    while (!is->abort_request && !is->promote_req) {
+        if (pending) {
+            pktl = pending;
+            pending = pktl->next;
+            *pkt = pktl->pkt;
+            av_free(pktl);
+            ret = 0;
+        } else if (!eof) {
+            ret = av_read_frame(ic, pkt);
+        } else {
+            ret = AVERROR_EOF;
+        }
+
+        if (ret < 0) {
+            /* stop reading; what went wrong is reported after promotion */
+            if (ret == AVERROR_EOF || avio_feof(ic->pb) || (ic->pb && ic->pb->error))
+                eof = 1;
+            SDL_LockMutex(wait_mutex);
+            if (!is->promote_req && !is->abort_request)
+                SDL_CondWaitTimeout(is->continue_read_thread, wait_mutex, 10);
+            SDL_UnlockMutex(wait_mutex);
+            continue;
+        }
+
+        if (pkt->stream_index != video && pkt->stream_index != audio) {
+            av_packet_unref(pkt);
+            continue;
+        }
+        if (video < 0 || (pkt->stream_index == video && (pkt->flags & AV_PKT_FLAG_KEY))) {
+            ffp_probe_cache_packets_free(&gop);
+            gop_tail = &gop;
+            gop_size = 0;
+            if (!ready) {
+                ready = 1;
+                ffp_notify_msg1(ffp, FFP_MSG_PRELOAD_READY);
+            }
+        } else if (!gop) {
+            /* nothing to decode from until the next keyframe */
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        pktl = av_malloc(sizeof(AVPacketList));
+        if (!pktl) {
+            av_packet_unref(pkt);
+            ret = AVERROR(ENOMEM);
+            break;
+        }
+        pktl->pkt  = *pkt;
+        pktl->next = NULL;
+        *gop_tail  = pktl;
+        gop_tail   = &pktl->next;
+        gop_size  += pkt->size;
+
+        /* a gop larger than the whole buffer is held until the next one */
+        if (gop_size > ffp->dcc.max_buffer_size) {
+            ffp_probe_cache_packets_free(&gop);
+            gop_tail = &gop;
+            gop_size = 0;
+        }
+    }
+
+    if (is->abort_request || !is->promote_req) {
+        ffp_probe_cache_packets_free(&pending);
+        ffp_probe_cache_packets_free(&gop);
+        return is->abort_request ? AVERROR_EXIT : ret;
+    }
+    /* probe packets not looked at yet follow the gop */
+    *gop_tail = pending;
+    av_log(ffp, AV_LOG_INFO, "preload: promoted with %"PRId64" bytes held%s\n", gop_size, eof ? ", at eof" : "");
+    *pkts    = gop;
+    *eof_out = eof;
+    return 0;
+}
+
+/* picks the hls variant for the next segment, see ff_abr.h */
+static void read_thread_abr_update(FFPlayer *ffp, AVFormatContext *ic, FFAbr *abr, int64_t *last_bps)
+{
+    VideoState *is = ffp->is;
+    int64_t now = av_gettime_relative();
+    int64_t bps = 0;
+    int buffer_ms;
+    int cur = abr->cur;
+
+    if (av_opt_get_int(ic->priv_data, "segment_throughput", 0, &bps) >= 0 && bps > 0 && bps != *last_bps) {
+        ffp_abr_add_sample(abr, bps);
+        *last_bps = bps;
+    } else if (!abr->n_samples) {
+        /* before the first segment completes, seed with the io rate if the app reports it */
+        ffp_abr_add_sample(abr, SDL_SpeedSampler2GetSpeed(&ffp->stat.tcp_read_sampler) * 8);
+    }
+
+    if (is->audio_st && is->video_st)
+        buffer_ms = (int)FFMIN(ffp->stat.audio_cache.duration, ffp->stat.video_cache.duration);
+    else if (is->video_st)
+        buffer_ms = (int)ffp->stat.video_cache.duration;
+    else
+        buffer_ms = (int)ffp->stat.audio_cache.duration;
+
+    if (ffp_abr_choose(abr, buffer_ms, now) != cur) {
+        av_log(ffp, AV_LOG_INFO, "abr: variant %d -> %d (%"PRId64" bps), estimate %"PRId64" bps, buffer %d ms\n",
+               cur, abr->cur, abr->bitrates[abr->cur], ffp_abr_get_estimate(abr), buffer_ms);
+        av_opt_set_int(ic->priv_data, "abr_variant", abr->cur, 0);
+    }
+    ffp->stat.abr_bandwidth = ffp_abr_get_estimate(abr);
+    ffp->stat.abr_bitrate   = abr->bitrates[abr->cur];
+}
+
 /* this thread gets the stream from the disk or the network */
 static int read_thread(void *arg)
 {
@@ -3077,6 +3485,16 @@ static int read_thread(void *arg)
     int64_t prev_io_tick_counter = 0;
     int64_t io_tick_counter = 0;
     int init_ijkmeta = 0;
+    char *probe_cache_key = NULL;
+    FFProbeCacheEntry *probe_cache_entry = NULL;
+    AVDictionary *probe_cache_format_opts = NULL;
+    AVPacketList *probe_pkts = NULL;
+    int probe_cache_hit = 0;
+    int probe_cache_reopened = 0;
+    int standby_eof = 0;
+    FFAbr abr;
+    int abr_enabled = 0;
+    int64_t abr_last_bps = 0;
 
     if (!wait_mutex) {
         av_log(NULL, AV_LOG_FATAL, "SDL_CreateMutex(): %s\n", SDL_GetError());
@@ -3090,6 +3508,15 @@ static int read_thread(void *arg)
     is->last_subtitle_stream = is->subtitle_stream = -1;
     is->eof = 0;
 
+    if (ffp->probe_cache && ffp->find_stream_info) {
+        probe_cache_key = ffp_probe_cache_make_key(ffp->probe_cache_key ? ffp->probe_cache_key : is->filename);
+        probe_cache_entry = ffp_probe_cache_lookup(ffp->probe_cache_dir, probe_cache_key);
+        /* avformat_open_input() consumes the options, keep them for a reopen */
+        if (probe_cache_entry)
+            av_dict_copy(&probe_cache_format_opts, ffp->format_opts, 0);
+    }
+
+reopen:
     ic = avformat_alloc_context();
     if (!ic) {
         av_log(NULL, AV_LOG_FATAL, "Could not allocate context.\n");
@@ -3116,13 +3543,21 @@ static int read_thread(void *arg)
 
     if (ffp->iformat_name)
         is->iformat = av_find_input_format(ffp->iformat_name);
+    /* the demuxer is only known once the input is probed, so "abr" is offered
+     * unless another one is forced and taken back if something else opened */
+    if (ffp->abr && (!is->iformat || !strcmp(is->iformat->name, "hls,applehttp")))
+        av_dict_set(&ffp->format_opts, "abr", "1", 0);
     err = avformat_open_input(&ic, is->filename, is->iformat, &ffp->format_opts);
+    if (ffp->abr)
+        av_dict_set(&ffp->format_opts, "abr", NULL, 0);
     if (err < 0) {
         print_error(is->filename, err);
         ret = -1;
         goto fail;
     }
-    ffp_notify_msg1(ffp, FFP_MSG_OPEN_INPUT);
+    /* the application already heard about the first open */
+    if (!probe_cache_reopened)
+        ffp_notify_msg1(ffp, FFP_MSG_OPEN_INPUT);
 
     if (scan_all_pmts_set)
         av_dict_set(&ffp->format_opts, "scan_all_pmts", NULL, AV_DICT_MATCH_CASE);
@@ -3146,8 +3581,27 @@ static int read_thread(void *arg)
     //opts = setup_find_stream_info_opts(ic, ffp->codec_opts);
     //orig_nb_streams = ic->nb_streams;
 
+    if (probe_cache_entry) {
+        probe_cache_hit = ffp_probe_cache_apply(probe_cache_entry, ic) >= 0 &&
+                          ffp_probe_cache_validate(probe_cache_entry, ic, &probe_pkts, MAX_PROBE_CACHE_VALIDATE_PACKETS) >= 0;
+        ffp_probe_cache_entry_free(&probe_cache_entry);
+        if (!probe_cache_hit) {
+            /* streams were touched and packets consumed, start over with a full probe */
+            av_log(ffp, AV_LOG_WARNING, "probe cache mismatch, reopening %s\n", is->filename);
+            ffp_probe_cache_invalidate(ffp->probe_cache_dir, probe_cache_key);
+            ffp_probe_cache_packets_free(&probe_pkts);
+            is->ic = NULL;
+            avformat_close_input(&ic);
+            av_dict_free(&ffp->format_opts);
+            ffp->format_opts = probe_cache_format_opts;
+            probe_cache_format_opts = NULL;
+            probe_cache_reopened = 1;
+            goto reopen;
+        }
+        ffp_notify_msg1(ffp, FFP_MSG_FIND_STREAM_INFO);
+    }
 
-    if (ffp->find_stream_info) {
+    if (ffp->find_stream_info && !probe_cache_hit) {
         AVDictionary **opts = setup_find_stream_info_opts(ic, ffp->codec_opts);
         int orig_nb_streams = ic->nb_streams;
 
@@ -3177,6 +3631,8 @@ static int read_thread(void *arg)
             ret = -1;
             goto fail;
         }
+        if (probe_cache_key)
+            ffp_probe_cache_store(ffp->probe_cache_dir, probe_cache_key, ic);
     }
     if (ic->pb)
         ic->pb->eof_reached = 0; // FIXME hack, ffplay maybe should not use avio_feof() to test for the end
@@ -3205,6 +3661,8 @@ static int read_thread(void *arg)
         if (ret < 0) {
             av_log(NULL, AV_LOG_WARNING, "%s: could not seek to position %0.3f\n",
                     is->filename, (double)timestamp / AV_TIME_BASE);
+        } else {
+            ffp_probe_cache_packets_free(&probe_pkts);
         }
     }
 
@@ -3269,6 +3727,14 @@ static int read_thread(void *arg)
     }
 #endif
 
+    if (ffp->preload) {
+        ret = read_thread_standby(ffp, ic, st_index, &probe_pkts, &standby_eof, wait_mutex);
+        if (ret < 0) {
+            last_error = ret;
+            goto fail;
+        }
+    }
+
     /* open the streams */
     if (st_index[AVMEDIA_TYPE_AUDIO] >= 0) {
         stream_component_open(ffp, st_index[AVMEDIA_TYPE_AUDIO]);
@@ -3343,6 +3809,21 @@ static int read_thread(void *arg)
         ffp_seek_to_l(ffp, (long)(ffp->seek_at_start));
     }
 
+    /* hls with abr: one program per variant, see hls.c */
+    if (ffp->abr && ic->nb_programs > 1 && av_opt_find(ic->priv_data, "abr_variant", NULL, 0, 0)) {
+        int64_t bitrates[FFP_ABR_MAX_VARIANTS];
+        int64_t start_variant = 0;
+        int n_variants = FFMIN(ic->nb_programs, FFP_ABR_MAX_VARIANTS);
+
+        for (i = 0; i < n_variants; i++) {
+            t = av_dict_get(ic->programs[i]->metadata, "variant_bitrate", NULL, 0);
+            bitrates[i] = t ? strtoll(t->value, NULL, 10) : 0;
+        }
+        av_opt_get_int(ic->priv_data, "cur_variant", 0, &start_variant);
+        ffp_abr_init(&abr, bitrates, n_variants, (int)start_variant);
+        abr_enabled = 1;
+    }
+
     for (;;) {
         if (is->abort_request)
             break;
@@ -3379,6 +3860,8 @@ static int read_thread(void *arg)
                 av_log(NULL, AV_LOG_ERROR,
                        "%s: error while seeking\n", is->ic->filename);
             } else {
+                ffp_probe_cache_packets_free(&probe_pkts);
+                standby_eof = 0;
                 if (is->audio_stream >= 0) {
                     packet_queue_flush(&is->audioq);
                     packet_queue_put(&is->audioq, &flush_pkt);
@@ -3512,7 +3995,19 @@ static int read_thread(void *arg)
             }
         }
         pkt->flags = 0;
-        ret = av_read_frame(ic, pkt);
+        if (probe_pkts) {
+            /* read while validating the probe cache or held in preload standby */
+            AVPacketList *pktl = probe_pkts;
+            probe_pkts = pktl->next;
+            *pkt = pktl->pkt;
+            av_free(pktl);
+            ret = 0;
+        } else if (standby_eof) {
+            /* the input ended while standing by, until a seek says otherwise */
+            ret = AVERROR_EOF;
+        } else {
+            ret = av_read_frame(ic, pkt);
+        }
         if (ret < 0) {
             int pb_eof = 0;
             int pb_error = 0;
@@ -3565,6 +4060,8 @@ static int read_thread(void *arg)
         } else {
             is->eof = 0;
         }
+        SDL_TRACE_INSTANT("read", pkt->stream_index,
+                          trace_pts_us(ic->streams[pkt->stream_index]->time_base, pkt->pts));
 
         if (pkt->flags & AV_PKT_FLAG_DISCONTINUITY) {
             if (is->audio_stream >= 0) {
@@ -3598,6 +4095,8 @@ static int read_thread(void *arg)
         }
 
         ffp_statistic_l(ffp);
+        if (abr_enabled)
+            read_thread_abr_update(ffp, ic, &abr, &abr_last_bps);
 
         if (ffp->ijkmeta_delay_init && !init_ijkmeta &&
                 (ffp->first_video_frame_rendered || !is->video_st) && (ffp->first_audio_frame_rendered || !is->audio_st)) {
@@ -3626,6 +4125,10 @@ static int read_thread(void *arg)
  fail:
     if (ic && !is->ic)
         avformat_close_input(&ic);
+    ffp_probe_cache_entry_free(&probe_cache_entry);
+    ffp_probe_cache_packets_free(&probe_pkts);
+    av_dict_free(&probe_cache_format_opts);
+    av_freep(&probe_cache_key);
 
     if (!ffp->prepared || !is->abort_request) {
         ffp->last_error = last_error;
@@ -3684,9 +4187,10 @@ static VideoState *stream_open(FFPlayer *ffp, const char *filename, AVInputForma
         ffp->enable_accurate_seek = 0;
     }
 
-    init_clock(&is->vidclk, &is->videoq.serial);
-    init_clock(&is->audclk, &is->audioq.serial);
-    init_clock(&is->extclk, &is->extclk.serial);
+    init_clock(&is->vidclk, &is->videoq.serial, ffp->aout);
+    ffp_pacer_init(&is->pacer);
+    init_clock(&is->audclk, &is->audioq.serial, ffp->aout);
+    init_clock(&is->extclk, &is->extclk.serial, ffp->aout);
     is->audio_clock_serial = -1;
     if (ffp->startup_volume < 0)
         av_log(NULL, AV_LOG_WARNING, "-volume=%d < 0, setting to 0\n", ffp->startup_volume);
@@ -3920,6 +4424,16 @@ void ffp_global_set_log_level(int log_level)
     av_log_set_level(av_level);
 }
 
+void ffp_global_set_trace_enabled(int enabled)
+{
+    SDL_TraceSetEnabled(enabled);
+}
+
+int ffp_global_trace_export(const char *path)
+{
+    return SDL_TraceExportChrome(path);
+}
+
 static ijk_inject_callback s_inject_callback;
 int inject_callback(void *opaque, int type, void *data, size_t data_size)
 {
@@ -4376,6 +4890,20 @@ int ffp_stop_l(FFPlayer *ffp)
     return 0;
 }
 
+int ffp_promote_l(FFPlayer *ffp)
+{
+    assert(ffp);
+    VideoState *is = ffp->is;
+    if (!is)
+        return EIJK_NULL_IS_PTR;
+
+    SDL_LockMutex(is->play_mutex);
+    is->promote_req = 1;
+    SDL_UnlockMutex(is->play_mutex);
+    SDL_CondSignal(is->continue_read_thread);
+    return 0;
+}
+
 int ffp_wait_stop_l(FFPlayer *ffp)
 {
     assert(ffp);
@@ -4574,6 +5102,10 @@ void ffp_toggle_buffering_l(FFPlayer *ffp, int buffering_on)
         av_log(ffp, AV_LOG_DEBUG, "ffp_toggle_buffering_l: start\n");
         is->buffering_on = 1;
         stream_update_pause_l(ffp);
+        if (ffp->gop_join && !is->seek_req && is->video_stream >= 0) {
+            packet_queue_hold(&is->videoq, 1);
+            packet_queue_hold(&is->audioq, 1);
+        }
         if (is->seek_req) {
             is->seek_buffering = 1;
             ffp_notify_msg2(ffp, FFP_MSG_BUFFERING_START, 1);
@@ -4583,6 +5115,11 @@ void ffp_toggle_buffering_l(FFPlayer *ffp, int buffering_on)
     } else if (!buffering_on && is->buffering_on){
         av_log(ffp, AV_LOG_DEBUG, "ffp_toggle_buffering_l: end\n");
         is->buffering_on = 0;
+        if (is->videoq.hold) {
+            packet_queue_trim_to_keyframe(ffp, &is->videoq, is->audio_stream >= 0 ? &is->audioq : NULL);
+            packet_queue_hold(&is->videoq, 0);
+            packet_queue_hold(&is->audioq, 0);
+        }
         stream_update_pause_l(ffp);
         if (is->seek_buffering) {
             is->seek_buffering = 0;
@@ -5002,6 +5539,50 @@ int64_t ffp_get_property_int64(FFPlayer *ffp, int id, int64_t default_value)
             if (!ffp)
                 return default_value;
             return ffp->stat.logical_file_size;
+        case FFP_PROP_INT64_DISPLAY_LATENCY_P50:
+            if (!ffp)
+                return default_value;
+            return SDL_HistogramGetPercentile(&ffp->stat.display_latency, 50) / 1000;
+        case FFP_PROP_INT64_DISPLAY_LATENCY_P95:
+            if (!ffp)
+                return default_value;
+            return SDL_HistogramGetPercentile(&ffp->stat.display_latency, 95) / 1000;
+        case FFP_PROP_INT64_DISPLAY_LATENCY_P99:
+            if (!ffp)
+                return default_value;
+            return SDL_HistogramGetPercentile(&ffp->stat.display_latency, 99) / 1000;
+        case FFP_PROP_INT64_DISPLAY_LATENCY_MAX:
+            if (!ffp)
+                return default_value;
+            return ffp->stat.display_latency.max / 1000;
+        case FFP_PROP_INT64_DISPLAY_LATENCY_COUNT:
+            if (!ffp)
+                return default_value;
+            return ffp->stat.display_latency.count;
+        case FFP_PROP_INT64_ABR_BANDWIDTH:
+            if (!ffp)
+                return default_value;
+            return ffp->stat.abr_bandwidth;
+        case FFP_PROP_INT64_ABR_BITRATE:
+            if (!ffp)
+                return default_value;
+            return ffp->stat.abr_bitrate;
+        case FFP_PROP_INT64_PRESENT_ERROR_P50:
+            if (!ffp)
+                return default_value;
+            return SDL_HistogramGetPercentile(&ffp->stat.present_error, 50);
+        case FFP_PROP_INT64_PRESENT_ERROR_P95:
+            if (!ffp)
+                return default_value;
+            return SDL_HistogramGetPercentile(&ffp->stat.present_error, 95);
+        case FFP_PROP_INT64_PRESENT_ERROR_MAX:
+            if (!ffp)
+                return default_value;
+            return ffp->stat.present_error.max;
+        case FFP_PROP_INT64_PRESENT_ERROR_COUNT:
+            if (!ffp)
+                return default_value;
+            return ffp->stat.present_error.count;
         default:
             return default_value;
     }
@@ -33,6 +33,8 @@ void      ffp_global_init();
 void      ffp_global_uninit();
 void      ffp_global_set_log_report(int use_report);
 void      ffp_global_set_log_level(int log_level);
+void      ffp_global_set_trace_enabled(int enabled);
+int       ffp_global_trace_export(const char *path);
 void      ffp_global_set_inject_callback(ijk_inject_callback cb);
 void      ffp_io_stat_register(void (*cb)(const char *url, int type, int bytes));
 void      ffp_io_stat_complete_register(void (*cb)(const char *url,
@@ -63,6 +65,8 @@ int       ffp_pause_l(FFPlayer *ffp);
 int       ffp_is_paused_l(FFPlayer *ffp);
 int       ffp_stop_l(FFPlayer *ffp);
 int       ffp_wait_stop_l(FFPlayer *ffp);
+/* leave the standby of the "preload" option and open the decoders */
+int       ffp_promote_l(FFPlayer *ffp);
 
 /* all in milliseconds */
 int       ffp_seek_to_l(FFPlayer *ffp, long msec);
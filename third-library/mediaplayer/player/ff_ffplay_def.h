@@ -65,6 +65,8 @@
 #include "ff_ffmsg_queue.h"
 #include "ff_ffpipenode.h"
 #include "ijkmeta.h"
+#include "ff_pacer.h"
+#include "ff_framedrop.h"
 
 #define DEFAULT_HIGH_WATER_MARK_IN_BYTES        (256 * 1024)
 
@@ -94,11 +96,6 @@
 #define EXTERNAL_CLOCK_MIN_FRAMES 2
 #define EXTERNAL_CLOCK_MAX_FRAMES 10
 
-/* Minimum SDL audio buffer size, in samples. */
-#define SDL_AUDIO_MIN_BUFFER_SIZE 512
-/* Calculate actual buffer size keeping in mind not cause too frequent audio callbacks */
-#define SDL_AUDIO_MAX_CALLBACKS_PER_SEC 30
-
 /* Step size for volume control */
 #define SDL_VOLUME_STEP (SDL_MIX_MAXVOLUME / 50)
 
@@ -131,6 +128,9 @@
 
 #define MIN_PKT_DURATION 15
 
+/* packets read to check a probe cache hit, see ff_probe_cache.h */
+#define MAX_PROBE_CACHE_VALIDATE_PACKETS 64
+
 #ifdef FFP_MERGE
 #define CURSOR_HIDE_DELAY 1000000
 
@@ -161,6 +161,7 @@ typedef struct MyAVPacketList {
     AVPacket pkt;
     struct MyAVPacketList *next;
     int serial;
+    int64_t recv_time;    /* av_gettime_relative() when demuxed */
 } MyAVPacketList;
 
 typedef struct PacketQueue {
@@ -177,6 +178,9 @@ typedef struct PacketQueue {
     int alloc_count;
 
     int is_buffer_indicator;
+    AVRational time_base;   /* of the packets, for tracing */
+    int64_t last_recv_time; /* of the packet last returned by packet_queue_get() */
+    int hold;               /* packet_queue_get() waits while set, see "gop-join" */
 } PacketQueue;
 
 // #define VIDEO_PICTURE_QUEUE_SIZE 3
@@ -206,6 +210,7 @@ typedef struct Clock {
     int serial;           /* clock is based on a packet with this serial */
     int paused;
     int *queue_serial;    /* pointer to the current packet queue serial, used for obsolete clock detection */
+    SDL_Aout *aout;       /* output whose time the clock runs on, see SDL_AoutGetTimeUs */
 } Clock;
 
 /* Common struct for handling all types of decoded data and allocated render buffers. */
@@ -216,6 +221,8 @@ typedef struct Frame {
     double pts;           /* presentation timestamp for the frame */
     double duration;      /* estimated duration of the frame */
     int64_t pos;          /* byte position of the frame in the input file */
+    int64_t recv_time;    /* when its first packet was demuxed, 0 if unknown */
+    int64_t present_time; /* vsync picked by the pacer, 0 until scheduled */
 #ifdef FFP_MERGE
     SDL_Texture *bmp;
 #else
@@ -270,6 +277,8 @@ typedef struct Decoder {
     SDL_Profiler decode_profiler;
     Uint64 first_frame_decoded_time;
     int    first_frame_decoded;
+
+    SDL_FFmpegFramePool *frame_pool;
 } Decoder;
 
 typedef struct VideoState {
@@ -335,6 +344,8 @@ typedef struct VideoState {
     int frame_drops_early;
     int frame_drops_late;
     int continuous_frame_drops_early;
+    FFFrameDrop framedrop;                  /* before decode, see ff_framedrop.h */
+    enum AVDiscard video_skip_frame;        /* the decoder's own, restored once caught up */
 
     enum ShowMode {
         SHOW_MODE_NONE = -1, SHOW_MODE_VIDEO = 0, SHOW_MODE_WAVES, SHOW_MODE_RDFT, SHOW_MODE_NB
@@ -359,6 +370,8 @@ typedef struct VideoState {
     PacketQueue subtitleq;
 
     double frame_timer;
+    FFPacer pacer;              /* video_refresh only */
+    int pacer_reset_req;        /* restart the cadence at the next video_refresh */
     double frame_last_returned_time;
     double frame_last_filter_delay;
     int video_stream;
@@ -389,6 +402,7 @@ typedef struct VideoState {
     SDL_cond *continue_read_thread;
 
     /* extra fields */
+    int promote_req;        // leave preload standby, see ffp_promote_l()
     SDL_mutex  *play_mutex; // only guard state, do not block any long operation
     SDL_Thread *video_refresh_tid;
     SDL_Thread _video_refresh_tid;
@@ -516,6 +530,10 @@ typedef struct FFStatistic
     int drop_frame_count;
     int decode_frame_count;
     float drop_frame_rate;
+    SDL_Histogram display_latency;  /* demux -> display, us */
+    SDL_Histogram present_error;    /* |visible vsync - target|, us, when the vout knows its vsync */
+    int64_t abr_bandwidth;          /* throughput estimate, bps */
+    int64_t abr_bitrate;            /* of the selected variant, bps */
 } FFStatistic;
 
 #define FFP_TCP_READ_SAMPLE_RANGE 2000
@@ -601,6 +619,7 @@ typedef struct FFPlayer {
 #endif
     int loop;
     int framedrop;
+    int framedrop_decoder;
     int64_t seek_at_start;
     int subtitle;
     int infinite_buffer;
@@ -662,6 +681,7 @@ typedef struct FFPlayer {
     int packet_buffering;
     int pictq_size;
     int max_fps;
+    int direct_rendering;
     int startup_volume;
 
     int videotoolbox;
@@ -680,6 +700,8 @@ typedef struct FFPlayer {
 
     int opensles;
     int soundtouch_enable;
+    int null_aout_realtime;
+    int vsync_pacing;
 
     char *iformat_name;
 
@@ -720,6 +742,12 @@ typedef struct FFPlayer {
     char *mediacodec_default_name;
     int ijkmeta_delay_init;
     int render_wait_start;
+    int probe_cache;
+    char *probe_cache_key;
+    char *probe_cache_dir;
+    int preload;
+    int gop_join;
+    int abr;
 } FFPlayer;
 
 #define fftime_to_milliseconds(ts) (av_rescale(ts, 1000, AV_TIME_BASE))
@@ -756,6 +784,7 @@ inline static void ffp_reset_internal(FFPlayer *ffp)
     ffp->autoexit               = 0;
     ffp->loop                   = 1;
     ffp->framedrop              = 0; // option
+    ffp->framedrop_decoder      = 100; // option
     ffp->seek_at_start          = 0;
     ffp->infinite_buffer        = -1;
     ffp->show_mode              = SHOW_MODE_NONE;
@@ -805,6 +834,7 @@ inline static void ffp_reset_internal(FFPlayer *ffp)
     ffp->packet_buffering               = 1;
     ffp->pictq_size                     = VIDEO_PICTURE_QUEUE_SIZE_DEFAULT; // option
     ffp->max_fps                        = 31; // option
+    ffp->direct_rendering               = 1; // option
 
     ffp->videotoolbox                   = 0; // option
     ffp->vtb_max_frame_width            = 0; // option
@@ -821,6 +851,8 @@ inline static void ffp_reset_internal(FFPlayer *ffp)
 
     ffp->opensles                       = 0; // option
     ffp->soundtouch_enable              = 0; // option
+    ffp->null_aout_realtime             = 1; // option
+    ffp->vsync_pacing                   = 1; // option
 
     ffp->iformat_name                   = NULL; // option
 
@@ -830,6 +862,12 @@ inline static void ffp_reset_internal(FFPlayer *ffp)
     ffp->mediacodec_default_name        = NULL; // option
     ffp->ijkmeta_delay_init             = 0; // option
     ffp->render_wait_start              = 0;
+    ffp->probe_cache                    = 0; // option
+    ffp->probe_cache_key                = NULL; // option
+    ffp->probe_cache_dir                = NULL; // option
+    ffp->preload                        = 0; // option
+    ffp->gop_join                       = 0; // option
+    ffp->abr                            = 0; // option
 
     ijkmeta_reset(ffp->meta);
 
@@ -80,6 +80,8 @@ static const AVOption ffp_context_options[] = {
         OPTION_OFFSET(infinite_buffer), OPTION_INT(0, 0, 1) },
     { "framedrop",                      "drop frames when cpu is too slow",
         OPTION_OFFSET(framedrop),       OPTION_INT(0, -1, 120) },
+    { "framedrop-decoder",              "with framedrop, skip frames before decoding once video is this many ms late, 0 to disable",
+        OPTION_OFFSET(framedrop_decoder), OPTION_INT(100, 0, 10000) },
     { "seek-at-start",                  "set offset of player should be seeked",
         OPTION_OFFSET(seek_at_start),       OPTION_INT64(0, 0, INT_MAX) },
     { "subtitle",                       "decode subtitle stream",
@@ -112,6 +114,8 @@ static const AVOption ffp_context_options[] = {
     { "fcc-rv16",                       "", 0, OPTION_CONST(SDL_FCC_RV16), .unit = "overlay-format" },
     { "fcc-rv24",                       "", 0, OPTION_CONST(SDL_FCC_RV24), .unit = "overlay-format" },
     { "fcc-rv32",                       "", 0, OPTION_CONST(SDL_FCC_RV32), .unit = "overlay-format" },
+    { "direct-rendering",               "let the video decoder write into buffers the overlay can display as is",
+        OPTION_OFFSET(direct_rendering), OPTION_INT(1, 0, 1) },
 
     { "start-on-prepared",                  "automatically start playing on prepared",
         OPTION_OFFSET(start_on_prepared),   OPTION_INT(1, 0, 1) },
@@ -198,6 +202,10 @@ static const AVOption ffp_context_options[] = {
         OPTION_OFFSET(opensles),            OPTION_INT(0, 0, 1) },
     { "soundtouch",                           "SoundTouch: enable",
         OPTION_OFFSET(soundtouch_enable),            OPTION_INT(0, 0, 1) },
+    { "null-aout-realtime",                 "null audio output: pace callbacks to the wall clock, 0 to pull as fast as possible",
+        OPTION_OFFSET(null_aout_realtime),  OPTION_INT(1, 0, 1) },
+    { "vsync-pacing",                       "show frames on the vsync cadence of the output, when it reports one",
+        OPTION_OFFSET(vsync_pacing),        OPTION_INT(1, 0, 1) },
     { "mediacodec-sync",                 "mediacodec: use msg_queue for synchronise",
         OPTION_OFFSET(mediacodec_sync),           OPTION_INT(0, 0, 1) },
     { "mediacodec-default-name",          "mediacodec default name",
@@ -206,6 +214,18 @@ static const AVOption ffp_context_options[] = {
         OPTION_OFFSET(ijkmeta_delay_init),      OPTION_INT(0, 0, 1) },
     { "render-wait-start",          "render wait start",
         OPTION_OFFSET(render_wait_start),      OPTION_INT(0, 0, 1) },
+    { "probe-cache",                        "reuse stream info of earlier opens instead of probing",
+        OPTION_OFFSET(probe_cache),         OPTION_INT(0, 0, 1) },
+    { "probe-cache-key",                    "probe cache key, defaults to the url without query",
+        OPTION_OFFSET(probe_cache_key),     OPTION_STR(NULL) },
+    { "probe-cache-dir",                    "directory to persist the probe cache in",
+        OPTION_OFFSET(probe_cache_dir),     OPTION_STR(NULL) },
+    { "preload",                            "open and buffer from the latest keyframe, start decoding on promote",
+        OPTION_OFFSET(preload),             OPTION_INT(0, 0, 1) },
+    { "gop-join",                           "live: after (re)buffering start decoding at the latest buffered keyframe",
+        OPTION_OFFSET(gop_join),            OPTION_INT(0, 0, 1) },
+    { "abr",                                "hls: switch variants by measured throughput and buffer level",
+        OPTION_OFFSET(abr),                 OPTION_INT(0, 0, 1) },
 
     { NULL }
 };
@@ -0,0 +1,228 @@
+/*
+ * ff_framedrop.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ff_framedrop.h"
+#include <string.h>
+
+static int rb16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+void ffp_framedrop_init(FFFrameDrop *fd, double threshold)
+{
+    memset(fd, 0, sizeof(*fd));
+    fd->threshold       = threshold;
+    fd->escalate_frames = 15;
+    fd->recover_frames  = 30;
+}
+
+/* next NAL in [*p, end) with length_size prefixes, or after a start code when 0 */
+static int next_nal(int length_size, const uint8_t **p, const uint8_t *end,
+                    const uint8_t **nal, int *nal_size)
+{
+    const uint8_t *q = *p;
+
+    if (length_size > 0) {
+        uint32_t len = 0;
+        if (end - q < length_size)
+            return 0;
+        for (int i = 0; i < length_size; i++)
+            len = (len << 8) | *q++;
+        if (len == 0 || len > (uint32_t)(end - q))
+            return 0;
+        *nal      = q;
+        *nal_size = len;
+        *p        = q + len;
+        return 1;
+    }
+
+    /* next 00 00 01, up to the one after it */
+    while (end - q >= 3 && (q[0] || q[1] || q[2] != 1))
+        q++;
+    if (end - q < 4)
+        return 0;
+    q   += 3;
+    *nal = q;
+    while (end - q >= 3 && (q[0] || q[1] || q[2] != 1))
+        q++;
+    if (end - q < 3)
+        q = end;
+    *nal_size = q - *nal;
+    *p        = q;
+    return 1;
+}
+
+/* HEVC SPS: sps_max_sub_layers_minus1 follows the 4 bit VPS id */
+static void hevc_parse_nal(FFFrameDrop *fd, const uint8_t *nal, int size)
+{
+    if (size >= 3 && ((nal[0] >> 1) & 0x3f) == 33)
+        fd->max_sub_layers = ((nal[2] >> 1) & 7) + 1;
+}
+
+void ffp_framedrop_set_stream(FFFrameDrop *fd, int codec, const uint8_t *extradata, int extradata_size)
+{
+    const uint8_t *p   = extradata;
+    const uint8_t *end = extradata + extradata_size;
+    const uint8_t *nal;
+    int nal_size;
+
+    fd->codec          = codec;
+    fd->length_size    = 0;
+    fd->max_sub_layers = 0;
+
+    /* avcC / hvcC rather than Annex B start codes */
+    if (extradata_size > 3 && (extradata[0] || extradata[1] || extradata[2] > 1)) {
+        if (codec == FFP_FRAMEDROP_CODEC_H264 && extradata_size >= 7) {
+            fd->length_size = (extradata[4] & 3) + 1;
+        } else if (codec == FFP_FRAMEDROP_CODEC_HEVC && extradata_size >= 23) {
+            fd->length_size    = (extradata[21] & 3) + 1;
+            fd->max_sub_layers = (extradata[21] >> 3) & 7;
+            /* 0 is unknown, look for the SPS in the NAL arrays */
+            p += 23;
+            for (int i = 0; i < extradata[22] && !fd->max_sub_layers && end - p >= 3; i++) {
+                int count = rb16(p + 1);
+                p += 3;
+                for (int j = 0; j < count && end - p >= 2; j++) {
+                    nal_size = rb16(p);
+                    p += 2;
+                    if (nal_size > end - p)
+                        break;
+                    hevc_parse_nal(fd, p, nal_size);
+                    p += nal_size;
+                }
+            }
+        } else {
+            fd->codec = FFP_FRAMEDROP_CODEC_OTHER;
+        }
+    } else if (codec == FFP_FRAMEDROP_CODEC_HEVC && extradata) {
+        while (next_nal(0, &p, end, &nal, &nal_size))
+            hevc_parse_nal(fd, nal, nal_size);
+    }
+}
+
+static void framedrop_set_level(FFFrameDrop *fd, int level)
+{
+    fd->level            = level;
+    fd->frames_at_level  = 0;
+    fd->frames_caught_up = 0;
+    fd->level_changes++;
+    if (level > fd->max_level)
+        fd->max_level = level;
+}
+
+void ffp_framedrop_reset(FFFrameDrop *fd)
+{
+    fd->level            = FFP_FRAMEDROP_NONE;
+    fd->frames_at_level  = 0;
+    fd->frames_caught_up = 0;
+}
+
+int ffp_framedrop_update(FFFrameDrop *fd, double lag)
+{
+    if (fd->threshold <= 0)
+        return fd->level;
+
+    fd->frames_at_level++;
+    if (lag > fd->threshold) {
+        fd->frames_caught_up = 0;
+        if (fd->level == FFP_FRAMEDROP_NONE ||
+            (fd->level < FFP_FRAMEDROP_BIDIR && fd->frames_at_level >= fd->escalate_frames))
+            framedrop_set_level(fd, fd->level + 1);
+    } else if (lag < fd->threshold / 2) {
+        if (fd->level > FFP_FRAMEDROP_NONE && ++fd->frames_caught_up >= fd->recover_frames)
+            framedrop_set_level(fd, fd->level - 1);
+    } else {
+        fd->frames_caught_up = 0;
+    }
+    return fd->level;
+}
+
+/*
+ * -1 for parameter sets, which must reach the decoder, 1 for pictures that
+ * may be used for reference, 0 otherwise.
+ *
+ * An HEVC sub-layer non-reference picture can still be referenced by the
+ * pictures of higher sub-layers, so it is only disposable in the highest
+ * one, and only once the SPS has said which that is.
+ */
+static int nal_is_needed(const FFFrameDrop *fd, const uint8_t *nal, int size)
+{
+    if (fd->codec == FFP_FRAMEDROP_CODEC_H264) {
+        int type = nal[0] & 0x1f;
+        if (type == 7 || type == 8)
+            return -1;
+        return type >= 1 && type <= 5 && (nal[0] & 0x60);
+    } else {
+        int type = (nal[0] >> 1) & 0x3f;
+        if (type >= 32 && type <= 34)
+            return -1;
+        if (type >= 32)
+            return 0;
+        /* VCL types 0..14 with an even number are sub-layer non-reference */
+        if (type > 14 || (type & 1) || size < 2 || !fd->max_sub_layers)
+            return 1;
+        return (nal[1] & 7) != fd->max_sub_layers;    /* TemporalId + 1 */
+    }
+}
+
+/* VCL NALs carry the picture, the rest (SEI, AUD, ...) go with it */
+static int nal_is_vcl(int codec, uint8_t header)
+{
+    if (codec == FFP_FRAMEDROP_CODEC_H264) {
+        int type = header & 0x1f;
+        return type >= 1 && type <= 5;
+    }
+    return ((header >> 1) & 0x3f) < 32;
+}
+
+int ffp_framedrop_is_disposable(FFFrameDrop *fd, const uint8_t *data, int size)
+{
+    const uint8_t *p   = data;
+    const uint8_t *end = data + size;
+    const uint8_t *nal;
+    int nal_size;
+    int vcl = 0;
+
+    if (!data || (fd->codec != FFP_FRAMEDROP_CODEC_H264 && fd->codec != FFP_FRAMEDROP_CODEC_HEVC))
+        return 0;
+
+    while (next_nal(fd->length_size, &p, end, &nal, &nal_size)) {
+        if (fd->codec == FFP_FRAMEDROP_CODEC_HEVC)
+            hevc_parse_nal(fd, nal, nal_size);
+        if (nal_is_needed(fd, nal, nal_size))
+            return 0;
+        vcl |= nal_is_vcl(fd->codec, *nal);
+    }
+    /* a broken length prefix leaves the rest unchecked */
+    if (fd->length_size > 0 && p != end)
+        return 0;
+    return vcl;
+}
+
+int ffp_framedrop_skip_packet(FFFrameDrop *fd, const uint8_t *data, int size)
+{
+    if (fd->level < FFP_FRAMEDROP_NONREF ||
+        !ffp_framedrop_is_disposable(fd, data, size))
+        return 0;
+
+    fd->skipped_packets++;
+    return 1;
+}
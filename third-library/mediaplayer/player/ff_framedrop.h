@@ -0,0 +1,94 @@
+/*
+ * ff_framedrop.h
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef FFPLAY__FF_FRAMEDROP_H
+#define FFPLAY__FF_FRAMEDROP_H
+
+#include <stdint.h>
+
+/*
+ * Frame dropping ahead of the decoder, independent of FFmpeg so that
+ * bench/framedrop_bench.c can drive it outside the player. The video
+ * thread reports how late each decoded frame is against the master clock
+ * and gets back how much the decoder should throw away:
+ *
+ *   NONE     decode everything, late frames are dropped after decoding
+ *   NONREF   skip packets holding only non-reference pictures before they
+ *            reach the decoder, and have it discard any it still gets
+ *   BIDIR    also discard B pictures that are used for reference; frames
+ *            predicted from them may show artifacts until the next one
+ *
+ * A frame more than threshold late raises the level from NONE at once,
+ * and from NONREF if it is still late escalate_frames frames later.
+ * recover_frames frames in a row less than threshold / 2 late step it
+ * back down one level.
+ *
+ * Packets are classified from their NAL headers. H.264 slices with
+ * nal_ref_idc 0 are skipped, the test the FFmpeg H.264 decoder uses for
+ * AVDISCARD_NONREF. For HEVC, whose decoder has no AVDISCARD_NONREF, only
+ * sub-layer non-reference pictures in the highest temporal sub-layer are
+ * skipped, as lower ones can still be referenced from above; until the
+ * hvcC or an SPS gives the number of sub-layers nothing is. Other codecs
+ * are left to the decoder.
+ */
+
+enum {
+    FFP_FRAMEDROP_NONE = 0,
+    FFP_FRAMEDROP_NONREF,
+    FFP_FRAMEDROP_BIDIR,
+};
+
+enum {
+    FFP_FRAMEDROP_CODEC_OTHER = 0,
+    FFP_FRAMEDROP_CODEC_H264,
+    FFP_FRAMEDROP_CODEC_HEVC,
+};
+
+typedef struct FFFrameDrop {
+    int     codec;
+    int     length_size;        /* NAL length prefix in bytes, 0 for start codes */
+    int     max_sub_layers;     /* HEVC, 0 while unknown */
+
+    int     level;
+    double  threshold;          /* s */
+    int     escalate_frames;
+    int     recover_frames;
+    int     frames_at_level;
+    int     frames_caught_up;
+
+    /* stats */
+    int64_t skipped_packets;
+    int     level_changes;
+    int     max_level;
+} FFFrameDrop;
+
+void ffp_framedrop_init(FFFrameDrop *fd, double threshold);
+/* codec: FFP_FRAMEDROP_CODEC_*; extradata tells length prefixed from Annex B streams */
+void ffp_framedrop_set_stream(FFFrameDrop *fd, int codec, const uint8_t *extradata, int extradata_size);
+/* back to NONE, e.g. after a seek, keeping the stats */
+void ffp_framedrop_reset(FFFrameDrop *fd);
+/* lag: s the latest decoded frame is behind the master clock; returns the level from now on */
+int  ffp_framedrop_update(FFFrameDrop *fd, double lag);
+/* 1 if the packet should not be sent to the decoder at the current level */
+int  ffp_framedrop_skip_packet(FFFrameDrop *fd, const uint8_t *data, int size);
+/* 1 if the packet holds pictures but none used for reference; picks up HEVC SPS on the way */
+int  ffp_framedrop_is_disposable(FFFrameDrop *fd, const uint8_t *data, int size);
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * ff_pacer.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ff_pacer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void ffp_pacer_init(FFPacer *pacer)
+{
+    memset(pacer, 0, sizeof(*pacer));
+    pacer->gain          = 0.05;
+    pacer->relock_vsyncs = 0.75;
+}
+
+void ffp_pacer_reset(FFPacer *pacer)
+{
+    pacer->locked = 0;
+}
+
+int64_t ffp_pacer_schedule(FFPacer *pacer, int64_t target_us, int64_t duration_us,
+                           int64_t vsync_us, int64_t period_us)
+{
+    double target, error;
+    int64_t slot, present;
+    int restarted;
+
+    if (period_us <= 0)
+        return target_us;
+
+    if (!pacer->period || llabs(period_us - pacer->period) * 100 > pacer->period) {
+        /* new display timing: number the vsyncs from this one */
+        if (pacer->period)
+            pacer->slot = llround((double)(pacer->base + pacer->slot * pacer->period - vsync_us) / period_us);
+        pacer->base   = vsync_us;
+        pacer->period = period_us;
+        pacer->locked = 0;
+    } else {
+        /* keep the numbering while the phase estimate moves */
+        int64_t n = llround((double)(vsync_us - pacer->base) / period_us);
+        pacer->base   = vsync_us - n * period_us;
+        pacer->period = period_us;
+    }
+
+    target = (double)(target_us - pacer->base) / period_us;
+    restarted = !pacer->locked;
+    if (pacer->locked) {
+        pacer->position += (double)duration_us / period_us;
+        error = target - pacer->position;
+        if (fabs(error) > pacer->relock_vsyncs) {
+            pacer->locked = 0;
+            pacer->relocks++;
+            restarted = 1;
+        } else {
+            pacer->position += pacer->gain * error;
+        }
+    }
+    if (!pacer->locked) {
+        pacer->position = target;
+        pacer->locked   = 1;
+    }
+
+    /* never two frames on one vsync */
+    slot = (int64_t)floor(pacer->position + 0.5);
+    if (pacer->frames && slot <= pacer->slot)
+        slot = pacer->slot + 1;
+    if (!restarted) {
+        int64_t hold = slot - pacer->slot;
+        pacer->holds[hold < FFP_PACER_MAX_HOLD ? hold : FFP_PACER_MAX_HOLD]++;
+    }
+    pacer->slot = slot;
+    pacer->frames++;
+
+    present = pacer->base + slot * period_us;
+    pacer->error_sum += llabs(present - target_us);
+    if (llabs(present - target_us) > pacer->error_max)
+        pacer->error_max = llabs(present - target_us);
+    return present;
+}
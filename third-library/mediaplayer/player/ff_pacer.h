@@ -0,0 +1,72 @@
+/*
+ * ff_pacer.h
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef FFPLAY__FF_PACER_H
+#define FFPLAY__FF_PACER_H
+
+#include <stdint.h>
+
+/*
+ * Picks the display vsync each video frame is shown on, independent of
+ * FFmpeg so that bench/pacing_sim.c can drive it with the same inputs as
+ * video_refresh: the time a frame should appear, its nominal duration and
+ * the display's vsync phase and period.
+ *
+ * Every frame moves a cadence position on by duration / period vsyncs and
+ * lands on the vsync nearest to it, so 24 fps on 60 Hz settles into 3:2
+ * and 25 fps into 3:2:3:2:2 instead of following the wake-up jitter of the
+ * refresh thread. The position follows the target times through a slow
+ * loop, which absorbs jitter but tracks drift between the media clock and
+ * the display. A target further than relock_vsyncs from the position
+ * (seek, sync correction, dropped frame) restarts the cadence from it.
+ */
+
+#define FFP_PACER_MAX_HOLD 8
+
+typedef struct FFPacer {
+    int64_t period;                 /* us, 0 until the first frame */
+    int64_t base;                   /* a vsync, us; slot n is at base + n * period */
+    double  position;               /* cadence position of the last frame, vsyncs from base */
+    int64_t slot;                   /* vsync index of the last frame */
+    int     locked;
+
+    double  gain;                   /* share of the target error the position takes per frame */
+    double  relock_vsyncs;
+
+    /* stats */
+    int64_t frames;
+    int64_t relocks;
+    int64_t holds[FFP_PACER_MAX_HOLD + 1];  /* frames shown for n vsyncs, the last bucket for more */
+    int64_t error_sum;              /* |slot - target|, us */
+    int64_t error_max;
+} FFPacer;
+
+void    ffp_pacer_init(FFPacer *pacer);
+/* restarts the cadence at the next frame, keeping the stats */
+void    ffp_pacer_reset(FFPacer *pacer);
+/*
+ * target_us: when the frame should appear; duration_us: its nominal
+ * duration; vsync_us: a recent vsync. All on the same clock.
+ * Returns the vsync time the frame should be shown at.
+ */
+int64_t ffp_pacer_schedule(FFPacer *pacer, int64_t target_us, int64_t duration_us,
+                           int64_t vsync_us, int64_t period_us);
+
+#endif
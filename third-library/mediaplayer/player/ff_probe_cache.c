@@ -0,0 +1,792 @@
+/*
+ * ff_probe_cache.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ff_probe_cache.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libavutil/avstring.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/md5.h"
+
+#define PROBE_CACHE_MAGIC       MKTAG('F', 'P', 'C', '1')
+#define PROBE_CACHE_MEM_ENTRIES 16
+#define PROBE_CACHE_MAX_STREAMS 32
+
+typedef struct FFProbeCacheStream {
+    int                 id;
+    AVRational          time_base;
+    int                 pts_wrap_bits;
+    AVRational          avg_frame_rate;
+    AVRational          r_frame_rate;
+    AVRational          sample_aspect_ratio;
+    int                 disposition;
+    int64_t             start_time;
+    int64_t             duration;
+    AVCodecParameters  *par;
+    int                 seen;
+} FFProbeCacheStream;
+
+struct FFProbeCacheEntry {
+    char               *iformat_name;
+    int64_t             start_time;
+    int64_t             duration;
+    int64_t             bit_rate;
+    int                 nb_streams;
+    FFProbeCacheStream *streams;
+};
+
+/* serialized entries, most recently used first */
+typedef struct ProbeCacheBlob {
+    char               *key;
+    uint8_t            *data;
+    int                 size;
+} ProbeCacheBlob;
+
+static pthread_mutex_t  g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ProbeCacheBlob   g_blobs[PROBE_CACHE_MEM_ENTRIES];
+
+/* ---------- serialization ---------- */
+
+typedef struct ProbeWriter {
+    uint8_t            *data;
+    unsigned int        capacity;
+    int                 size;
+    int                 error;
+} ProbeWriter;
+
+typedef struct ProbeReader {
+    const uint8_t      *p;
+    const uint8_t      *end;
+    int                 error;
+} ProbeReader;
+
+static void put_bytes(ProbeWriter *w, const void *src, int size)
+{
+    uint8_t *data;
+
+    if (w->error)
+        return;
+    data = av_fast_realloc(w->data, &w->capacity, w->size + size);
+    if (!data) {
+        w->error = 1;
+        return;
+    }
+    w->data = data;
+    memcpy(w->data + w->size, src, size);
+    w->size += size;
+}
+
+static void put_i64(ProbeWriter *w, int64_t value)
+{
+    uint8_t buf[8];
+
+    AV_WL64(buf, value);
+    put_bytes(w, buf, sizeof(buf));
+}
+
+static void put_rational(ProbeWriter *w, AVRational q)
+{
+    put_i64(w, q.num);
+    put_i64(w, q.den);
+}
+
+static void put_blob(ProbeWriter *w, const uint8_t *data, int size)
+{
+    put_i64(w, size);
+    if (size > 0)
+        put_bytes(w, data, size);
+}
+
+static int64_t get_i64(ProbeReader *r)
+{
+    int64_t value;
+
+    if (r->error || r->end - r->p < 8) {
+        r->error = 1;
+        return 0;
+    }
+    value = AV_RL64(r->p);
+    r->p += 8;
+    return value;
+}
+
+static AVRational get_rational(ProbeReader *r)
+{
+    AVRational q;
+
+    q.num = (int)get_i64(r);
+    q.den = (int)get_i64(r);
+    return q;
+}
+
+/* returns a pointer into the reader's buffer */
+static const uint8_t *get_blob(ProbeReader *r, int *size)
+{
+    const uint8_t *data;
+    int64_t len = get_i64(r);
+
+    if (r->error || len < 0 || len > r->end - r->p) {
+        r->error = 1;
+        *size = 0;
+        return NULL;
+    }
+    data = r->p;
+    r->p += len;
+    *size = (int)len;
+    return data;
+}
+
+static void put_codecpar(ProbeWriter *w, const AVCodecParameters *par)
+{
+    put_i64(w, par->codec_type);
+    put_i64(w, par->codec_id);
+    put_i64(w, par->codec_tag);
+    put_i64(w, par->format);
+    put_i64(w, par->bit_rate);
+    put_i64(w, par->bits_per_coded_sample);
+    put_i64(w, par->bits_per_raw_sample);
+    put_i64(w, par->profile);
+    put_i64(w, par->level);
+    put_i64(w, par->width);
+    put_i64(w, par->height);
+    put_rational(w, par->sample_aspect_ratio);
+    put_i64(w, par->field_order);
+    put_i64(w, par->color_range);
+    put_i64(w, par->color_primaries);
+    put_i64(w, par->color_trc);
+    put_i64(w, par->color_space);
+    put_i64(w, par->chroma_location);
+    put_i64(w, par->video_delay);
+    put_i64(w, par->channel_layout);
+    put_i64(w, par->channels);
+    put_i64(w, par->sample_rate);
+    put_i64(w, par->block_align);
+    put_i64(w, par->frame_size);
+    put_i64(w, par->initial_padding);
+    put_i64(w, par->trailing_padding);
+    put_i64(w, par->seek_preroll);
+    put_blob(w, par->extradata, par->extradata_size);
+}
+
+static int get_codecpar(ProbeReader *r, AVCodecParameters *par)
+{
+    const uint8_t *extradata;
+    int extradata_size;
+
+    par->codec_type             = get_i64(r);
+    par->codec_id               = get_i64(r);
+    par->codec_tag              = get_i64(r);
+    par->format                 = get_i64(r);
+    par->bit_rate               = get_i64(r);
+    par->bits_per_coded_sample  = get_i64(r);
+    par->bits_per_raw_sample    = get_i64(r);
+    par->profile                = get_i64(r);
+    par->level                  = get_i64(r);
+    par->width                  = get_i64(r);
+    par->height                 = get_i64(r);
+    par->sample_aspect_ratio    = get_rational(r);
+    par->field_order            = get_i64(r);
+    par->color_range            = get_i64(r);
+    par->color_primaries        = get_i64(r);
+    par->color_trc              = get_i64(r);
+    par->color_space            = get_i64(r);
+    par->chroma_location        = get_i64(r);
+    par->video_delay            = get_i64(r);
+    par->channel_layout         = get_i64(r);
+    par->channels               = get_i64(r);
+    par->sample_rate            = get_i64(r);
+    par->block_align            = get_i64(r);
+    par->frame_size             = get_i64(r);
+    par->initial_padding        = get_i64(r);
+    par->trailing_padding       = get_i64(r);
+    par->seek_preroll           = get_i64(r);
+
+    extradata = get_blob(r, &extradata_size);
+    if (r->error)
+        return -1;
+    if (extradata_size > 0) {
+        par->extradata = av_mallocz(extradata_size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!par->extradata)
+            return AVERROR(ENOMEM);
+        memcpy(par->extradata, extradata, extradata_size);
+        par->extradata_size = extradata_size;
+    }
+    return 0;
+}
+
+static int serialize(AVFormatContext *ic, uint8_t **data)
+{
+    ProbeWriter w = { 0 };
+    const char *name = ic->iformat->name;
+    unsigned int i;
+
+    put_i64(&w, PROBE_CACHE_MAGIC);
+    put_i64(&w, LIBAVFORMAT_VERSION_INT);
+    put_i64(&w, LIBAVCODEC_VERSION_INT);
+    put_blob(&w, (const uint8_t *)name, strlen(name));
+    put_i64(&w, ic->start_time);
+    put_i64(&w, ic->duration);
+    put_i64(&w, ic->bit_rate);
+    put_i64(&w, ic->nb_streams);
+    for (i = 0; i < ic->nb_streams; i++) {
+        AVStream *st = ic->streams[i];
+
+        put_i64(&w, st->id);
+        put_rational(&w, st->time_base);
+        put_i64(&w, st->pts_wrap_bits);
+        put_rational(&w, st->avg_frame_rate);
+        put_rational(&w, st->r_frame_rate);
+        put_rational(&w, st->sample_aspect_ratio);
+        put_i64(&w, st->disposition);
+        put_i64(&w, st->start_time);
+        put_i64(&w, st->duration);
+        put_codecpar(&w, st->codecpar);
+    }
+
+    if (w.error) {
+        av_freep(&w.data);
+        return AVERROR(ENOMEM);
+    }
+    *data = w.data;
+    return w.size;
+}
+
+static FFProbeCacheEntry *deserialize(const uint8_t *data, int size)
+{
+    ProbeReader r = { data, data + size, 0 };
+    FFProbeCacheEntry *entry;
+    const uint8_t *name;
+    int name_size, i;
+
+    if (get_i64(&r) != PROBE_CACHE_MAGIC ||
+        get_i64(&r) != LIBAVFORMAT_VERSION_INT ||
+        get_i64(&r) != LIBAVCODEC_VERSION_INT)
+        return NULL;
+
+    entry = av_mallocz(sizeof(FFProbeCacheEntry));
+    if (!entry)
+        return NULL;
+
+    name = get_blob(&r, &name_size);
+    if (name)
+        entry->iformat_name = av_strndup((const char *)name, name_size);
+    entry->start_time = get_i64(&r);
+    entry->duration   = get_i64(&r);
+    entry->bit_rate   = get_i64(&r);
+    entry->nb_streams = (int)get_i64(&r);
+    if (r.error || !entry->iformat_name ||
+        entry->nb_streams <= 0 || entry->nb_streams > PROBE_CACHE_MAX_STREAMS)
+        goto fail;
+
+    entry->streams = av_mallocz_array(entry->nb_streams, sizeof(FFProbeCacheStream));
+    if (!entry->streams)
+        goto fail;
+    for (i = 0; i < entry->nb_streams; i++) {
+        FFProbeCacheStream *cs = &entry->streams[i];
+
+        cs->id                  = (int)get_i64(&r);
+        cs->time_base           = get_rational(&r);
+        cs->pts_wrap_bits       = (int)get_i64(&r);
+        cs->avg_frame_rate      = get_rational(&r);
+        cs->r_frame_rate        = get_rational(&r);
+        cs->sample_aspect_ratio = get_rational(&r);
+        cs->disposition         = (int)get_i64(&r);
+        cs->start_time          = get_i64(&r);
+        cs->duration            = get_i64(&r);
+        cs->par = avcodec_parameters_alloc();
+        if (!cs->par || get_codecpar(&r, cs->par) < 0)
+            goto fail;
+        if (cs->time_base.num <= 0 || cs->time_base.den <= 0)
+            goto fail;
+    }
+    return entry;
+fail:
+    ffp_probe_cache_entry_free(&entry);
+    return NULL;
+}
+
+/* ---------- storage ---------- */
+
+static char *cache_path(const char *dir, const char *key)
+{
+    uint8_t md5[16];
+    char hex[33];
+    int i;
+
+    if (!dir || !*dir)
+        return NULL;
+    av_md5_sum(md5, (const uint8_t *)key, strlen(key));
+    for (i = 0; i < 16; i++)
+        snprintf(hex + i * 2, 3, "%02x", md5[i]);
+    return av_asprintf("%s/%s.probe", dir, hex);
+}
+
+static int file_read(const char *path, uint8_t **data)
+{
+    FILE *fp = fopen(path, "rb");
+    long size;
+    int ret = -1;
+
+    if (!fp)
+        return -1;
+    if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) > 0 && size < (1 << 20) &&
+        fseek(fp, 0, SEEK_SET) == 0) {
+        *data = av_malloc(size);
+        if (*data && fread(*data, 1, size, fp) == (size_t)size)
+            ret = (int)size;
+        else
+            av_freep(data);
+    }
+    fclose(fp);
+    return ret;
+}
+
+/*
+ * write to a temporary file first so a concurrent reader never sees a partial
+ * entry; mkstemp() gives each writer its own, players in the same process
+ * storing the same key included
+ */
+static void file_write(const char *path, const uint8_t *data, int size)
+{
+    char *tmp = av_asprintf("%s.XXXXXX", path);
+    FILE *fp = NULL;
+    int fd, ok;
+
+    if (!tmp)
+        return;
+    fd = mkstemp(tmp);
+    if (fd >= 0 && !(fp = fdopen(fd, "wb"))) {
+        close(fd);
+        remove(tmp);
+    }
+    if (fp) {
+        ok = fwrite(data, 1, size, fp) == (size_t)size;
+        ok = !fclose(fp) && ok;
+        if (!ok || rename(tmp, path) < 0)
+            remove(tmp);
+    }
+    av_free(tmp);
+}
+
+static void blob_clear(ProbeCacheBlob *blob)
+{
+    av_freep(&blob->key);
+    av_freep(&blob->data);
+    blob->size = 0;
+}
+
+/* call with g_mutex held; index of key, or -1 */
+static int mem_find(const char *key)
+{
+    int i;
+
+    for (i = 0; i < PROBE_CACHE_MEM_ENTRIES && g_blobs[i].key; i++) {
+        if (!strcmp(g_blobs[i].key, key))
+            return i;
+    }
+    return -1;
+}
+
+/* call with g_mutex held; moves g_blobs[i] to the front */
+static void mem_touch(int i)
+{
+    ProbeCacheBlob blob = g_blobs[i];
+
+    memmove(&g_blobs[1], &g_blobs[0], i * sizeof(ProbeCacheBlob));
+    g_blobs[0] = blob;
+}
+
+/* call with g_mutex held; takes ownership of data */
+static void mem_insert(const char *key, uint8_t *data, int size)
+{
+    int i = mem_find(key);
+
+    if (i < 0) {
+        /* first free slot, or evict the least recently used */
+        for (i = 0; i < PROBE_CACHE_MEM_ENTRIES - 1 && g_blobs[i].key; i++)
+            ;
+        blob_clear(&g_blobs[i]);
+        g_blobs[i].key = av_strdup(key);
+        if (!g_blobs[i].key) {
+            av_free(data);
+            return;
+        }
+    } else {
+        av_freep(&g_blobs[i].data);
+    }
+    g_blobs[i].data = data;
+    g_blobs[i].size = size;
+    mem_touch(i);
+}
+
+/* call with g_mutex held */
+static void mem_remove(const char *key)
+{
+    int i = mem_find(key);
+
+    if (i < 0)
+        return;
+    blob_clear(&g_blobs[i]);
+    memmove(&g_blobs[i], &g_blobs[i + 1], (PROBE_CACHE_MEM_ENTRIES - 1 - i) * sizeof(ProbeCacheBlob));
+    memset(&g_blobs[PROBE_CACHE_MEM_ENTRIES - 1], 0, sizeof(ProbeCacheBlob));
+}
+
+/* ---------- public ---------- */
+
+char *ffp_probe_cache_make_key(const char *url)
+{
+    size_t len;
+
+    if (!url)
+        return NULL;
+    len = strcspn(url, "?#");
+    return av_strndup(url, len);
+}
+
+FFProbeCacheEntry *ffp_probe_cache_lookup(const char *dir, const char *key)
+{
+    FFProbeCacheEntry *entry = NULL;
+    uint8_t *data = NULL;
+    char *path;
+    int i, size;
+
+    if (!key)
+        return NULL;
+
+    pthread_mutex_lock(&g_mutex);
+    i = mem_find(key);
+    if (i >= 0) {
+        entry = deserialize(g_blobs[i].data, g_blobs[i].size);
+        mem_touch(i);
+    }
+    pthread_mutex_unlock(&g_mutex);
+    if (entry)
+        return entry;
+
+    path = cache_path(dir, key);
+    if (!path)
+        return NULL;
+    size = file_read(path, &data);
+    if (size > 0)
+        entry = deserialize(data, size);
+    if (entry) {
+        pthread_mutex_lock(&g_mutex);
+        mem_insert(key, data, size);
+        pthread_mutex_unlock(&g_mutex);
+    } else {
+        av_free(data);
+        if (size > 0)
+            remove(path);
+    }
+    av_free(path);
+    return entry;
+}
+
+void ffp_probe_cache_entry_free(FFProbeCacheEntry **entry)
+{
+    FFProbeCacheEntry *e;
+    int i;
+
+    if (!entry || !*entry)
+        return;
+    e = *entry;
+    if (e->streams) {
+        for (i = 0; i < e->nb_streams; i++)
+            avcodec_parameters_free(&e->streams[i].par);
+        av_freep(&e->streams);
+    }
+    av_freep(&e->iformat_name);
+    av_freep(entry);
+}
+
+/*
+ * The demuxer's own values against the cached ones, before anything is
+ * filled in: a source that changed behind the same key must not get stale
+ * codec ids, dimensions or extradata. Only fields that identify the
+ * stream are compared, the rest may legitimately be refined by
+ * avformat_find_stream_info() after the header was read.
+ */
+static int codecpar_conflicts(const AVCodecParameters *par, const AVCodecParameters *cache)
+{
+#define CONFLICT(field, unset) (par->field != (unset) && par->field != cache->field)
+    if (CONFLICT(codec_type, AVMEDIA_TYPE_UNKNOWN) || CONFLICT(codec_id, AV_CODEC_ID_NONE))
+        return 1;
+    if (par->codec_type == AVMEDIA_TYPE_VIDEO &&
+        (CONFLICT(width, 0) || CONFLICT(height, 0)))
+        return 1;
+    if (par->codec_type == AVMEDIA_TYPE_AUDIO &&
+        (CONFLICT(sample_rate, 0) || CONFLICT(channels, 0)))
+        return 1;
+#undef CONFLICT
+    if (par->extradata_size > 0 &&
+        (par->extradata_size != cache->extradata_size ||
+         memcmp(par->extradata, cache->extradata, par->extradata_size)))
+        return 1;
+    return 0;
+}
+
+/* fills what the demuxer left unset, keeps everything it did set */
+static int codecpar_fill(AVCodecParameters *par, const AVCodecParameters *cache)
+{
+#define FILL(field, unset) do { if (par->field == (unset)) par->field = cache->field; } while (0)
+    FILL(codec_type,            AVMEDIA_TYPE_UNKNOWN);
+    FILL(codec_id,              AV_CODEC_ID_NONE);
+    FILL(codec_tag,             0);
+    FILL(format,                -1);
+    FILL(bit_rate,              0);
+    FILL(bits_per_coded_sample, 0);
+    FILL(bits_per_raw_sample,   0);
+    FILL(profile,               FF_PROFILE_UNKNOWN);
+    FILL(level,                 FF_LEVEL_UNKNOWN);
+    FILL(width,                 0);
+    FILL(height,                0);
+    if (!par->sample_aspect_ratio.num)
+        par->sample_aspect_ratio = cache->sample_aspect_ratio;
+    FILL(field_order,           AV_FIELD_UNKNOWN);
+    FILL(color_range,           AVCOL_RANGE_UNSPECIFIED);
+    FILL(color_primaries,       AVCOL_PRI_UNSPECIFIED);
+    FILL(color_trc,             AVCOL_TRC_UNSPECIFIED);
+    FILL(color_space,           AVCOL_SPC_UNSPECIFIED);
+    FILL(chroma_location,       AVCHROMA_LOC_UNSPECIFIED);
+    FILL(video_delay,           0);
+    FILL(channel_layout,        0);
+    FILL(channels,              0);
+    FILL(sample_rate,           0);
+    FILL(block_align,           0);
+    FILL(frame_size,            0);
+    FILL(initial_padding,       0);
+    FILL(trailing_padding,      0);
+    FILL(seek_preroll,          0);
+#undef FILL
+
+    if (par->extradata_size <= 0 && cache->extradata_size > 0) {
+        av_freep(&par->extradata);
+        par->extradata = av_mallocz(cache->extradata_size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!par->extradata)
+            return AVERROR(ENOMEM);
+        memcpy(par->extradata, cache->extradata, cache->extradata_size);
+        par->extradata_size = cache->extradata_size;
+    }
+    return 0;
+}
+
+int ffp_probe_cache_apply(FFProbeCacheEntry *entry, AVFormatContext *ic)
+{
+    int i, ret;
+
+    if (!entry || !ic->iformat || strcmp(entry->iformat_name, ic->iformat->name))
+        return -1;
+    if ((int)ic->nb_streams > entry->nb_streams)
+        return -1;
+    /* only formats without a header may still be missing streams */
+    if ((int)ic->nb_streams < entry->nb_streams && !(ic->ctx_flags & AVFMTCTX_NOHEADER))
+        return -1;
+
+    /* compare everything first, so that a mismatch leaves ic as the demuxer made it */
+    for (i = 0; i < (int)ic->nb_streams; i++) {
+        AVStream *st = ic->streams[i];
+        FFProbeCacheStream *cs = &entry->streams[i];
+
+        if (st->id != cs->id || av_cmp_q(st->time_base, cs->time_base) ||
+            codecpar_conflicts(st->codecpar, cs->par)) {
+            av_log(ic, AV_LOG_WARNING, "probe cache: stream %d differs from cached parameters\n", i);
+            return -1;
+        }
+    }
+
+    for (i = 0; i < entry->nb_streams; i++) {
+        FFProbeCacheStream *cs = &entry->streams[i];
+        AVStream *st;
+
+        if (i < (int)ic->nb_streams) {
+            st = ic->streams[i];
+        } else {
+            st = avformat_new_stream(ic, NULL);
+            if (!st)
+                return AVERROR(ENOMEM);
+            st->id            = cs->id;
+            st->time_base     = cs->time_base;
+            st->pts_wrap_bits = cs->pts_wrap_bits;
+        }
+        ret = codecpar_fill(st->codecpar, cs->par);
+        if (ret < 0)
+            return ret;
+        if (!st->avg_frame_rate.num)
+            st->avg_frame_rate = cs->avg_frame_rate;
+        if (!st->r_frame_rate.num)
+            st->r_frame_rate = cs->r_frame_rate;
+        if (!st->sample_aspect_ratio.num)
+            st->sample_aspect_ratio = cs->sample_aspect_ratio;
+        if (!st->disposition)
+            st->disposition = cs->disposition;
+        if (st->start_time == AV_NOPTS_VALUE)
+            st->start_time = cs->start_time;
+        if (st->duration == AV_NOPTS_VALUE)
+            st->duration = cs->duration;
+        cs->seen = 0;
+    }
+    if (ic->start_time == AV_NOPTS_VALUE)
+        ic->start_time = entry->start_time;
+    if (ic->duration == AV_NOPTS_VALUE)
+        ic->duration = entry->duration;
+    if (!ic->bit_rate)
+        ic->bit_rate = entry->bit_rate;
+    return 0;
+}
+
+/*
+ * The codec parameters were checked against the demuxer's in
+ * ffp_probe_cache_apply(); what is left to see in the packets is a stream
+ * the cache does not have, and in-band sequence headers.
+ */
+static int check_packet(FFProbeCacheEntry *entry, const AVPacket *pkt)
+{
+    FFProbeCacheStream *cs;
+    uint8_t *side;
+    int side_size;
+
+    /* the demuxer found a stream the cache does not know about */
+    if (pkt->stream_index < 0 || pkt->stream_index >= entry->nb_streams)
+        return -1;
+    cs = &entry->streams[pkt->stream_index];
+
+    /* e.g. FLV AVC/AAC config tags */
+    side = av_packet_get_side_data(pkt, AV_PKT_DATA_NEW_EXTRADATA, &side_size);
+    if (side && side_size > 0 && cs->par->extradata_size > 0 &&
+        (side_size != cs->par->extradata_size || memcmp(side, cs->par->extradata, side_size)))
+        return -1;
+
+    cs->seen = 1;
+    return 0;
+}
+
+static int all_seen(FFProbeCacheEntry *entry)
+{
+    int i;
+
+    for (i = 0; i < entry->nb_streams; i++) {
+        enum AVMediaType type = entry->streams[i].par->codec_type;
+
+        if ((type == AVMEDIA_TYPE_AUDIO || type == AVMEDIA_TYPE_VIDEO) && !entry->streams[i].seen)
+            return 0;
+    }
+    return 1;
+}
+
+int ffp_probe_cache_validate(FFProbeCacheEntry *entry, AVFormatContext *ic,
+                             AVPacketList **pkts, int max_packets)
+{
+    AVPacketList **tail = pkts;
+    int flags = ic->flags;
+    int count = 0;
+    int ret = 0;
+
+    while (*tail)
+        tail = &(*tail)->next;
+
+#ifdef AVFMT_FLAG_KEEP_SIDE_DATA
+    /* keep NEW_EXTRADATA visible instead of merged into the payload */
+    ic->flags |= AVFMT_FLAG_KEEP_SIDE_DATA;
+#endif
+    while (count < max_packets && !all_seen(entry)) {
+        AVPacketList *pktl = av_mallocz(sizeof(AVPacketList));
+
+        if (!pktl) {
+            ret = AVERROR(ENOMEM);
+            break;
+        }
+        ret = av_read_frame(ic, &pktl->pkt);
+        if (ret < 0) {
+            av_free(pktl);
+            /* nothing to compare against, let a full probe decide */
+            if (count > 0)
+                ret = 0;
+            break;
+        }
+        *tail = pktl;
+        tail  = &pktl->next;
+        count++;
+
+        ret = check_packet(entry, &pktl->pkt);
+        if (ret < 0) {
+            av_log(ic, AV_LOG_WARNING, "probe cache: stream %d differs from cached parameters\n",
+                   pktl->pkt.stream_index);
+            break;
+        }
+    }
+    ic->flags = flags;
+    return ret;
+}
+
+void ffp_probe_cache_store(const char *dir, const char *key, AVFormatContext *ic)
+{
+    uint8_t *data = NULL;
+    char *path;
+    int size;
+
+    if (!key || !ic->nb_streams || ic->nb_streams > PROBE_CACHE_MAX_STREAMS)
+        return;
+    size = serialize(ic, &data);
+    if (size <= 0)
+        return;
+
+    path = cache_path(dir, key);
+    if (path) {
+        file_write(path, data, size);
+        av_free(path);
+    }
+
+    pthread_mutex_lock(&g_mutex);
+    mem_insert(key, data, size);
+    pthread_mutex_unlock(&g_mutex);
+}
+
+void ffp_probe_cache_invalidate(const char *dir, const char *key)
+{
+    char *path;
+
+    if (!key)
+        return;
+    pthread_mutex_lock(&g_mutex);
+    mem_remove(key);
+    pthread_mutex_unlock(&g_mutex);
+
+    path = cache_path(dir, key);
+    if (path) {
+        remove(path);
+        av_free(path);
+    }
+}
+
+void ffp_probe_cache_packets_free(AVPacketList **pkts)
+{
+    while (*pkts) {
+        AVPacketList *pktl = *pkts;
+
+        *pkts = pktl->next;
+        av_packet_unref(&pktl->pkt);
+        av_free(pktl);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * ff_probe_cache.h
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef FFPLAY__FF_PROBE_CACHE_H
+#define FFPLAY__FF_PROBE_CACHE_H
+
+#include "libavformat/avformat.h"
+
+/*
+ * Remembers the stream layout and codec parameters found by
+ * avformat_find_stream_info(), so that the next open of the same source can
+ * skip probing. Entries live in memory for the process lifetime and, when a
+ * directory is given, in one file per key so they survive restarts.
+ *
+ * Usage after avformat_open_input():
+ *   entry = ffp_probe_cache_lookup(dir, key);
+ *   if (entry && ffp_probe_cache_apply(entry, ic) == 0 &&
+ *       ffp_probe_cache_validate(entry, ic, &pkts, n) == 0)
+ *       -> play, feeding pkts first
+ *   else
+ *       -> ffp_probe_cache_invalidate(), reopen, avformat_find_stream_info(),
+ *          ffp_probe_cache_store()
+ */
+
+typedef struct FFProbeCacheEntry FFProbeCacheEntry;
+
+/* url without query string and fragment, which usually carry per-session tokens */
+char               *ffp_probe_cache_make_key(const char *url);
+
+FFProbeCacheEntry  *ffp_probe_cache_lookup(const char *dir, const char *key);
+void                ffp_probe_cache_entry_free(FFProbeCacheEntry **entry);
+
+/* creates/fills the streams of a freshly opened ic, < 0 if they do not fit */
+int                 ffp_probe_cache_apply(FFProbeCacheEntry *entry, AVFormatContext *ic);
+/*
+ * reads up to max_packets (stops early once every stream was seen) and
+ * checks them against the entry; read packets are appended to *pkts
+ * either way and must be consumed or freed by the caller.
+ */
+int                 ffp_probe_cache_validate(FFProbeCacheEntry *entry, AVFormatContext *ic,
+                                             AVPacketList **pkts, int max_packets);
+
+void                ffp_probe_cache_store(const char *dir, const char *key, AVFormatContext *ic);
+void                ffp_probe_cache_invalidate(const char *dir, const char *key);
+
+void                ffp_probe_cache_packets_free(AVPacketList **pkts);
+
+#endif
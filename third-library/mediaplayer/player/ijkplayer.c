@@ -86,6 +86,16 @@ void ijkmp_global_set_log_level(int log_level)
     ffp_global_set_log_level(log_level);
 }
 
+void ijkmp_global_set_trace_enabled(int enabled)
+{
+    ffp_global_set_trace_enabled(enabled);
+}
+
+int ijkmp_global_trace_export(const char *path)
+{
+    return ffp_global_trace_export(path);
+}
+
 void ijkmp_global_set_inject_callback(ijk_inject_callback cb)
 {
     ffp_global_set_inject_callback(cb);
@@ -547,6 +557,28 @@ int ijkmp_stop(IjkMediaPlayer *mp)
     return retval;
 }
 
+static int ijkmp_promote_l(IjkMediaPlayer *mp)
+{
+    MPST_RET_IF_EQ(mp->mp_state, MP_STATE_IDLE);
+    MPST_RET_IF_EQ(mp->mp_state, MP_STATE_INITIALIZED);
+    MPST_RET_IF_EQ(mp->mp_state, MP_STATE_STOPPED);
+    MPST_RET_IF_EQ(mp->mp_state, MP_STATE_ERROR);
+    MPST_RET_IF_EQ(mp->mp_state, MP_STATE_END);
+
+    return ffp_promote_l(mp->ffplayer);
+}
+
+int ijkmp_promote(IjkMediaPlayer *mp)
+{
+    assert(mp);
+    MPTRACE("ijkmp_promote()\n");
+    pthread_mutex_lock(&mp->mutex);
+    int retval = ijkmp_promote_l(mp);
+    pthread_mutex_unlock(&mp->mutex);
+    MPTRACE("ijkmp_promote()=%d\n", retval);
+    return retval;
+}
+
 bool ijkmp_is_playing(IjkMediaPlayer *mp)
 {
     assert(mp);
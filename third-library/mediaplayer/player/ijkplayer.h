@@ -155,6 +155,8 @@ void            ijkmp_global_init();
 void            ijkmp_global_uninit();
 void            ijkmp_global_set_log_report(int use_report);
 void            ijkmp_global_set_log_level(int log_level);   // log_level = AV_LOG_xxx
+void            ijkmp_global_set_trace_enabled(int enabled);
+int             ijkmp_global_trace_export(const char *path); // Chrome trace-event JSON
 void            ijkmp_global_set_inject_callback(ijk_inject_callback cb);
 const char     *ijkmp_version();
 void            ijkmp_io_stat_register(void (*cb)(const char *url, int type, int bytes));
@@ -201,6 +203,8 @@ int             ijkmp_prepare_async(IjkMediaPlayer *mp);
 int             ijkmp_start(IjkMediaPlayer *mp);
 int             ijkmp_pause(IjkMediaPlayer *mp);
 int             ijkmp_stop(IjkMediaPlayer *mp);
+// with the "preload" player option: leave the standby and go on to PREPARED
+int             ijkmp_promote(IjkMediaPlayer *mp);
 int             ijkmp_seek_to(IjkMediaPlayer *mp, long msec);
 int             ijkmp_get_state(IjkMediaPlayer *mp);
 bool            ijkmp_is_playing(IjkMediaPlayer *mp);
@@ -0,0 +1,204 @@
+/*
+ * ijkplayer_pool.c
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ijkplayer_pool.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ff_ffplay.h"
+
+typedef struct IjkMediaPlayerPoolEntry {
+    char           *url;
+    IjkMediaPlayer *mp;
+    int64_t         serial;     // preload order, the smallest is evicted first
+} IjkMediaPlayerPoolEntry;
+
+struct IjkMediaPlayerPool {
+    pthread_mutex_t          mutex;
+    IjkMediaPlayerPoolEntry *entries;
+    int                      capacity;
+    int64_t                  serial;
+
+    IjkMediaPlayer *(*create)(void *opaque);
+    void            *opaque;
+};
+
+static void entry_release(IjkMediaPlayer *mp)
+{
+    if (!mp)
+        return;
+    ijkmp_shutdown(mp);
+    ijkmp_dec_ref_p(&mp);
+}
+
+static IjkMediaPlayerPoolEntry *entry_find_l(IjkMediaPlayerPool *pool, const char *url)
+{
+    for (int i = 0; i < pool->capacity; i++) {
+        if (pool->entries[i].url && !strcmp(pool->entries[i].url, url))
+            return &pool->entries[i];
+    }
+    return NULL;
+}
+
+static IjkMediaPlayer *entry_take_l(IjkMediaPlayerPoolEntry *entry)
+{
+    IjkMediaPlayer *mp = entry->mp;
+
+    free(entry->url);
+    memset(entry, 0, sizeof(*entry));
+    return mp;
+}
+
+IjkMediaPlayerPool *ijkmp_pool_create(int capacity, IjkMediaPlayer *(*create)(void *opaque), void *opaque)
+{
+    IjkMediaPlayerPool *pool;
+
+    assert(create);
+    if (capacity <= 0)
+        return NULL;
+
+    pool = calloc(1, sizeof(IjkMediaPlayerPool));
+    if (!pool)
+        return NULL;
+    pool->entries = calloc(capacity, sizeof(IjkMediaPlayerPoolEntry));
+    if (!pool->entries) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pool->capacity = capacity;
+    pool->create   = create;
+    pool->opaque   = opaque;
+    return pool;
+}
+
+void ijkmp_pool_destroy(IjkMediaPlayerPool **ppool)
+{
+    IjkMediaPlayerPool *pool;
+
+    if (!ppool || !*ppool)
+        return;
+    pool = *ppool;
+
+    for (int i = 0; i < pool->capacity; i++) {
+        if (pool->entries[i].url)
+            entry_release(entry_take_l(&pool->entries[i]));
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->entries);
+    free(pool);
+    *ppool = NULL;
+}
+
+int ijkmp_pool_preload(IjkMediaPlayerPool *pool, const char *url)
+{
+    IjkMediaPlayerPoolEntry *entry = NULL;
+    IjkMediaPlayer *evicted = NULL;
+    IjkMediaPlayer *mp = NULL;
+    char *url_copy = NULL;
+    int ret = 0;
+
+    assert(pool);
+    assert(url);
+
+    /* lookup and insert under one lock, or two callers preloading the same
+     * url would both miss and start two players for it */
+    pthread_mutex_lock(&pool->mutex);
+    if (entry_find_l(pool, url))
+        goto end;
+
+    url_copy = strdup(url);
+    mp = url_copy ? pool->create(pool->opaque) : NULL;
+    if (!mp) {
+        ret = EIJK_OUT_OF_MEMORY;
+        goto end;
+    }
+    ijkmp_set_option_int(mp, IJKMP_OPT_CATEGORY_PLAYER, "preload", 1);
+    ret = ijkmp_set_data_source(mp, url);
+    if (ret == 0)
+        ret = ijkmp_prepare_async(mp);
+    if (ret != 0)
+        goto end;
+
+    for (int i = 0; i < pool->capacity; i++) {
+        IjkMediaPlayerPoolEntry *e = &pool->entries[i];
+        if (!e->url) {
+            entry = e;
+            break;
+        }
+        if (!entry || e->serial < entry->serial)
+            entry = e;
+    }
+    if (entry->url)
+        evicted = entry_take_l(entry);
+    entry->url    = url_copy;
+    entry->mp     = mp;
+    entry->serial = pool->serial++;
+    url_copy = NULL;
+    mp       = NULL;
+
+end:
+    pthread_mutex_unlock(&pool->mutex);
+    /* shutting a player down waits for its threads, keep that out of the lock */
+    free(url_copy);
+    entry_release(mp);
+    entry_release(evicted);
+    return ret;
+}
+
+IjkMediaPlayer *ijkmp_pool_promote(IjkMediaPlayerPool *pool, const char *url)
+{
+    IjkMediaPlayerPoolEntry *entry;
+    IjkMediaPlayer *mp = NULL;
+
+    assert(pool);
+    assert(url);
+
+    pthread_mutex_lock(&pool->mutex);
+    entry = entry_find_l(pool, url);
+    if (entry)
+        mp = entry_take_l(entry);
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (mp && ijkmp_promote(mp) != 0) {
+        /* failed while in standby, let the caller cold start */
+        entry_release(mp);
+        mp = NULL;
+    }
+    return mp;
+}
+
+void ijkmp_pool_remove(IjkMediaPlayerPool *pool, const char *url)
+{
+    IjkMediaPlayerPoolEntry *entry;
+    IjkMediaPlayer *mp = NULL;
+
+    assert(pool);
+    assert(url);
+
+    pthread_mutex_lock(&pool->mutex);
+    entry = entry_find_l(pool, url);
+    if (entry)
+        mp = entry_take_l(entry);
+    pthread_mutex_unlock(&pool->mutex);
+
+    entry_release(mp);
+}
@@ -0,0 +1,60 @@
+/*
+ * ijkplayer_pool.h
+ *
+ * This file is part of ijkPlayer.
+ *
+ * ijkPlayer is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ijkPlayer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with ijkPlayer; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef IJKPLAYER_ANDROID__IJKPLAYER_POOL_H
+#define IJKPLAYER_ANDROID__IJKPLAYER_POOL_H
+
+#include "ijkplayer.h"
+
+/*
+ * Warm-standby players for fast channel switching.
+ *
+ * Each preloaded player runs with the "preload" option: it connects, probes
+ * and keeps the packets from the latest keyframe on, but opens no decoder
+ * until it is promoted. Promotion hands the player over to the caller, which
+ * then sees FFP_MSG_PREPARED on its message loop as with a normal prepare.
+ *
+ *   pool = ijkmp_pool_create(3, create_player, app);
+ *   ijkmp_pool_preload(pool, "http://.../ch2.m3u8");
+ *   ...
+ *   mp = ijkmp_pool_promote(pool, "http://.../ch2.m3u8");
+ *   if (!mp)
+ *       mp = ... cold start ...
+ */
+
+typedef struct IjkMediaPlayerPool IjkMediaPlayerPool;
+
+/*
+ * create returns a new player with its vout, options and weak_thiz set up,
+ * exactly as for a normal playback; it must not set the data source.
+ * It is called with the pool locked and must not call back into the pool.
+ */
+IjkMediaPlayerPool *ijkmp_pool_create(int capacity, IjkMediaPlayer *(*create)(void *opaque), void *opaque);
+// NOTE: may block, every player still in the pool is shut down
+void                ijkmp_pool_destroy(IjkMediaPlayerPool **ppool);
+
+// evicts the least recently preloaded player when the pool is full
+int                 ijkmp_pool_preload(IjkMediaPlayerPool *pool, const char *url);
+// returns a promoted player owned by the caller, or NULL if url is not preloaded
+IjkMediaPlayer     *ijkmp_pool_promote(IjkMediaPlayerPool *pool, const char *url);
+// NOTE: may block
+void                ijkmp_pool_remove(IjkMediaPlayerPool *pool, const char *url);
+
+#endif
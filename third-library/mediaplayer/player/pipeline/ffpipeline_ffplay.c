@@ -24,6 +24,7 @@
 #include "ffpipeline_ffplay.h"
 #include "ffpipenode_ffplay_vdec.h"
 #include "../ff_ffplay.h"
+#include "ijksdl/dummy/ijksdl_aout_dummy.h"
 
 static SDL_Class g_pipeline_class = {
     .name = "ffpipeline_ffplay",
@@ -43,9 +44,10 @@ static IJKFF_Pipenode *func_open_video_decoder(IJKFF_Pipeline *pipeline, FFPlaye
     return ffpipenode_create_video_decoder_from_ffplay(ffp);
 }
 
+/* no audio device on this pipeline: play into the null output */
 static SDL_Aout *func_open_audio_output(IJKFF_Pipeline *pipeline, FFPlayer *ffp)
 {
-    return NULL;
+    return SDL_AoutDummy_Create(ffp->null_aout_realtime);
 }
 
 IJKFF_Pipeline *ffpipeline_create_from_ffplay(FFPlayer *ffp)
@@ -709,6 +709,50 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
 }
 
 
+/* Fills one device buffer through the resampler, running the callback at
+   its own buffer size as many times as that takes. */
+static void
+SDL_ResampleAudio(SDL_AudioDevice *device, Uint8 *stream)
+{
+    SDL_AudioCVT *cvt = &device->resample_cvt;
+    const int channels = device->spec.channels;
+    const int frames = device->spec.samples;
+    float *out = (float *) cvt->buf;
+    int done = 0;
+
+    while (done < frames) {
+        done += SDL_GetAudioResampler(device->resampler, out + done * channels,
+                                      frames - done);
+        if (done < frames) {
+            const float *in = (const float *) device->convert.buf;
+            int len = device->callback_len;
+
+            /* !!! FIXME: this should be LockDevice. */
+            SDL_LockMutex(device->mixer_lock);
+            if (SDL_AtomicGet(&device->paused)) {
+                SDL_UnlockMutex(device->mixer_lock);
+                SDL_memset(out + done * channels, '\0',
+                           (frames - done) * channels * sizeof (float));
+                break;
+            }
+            device->spec.callback(device->spec.userdata, device->convert.buf, len);
+            SDL_UnlockMutex(device->mixer_lock);
+
+            if (device->convert.needed) {
+                SDL_ConvertAudio(&device->convert);
+                len = device->convert.len_cvt;
+            }
+            SDL_PutAudioResampler(device->resampler, in,
+                                  len / (int) (channels * sizeof (float)));
+        }
+    }
+
+    if (cvt->needed) {
+        SDL_ConvertAudio(cvt);
+    }
+    SDL_memcpy(stream, cvt->buf, device->spec.size);
+}
+
 /* The general mixing thread function */
 static int SDLCALL
 SDL_RunAudio(void *devicep)
@@ -733,43 +777,57 @@ SDL_RunAudio(void *devicep)
     /* Loop, filling the audio buffers */
     while (!SDL_AtomicGet(&device->shutdown)) {
         /* Fill the current buffer with sound */
-        if (device->convert.needed) {
-            stream = device->convert.buf;
-        } else if (SDL_AtomicGet(&device->enabled)) {
-            stream = current_audio.impl.GetDeviceBuf(device);
-        } else {
-            /* if the device isn't enabled, we still write to the
-               fake_stream, so the app's callback will fire with
-               a regular frequency, in case they depend on that
-               for timing or progress. They can use hotplug
-               now to know if the device failed. */
+        if (device->resampler) {
+            /* the callback runs from in here, as often as the rate takes */
             stream = NULL;
-        }
-
-        if (stream == NULL) {
-            stream = device->fake_stream;
-        }
-
-        /* !!! FIXME: this should be LockDevice. */
-        if ( SDL_AtomicGet(&device->enabled) ) {
-            SDL_LockMutex(device->mixer_lock);
-            if (SDL_AtomicGet(&device->paused)) {
-                SDL_memset(stream, silence, stream_len);
+            if (SDL_AtomicGet(&device->enabled)) {
+                stream = current_audio.impl.GetDeviceBuf(device);
+                if (stream == NULL) {
+                    stream = device->fake_stream;
+                }
+                SDL_ResampleAudio(device, stream);
             } else {
-                (*callback) (udata, stream, stream_len);
+                stream = device->fake_stream;
+            }
+        } else {
+            if (device->convert.needed) {
+                stream = device->convert.buf;
+            } else if (SDL_AtomicGet(&device->enabled)) {
+                stream = current_audio.impl.GetDeviceBuf(device);
+            } else {
+                /* if the device isn't enabled, we still write to the
+                   fake_stream, so the app's callback will fire with
+                   a regular frequency, in case they depend on that
+                   for timing or progress. They can use hotplug
+                   now to know if the device failed. */
+                stream = NULL;
             }
-            SDL_UnlockMutex(device->mixer_lock);
-        }
 
-        /* Convert the audio if necessary */
-        if (device->convert.needed && SDL_AtomicGet(&device->enabled)) {
-            SDL_ConvertAudio(&device->convert);
-            stream = current_audio.impl.GetDeviceBuf(device);
             if (stream == NULL) {
                 stream = device->fake_stream;
-            } else {
-                SDL_memcpy(stream, device->convert.buf,
-                           device->convert.len_cvt);
+            }
+
+            /* !!! FIXME: this should be LockDevice. */
+            if ( SDL_AtomicGet(&device->enabled) ) {
+                SDL_LockMutex(device->mixer_lock);
+                if (SDL_AtomicGet(&device->paused)) {
+                    SDL_memset(stream, silence, stream_len);
+                } else {
+                    (*callback) (udata, stream, stream_len);
+                }
+                SDL_UnlockMutex(device->mixer_lock);
+            }
+
+            /* Convert the audio if necessary */
+            if (device->convert.needed && SDL_AtomicGet(&device->enabled)) {
+                SDL_ConvertAudio(&device->convert);
+                stream = current_audio.impl.GetDeviceBuf(device);
+                if (stream == NULL) {
+                    stream = device->fake_stream;
+                } else {
+                    SDL_memcpy(stream, device->convert.buf,
+                               device->convert.len_cvt);
+                }
             }
         }
 
@@ -1099,9 +1157,9 @@ close_audio_device(SDL_AudioDevice * device)
         SDL_DestroyMutex(device->mixer_lock);
     }
     SDL_free(device->fake_stream);
-    if (device->convert.needed) {
-        SDL_free(device->convert.buf);
-    }
+    SDL_free(device->convert.buf);
+    SDL_free(device->resample_cvt.buf);
+    SDL_FreeAudioResampler(device->resampler);
     if (device->hidden != NULL) {
         current_audio.impl.CloseDevice(device);
     }
@@ -1175,6 +1233,65 @@ prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared)
     return 1;
 }
 
+/*
+ * Filter length for opened playback devices that resample, from
+ *  SDL_HINT_AUDIO_RESAMPLING_MODE; zero means the stateless filters of
+ *  SDL_BuildAudioCVT().
+ */
+static int
+get_resampler_taps(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_AUDIO_RESAMPLING_MODE);
+
+    if (hint) {
+        if (*hint == '0' || SDL_strcasecmp(hint, "fast") == 0) {
+            return 0;
+        } else if (*hint == '2' || SDL_strcasecmp(hint, "best") == 0) {
+            return 48;
+        }
+    }
+    return 16;
+}
+
+/*
+ * Sets up (device) to take the callback's data through the resampler:
+ *  format and channels to float first, rate next, then the device format.
+ */
+static int
+prepare_audio_resampler(SDL_AudioDevice *device, const SDL_AudioSpec *obtained,
+                        int taps)
+{
+    const int channels = device->spec.channels;
+
+    if (SDL_BuildAudioCVT(&device->convert,
+                          obtained->format, obtained->channels, obtained->freq,
+                          AUDIO_F32SYS, channels, obtained->freq) < 0) {
+        return -1;
+    }
+    device->callback_len = obtained->size;
+    device->convert.len = obtained->size;
+    device->convert.buf = (Uint8 *) SDL_malloc(device->convert.len *
+                                               device->convert.len_mult);
+
+    if (SDL_BuildAudioCVT(&device->resample_cvt,
+                          AUDIO_F32SYS, channels, device->spec.freq,
+                          device->spec.format, channels, device->spec.freq) < 0) {
+        return -1;
+    }
+    device->resample_cvt.len = device->spec.samples * channels * sizeof (float);
+    device->resample_cvt.buf = (Uint8 *) SDL_malloc(device->resample_cvt.len *
+                                                    device->resample_cvt.len_mult);
+
+    if (device->convert.buf == NULL || device->resample_cvt.buf == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    device->resampler = SDL_NewAudioResampler(channels, obtained->freq,
+                                              device->spec.freq, taps,
+                                              obtained->samples);
+    return (device->resampler != NULL) ? 0 : -1;
+}
+
 static SDL_AudioDeviceID
 open_audio_device(const char *devname, int iscapture,
                   const SDL_AudioSpec * desired, SDL_AudioSpec * obtained,
@@ -1185,6 +1302,7 @@ open_audio_device(const char *devname, int iscapture,
     SDL_AudioSpec _obtained;
     SDL_AudioDevice *device;
     SDL_bool build_cvt;
+    int resampler_taps;
     void *handle = NULL;
     int i = 0;
 
@@ -1351,7 +1469,14 @@ open_audio_device(const char *devname, int iscapture,
         SDL_CalculateAudioSpec(obtained);
     }
 
-    if (build_cvt) {
+    if (build_cvt && (obtained->freq != device->spec.freq) && !iscapture &&
+        !current_audio.impl.ProvidesOwnCallbackThread &&
+        (resampler_taps = get_resampler_taps()) > 0) {
+        if (prepare_audio_resampler(device, obtained, resampler_taps) < 0) {
+            close_audio_device(device);
+            return 0;
+        }
+    } else if (build_cvt) {
         /* Build an audio conversion block */
         if (SDL_BuildAudioCVT(&device->convert,
                               obtained->format, obtained->channels,
@@ -1379,7 +1504,7 @@ open_audio_device(const char *devname, int iscapture,
     if (device->spec.callback == NULL) {  /* use buffer queueing? */
         /* pool a few packets to start. Enough for two callbacks. */
         const int packetlen = SDL_AUDIOBUFFERQUEUE_PACKETLEN;
-        const int wantbytes = ((device->convert.needed) ? device->convert.len : device->spec.size) * 2;
+        const int wantbytes = ((device->resampler) ? device->callback_len : (device->convert.needed) ? device->convert.len : device->spec.size) * 2;
         const int wantpackets = (wantbytes / packetlen) + ((wantbytes % packetlen) ? packetlen : 0);
         for (i = 0; i < wantpackets; i++) {
             SDL_AudioBufferQueue *packet = (SDL_AudioBufferQueue *) SDL_malloc(sizeof (SDL_AudioBufferQueue));
@@ -49,4 +49,36 @@ typedef struct
 } SDL_AudioRateFilters;
 extern const SDL_AudioRateFilters sdl_audio_rate_filters[];
 
+/* Streaming resampler for opened devices, working on interleaved float
+   frames. Put takes up to (frames) frames and returns how many fit; at most
+   max_frames more always fit once Get has returned less than asked for. */
+typedef struct SDL_AudioResampler SDL_AudioResampler;
+extern SDL_AudioResampler *SDL_NewAudioResampler(int channels, int src_rate,
+                                                 int dst_rate, int taps,
+                                                 int max_frames);
+extern void SDL_ResetAudioResampler(SDL_AudioResampler * r);
+extern void SDL_FreeAudioResampler(SDL_AudioResampler * r);
+extern int SDL_PutAudioResampler(SDL_AudioResampler * r, const float *in, int frames);
+extern int SDL_GetAudioResampler(SDL_AudioResampler * r, float *out, int frames);
+
+/* Vector paths for the native-endian S16/S32/F32 formats.  SSE2 and AVX2 are
+   picked at runtime through SDL_cpuinfo; NEON is used when the compiler
+   targets it. */
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#if defined(__SSE2__)
+#define HAVE_SSE2_AUDIO 1
+#include <emmintrin.h>
+#if defined(__clang__) || \
+    (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define HAVE_AVX2_AUDIO 1
+#define SDL_TARGETING_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAVE_NEON_AUDIO 1
+#include <arm_neon.h>
+#endif
+#endif
+
 /* vi: set ts=4 sw=4 expandtab: */
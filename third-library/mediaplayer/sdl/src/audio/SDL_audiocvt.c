@@ -26,6 +26,7 @@
 #include "SDL_audio_c.h"
 
 #include "SDL_assert.h"
+#include "SDL_cpuinfo.h"
 
 /* #define DEBUG_CONVERT */
 
@@ -834,6 +835,545 @@ SDL_ConvertAudio(SDL_AudioCVT * cvt)
 }
 
 
+/*
+ * Vectorized converters for the native-endian S16/S32/F32 formats.  They give
+ *  the same samples as the autogenerated scalar ones; float input outside
+ *  [-1.0, 1.0] is clamped instead of being left to an undefined cast.
+ *  Conversions that grow the buffer run from its end, like the scalar ones.
+ */
+#define DIVBY32767 3.05185094759972e-05f
+#define DIVBY2147483647 4.6566128752458e-10f
+
+static SDL_INLINE Sint16
+SDL_F32ToS16(const float sample)
+{
+    const float val = sample * 32767.0f;
+    if (val >= 32767.0f) {
+        return 32767;
+    } else if (val <= -32768.0f) {
+        return -32768;
+    }
+    return (Sint16) val;
+}
+
+static SDL_INLINE Sint32
+SDL_F32ToS32(const float sample)
+{
+    const double val = sample * 2147483647.0;
+    if (val >= 2147483647.0) {
+        return 2147483647;
+    } else if (val <= -2147483648.0) {
+        return (-2147483647 - 1);
+    }
+    return (Sint32) val;
+}
+
+/* Finish a vectorized filter: record the new length and run the next one. */
+static void
+SDL_NextAudioFilter(SDL_AudioCVT * cvt, int len_cvt, SDL_AudioFormat format)
+{
+    cvt->len_cvt = len_cvt;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+#if HAVE_SSE2_AUDIO
+static void SDLCALL
+SDL_Convert_S16_to_F32_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby32767 = _mm_set1_ps(DIVBY32767);
+    int i = cvt->len_cvt / sizeof (Sint16);
+    const int len_cvt = i * sizeof (float);
+
+    while (i & 7) {
+        --i;
+        dst[i] = ((float) src[i]) * DIVBY32767;
+    }
+    while (i) {
+        __m128i ints;
+        i -= 8;
+        ints = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(ints, ints), 16)), divby32767));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(ints, ints), 16)), divby32767));
+    }
+    SDL_NextAudioFilter(cvt, len_cvt, AUDIO_F32SYS);
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_S16_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m128 mul = _mm_set1_ps(32767.0f);
+    const __m128 minval = _mm_set1_ps(-32768.0f);
+    const __m128 maxval = _mm_set1_ps(32767.0f);
+    const int n = cvt->len_cvt / sizeof (float);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const __m128 lo = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), mul), minval), maxval);
+        const __m128 hi = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), mul), minval), maxval);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi)));
+    }
+    for (; i < n; i++) {
+        dst[i] = SDL_F32ToS16(src[i]);
+    }
+    SDL_NextAudioFilter(cvt, n * sizeof (Sint16), AUDIO_S16SYS);
+}
+
+static void SDLCALL
+SDL_Convert_S32_to_F32_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby2147483647 = _mm_set1_ps(DIVBY2147483647);
+    const int n = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        const __m128i ints = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(ints), divby2147483647));
+    }
+    for (; i < n; i++) {
+        dst[i] = ((float) src[i]) * DIVBY2147483647;
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt, AUDIO_F32SYS);
+}
+
+/* the scalar converter scales in double precision, so this one does too */
+static void SDLCALL
+SDL_Convert_F32_to_S32_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m128d mul = _mm_set1_pd(2147483647.0);
+    const __m128d minval = _mm_set1_pd(-2147483648.0);
+    const __m128d maxval = _mm_set1_pd(2147483647.0);
+    const int n = cvt->len_cvt / sizeof (float);
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        const __m128 floats = _mm_loadu_ps(src + i);
+        const __m128d lo = _mm_min_pd(_mm_max_pd(_mm_mul_pd(_mm_cvtps_pd(floats), mul), minval), maxval);
+        const __m128d hi = _mm_min_pd(_mm_max_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(floats, floats)), mul), minval), maxval);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi)));
+    }
+    for (; i < n; i++) {
+        dst[i] = SDL_F32ToS32(src[i]);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt, AUDIO_S32SYS);
+}
+
+static void SDLCALL
+SDL_Convert_S16_to_S32_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m128i zero = _mm_setzero_si128();
+    int i = cvt->len_cvt / sizeof (Sint16);
+    const int len_cvt = i * sizeof (Sint32);
+
+    while (i & 7) {
+        --i;
+        dst[i] = ((Sint32) src[i]) << 16;
+    }
+    while (i) {
+        __m128i ints;
+        i -= 8;
+        ints = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i + 4), _mm_unpackhi_epi16(zero, ints));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi16(zero, ints));
+    }
+    SDL_NextAudioFilter(cvt, len_cvt, AUDIO_S32SYS);
+}
+
+static void SDLCALL
+SDL_Convert_S32_to_S16_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const int n = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const __m128i lo = _mm_srai_epi32(_mm_loadu_si128((const __m128i *) (src + i)), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_loadu_si128((const __m128i *) (src + i + 4)), 16);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packs_epi32(lo, hi));
+    }
+    for (; i < n; i++) {
+        dst[i] = (Sint16) (src[i] >> 16);
+    }
+    SDL_NextAudioFilter(cvt, n * sizeof (Sint16), AUDIO_S16SYS);
+}
+
+/* (left + right) / 2, rounded toward zero like the scalar version */
+static void SDLCALL
+SDL_ConvertMono_S16_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m128i ones = _mm_set1_epi16(1);
+    const int n = cvt->len_cvt / (sizeof (Sint16) * 2);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m128i lo = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (src + i * 2)), ones);
+        __m128i hi = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (src + i * 2 + 8)), ones);
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_srli_epi32(lo, 31)), 1);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, _mm_srli_epi32(hi, 31)), 1);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packs_epi32(lo, hi));
+    }
+    for (; i < n; i++) {
+        dst[i] = (Sint16) ((src[i * 2] + src[i * 2 + 1]) / 2);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt / 2, format);
+}
+
+static void SDLCALL
+SDL_ConvertMono_F32_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128d half = _mm_set1_pd(0.5);
+    const int n = cvt->len_cvt / (sizeof (float) * 2);
+    int i;
+
+    for (i = 0; i + 2 <= n; i += 2) {
+        const __m128 frames = _mm_loadu_ps(src + i * 2);
+        const __m128d lo = _mm_cvtps_pd(frames);
+        const __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(frames, frames));
+        const __m128d sum = _mm_add_pd(_mm_unpacklo_pd(lo, hi), _mm_unpackhi_pd(lo, hi));
+        _mm_storel_pi((__m64 *) (dst + i), _mm_cvtpd_ps(_mm_mul_pd(sum, half)));
+    }
+    for (; i < n; i++) {
+        dst[i] = (float) ((((double) src[i * 2]) + ((double) src[i * 2 + 1])) * 0.5);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt / 2, format);
+}
+
+static void SDLCALL
+SDL_ConvertStereo_16_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (Uint16);
+
+    while (i & 7) {
+        --i;
+        dst[i * 2] = dst[i * 2 + 1] = src[i];
+    }
+    while (i) {
+        __m128i samples;
+        i -= 8;
+        samples = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i * 2 + 8), _mm_unpackhi_epi16(samples, samples));
+        _mm_storeu_si128((__m128i *) (dst + i * 2), _mm_unpacklo_epi16(samples, samples));
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt * 2, format);
+}
+
+static void SDLCALL
+SDL_ConvertStereo_32_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    Uint32 *dst = (Uint32 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (Uint32);
+
+    while (i & 3) {
+        --i;
+        dst[i * 2] = dst[i * 2 + 1] = src[i];
+    }
+    while (i) {
+        __m128i samples;
+        i -= 4;
+        samples = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i * 2 + 4), _mm_unpackhi_epi32(samples, samples));
+        _mm_storeu_si128((__m128i *) (dst + i * 2), _mm_unpacklo_epi32(samples, samples));
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt * 2, format);
+}
+#endif /* HAVE_SSE2_AUDIO */
+
+#if HAVE_AVX2_AUDIO
+static void SDLCALL SDL_TARGETING_AVX2
+SDL_Convert_S16_to_F32_AVX2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby32767 = _mm256_set1_ps(DIVBY32767);
+    int i = cvt->len_cvt / sizeof (Sint16);
+    const int len_cvt = i * sizeof (float);
+
+    while (i & 7) {
+        --i;
+        dst[i] = ((float) src[i]) * DIVBY32767;
+    }
+    while (i) {
+        __m256i ints;
+        i -= 8;
+        ints = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(ints), divby32767));
+    }
+    SDL_NextAudioFilter(cvt, len_cvt, AUDIO_F32SYS);
+}
+
+static void SDLCALL SDL_TARGETING_AVX2
+SDL_Convert_F32_to_S16_AVX2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m256 mul = _mm256_set1_ps(32767.0f);
+    const __m256 minval = _mm256_set1_ps(-32768.0f);
+    const __m256 maxval = _mm256_set1_ps(32767.0f);
+    const int n = cvt->len_cvt / sizeof (float);
+    int i;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        const __m256 lo = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), mul), minval), maxval);
+        const __m256 hi = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), mul), minval), maxval);
+        /* packs works per 128-bit lane; put the quarters back in order */
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(lo), _mm256_cvttps_epi32(hi));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    for (; i < n; i++) {
+        dst[i] = SDL_F32ToS16(src[i]);
+    }
+    SDL_NextAudioFilter(cvt, n * sizeof (Sint16), AUDIO_S16SYS);
+}
+
+static void SDLCALL SDL_TARGETING_AVX2
+SDL_Convert_S32_to_F32_AVX2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby2147483647 = _mm256_set1_ps(DIVBY2147483647);
+    const int n = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const __m256i ints = _mm256_loadu_si256((const __m256i *) (src + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(ints), divby2147483647));
+    }
+    for (; i < n; i++) {
+        dst[i] = ((float) src[i]) * DIVBY2147483647;
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt, AUDIO_F32SYS);
+}
+
+static void SDLCALL SDL_TARGETING_AVX2
+SDL_Convert_F32_to_S32_AVX2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m256d mul = _mm256_set1_pd(2147483647.0);
+    const __m256d minval = _mm256_set1_pd(-2147483648.0);
+    const __m256d maxval = _mm256_set1_pd(2147483647.0);
+    const int n = cvt->len_cvt / sizeof (float);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const __m256d lo = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(src + i)), mul), minval), maxval);
+        const __m256d hi = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)), mul), minval), maxval);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm256_cvttpd_epi32(lo));
+        _mm_storeu_si128((__m128i *) (dst + i + 4), _mm256_cvttpd_epi32(hi));
+    }
+    for (; i < n; i++) {
+        dst[i] = SDL_F32ToS32(src[i]);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt, AUDIO_S32SYS);
+}
+#endif /* HAVE_AVX2_AUDIO */
+
+#if HAVE_NEON_AUDIO
+static void SDLCALL
+SDL_Convert_S16_to_F32_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (Sint16);
+    const int len_cvt = i * sizeof (float);
+
+    while (i & 7) {
+        --i;
+        dst[i] = ((float) src[i]) * DIVBY32767;
+    }
+    while (i) {
+        int16x8_t ints;
+        i -= 8;
+        ints = vld1q_s16(src + i);
+        vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(ints))), DIVBY32767));
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(ints))), DIVBY32767));
+    }
+    SDL_NextAudioFilter(cvt, len_cvt, AUDIO_F32SYS);
+}
+
+/* vcvt and vqmovn saturate, so no explicit clamp is needed */
+static void SDLCALL
+SDL_Convert_F32_to_S16_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const int n = cvt->len_cvt / sizeof (float);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const int32x4_t lo = vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), 32767.0f));
+        const int32x4_t hi = vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 32767.0f));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+    for (; i < n; i++) {
+        dst[i] = SDL_F32ToS16(src[i]);
+    }
+    SDL_NextAudioFilter(cvt, n * sizeof (Sint16), AUDIO_S16SYS);
+}
+
+static void SDLCALL
+SDL_Convert_S32_to_F32_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const int n = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), DIVBY2147483647));
+    }
+    for (; i < n; i++) {
+        dst[i] = ((float) src[i]) * DIVBY2147483647;
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt, AUDIO_F32SYS);
+}
+
+#if defined(__aarch64__)
+static void SDLCALL
+SDL_Convert_F32_to_S32_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const int n = cvt->len_cvt / sizeof (float);
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        const float32x4_t floats = vld1q_f32(src + i);
+        const int64x2_t lo = vcvtq_s64_f64(vmulq_n_f64(vcvt_f64_f32(vget_low_f32(floats)), 2147483647.0));
+        const int64x2_t hi = vcvtq_s64_f64(vmulq_n_f64(vcvt_high_f64_f32(floats), 2147483647.0));
+        vst1q_s32(dst + i, vcombine_s32(vqmovn_s64(lo), vqmovn_s64(hi)));
+    }
+    for (; i < n; i++) {
+        dst[i] = SDL_F32ToS32(src[i]);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt, AUDIO_S32SYS);
+}
+#endif
+
+static void SDLCALL
+SDL_Convert_S16_to_S32_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (Sint16);
+    const int len_cvt = i * sizeof (Sint32);
+
+    while (i & 7) {
+        --i;
+        dst[i] = ((Sint32) src[i]) << 16;
+    }
+    while (i) {
+        int16x8_t ints;
+        i -= 8;
+        ints = vld1q_s16(src + i);
+        vst1q_s32(dst + i + 4, vshll_n_s16(vget_high_s16(ints), 16));
+        vst1q_s32(dst + i, vshll_n_s16(vget_low_s16(ints), 16));
+    }
+    SDL_NextAudioFilter(cvt, len_cvt, AUDIO_S32SYS);
+}
+
+static void SDLCALL
+SDL_Convert_S32_to_S16_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const int n = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const int16x4_t lo = vshrn_n_s32(vld1q_s32(src + i), 16);
+        const int16x4_t hi = vshrn_n_s32(vld1q_s32(src + i + 4), 16);
+        vst1q_s16(dst + i, vcombine_s16(lo, hi));
+    }
+    for (; i < n; i++) {
+        dst[i] = (Sint16) (src[i] >> 16);
+    }
+    SDL_NextAudioFilter(cvt, n * sizeof (Sint16), AUDIO_S16SYS);
+}
+
+static void SDLCALL
+SDL_ConvertMono_S16_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const int n = cvt->len_cvt / (sizeof (Sint16) * 2);
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const int16x8x2_t frames = vld2q_s16(src + i * 2);
+        int32x4_t lo = vaddl_s16(vget_low_s16(frames.val[0]), vget_low_s16(frames.val[1]));
+        int32x4_t hi = vaddl_s16(vget_high_s16(frames.val[0]), vget_high_s16(frames.val[1]));
+        lo = vshrq_n_s32(vaddq_s32(lo, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(lo), 31))), 1);
+        hi = vshrq_n_s32(vaddq_s32(hi, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(hi), 31))), 1);
+        vst1q_s16(dst + i, vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+    }
+    for (; i < n; i++) {
+        dst[i] = (Sint16) ((src[i * 2] + src[i * 2 + 1]) / 2);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt / 2, format);
+}
+
+static void SDLCALL
+SDL_ConvertStereo_16_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (Uint16);
+
+    while (i & 7) {
+        --i;
+        dst[i * 2] = dst[i * 2 + 1] = src[i];
+    }
+    while (i) {
+        uint16x8x2_t frames;
+        i -= 8;
+        frames.val[0] = frames.val[1] = vld1q_u16(src + i);
+        vst2q_u16(dst + i * 2, frames);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt * 2, format);
+}
+
+static void SDLCALL
+SDL_ConvertStereo_32_NEON(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    Uint32 *dst = (Uint32 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (Uint32);
+
+    while (i & 3) {
+        --i;
+        dst[i * 2] = dst[i * 2 + 1] = src[i];
+    }
+    while (i) {
+        uint32x4x2_t frames;
+        i -= 4;
+        frames.val[0] = frames.val[1] = vld1q_u32(src + i);
+        vst2q_u32(dst + i * 2, frames);
+    }
+    SDL_NextAudioFilter(cvt, cvt->len_cvt * 2, format);
+}
+#endif /* HAVE_NEON_AUDIO */
+
+
 static SDL_AudioFilter
 SDL_HandTunedTypeCVT(SDL_AudioFormat src_fmt, SDL_AudioFormat dst_fmt)
 {
@@ -841,11 +1381,89 @@ SDL_HandTunedTypeCVT(SDL_AudioFormat src_fmt, SDL_AudioFormat dst_fmt)
      * Fill in any future conversions that are specialized to a
      *  processor, platform, compiler, or library here.
      */
+#if HAVE_AVX2_AUDIO
+    if (SDL_HasAVX2()) {
+        if (src_fmt == AUDIO_S16SYS && dst_fmt == AUDIO_F32SYS) {
+            return SDL_Convert_S16_to_F32_AVX2;
+        } else if (src_fmt == AUDIO_F32SYS && dst_fmt == AUDIO_S16SYS) {
+            return SDL_Convert_F32_to_S16_AVX2;
+        } else if (src_fmt == AUDIO_S32SYS && dst_fmt == AUDIO_F32SYS) {
+            return SDL_Convert_S32_to_F32_AVX2;
+        } else if (src_fmt == AUDIO_F32SYS && dst_fmt == AUDIO_S32SYS) {
+            return SDL_Convert_F32_to_S32_AVX2;
+        }
+    }
+#endif
+#if HAVE_SSE2_AUDIO
+    if (SDL_HasSSE2()) {
+        if (src_fmt == AUDIO_S16SYS && dst_fmt == AUDIO_F32SYS) {
+            return SDL_Convert_S16_to_F32_SSE2;
+        } else if (src_fmt == AUDIO_F32SYS && dst_fmt == AUDIO_S16SYS) {
+            return SDL_Convert_F32_to_S16_SSE2;
+        } else if (src_fmt == AUDIO_S32SYS && dst_fmt == AUDIO_F32SYS) {
+            return SDL_Convert_S32_to_F32_SSE2;
+        } else if (src_fmt == AUDIO_F32SYS && dst_fmt == AUDIO_S32SYS) {
+            return SDL_Convert_F32_to_S32_SSE2;
+        } else if (src_fmt == AUDIO_S16SYS && dst_fmt == AUDIO_S32SYS) {
+            return SDL_Convert_S16_to_S32_SSE2;
+        } else if (src_fmt == AUDIO_S32SYS && dst_fmt == AUDIO_S16SYS) {
+            return SDL_Convert_S32_to_S16_SSE2;
+        }
+    }
+#endif
+#if HAVE_NEON_AUDIO
+    if (src_fmt == AUDIO_S16SYS && dst_fmt == AUDIO_F32SYS) {
+        return SDL_Convert_S16_to_F32_NEON;
+    } else if (src_fmt == AUDIO_F32SYS && dst_fmt == AUDIO_S16SYS) {
+        return SDL_Convert_F32_to_S16_NEON;
+    } else if (src_fmt == AUDIO_S32SYS && dst_fmt == AUDIO_F32SYS) {
+        return SDL_Convert_S32_to_F32_NEON;
+#if defined(__aarch64__)
+    } else if (src_fmt == AUDIO_F32SYS && dst_fmt == AUDIO_S32SYS) {
+        return SDL_Convert_F32_to_S32_NEON;
+#endif
+    } else if (src_fmt == AUDIO_S16SYS && dst_fmt == AUDIO_S32SYS) {
+        return SDL_Convert_S16_to_S32_NEON;
+    } else if (src_fmt == AUDIO_S32SYS && dst_fmt == AUDIO_S16SYS) {
+        return SDL_Convert_S32_to_S16_NEON;
+    }
+#endif
 
     return NULL;                /* no specialized converter code available. */
 }
 
 
+/* Same idea for the channel filters; (format) is the one they will see. */
+static SDL_AudioFilter
+SDL_HandTunedChannelCVT(SDL_AudioFilter filter, SDL_AudioFormat format)
+{
+#if HAVE_SSE2_AUDIO
+    if (SDL_HasSSE2()) {
+        if (filter == SDL_ConvertMono && format == AUDIO_S16SYS) {
+            return SDL_ConvertMono_S16_SSE2;
+        } else if (filter == SDL_ConvertMono && format == AUDIO_F32SYS) {
+            return SDL_ConvertMono_F32_SSE2;
+        } else if (filter == SDL_ConvertStereo && SDL_AUDIO_BITSIZE(format) == 16) {
+            return SDL_ConvertStereo_16_SSE2;
+        } else if (filter == SDL_ConvertStereo && SDL_AUDIO_BITSIZE(format) == 32) {
+            return SDL_ConvertStereo_32_SSE2;
+        }
+    }
+#endif
+#if HAVE_NEON_AUDIO
+    if (filter == SDL_ConvertMono && format == AUDIO_S16SYS) {
+        return SDL_ConvertMono_S16_NEON;
+    } else if (filter == SDL_ConvertStereo && SDL_AUDIO_BITSIZE(format) == 16) {
+        return SDL_ConvertStereo_16_NEON;
+    } else if (filter == SDL_ConvertStereo && SDL_AUDIO_BITSIZE(format) == 32) {
+        return SDL_ConvertStereo_32_NEON;
+    }
+#endif
+
+    return filter;
+}
+
+
 /*
  * Find a converter between two data types. We try to select a hand-tuned
  *  asm/vectorized/optimized function first, and then fallback to an
@@ -1051,7 +1669,8 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
     /* Channel conversion */
     if (src_channels != dst_channels) {
         if ((src_channels == 1) && (dst_channels > 1)) {
-            cvt->filters[cvt->filter_index++] = SDL_ConvertStereo;
+            cvt->filters[cvt->filter_index++] =
+                SDL_HandTunedChannelCVT(SDL_ConvertStereo, dst_fmt);
             cvt->len_mult *= 2;
             src_channels = 2;
             cvt->len_ratio *= 2;
@@ -1069,7 +1688,8 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
             cvt->len_ratio *= 2;
         }
         while ((src_channels * 2) <= dst_channels) {
-            cvt->filters[cvt->filter_index++] = SDL_ConvertStereo;
+            cvt->filters[cvt->filter_index++] =
+                SDL_HandTunedChannelCVT(SDL_ConvertStereo, dst_fmt);
             cvt->len_mult *= 2;
             src_channels *= 2;
             cvt->len_ratio *= 2;
@@ -1090,7 +1710,8 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
          */
         while (((src_channels % 2) == 0) &&
                ((src_channels / 2) >= dst_channels)) {
-            cvt->filters[cvt->filter_index++] = SDL_ConvertMono;
+            cvt->filters[cvt->filter_index++] =
+                SDL_HandTunedChannelCVT(SDL_ConvertMono, dst_fmt);
             src_channels /= 2;
             cvt->len_ratio /= 2;
         }
@@ -1118,4 +1739,252 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
 }
 
 
+
+/*
+ * Streaming polyphase resampler for opened devices.
+ *
+ * The filters above are stateless and rebuilt for every buffer, so they can
+ *  only do power-of-two steps and click at buffer edges. This one keeps a
+ *  history of planar float input between calls and computes each output
+ *  frame as a dot product of (taps) input frames with one row of a
+ *  Kaiser-windowed sinc table built when the device is opened. The rate
+ *  ratio is reduced to out_step/in_step; with at most
+ *  SDL_RESAMPLER_MAX_PHASES output phases the table has a row for every one
+ *  of them, otherwise the two nearest rows are interpolated.
+ */
+#define SDL_RESAMPLER_MAX_PHASES 512
+
+struct SDL_AudioResampler
+{
+    int channels;
+    int taps;                   /* filter length, a multiple of 4 */
+    int in_step;                /* src_rate / gcd(src_rate, dst_rate) */
+    int out_step;               /* dst_rate / gcd(src_rate, dst_rate) */
+    int phases;                 /* rows in (filter), less the guard row */
+    float *filter;              /* (phases + 1) rows of (taps) coefficients */
+    float *row;                 /* interpolated row, when phases < out_step */
+    float *fifo;                /* (channels) planes of (capacity) frames */
+    int capacity;
+    int fill;                   /* frames held in each plane */
+    int pos;                    /* first input frame of the next output */
+    int phase;                  /* position of the next output past (pos),
+                                   in 1/out_step input frames */
+};
+
+/* Zeroth order modified Bessel function of the first kind, for the window. */
+static double
+SDL_BesselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    int k;
+
+    for (k = 1; k < 50 && term > sum * 1e-12; k++) {
+        const double t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+static int
+SDL_GreatestCommonDivisor(int a, int b)
+{
+    while (b != 0) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+SDL_AudioResampler *
+SDL_NewAudioResampler(int channels, int src_rate, int dst_rate, int taps,
+                      int max_frames)
+{
+    const int gcd = SDL_GreatestCommonDivisor(src_rate, dst_rate);
+    const double half = taps / 2;
+    /* cut off a little below the lower of the two Nyquist rates */
+    const double cutoff = 0.97 * SDL_min(1.0, ((double) dst_rate) / src_rate);
+    const double beta = (taps >= 32) ? 9.0 : 6.5;
+    const double i0_beta = SDL_BesselI0(beta);
+    SDL_AudioResampler *r;
+    int p, k;
+
+    SDL_assert(channels > 0);
+    SDL_assert(src_rate > 0 && dst_rate > 0);
+    SDL_assert(taps >= 4 && (taps % 4) == 0);
+
+    r = (SDL_AudioResampler *) SDL_calloc(1, sizeof (SDL_AudioResampler));
+    if (r == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    r->channels = channels;
+    r->taps = taps;
+    r->in_step = src_rate / gcd;
+    r->out_step = dst_rate / gcd;
+    r->phases = SDL_min(r->out_step, SDL_RESAMPLER_MAX_PHASES);
+    r->capacity = taps + max_frames;
+    r->filter = (float *) SDL_malloc((r->phases + 1) * taps * sizeof (float));
+    r->row = (float *) SDL_malloc(taps * sizeof (float));
+    r->fifo = (float *) SDL_malloc(channels * r->capacity * sizeof (float));
+    if (!r->filter || !r->row || !r->fifo) {
+        SDL_FreeAudioResampler(r);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Row (p) filters the input (p / phases) of a frame past the tap at
+       half - 1; the extra last row is the first one shifted a frame along,
+       so interpolation never has to wrap. */
+    for (p = 0; p <= r->phases; p++) {
+        float *row = r->filter + p * taps;
+        double sum = 0.0;
+
+        for (k = 0; k < taps; k++) {
+            const double x = k - (half - 1) - ((double) p) / r->phases;
+            const double w = x / half;
+            double h = cutoff;
+            if (x != 0.0) {
+                h = SDL_sin(M_PI * cutoff * x) / (M_PI * x);
+            }
+            h *= (w * w < 1.0) ? SDL_BesselI0(beta * SDL_sqrt(1.0 - w * w)) / i0_beta : 0.0;
+            row[k] = (float) h;
+            sum += h;
+        }
+        /* unity gain at DC for every phase */
+        for (k = 0; k < taps; k++) {
+            row[k] = (float) (row[k] / sum);
+        }
+    }
+
+    SDL_ResetAudioResampler(r);
+    return r;
+}
+
+void
+SDL_ResetAudioResampler(SDL_AudioResampler * r)
+{
+    /* start with half a filter of silence, so the first output frame lines
+       up with the first input frame */
+    r->fill = r->taps / 2 - 1;
+    r->pos = 0;
+    r->phase = 0;
+    SDL_memset(r->fifo, '\0', r->channels * r->capacity * sizeof (float));
+}
+
+void
+SDL_FreeAudioResampler(SDL_AudioResampler * r)
+{
+    if (r) {
+        SDL_free(r->filter);
+        SDL_free(r->row);
+        SDL_free(r->fifo);
+        SDL_free(r);
+    }
+}
+
+int
+SDL_PutAudioResampler(SDL_AudioResampler * r, const float *in, int frames)
+{
+    const int channels = r->channels;
+    int c, i;
+
+    /* drop what has been consumed when the new frames wouldn't fit */
+    if (r->fill + frames > r->capacity && r->pos > 0) {
+        for (c = 0; c < channels; c++) {
+            float *plane = r->fifo + c * r->capacity;
+            SDL_memmove(plane, plane + r->pos, (r->fill - r->pos) * sizeof (float));
+        }
+        r->fill -= r->pos;
+        r->pos = 0;
+    }
+
+    frames = SDL_min(frames, r->capacity - r->fill);
+    for (c = 0; c < channels; c++) {
+        float *dst = r->fifo + c * r->capacity + r->fill;
+        const float *src = in + c;
+        for (i = 0; i < frames; i++, src += channels) {
+            dst[i] = *src;
+        }
+    }
+    r->fill += frames;
+    return frames;
+}
+
+static SDL_INLINE float
+SDL_ResampleDot(const float *x, const float *h, int taps)
+{
+    int k;
+#if HAVE_SSE2_AUDIO
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (k = 0; k + 8 <= taps; k += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(h + k)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + k + 4), _mm_loadu_ps(h + k + 4)));
+    }
+    if (k < taps) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(h + k)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+    acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+    return _mm_cvtss_f32(acc0);
+#elif HAVE_NEON_AUDIO
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    float32x2_t sum;
+    for (k = 0; k < taps; k += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(x + k), vld1q_f32(h + k));
+    }
+    sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+    float acc = 0.0f;
+    for (k = 0; k < taps; k++) {
+        acc += x[k] * h[k];
+    }
+    return acc;
+#endif
+}
+
+int
+SDL_GetAudioResampler(SDL_AudioResampler * r, float *out, int frames)
+{
+    const int channels = r->channels;
+    const int taps = r->taps;
+    int done = 0;
+    int c, k;
+
+    while (done < frames && r->pos + taps <= r->fill) {
+        const float *row;
+
+        if (r->phases == r->out_step) {
+            row = r->filter + r->phase * taps;
+        } else {
+            const double where = ((double) r->phase) * r->phases / r->out_step;
+            const int p = (int) where;
+            const float t = (float) (where - p);
+            const float *a = r->filter + p * taps;
+            const float *b = a + taps;
+            for (k = 0; k < taps; k++) {
+                r->row[k] = a[k] + (b[k] - a[k]) * t;
+            }
+            row = r->row;
+        }
+
+        for (c = 0; c < channels; c++) {
+            *(out++) = SDL_ResampleDot(r->fifo + c * r->capacity + r->pos, row, taps);
+        }
+        done++;
+
+        r->phase += r->in_step;
+        r->pos += r->phase / r->out_step;
+        r->phase %= r->out_step;
+    }
+
+    return done;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -26,6 +26,7 @@
 #include "SDL_timer.h"
 #include "SDL_audio.h"
 #include "SDL_sysaudio.h"
+#include "SDL_audio_c.h"
 
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
@@ -86,6 +87,209 @@ static const Uint8 mix8[] = {
 #define ADJUST_VOLUME_U8(s, v)  (s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
 
+/*
+ * Vectorized mixers for native-endian S16/S32/F32.  Each one mixes a whole
+ *  number of vectors and returns how many samples it did; the scalar loops
+ *  below finish the rest, and give identical results.  Volumes above
+ *  SDL_MIX_MAXVOLUME wrap in the scalar S16 path, so they are left to it.
+ */
+#if HAVE_SSE2_AUDIO
+static Uint32
+SDL_MixAudio_S16_SSE2(Sint16 * dst, const Sint16 * src, Uint32 len, int volume)
+{
+    const __m128i vol = _mm_set1_epi16((Sint16) volume);
+    Uint32 i;
+
+    for (i = 0; i + 8 <= len; i += 8) {
+        const __m128i samples = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i prodlo = _mm_mullo_epi16(samples, vol);
+        const __m128i prodhi = _mm_mulhi_epi16(samples, vol);
+        __m128i lo = _mm_unpacklo_epi16(prodlo, prodhi);
+        __m128i hi = _mm_unpackhi_epi16(prodlo, prodhi);
+        /* divide by 128, rounding toward zero */
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_srli_epi32(_mm_srai_epi32(lo, 31), 25)), 7);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, _mm_srli_epi32(_mm_srai_epi32(hi, 31), 25)), 7);
+        _mm_storeu_si128((__m128i *) (dst + i),
+                         _mm_adds_epi16(_mm_packs_epi32(lo, hi),
+                                        _mm_loadu_si128((const __m128i *) (dst + i))));
+    }
+    return i;
+}
+
+/* doubles hold the 64-bit intermediates of the scalar path exactly */
+static Uint32
+SDL_MixAudio_S32_SSE2(Sint32 * dst, const Sint32 * src, Uint32 len, int volume)
+{
+    const __m128d scale = _mm_set1_pd(((double) volume) / SDL_MIX_MAXVOLUME);
+    const __m128d minval = _mm_set1_pd(-2147483648.0);
+    const __m128d maxval = _mm_set1_pd(2147483647.0);
+    Uint32 i;
+
+    for (i = 0; i + 4 <= len; i += 4) {
+        const __m128i samples = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i mixed = _mm_loadu_si128((const __m128i *) (dst + i));
+        const __m128i scaledlo = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(samples), scale));
+        const __m128i scaledhi = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(samples, 8)), scale));
+        __m128d lo = _mm_add_pd(_mm_cvtepi32_pd(scaledlo), _mm_cvtepi32_pd(mixed));
+        __m128d hi = _mm_add_pd(_mm_cvtepi32_pd(scaledhi), _mm_cvtepi32_pd(_mm_srli_si128(mixed, 8)));
+        lo = _mm_min_pd(_mm_max_pd(lo, minval), maxval);
+        hi = _mm_min_pd(_mm_max_pd(hi, minval), maxval);
+        _mm_storeu_si128((__m128i *) (dst + i),
+                         _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi)));
+    }
+    return i;
+}
+
+/* min/max take their second operand on NaN, which lets NaN through as the
+   scalar comparisons do */
+static Uint32
+SDL_MixAudio_F32_SSE2(float * dst, const float * src, Uint32 len, int volume)
+{
+    const __m128 fvolume = _mm_set1_ps((float) volume);
+    const __m128 fmaxvolume = _mm_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m128 minval = _mm_set1_ps(-3.402823466e+38F);
+    const __m128 maxval = _mm_set1_ps(3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; i + 4 <= len; i += 4) {
+        const __m128 samples = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src + i), fvolume), fmaxvolume);
+        const __m128 mixed = _mm_add_ps(samples, _mm_loadu_ps(dst + i));
+        _mm_storeu_ps(dst + i, _mm_max_ps(minval, _mm_min_ps(maxval, mixed)));
+    }
+    return i;
+}
+#endif /* HAVE_SSE2_AUDIO */
+
+#if HAVE_AVX2_AUDIO
+static Uint32 SDL_TARGETING_AVX2
+SDL_MixAudio_S16_AVX2(Sint16 * dst, const Sint16 * src, Uint32 len, int volume)
+{
+    const __m256i vol = _mm256_set1_epi16((Sint16) volume);
+    Uint32 i;
+
+    for (i = 0; i + 16 <= len; i += 16) {
+        const __m256i samples = _mm256_loadu_si256((const __m256i *) (src + i));
+        const __m256i prodlo = _mm256_mullo_epi16(samples, vol);
+        const __m256i prodhi = _mm256_mulhi_epi16(samples, vol);
+        __m256i lo = _mm256_unpacklo_epi16(prodlo, prodhi);
+        __m256i hi = _mm256_unpackhi_epi16(prodlo, prodhi);
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, _mm256_srli_epi32(_mm256_srai_epi32(lo, 31), 25)), 7);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, _mm256_srli_epi32(_mm256_srai_epi32(hi, 31), 25)), 7);
+        /* unpack and pack are both per 128-bit lane, so the order survives */
+        _mm256_storeu_si256((__m256i *) (dst + i),
+                            _mm256_adds_epi16(_mm256_packs_epi32(lo, hi),
+                                              _mm256_loadu_si256((const __m256i *) (dst + i))));
+    }
+    return i;
+}
+
+static Uint32 SDL_TARGETING_AVX2
+SDL_MixAudio_F32_AVX2(float * dst, const float * src, Uint32 len, int volume)
+{
+    const __m256 fvolume = _mm256_set1_ps((float) volume);
+    const __m256 fmaxvolume = _mm256_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m256 minval = _mm256_set1_ps(-3.402823466e+38F);
+    const __m256 maxval = _mm256_set1_ps(3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; i + 8 <= len; i += 8) {
+        const __m256 samples = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), fvolume), fmaxvolume);
+        const __m256 mixed = _mm256_add_ps(samples, _mm256_loadu_ps(dst + i));
+        _mm256_storeu_ps(dst + i, _mm256_max_ps(minval, _mm256_min_ps(maxval, mixed)));
+    }
+    return i;
+}
+#endif /* HAVE_AVX2_AUDIO */
+
+#if HAVE_NEON_AUDIO
+static Uint32
+SDL_MixAudio_S16_NEON(Sint16 * dst, const Sint16 * src, Uint32 len, int volume)
+{
+    const int16x4_t vol = vdup_n_s16((Sint16) volume);
+    Uint32 i;
+
+    for (i = 0; i + 8 <= len; i += 8) {
+        const int16x8_t samples = vld1q_s16(src + i);
+        int32x4_t lo = vmull_s16(vget_low_s16(samples), vol);
+        int32x4_t hi = vmull_s16(vget_high_s16(samples), vol);
+        lo = vshrq_n_s32(vaddq_s32(lo, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(lo, 31)), 25))), 7);
+        hi = vshrq_n_s32(vaddq_s32(hi, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(hi, 31)), 25))), 7);
+        vst1q_s16(dst + i, vqaddq_s16(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)), vld1q_s16(dst + i)));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_F32_NEON(float * dst, const float * src, Uint32 len, int volume)
+{
+    const float fvolume = (float) volume;
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    const float32x4_t minval = vdupq_n_f32(-3.402823466e+38F);
+    const float32x4_t maxval = vdupq_n_f32(3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; i + 4 <= len; i += 4) {
+        const float32x4_t samples = vmulq_n_f32(vmulq_n_f32(vld1q_f32(src + i), fvolume), fmaxvolume);
+        const float32x4_t mixed = vaddq_f32(samples, vld1q_f32(dst + i));
+        vst1q_f32(dst + i, vmaxq_f32(minval, vminq_f32(maxval, mixed)));
+    }
+    return i;
+}
+#endif /* HAVE_NEON_AUDIO */
+
+static Uint32
+SDL_MixAudio_S16_Vector(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    if (volume > SDL_MIX_MAXVOLUME) {
+        return 0;
+    }
+#if HAVE_AVX2_AUDIO
+    if (SDL_HasAVX2()) {
+        return SDL_MixAudio_S16_AVX2((Sint16 *) dst, (const Sint16 *) src, len, volume);
+    }
+#endif
+#if HAVE_SSE2_AUDIO
+    if (SDL_HasSSE2()) {
+        return SDL_MixAudio_S16_SSE2((Sint16 *) dst, (const Sint16 *) src, len, volume);
+    }
+#endif
+#if HAVE_NEON_AUDIO
+    return SDL_MixAudio_S16_NEON((Sint16 *) dst, (const Sint16 *) src, len, volume);
+#endif
+    return 0;
+}
+
+static Uint32
+SDL_MixAudio_S32_Vector(Uint32 * dst, const Uint32 * src, Uint32 len, int volume)
+{
+#if HAVE_SSE2_AUDIO
+    if (volume <= SDL_MIX_MAXVOLUME && SDL_HasSSE2()) {
+        return SDL_MixAudio_S32_SSE2((Sint32 *) dst, (const Sint32 *) src, len, volume);
+    }
+#endif
+    return 0;
+}
+
+static Uint32
+SDL_MixAudio_F32_Vector(float * dst, const float * src, Uint32 len, int volume)
+{
+#if HAVE_AVX2_AUDIO
+    if (SDL_HasAVX2()) {
+        return SDL_MixAudio_F32_AVX2(dst, src, len, volume);
+    }
+#endif
+#if HAVE_SSE2_AUDIO
+    if (SDL_HasSSE2()) {
+        return SDL_MixAudio_F32_SSE2(dst, src, len, volume);
+    }
+#endif
+#if HAVE_NEON_AUDIO
+    return SDL_MixAudio_F32_NEON(dst, src, len, volume);
+#endif
+    return 0;
+}
+
+
 void
 SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
                    Uint32 len, int volume)
@@ -149,8 +353,13 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
             int dst_sample;
             const int max_audioval = ((1 << (16 - 1)) - 1);
             const int min_audioval = -(1 << (16 - 1));
+            Uint32 done;
 
             len /= 2;
+            done = SDL_MixAudio_S16_Vector(dst, src, len, volume);
+            src += done * 2;
+            dst += done * 2;
+            len -= done;
             while (len--) {
                 src1 = ((src[1]) << 8 | src[0]);
                 ADJUST_VOLUME(src1, volume);
@@ -258,8 +467,13 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
             Sint64 dst_sample;
             const Sint64 max_audioval = ((((Sint64) 1) << (32 - 1)) - 1);
             const Sint64 min_audioval = -(((Sint64) 1) << (32 - 1));
+            Uint32 done;
 
             len /= 4;
+            done = SDL_MixAudio_S32_Vector(dst32, src32, len, volume);
+            src32 += done;
+            dst32 += done;
+            len -= done;
             while (len--) {
                 src1 = (Sint64) ((Sint32) SDL_SwapLE32(*src32));
                 src32++;
@@ -313,8 +527,13 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
             /* !!! FIXME: are these right? */
             const double max_audioval = 3.402823466e+38F;
             const double min_audioval = -3.402823466e+38F;
+            Uint32 done;
 
             len /= 4;
+            done = SDL_MixAudio_F32_Vector(dst32, src32, len, volume);
+            src32 += done;
+            dst32 += done;
+            len -= done;
             while (len--) {
                 src1 = ((SDL_SwapFloatLE(*src32) * fvolume) * fmaxvolume);
                 src2 = SDL_SwapFloatLE(*dst32);
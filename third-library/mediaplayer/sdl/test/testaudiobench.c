@@ -0,0 +1,505 @@
+/*
+  Copyright (C) 1997-2016 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Times the format conversions, channel conversions and mixing on the audio
+   callback path, in samples per second, against plain C loops that do what
+   the portable converters do.  Every result is also checked against those
+   loops, so a vector path that drifts shows up as a MISMATCH.  Float output
+   is allowed a few units in the last place, as the scalar tails may have
+   been built for the x87 FPU.
+
+   The rate converter is timed through an opened device.  A device opened at
+   96 kHz with SDL_AUDIO_ALLOW_FREQUENCY_CHANGE reports the rate the driver
+   runs at; the Android driver, for one, stops at 48 kHz.  The callback then
+   plays a 1 kHz tone at each of 44.1, 48 and 96 kHz that differs from that
+   rate, once per SDL_HINT_AUDIO_RESAMPLING_MODE, and the process CPU time
+   per second of audio is reported.  Drivers that take any rate, like disk
+   and dummy, never convert, so these rows are skipped there.  Pick the
+   driver with SDL_AUDIODRIVER.
+
+   testaudiobench [--frames n] [--iterations n]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SDL.h"
+
+typedef void (*ReferenceFunc) (void *dst, const void *src, int samples, int volume);
+
+typedef struct
+{
+    const char *name;
+    SDL_AudioFormat src_format;
+    int src_channels;
+    SDL_AudioFormat dst_format;
+    int dst_channels;
+    ReferenceFunc reference;
+} BenchCase;
+
+static void
+ref_s16_to_f32(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((float *) dst)[i] = ((float) ((const Sint16 *) src)[i]) * 3.05185094759972e-05f;
+    }
+}
+
+static void
+ref_f32_to_s16(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((Sint16 *) dst)[i] = (Sint16) (((const float *) src)[i] * 32767.0f);
+    }
+}
+
+static void
+ref_s32_to_f32(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((float *) dst)[i] = ((float) ((const Sint32 *) src)[i]) * 4.6566128752458e-10f;
+    }
+}
+
+static void
+ref_f32_to_s32(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((Sint32 *) dst)[i] = (Sint32) (((const float *) src)[i] * 2147483647.0);
+    }
+}
+
+static void
+ref_s16_to_s32(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((Sint32 *) dst)[i] = ((Sint32) ((const Sint16 *) src)[i]) << 16;
+    }
+}
+
+static void
+ref_s32_to_s16(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((Sint16 *) dst)[i] = (Sint16) (((const Sint32 *) src)[i] >> 16);
+    }
+}
+
+static void
+ref_mono_s16(void *dst, const void *src, int samples, int volume)
+{
+    const Sint16 *in = (const Sint16 *) src;
+    int i;
+    for (i = 0; i < samples / 2; i++) {
+        ((Sint16 *) dst)[i] = (Sint16) ((in[i * 2] + in[i * 2 + 1]) / 2);
+    }
+}
+
+static void
+ref_mono_f32(void *dst, const void *src, int samples, int volume)
+{
+    const float *in = (const float *) src;
+    int i;
+    for (i = 0; i < samples / 2; i++) {
+        ((float *) dst)[i] = (float) ((((double) in[i * 2]) + ((double) in[i * 2 + 1])) * 0.5);
+    }
+}
+
+static void
+ref_stereo_s16(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((Sint16 *) dst)[i * 2] = ((Sint16 *) dst)[i * 2 + 1] = ((const Sint16 *) src)[i];
+    }
+}
+
+static void
+ref_stereo_f32(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        ((float *) dst)[i * 2] = ((float *) dst)[i * 2 + 1] = ((const float *) src)[i];
+    }
+}
+
+static void
+ref_mix_s16(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        int sample = ((const Sint16 *) src)[i] * volume / SDL_MIX_MAXVOLUME + ((Sint16 *) dst)[i];
+        ((Sint16 *) dst)[i] = (Sint16) SDL_max(-32768, SDL_min(sample, 32767));
+    }
+}
+
+static void
+ref_mix_s32(void *dst, const void *src, int samples, int volume)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        Sint64 sample = ((Sint64) ((const Sint32 *) src)[i]) * volume / SDL_MIX_MAXVOLUME + ((Sint32 *) dst)[i];
+        ((Sint32 *) dst)[i] = (Sint32) SDL_max(-2147483647 - 1, SDL_min(sample, 2147483647));
+    }
+}
+
+static void
+ref_mix_f32(void *dst, const void *src, int samples, int volume)
+{
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    int i;
+    for (i = 0; i < samples; i++) {
+        const float sample = (((const float *) src)[i] * (float) volume) * fmaxvolume;
+        double mixed = ((double) sample) + ((double) ((float *) dst)[i]);
+        mixed = SDL_max(-3.402823466e+38F, SDL_min(mixed, 3.402823466e+38F));
+        ((float *) dst)[i] = (float) mixed;
+    }
+}
+
+static const BenchCase convert_cases[] = {
+    { "S16 -> F32", AUDIO_S16SYS, 2, AUDIO_F32SYS, 2, ref_s16_to_f32 },
+    { "F32 -> S16", AUDIO_F32SYS, 2, AUDIO_S16SYS, 2, ref_f32_to_s16 },
+    { "S32 -> F32", AUDIO_S32SYS, 2, AUDIO_F32SYS, 2, ref_s32_to_f32 },
+    { "F32 -> S32", AUDIO_F32SYS, 2, AUDIO_S32SYS, 2, ref_f32_to_s32 },
+    { "S16 -> S32", AUDIO_S16SYS, 2, AUDIO_S32SYS, 2, ref_s16_to_s32 },
+    { "S32 -> S16", AUDIO_S32SYS, 2, AUDIO_S16SYS, 2, ref_s32_to_s16 },
+    { "S16 stereo -> mono", AUDIO_S16SYS, 2, AUDIO_S16SYS, 1, ref_mono_s16 },
+    { "F32 stereo -> mono", AUDIO_F32SYS, 2, AUDIO_F32SYS, 1, ref_mono_f32 },
+    { "S16 mono -> stereo", AUDIO_S16SYS, 1, AUDIO_S16SYS, 2, ref_stereo_s16 },
+    { "F32 mono -> stereo", AUDIO_F32SYS, 1, AUDIO_F32SYS, 2, ref_stereo_f32 },
+};
+
+static const BenchCase mix_cases[] = {
+    { "mix S16", AUDIO_S16SYS, 2, AUDIO_S16SYS, 2, ref_mix_s16 },
+    { "mix S32", AUDIO_S32SYS, 2, AUDIO_S32SYS, 2, ref_mix_s32 },
+    { "mix F32", AUDIO_F32SYS, 2, AUDIO_F32SYS, 2, ref_mix_f32 },
+};
+
+/* full-scale noise, kept inside [-1.0, 1.0) for the float formats */
+static void
+fill_samples(void *buf, SDL_AudioFormat format, int samples)
+{
+    int i;
+    for (i = 0; i < samples; i++) {
+        const Sint32 noise = (Sint32) (((Uint32) rand() << 16) ^ (Uint32) rand());
+        switch (format) {
+        case AUDIO_S16SYS:
+            ((Sint16 *) buf)[i] = (Sint16) noise;
+            break;
+        case AUDIO_S32SYS:
+            ((Sint32 *) buf)[i] = noise;
+            break;
+        case AUDIO_F32SYS:
+            ((float *) buf)[i] = (float) (noise * (1.0 / 2147483648.0));
+            break;
+        }
+    }
+}
+
+static int
+same_samples(const void *a, const void *b, SDL_AudioFormat format, int len)
+{
+    int i;
+    if (format != AUDIO_F32SYS) {
+        return SDL_memcmp(a, b, len) == 0;
+    }
+    for (i = 0; i < len / (int) sizeof (float); i++) {
+        const float x = ((const float *) a)[i];
+        const float y = ((const float *) b)[i];
+        if (SDL_fabs(x - y) > 1.0 / 4194304.0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static double
+elapsed_seconds(Uint64 start)
+{
+    return (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+static void
+report(const char *name, double samples, double sdl_seconds, double ref_seconds, int match)
+{
+    SDL_Log("  %-20s %10.1f %10.1f %8.2fx  %s\n", name,
+            samples / sdl_seconds / 1e6, samples / ref_seconds / 1e6,
+            ref_seconds / sdl_seconds, match ? "ok" : "MISMATCH");
+}
+
+static int
+bench_convert(const BenchCase *bench, int frames, int iterations)
+{
+    const int src_samples = frames * bench->src_channels;
+    const int src_len = src_samples * SDL_AUDIO_BITSIZE(bench->src_format) / 8;
+    SDL_AudioCVT cvt;
+    Uint8 *src, *expected;
+    Uint64 start;
+    double sdl_seconds, ref_seconds;
+    int i, match;
+
+    if (SDL_BuildAudioCVT(&cvt, bench->src_format, bench->src_channels, 48000,
+                          bench->dst_format, bench->dst_channels, 48000) <= 0) {
+        SDL_Log("  %-20s no conversion: %s\n", bench->name, SDL_GetError());
+        return 0;
+    }
+    cvt.len = src_len;
+    cvt.buf = (Uint8 *) SDL_malloc(src_len * cvt.len_mult);
+    src = (Uint8 *) SDL_malloc(src_len);
+    expected = (Uint8 *) SDL_malloc(src_len * cvt.len_mult);
+    if (!cvt.buf || !src || !expected) {
+        SDL_Log("  %-20s out of memory\n", bench->name);
+        SDL_free(cvt.buf);
+        SDL_free(src);
+        SDL_free(expected);
+        return 0;
+    }
+    fill_samples(src, bench->src_format, src_samples);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; i++) {
+        SDL_memcpy(cvt.buf, src, src_len);
+        SDL_ConvertAudio(&cvt);
+    }
+    sdl_seconds = elapsed_seconds(start);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; i++) {
+        bench->reference(expected, src, src_samples, 0);
+    }
+    ref_seconds = elapsed_seconds(start);
+
+    match = same_samples(cvt.buf, expected, bench->dst_format, cvt.len_cvt);
+    report(bench->name, (double) src_samples * iterations, sdl_seconds, ref_seconds, match);
+
+    SDL_free(cvt.buf);
+    SDL_free(src);
+    SDL_free(expected);
+    return match;
+}
+
+static int
+bench_mix(const BenchCase *bench, int frames, int iterations)
+{
+    const int samples = frames * bench->src_channels;
+    const Uint32 len = samples * SDL_AUDIO_BITSIZE(bench->src_format) / 8;
+    const int volume = SDL_MIX_MAXVOLUME * 3 / 4;
+    Uint8 *src = (Uint8 *) SDL_malloc(len);
+    Uint8 *mixed = (Uint8 *) SDL_malloc(len);
+    Uint8 *expected = (Uint8 *) SDL_malloc(len);
+    Uint64 start;
+    double sdl_seconds, ref_seconds;
+    int i, match;
+
+    if (!src || !mixed || !expected) {
+        SDL_Log("  %-20s out of memory\n", bench->name);
+        SDL_free(src);
+        SDL_free(mixed);
+        SDL_free(expected);
+        return 0;
+    }
+    fill_samples(src, bench->src_format, samples);
+    fill_samples(mixed, bench->src_format, samples);
+    SDL_memcpy(expected, mixed, len);
+
+    /* one pass for the check, before the buffers saturate */
+    SDL_MixAudioFormat(mixed, src, bench->src_format, len, volume);
+    bench->reference(expected, src, samples, volume);
+    match = same_samples(mixed, expected, bench->src_format, len);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; i++) {
+        SDL_MixAudioFormat(mixed, src, bench->src_format, len, volume);
+    }
+    sdl_seconds = elapsed_seconds(start);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; i++) {
+        bench->reference(expected, src, samples, volume);
+    }
+    ref_seconds = elapsed_seconds(start);
+
+    report(bench->name, (double) samples * iterations, sdl_seconds, ref_seconds, match);
+
+    SDL_free(src);
+    SDL_free(mixed);
+    SDL_free(expected);
+    return match;
+}
+
+static const int resample_rates[] = { 44100, 48000, 96000 };
+
+/* "fast" is the old cvt filters */
+static const char *resample_modes[] = { "fast", "medium", "best" };
+
+#define RESAMPLE_TONE 1000
+#define RESAMPLE_SECONDS 3
+
+typedef struct
+{
+    int rate;
+    double phase;
+    SDL_atomic_t frames;
+} ToneState;
+
+static void SDLCALL
+tone_callback(void *userdata, Uint8 *stream, int len)
+{
+    ToneState *tone = (ToneState *) userdata;
+    float *out = (float *) stream;
+    const int frames = len / (int) (2 * sizeof (float));
+    const double step = 2.0 * M_PI * RESAMPLE_TONE / tone->rate;
+    int i;
+
+    for (i = 0; i < frames; i++) {
+        out[i * 2] = out[i * 2 + 1] = (float) (0.5 * SDL_sin(tone->phase));
+        tone->phase += step;
+        if (tone->phase >= 2.0 * M_PI) {
+            tone->phase -= 2.0 * M_PI;
+        }
+    }
+    SDL_AtomicAdd(&tone->frames, frames);
+}
+
+static SDL_AudioDeviceID
+open_tone_device(ToneState *tone, int rate, int allowed_changes, SDL_AudioSpec *obtained)
+{
+    SDL_AudioSpec spec;
+
+    SDL_zero(spec);
+    SDL_zerop(tone);
+    spec.freq = tone->rate = rate;
+    spec.format = AUDIO_F32SYS;
+    spec.channels = 2;
+    spec.samples = 1024;
+    spec.callback = tone_callback;
+    spec.userdata = tone;
+    return SDL_OpenAudioDevice(NULL, 0, &spec, obtained, allowed_changes);
+}
+
+/* the rate the driver runs at, 0 if it takes whatever it is asked for */
+static int
+device_rate(void)
+{
+    ToneState tone;
+    SDL_AudioSpec obtained;
+    SDL_AudioDeviceID dev;
+    const int probe = resample_rates[SDL_arraysize(resample_rates) - 1];
+
+    dev = open_tone_device(&tone, probe, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE, &obtained);
+    if (!dev) {
+        SDL_Log("  no playback device: %s\n", SDL_GetError());
+        return 0;
+    }
+    SDL_CloseAudioDevice(dev);
+    return obtained.freq != probe ? obtained.freq : 0;
+}
+
+static int
+bench_resample(int src_rate, int dst_rate, const char *mode)
+{
+    char name[64];
+    ToneState tone;
+    SDL_AudioDeviceID dev;
+    Uint64 start;
+    clock_t cpu;
+    double seconds;
+
+    SDL_snprintf(name, sizeof (name), "%d -> %d %s", src_rate, dst_rate, mode);
+    SDL_SetHint(SDL_HINT_AUDIO_RESAMPLING_MODE, mode);
+    dev = open_tone_device(&tone, src_rate, 0, NULL);
+    if (!dev) {
+        SDL_Log("  %-20s open failed: %s\n", name, SDL_GetError());
+        return 0;
+    }
+
+    cpu = clock();
+    start = SDL_GetPerformanceCounter();
+    SDL_PauseAudioDevice(dev, 0);
+    while (SDL_AtomicGet(&tone.frames) < src_rate * RESAMPLE_SECONDS) {
+        SDL_Delay(10);
+    }
+    SDL_CloseAudioDevice(dev);
+    seconds = (double) SDL_AtomicGet(&tone.frames) / src_rate;
+    SDL_Log("  %-20s %10.2f %10.2f\n", name,
+            (double) (clock() - cpu) * 1000.0 / CLOCKS_PER_SEC / seconds,
+            seconds / elapsed_seconds(start));
+    return 1;
+}
+
+int
+main(int argc, char **argv)
+{
+    int frames = 4096;
+    int iterations = 2000;
+    int failed = 0;
+    int rate;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--frames n] [--iterations n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (frames <= 0 || iterations <= 0) {
+        SDL_Log("frames and iterations must be positive\n");
+        return 1;
+    }
+
+    SDL_Log("SSE2 %s, AVX2 %s; %d frames x %d iterations\n",
+            SDL_HasSSE2() ? "yes" : "no", SDL_HasAVX2() ? "yes" : "no", frames, iterations);
+    SDL_Log("  %-20s %10s %10s %9s\n", "", "SDL Ms/s", "C Ms/s", "speedup");
+    for (i = 0; i < SDL_arraysize(convert_cases); i++) {
+        failed += !bench_convert(&convert_cases[i], frames, iterations);
+    }
+    for (i = 0; i < SDL_arraysize(mix_cases); i++) {
+        failed += !bench_mix(&mix_cases[i], frames, iterations);
+    }
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        SDL_Log("  no audio driver: %s\n", SDL_GetError());
+    } else if (!(rate = device_rate())) {
+        SDL_Log("  %s audio runs at any rate, rate conversion not timed\n",
+                SDL_GetCurrentAudioDriver());
+    } else {
+        SDL_Log("  %-20s %10s %10s\n", SDL_GetCurrentAudioDriver(), "CPU ms/s", "realtime");
+        for (i = 0; i < SDL_arraysize(resample_rates); i++) {
+            int j;
+            if (resample_rates[i] == rate) {
+                continue;
+            }
+            for (j = 0; j < SDL_arraysize(resample_modes); j++) {
+                failed += !bench_resample(resample_rates[i], rate, resample_modes[j]);
+            }
+        }
+    }
+
+    SDL_Quit();
+    return failed ? 1 : 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
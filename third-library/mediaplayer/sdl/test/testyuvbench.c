@@ -0,0 +1,318 @@
+/*
+  Copyright (C) 1997-2016 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Times the software YUV to RGB conversion done by SDL_UpdateTexture when a
+   renderer has no YUV textures of its own, in milliseconds per frame, for
+   every YUV format and each of the SDL_HINT_YUV_CONVERSION_MODE matrices.
+   The rendered picture is read back and checked against a double precision
+   conversion of the same planes; anything more than one step off in any
+   channel shows up as a MISMATCH.
+
+   The "scaled" rows copy the middle half of the texture to a target 3/4 the
+   size of the picture, and time the update and the copy together.  Those
+   pixels are checked against the nearest source pixels.
+
+   testyuvbench [--size WxH] [--iterations n]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SDL.h"
+
+typedef struct
+{
+    const char *hint;
+    double kr, kb;
+    int full_range;
+} Matrix;
+
+static const Matrix matrices[] = {
+    { "BT601", 0.299, 0.114, 0 },
+    { "BT709", 0.2126, 0.0722, 0 },
+    { "JPEG", 0.299, 0.114, 1 },
+};
+
+static const Uint32 formats[] = {
+    SDL_PIXELFORMAT_IYUV,
+    SDL_PIXELFORMAT_YV12,
+    SDL_PIXELFORMAT_YUY2,
+    SDL_PIXELFORMAT_UYVY,
+    SDL_PIXELFORMAT_YVYU,
+};
+
+/* Planar 4:2:0 pattern: gradients with some texture, like a real picture */
+static void
+make_planes(Uint8 *y, Uint8 *u, Uint8 *v, int w, int h)
+{
+    int i, j;
+
+    for (j = 0; j < h; j++) {
+        for (i = 0; i < w; i++) {
+            y[j * w + i] = (Uint8) (16 + i * 203 / w + ((i ^ j) & 15));
+        }
+    }
+    for (j = 0; j < h / 2; j++) {
+        for (i = 0; i < w / 2; i++) {
+            u[j * (w / 2) + i] = (Uint8) (16 + j * 448 / h);
+            v[j * (w / 2) + i] = (Uint8) (16 + (i + j) * 448 / (w + h));
+        }
+    }
+}
+
+/* Lays the planes out as the texture format wants them.  The packed formats
+   are 4:2:2, so each chroma row is used for two picture rows. */
+static int
+pack_planes(Uint32 format, Uint8 *dst, const Uint8 *y, const Uint8 *u,
+            const Uint8 *v, int w, int h)
+{
+    int i, j;
+
+    switch (format) {
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_YV12:
+        SDL_memcpy(dst, y, w * h);
+        dst += w * h;
+        SDL_memcpy(dst, format == SDL_PIXELFORMAT_IYUV ? u : v, (w / 2) * (h / 2));
+        dst += (w / 2) * (h / 2);
+        SDL_memcpy(dst, format == SDL_PIXELFORMAT_IYUV ? v : u, (w / 2) * (h / 2));
+        return w;
+    default:
+        for (j = 0; j < h; j++) {
+            for (i = 0; i < w / 2; i++) {
+                const Uint8 y0 = y[j * w + 2 * i], y1 = y[j * w + 2 * i + 1];
+                const Uint8 cb = u[(j / 2) * (w / 2) + i], cr = v[(j / 2) * (w / 2) + i];
+                Uint8 *p = dst + j * w * 2 + i * 4;
+                if (format == SDL_PIXELFORMAT_YUY2) {
+                    p[0] = y0; p[1] = cb; p[2] = y1; p[3] = cr;
+                } else if (format == SDL_PIXELFORMAT_UYVY) {
+                    p[0] = cb; p[1] = y0; p[2] = cr; p[3] = y1;
+                } else {
+                    p[0] = y0; p[1] = cr; p[2] = y1; p[3] = cb;
+                }
+            }
+        }
+        return w * 2;
+    }
+}
+
+static int
+clamp_rgb(double value)
+{
+    const int rounded = (int) floor(value + 0.5);
+    return rounded < 0 ? 0 : rounded > 255 ? 255 : rounded;
+}
+
+static void
+reference_pixel(const Matrix *m, const Uint8 *y, const Uint8 *u, const Uint8 *v,
+                int w, int i, int j, int rgb[3])
+{
+    const double kg = 1.0 - m->kr - m->kb;
+    const double ys = m->full_range ? 1.0 : 255.0 / 219.0;
+    const double cs = m->full_range ? 1.0 : 255.0 / 224.0;
+    const double yo = m->full_range ? 0.0 : 16.0;
+    const double luma = (y[j * w + i] - yo) * ys;
+    const double cb = (u[(j / 2) * (w / 2) + i / 2] - 128.0) * cs;
+    const double cr = (v[(j / 2) * (w / 2) + i / 2] - 128.0) * cs;
+
+    rgb[0] = clamp_rgb(luma + 2.0 * (1.0 - m->kr) * cr);
+    rgb[1] = clamp_rgb(luma - (2.0 * m->kb * (1.0 - m->kb) * cb +
+                               2.0 * m->kr * (1.0 - m->kr) * cr) / kg);
+    rgb[2] = clamp_rgb(luma + 2.0 * (1.0 - m->kb) * cb);
+}
+
+static int
+pixel_diff(Uint32 pixel, const int ref[3])
+{
+    const int got[3] = {
+        (int) ((pixel >> 16) & 0xFF),
+        (int) ((pixel >> 8) & 0xFF),
+        (int) (pixel & 0xFF)
+    };
+    int c, worst = 0;
+
+    for (c = 0; c < 3; c++) {
+        const int diff = SDL_abs(got[c] - ref[c]);
+        if (diff > worst) {
+            worst = diff;
+        }
+    }
+    return worst;
+}
+
+/* (src) of the w x h picture drawn over the whole tw x th target; any of the
+   source pixels next to the nearest one will do, as the stretch may round
+   either way */
+static int
+check_picture(const Matrix *m, const Uint32 *pixels, const Uint8 *y,
+              const Uint8 *u, const Uint8 *v, int w, int h,
+              const SDL_Rect *src, int tw, int th)
+{
+    int i, j, worst = 0;
+
+    for (j = 0; j < th; j++) {
+        const int sy = src->y + (int) ((Sint64) j * src->h / th);
+        for (i = 0; i < tw; i++) {
+            const int sx = src->x + (int) ((Sint64) i * src->w / tw);
+            int best = 256;
+            int dx, dy;
+            for (dy = (th == src->h) ? 0 : -1; dy <= ((th == src->h) ? 0 : 1); dy++) {
+                for (dx = (tw == src->w) ? 0 : -1; dx <= ((tw == src->w) ? 0 : 1); dx++) {
+                    const int x = SDL_max(0, SDL_min(sx + dx, w - 1));
+                    const int yy = SDL_max(0, SDL_min(sy + dy, h - 1));
+                    int ref[3], diff;
+                    reference_pixel(m, y, u, v, w, x, yy, ref);
+                    diff = pixel_diff(pixels[j * tw + i], ref);
+                    if (diff < best) {
+                        best = diff;
+                    }
+                }
+            }
+            if (best > worst) {
+                worst = best;
+            }
+        }
+    }
+    return worst;
+}
+
+static void
+run_bench(Uint32 format, const Matrix *m, const Uint8 *y, const Uint8 *u,
+          const Uint8 *v, Uint8 *packed, int w, int h, int iterations,
+          SDL_bool scaled)
+{
+    SDL_Surface *target;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    SDL_Rect src;
+    Uint64 start;
+    double ms;
+    int tw, th, pitch, i, worst;
+
+    if (scaled) {
+        src.x = (w / 4) & ~1;
+        src.y = (h / 4) & ~1;
+        src.w = w / 2;
+        src.h = h / 2;
+        tw = w * 3 / 4;
+        th = h * 3 / 4;
+    } else {
+        src.x = src.y = 0;
+        src.w = tw = w;
+        src.h = th = h;
+    }
+
+    target = SDL_CreateRGBSurfaceWithFormat(0, tw, th, 32, SDL_PIXELFORMAT_ARGB8888);
+    renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    texture = renderer ? SDL_CreateTexture(renderer, format,
+                                           SDL_TEXTUREACCESS_STREAMING, w, h) : NULL;
+    if (!texture) {
+        SDL_Log("  %-6s %-6s %s\n", SDL_GetPixelFormatName(format) + 16,
+                m->hint, SDL_GetError());
+        goto done;
+    }
+
+    pitch = pack_planes(format, packed, y, u, v, w, h);
+    SDL_UpdateTexture(texture, NULL, packed, pitch);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; i++) {
+        SDL_UpdateTexture(texture, NULL, packed, pitch);
+        if (scaled) {
+            SDL_RenderCopy(renderer, texture, &src, NULL);
+        }
+    }
+    ms = (double) (SDL_GetPerformanceCounter() - start) * 1000.0 /
+         SDL_GetPerformanceFrequency() / iterations;
+
+    SDL_RenderCopy(renderer, texture, &src, NULL);
+    SDL_RenderPresent(renderer);
+    worst = check_picture(m, (const Uint32 *) target->pixels, y, u, v, w, h,
+                          &src, tw, th);
+
+    SDL_Log("  %-6s %-6s %-6s %10.3f %8d  %s\n", SDL_GetPixelFormatName(format) + 16,
+            m->hint, scaled ? "scaled" : "", ms, worst, worst > 1 ? "MISMATCH" : "ok");
+
+done:
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+    }
+    SDL_FreeSurface(target);
+}
+
+int
+main(int argc, char **argv)
+{
+    int w = 1920, h = 1080, iterations = 50;
+    Uint8 *y, *u, *v, *packed;
+    int i, j;
+
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (SDL_sscanf(argv[++i], "%dx%d", &w, &h) != 2) {
+                w = h = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--size WxH] [--iterations n]\n", argv[0]);
+            return 1;
+        }
+    }
+    /* the chroma planes are half size in both directions */
+    w &= ~1;
+    h &= ~1;
+    if (w <= 0 || h <= 0 || iterations <= 0) {
+        SDL_Log("size and iterations must be positive\n");
+        return 1;
+    }
+
+    y = (Uint8 *) SDL_malloc(w * h);
+    u = (Uint8 *) SDL_malloc((w / 2) * (h / 2));
+    v = (Uint8 *) SDL_malloc((w / 2) * (h / 2));
+    packed = (Uint8 *) SDL_malloc(w * h * 2);
+    if (!y || !u || !v || !packed) {
+        SDL_Log("out of memory\n");
+        return 1;
+    }
+    make_planes(y, u, v, w, h);
+
+    SDL_Log("SSE2 %s, AVX2 %s; %d CPUs; %dx%d x %d iterations\n",
+            SDL_HasSSE2() ? "yes" : "no", SDL_HasAVX2() ? "yes" : "no",
+            SDL_GetCPUCount(), w, h, iterations);
+    SDL_Log("  %-6s %-6s %-6s %10s %8s\n", "", "", "", "ms/frame", "maxdiff");
+    for (i = 0; i < SDL_arraysize(formats); i++) {
+        for (j = 0; j < SDL_arraysize(matrices); j++) {
+            SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, matrices[j].hint);
+            run_bench(formats[i], &matrices[j], y, u, v, packed, w, h, iterations, SDL_FALSE);
+        }
+    }
+    SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, matrices[0].hint);
+    for (i = 0; i < SDL_arraysize(formats); i++) {
+        run_bench(formats[i], &matrices[0], y, u, v, packed, w, h, iterations, SDL_TRUE);
+    }
+
+    SDL_free(y);
+    SDL_free(u);
+    SDL_free(v);
+    SDL_free(packed);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -6,6 +6,7 @@ LOCAL_C_INCLUDES += $(NDK_PROJECT_PATH)/librtmp \
 
 LOCAL_SRC_FILES:= \
 	amf.c \
+	chunk.c \
 	hashswf.c \
 	log.c \
 	parseurl.c \
@@ -0,0 +1,336 @@
+/*
+ *  This file is part of librtmp.
+ *
+ *  librtmp is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as
+ *  published by the Free Software Foundation; either version 2.1,
+ *  or (at your option) any later version.
+ *
+ *  librtmp is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with librtmp see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA  02110-1301, USA.
+ *  http://www.gnu.org/copyleft/lgpl.html
+ */
+
+/* Push-style chunk stream decoder.
+ *
+ * RTMP_ReadPacket() pulls bytes with ReadN() and loses its place if the
+ * socket times out in the middle of a header. This decoder instead takes
+ * whatever bytes are available, keeps every partial header and body in
+ * its own state, and calls back once per complete message. It never
+ * touches a socket, so it can be driven by non-blocking I/O, a capture
+ * file or a fuzzer alike.
+ *
+ * Header semantics follow RTMP_ReadPacket(): type 0 timestamps are
+ * absolute, the others are deltas, a type 3 header starting a new message
+ * reuses the channel's last delta, and only type 0-2 headers carry an
+ * extended timestamp.
+ *
+ * A message header declares up to 16 MB of body and there can be tens of
+ * thousands of chunk streams, so the body memory a peer can make us hold
+ * is capped per message and over the whole parser.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rtmp_sys.h"
+#include "log.h"
+
+enum
+{
+  CP_HEADER,			/* collecting basic + message header bytes */
+  CP_PAYLOAD			/* copying the body of the current chunk */
+};
+
+static const int msgHeaderSize[] = { 11, 7, 3, 0 };
+
+void
+RTMPChunkParser_Init(RTMPChunkParser *cp, RTMPChunkParser_OnPacket *onPacket, void *opaque)
+{
+  memset(cp, 0, sizeof(RTMPChunkParser));
+  cp->cp_chunkSize = RTMP_DEFAULT_CHUNKSIZE;
+  cp->cp_state = CP_HEADER;
+  cp->cp_onPacket = onPacket;
+  cp->cp_opaque = opaque;
+  cp->cp_maxBodySize = RTMP_CHUNK_MAX_BODY;
+  cp->cp_maxReserved = RTMP_CHUNK_MAX_RESERVED;
+}
+
+void
+RTMPChunkParser_SetLimits(RTMPChunkParser *cp, uint32_t maxBodySize, uint32_t maxReserved)
+{
+  cp->cp_maxBodySize = maxBodySize;
+  cp->cp_maxReserved = maxReserved;
+}
+
+void
+RTMPChunkParser_Free(RTMPChunkParser *cp)
+{
+  int i;
+
+  for (i = 0; i < cp->cp_nchannels; i++)
+    {
+      if (cp->cp_channels[i].cc_body)
+	free(cp->cp_channels[i].cc_body - RTMP_MAX_HEADER_SIZE);
+    }
+  free(cp->cp_channels);
+  cp->cp_channels = NULL;
+  cp->cp_nchannels = 0;
+  cp->cp_reserved = 0;
+}
+
+static RTMPChunkChannel *
+GetChannel(RTMPChunkParser *cp, int channel)
+{
+  if (channel >= cp->cp_nchannels)
+    {
+      int n = channel < 64 ? 64 : channel + 64;
+      RTMPChunkChannel *channels = realloc(cp->cp_channels, sizeof(RTMPChunkChannel) * n);
+
+      if (!channels)
+	return NULL;
+      memset(channels + cp->cp_nchannels, 0,
+	  sizeof(RTMPChunkChannel) * (n - cp->cp_nchannels));
+      cp->cp_channels = channels;
+      cp->cp_nchannels = n;
+    }
+  return &cp->cp_channels[channel];
+}
+
+/* bodies keep RTMP_MAX_HEADER_SIZE bytes of headroom like RTMPPacket_Alloc()
+ * does, so a callback may take one over and release it with RTMPPacket_Free() */
+static int
+ReserveBody(RTMPChunkParser *cp, RTMPChunkChannel *ch, int channel)
+{
+  uint32_t reserved;
+  char *ptr;
+
+  if (ch->cc_body && ch->cc_bodyAlloc >= ch->cc_bodySize)
+    return TRUE;
+
+  reserved = cp->cp_reserved - ch->cc_bodyAlloc;
+  if (ch->cc_bodySize > cp->cp_maxBodySize ||
+      ch->cc_bodySize > cp->cp_maxReserved - reserved)
+    {
+      RTMP_Log(RTMP_LOGERROR, "%s, channel %d: %u byte message over the limit (%u, %u of %u held)",
+	  __FUNCTION__, channel, ch->cc_bodySize, cp->cp_maxBodySize, reserved,
+	  cp->cp_maxReserved);
+      return FALSE;
+    }
+
+  ptr = malloc(ch->cc_bodySize + RTMP_MAX_HEADER_SIZE);
+  if (!ptr)
+    {
+      RTMP_Log(RTMP_LOGERROR, "%s, failed to allocate %u bytes", __FUNCTION__,
+	  ch->cc_bodySize);
+      return FALSE;
+    }
+  if (ch->cc_body)
+    free(ch->cc_body - RTMP_MAX_HEADER_SIZE);
+  ch->cc_body = ptr + RTMP_MAX_HEADER_SIZE;
+  ch->cc_bodyAlloc = ch->cc_bodySize;
+  cp->cp_reserved = reserved + ch->cc_bodyAlloc;
+  return TRUE;
+}
+
+/* a complete basic + message header is in cp_hbuf */
+static int
+StartChunk(RTMPChunkParser *cp)
+{
+  const char *hptr = (const char *)cp->cp_hbuf;
+  int headerType = (cp->cp_hbuf[0] & 0xc0) >> 6;
+  int channel = cp->cp_hbuf[0] & 0x3f;
+  uint32_t tsField = 0;
+  RTMPChunkChannel *ch;
+
+  hptr++;
+  if (channel == 0)
+    channel = (uint8_t)*hptr++ + 64;
+  else if (channel == 1)
+    {
+      channel = ((uint8_t)hptr[1] << 8) + (uint8_t)hptr[0] + 64;
+      hptr += 2;
+    }
+
+  ch = GetChannel(cp, channel);
+  if (!ch)
+    return FALSE;
+
+  if (headerType < 3)
+    {
+      tsField = AMF_DecodeInt24(hptr);
+      if (headerType < 2)
+	{
+	  uint32_t bodySize = AMF_DecodeInt24(hptr + 3);
+
+	  if (ch->cc_bytesRead)
+	    {
+	      RTMP_Log(RTMP_LOGWARNING, "%s, channel %d: new header before message end, dropped %u bytes",
+		  __FUNCTION__, channel, ch->cc_bytesRead);
+	      ch->cc_bytesRead = 0;
+	    }
+	  ch->cc_bodySize = bodySize;
+	  ch->cc_packetType = hptr[6];
+	  if (headerType == 0)
+	    {
+	      const uint8_t *sid = (const uint8_t *)hptr + 7;	/* little endian */
+	      ch->cc_streamID = sid[0] | (sid[1] << 8) | (sid[2] << 16) | ((uint32_t)sid[3] << 24);
+	    }
+	}
+      if (tsField == 0xffffff)
+	tsField = AMF_DecodeInt32((const char *)cp->cp_hbuf + cp->cp_hlen - 4);
+    }
+
+  if (!ch->cc_bytesRead)
+    {
+      /* first chunk of a message: resolve its timestamp */
+      if (headerType == 0)
+	{
+	  ch->cc_timestamp = tsField;
+	  ch->cc_delta = tsField;
+	}
+      else
+	{
+	  if (headerType < 3)
+	    ch->cc_delta = tsField;
+	  ch->cc_timestamp += ch->cc_delta;
+	}
+      ch->cc_headerType = headerType;
+      if (!ReserveBody(cp, ch, channel))
+	return FALSE;
+    }
+
+  cp->cp_channel = channel;
+  cp->cp_remaining = ch->cc_bodySize - ch->cc_bytesRead;
+  if (cp->cp_remaining > cp->cp_chunkSize)
+    cp->cp_remaining = cp->cp_chunkSize;
+  return TRUE;
+}
+
+static int
+EmitPacket(RTMPChunkParser *cp, int channel)
+{
+  RTMPChunkChannel *ch = &cp->cp_channels[channel];
+  RTMPPacket packet;
+  int ret = TRUE;
+
+  packet.m_headerType = ch->cc_headerType;
+  packet.m_packetType = ch->cc_packetType;
+  packet.m_hasAbsTimestamp = TRUE;
+  packet.m_nChannel = channel;
+  packet.m_nTimeStamp = ch->cc_timestamp;
+  packet.m_nInfoField2 = ch->cc_streamID;
+  packet.m_nBodySize = ch->cc_bodySize;
+  packet.m_nBytesRead = ch->cc_bodySize;
+  packet.m_chunk = NULL;
+  packet.m_body = ch->cc_body;
+  ch->cc_bytesRead = 0;
+  cp->cp_messages++;
+
+  /* protocol control messages that change how the stream is chunked */
+  if (packet.m_packetType == RTMP_PACKET_TYPE_CHUNK_SIZE && packet.m_nBodySize >= 4)
+    {
+      int size = AMF_DecodeInt32(packet.m_body) & 0x7fffffff;
+      if (size > 0)
+	cp->cp_chunkSize = size;
+    }
+  else if (packet.m_packetType == 0x02 && packet.m_nBodySize >= 4)	/* abort */
+    {
+      uint32_t abort = AMF_DecodeInt32(packet.m_body);
+      if (abort < (uint32_t)cp->cp_nchannels)
+	cp->cp_channels[abort].cc_bytesRead = 0;
+    }
+
+  if (cp->cp_onPacket)
+    ret = cp->cp_onPacket(cp->cp_opaque, &packet);
+
+  /* the callback took the body over */
+  if (!packet.m_body)
+    {
+      ch = &cp->cp_channels[channel];
+      cp->cp_reserved -= ch->cc_bodyAlloc;
+      ch->cc_body = NULL;
+      ch->cc_bodyAlloc = 0;
+    }
+  return ret;
+}
+
+/* Consumes all len bytes; returns FALSE on a protocol/allocation error or
+ * when the callback asked to stop. The parser is not reusable afterwards.
+ */
+int
+RTMPChunkParser_Feed(RTMPChunkParser *cp, const char *buf, int len)
+{
+  const char *end = buf + len;
+
+  cp->cp_bytesIn += len;
+
+  while (buf < end)
+    {
+      if (cp->cp_state == CP_HEADER)
+	{
+	  if (!cp->cp_hlen)
+	    {
+	      int channel = *buf & 0x3f;
+	      cp->cp_hneed = 1 + msgHeaderSize[(*buf & 0xc0) >> 6];
+	      if (channel == 0)
+		cp->cp_hneed += 1;
+	      else if (channel == 1)
+		cp->cp_hneed += 2;
+	      cp->cp_extended = FALSE;
+	    }
+
+	  /* header bytes are few, take them one at a time */
+	  while (buf < end && cp->cp_hlen < cp->cp_hneed)
+	    cp->cp_hbuf[cp->cp_hlen++] = *buf++;
+	  if (cp->cp_hlen < cp->cp_hneed)
+	    break;
+
+	  if (!cp->cp_extended && (cp->cp_hbuf[0] & 0xc0) != 0xc0)
+	    {
+	      /* timestamp field sits right after the basic header */
+	      int tsOffset = cp->cp_hneed - msgHeaderSize[(cp->cp_hbuf[0] & 0xc0) >> 6];
+	      cp->cp_extended = TRUE;
+	      if (AMF_DecodeInt24((const char *)cp->cp_hbuf + tsOffset) == 0xffffff)
+		{
+		  cp->cp_hneed += 4;
+		  continue;
+		}
+	    }
+
+	  if (!StartChunk(cp))
+	    return FALSE;
+	  cp->cp_hlen = 0;
+	  cp->cp_state = CP_PAYLOAD;
+	}
+      else
+	{
+	  RTMPChunkChannel *ch = &cp->cp_channels[cp->cp_channel];
+	  int n = end - buf;
+
+	  if (n > cp->cp_remaining)
+	    n = cp->cp_remaining;
+	  memcpy(ch->cc_body + ch->cc_bytesRead, buf, n);
+	  ch->cc_bytesRead += n;
+	  cp->cp_remaining -= n;
+	  buf += n;
+	}
+
+      if (cp->cp_state == CP_PAYLOAD && !cp->cp_remaining)
+	{
+	  RTMPChunkChannel *ch = &cp->cp_channels[cp->cp_channel];
+
+	  cp->cp_state = CP_HEADER;
+	  if (ch->cc_bytesRead == ch->cc_bodySize && !EmitPacket(cp, cp->cp_channel))
+	    return FALSE;
+	}
+    }
+  return TRUE;
+}
@@ -359,6 +359,57 @@ extern "C"
   int RTMP_FindFirstMatchingProperty(AMFObject *obj, const AVal *name,
 				      AMFObjectProperty * p);
 
+  /* chunk.c: push-style chunk stream decoder */
+  typedef struct RTMPChunkChannel
+  {
+    uint8_t cc_headerType;	/* of the message's first chunk */
+    uint8_t cc_packetType;
+    int32_t cc_streamID;
+    uint32_t cc_timestamp;	/* absolute, of the current message */
+    uint32_t cc_delta;		/* reused by type 3 headers */
+    uint32_t cc_bodySize;
+    uint32_t cc_bytesRead;
+    uint32_t cc_bodyAlloc;
+    char *cc_body;
+  } RTMPChunkChannel;
+
+  /* return FALSE to stop parsing; set packet->m_body to NULL to keep the
+   * body, which must then be released with RTMPPacket_Free() */
+  typedef int (RTMPChunkParser_OnPacket)(void *opaque, RTMPPacket *packet);
+
+  typedef struct RTMPChunkParser
+  {
+    int cp_chunkSize;		/* follows RTMP_PACKET_TYPE_CHUNK_SIZE */
+    int cp_state;
+    int cp_channel;		/* chunk in progress */
+    int cp_remaining;		/* payload bytes left in it */
+    int cp_hlen;
+    int cp_hneed;
+    int cp_extended;
+    uint8_t cp_hbuf[RTMP_MAX_HEADER_SIZE];
+    int cp_nchannels;
+    RTMPChunkChannel *cp_channels;	/* indexed by chunk stream id */
+    RTMPChunkParser_OnPacket *cp_onPacket;
+    void *cp_opaque;
+    uint64_t cp_bytesIn;
+    uint64_t cp_messages;
+    uint32_t cp_maxBodySize;	/* largest message accepted */
+    uint32_t cp_maxReserved;	/* body memory held over all channels */
+    uint32_t cp_reserved;
+  } RTMPChunkParser;
+
+#define RTMP_CHUNK_MAX_BODY	(4*1024*1024)
+#define RTMP_CHUNK_MAX_RESERVED	(16*1024*1024)
+
+  void RTMPChunkParser_Init(RTMPChunkParser *cp, RTMPChunkParser_OnPacket *onPacket,
+			    void *opaque);
+  void RTMPChunkParser_Free(RTMPChunkParser *cp);
+  /* defaults are RTMP_CHUNK_MAX_BODY and RTMP_CHUNK_MAX_RESERVED; a message
+   * over either limit makes RTMPChunkParser_Feed() fail */
+  void RTMPChunkParser_SetLimits(RTMPChunkParser *cp, uint32_t maxBodySize,
+				 uint32_t maxReserved);
+  int RTMPChunkParser_Feed(RTMPChunkParser *cp, const char *buf, int len);
+
   int RTMPSockBuf_Fill(RTMPSockBuf *sb);
   int RTMPSockBuf_Send(RTMPSockBuf *sb, const char *buf, int len);
   int RTMPSockBuf_Close(RTMPSockBuf *sb);
@@ -0,0 +1,899 @@
+/*  RTMP Ingest Server
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RTMPDump; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA  02110-1301, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/* A multi-session publish endpoint. Unlike rtmpsrv, which serves one
+ * blocking connection at a time, every worker thread here owns an epoll
+ * loop and drives each session as a resumable state machine:
+ *
+ *   C0C1 -> C2 -> chunk stream (connect/createStream/publish/media)
+ *
+ * Sockets are non-blocking; whatever recv() returns is pushed into the
+ * session's RTMPChunkParser, which keeps partial headers and bodies
+ * across wakeups, so a session never stalls the loop. Replies are queued
+ * per session and written as the socket takes them, with EPOLLOUT armed
+ * while anything is left, so a slow peer never stalls it either. Media is
+ * counted and discarded. Linux only.
+ */
+
+#define _GNU_SOURCE	/* accept4 */
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <sys/epoll.h>
+
+#include "librtmp/rtmp_sys.h"
+#include "librtmp/log.h"
+
+#include "thread.h"
+
+#define RD_SUCCESS		0
+#define RD_FAILED		1
+
+#define RTMP_SIG_SIZE		1536
+#define MAX_EVENTS		256
+#define MAX_WORKERS		64
+#define IDLE_TIMEOUT		30	/* seconds without input before a session is dropped */
+#define RECV_SIZE		(64*1024)
+#define MAX_OUTPUT		(256*1024)	/* unsent bytes before a session is dropped */
+
+enum
+{
+  SESSION_HANDSHAKE_C0C1,
+  SESSION_HANDSHAKE_C2,
+  SESSION_CONNECTING,
+  SESSION_PUBLISHING
+};
+
+struct INGEST_WORKER;
+
+typedef struct INGEST_SESSION
+{
+  struct INGEST_SESSION *prev, *next;
+  struct INGEST_WORKER *worker;
+  RTMP rtmp;
+  RTMPChunkParser parser;
+  char hsbuf[1 + RTMP_SIG_SIZE];
+  int hslen;
+  int state;
+  int streamID;
+  char *out;			/* queued output not yet taken by the socket */
+  int outlen;
+  int outsize;
+  int outArmed;			/* EPOLLOUT is set */
+  uint32_t lastActive;
+  char app[128];
+  char name[128];
+  uint64_t bytesIn;
+  uint32_t audioMsgs;
+  uint32_t videoMsgs;
+} INGEST_SESSION;
+
+typedef struct INGEST_WORKER
+{
+  int index;
+  int epfd;
+  int listenfd;
+  int nsessions;
+  INGEST_SESSION *sessions;
+  char buf[RECV_SIZE];
+
+  /* updated by the worker, read by the stats printer */
+  volatile uint32_t accepted;
+  volatile uint32_t publishing;
+  volatile uint64_t bytesIn;
+  volatile uint64_t mediaMsgs;
+} INGEST_WORKER;
+
+static INGEST_WORKER workers[MAX_WORKERS];
+static int nworkers = 1;
+static volatile int running = TRUE;
+
+#define SAVC(x) static const AVal av_##x = AVC(#x)
+
+SAVC(app);
+SAVC(connect);
+SAVC(createStream);
+SAVC(releaseStream);
+SAVC(FCPublish);
+SAVC(FCUnpublish);
+SAVC(publish);
+SAVC(deleteStream);
+SAVC(_result);
+SAVC(onStatus);
+SAVC(status);
+SAVC(level);
+SAVC(code);
+SAVC(description);
+SAVC(fmsVer);
+SAVC(capabilities);
+SAVC(mode);
+SAVC(objectEncoding);
+static const AVal av_NetConnection_Connect_Success = AVC("NetConnection.Connect.Success");
+static const AVal av_Connection_succeeded = AVC("Connection succeeded.");
+static const AVal av_NetStream_Publish_Start = AVC("NetStream.Publish.Start");
+static const AVal av_Started_publishing = AVC("Started publishing");
+static const AVal av_FMS_version = AVC("FMS/3,5,1,525");
+
+/* Appends to the session's output; FALSE once a peer that does not read
+ * has MAX_OUTPUT bytes waiting */
+static int
+QueueBytes(INGEST_SESSION *s, const char *buf, int len)
+{
+  if (s->outlen + len > s->outsize)
+    {
+      int size = s->outsize ? s->outsize : 4096;
+      char *out;
+
+      while (size < s->outlen + len)
+	size *= 2;
+      if (size > MAX_OUTPUT)
+	{
+	  RTMP_Log(RTMP_LOGWARNING, "%s: fd %d has %d bytes unsent, dropping it",
+	      __FUNCTION__, s->rtmp.m_sb.sb_socket, s->outlen);
+	  return FALSE;
+	}
+      out = realloc(s->out, size);
+      if (!out)
+	return FALSE;
+      s->out = out;
+      s->outsize = size;
+    }
+  memcpy(s->out + s->outlen, buf, len);
+  s->outlen += len;
+  return TRUE;
+}
+
+/* The chunking RTMP_SendPacket() does, always with a full header, into
+ * the session's output instead of a blocking write */
+static int
+QueuePacket(INGEST_SESSION *s, RTMPPacket *packet)
+{
+  RTMP *r = &s->rtmp;
+  char hbuf[RTMP_MAX_HEADER_SIZE], *hptr = hbuf;
+  char cont = (char)(0xc0 | (packet->m_nChannel & 0x3f));
+  uint32_t ts = packet->m_nTimeStamp;
+  uint32_t sid = packet->m_nInfoField2;
+  const char *body = packet->m_body;
+  int left = packet->m_nBodySize;
+
+  /* the server only talks on the low channels, one byte basic header */
+  *hptr++ = packet->m_nChannel & 0x3f;
+  hptr = AMF_EncodeInt24(hptr, hbuf + sizeof(hbuf), ts >= 0xffffff ? 0xffffff : ts);
+  hptr = AMF_EncodeInt24(hptr, hbuf + sizeof(hbuf), packet->m_nBodySize);
+  *hptr++ = packet->m_packetType;
+  *hptr++ = sid & 0xff;		/* stream id is little endian */
+  *hptr++ = (sid >> 8) & 0xff;
+  *hptr++ = (sid >> 16) & 0xff;
+  *hptr++ = (sid >> 24) & 0xff;
+  if (ts >= 0xffffff)
+    hptr = AMF_EncodeInt32(hptr, hbuf + sizeof(hbuf), ts);
+  if (!QueueBytes(s, hbuf, hptr - hbuf))
+    return FALSE;
+
+  while (1)
+    {
+      int n = left < r->m_outChunkSize ? left : r->m_outChunkSize;
+      if (!QueueBytes(s, body, n))
+	return FALSE;
+      body += n;
+      left -= n;
+      if (left <= 0)
+	break;
+      if (!QueueBytes(s, &cont, 1))
+	return FALSE;
+      if (ts >= 0xffffff)
+	{
+	  char ext[4];
+	  AMF_EncodeInt32(ext, ext + sizeof(ext), ts);
+	  if (!QueueBytes(s, ext, sizeof(ext)))
+	    return FALSE;
+	}
+    }
+  return TRUE;
+}
+
+/* Writes as much queued output as the socket takes and keeps EPOLLOUT
+ * armed exactly while some is left; returns FALSE on a socket error */
+static int
+FlushSession(INGEST_WORKER *w, INGEST_SESSION *s)
+{
+  int fd = s->rtmp.m_sb.sb_socket;
+  int sent = 0;
+
+  while (sent < s->outlen)
+    {
+      int n = send(fd, s->out + sent, s->outlen - sent, MSG_NOSIGNAL);
+      if (n < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  if (errno == EAGAIN || errno == EWOULDBLOCK)
+	    break;
+	  return FALSE;
+	}
+      sent += n;
+    }
+  if (sent)
+    {
+      memmove(s->out, s->out + sent, s->outlen - sent);
+      s->outlen -= sent;
+    }
+
+  if ((s->outlen > 0) != s->outArmed)
+    {
+      struct epoll_event ev;
+
+      s->outArmed = s->outlen > 0;
+      ev.events = EPOLLIN | EPOLLRDHUP | (s->outArmed ? EPOLLOUT : 0);
+      ev.data.ptr = s;
+      if (epoll_ctl(w->epfd, EPOLL_CTL_MOD, fd, &ev) < 0)
+	return FALSE;
+    }
+  return TRUE;
+}
+
+static int
+SendServerBW(INGEST_SESSION *s)
+{
+  RTMPPacket packet;
+  char pbuf[RTMP_MAX_HEADER_SIZE + 4];
+
+  packet.m_nChannel = 0x02;	/* control channel */
+  packet.m_headerType = RTMP_PACKET_SIZE_LARGE;
+  packet.m_packetType = RTMP_PACKET_TYPE_SERVER_BW;
+  packet.m_nTimeStamp = 0;
+  packet.m_nInfoField2 = 0;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = pbuf + RTMP_MAX_HEADER_SIZE;
+  packet.m_nBodySize = 4;
+
+  AMF_EncodeInt32(packet.m_body, pbuf + sizeof(pbuf), s->rtmp.m_nServerBW);
+  return QueuePacket(s, &packet);
+}
+
+static int
+SendClientBW(INGEST_SESSION *s)
+{
+  RTMPPacket packet;
+  char pbuf[RTMP_MAX_HEADER_SIZE + 5];
+
+  packet.m_nChannel = 0x02;	/* control channel */
+  packet.m_headerType = RTMP_PACKET_SIZE_LARGE;
+  packet.m_packetType = RTMP_PACKET_TYPE_CLIENT_BW;
+  packet.m_nTimeStamp = 0;
+  packet.m_nInfoField2 = 0;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = pbuf + RTMP_MAX_HEADER_SIZE;
+  packet.m_nBodySize = 5;
+
+  AMF_EncodeInt32(packet.m_body, pbuf + sizeof(pbuf), s->rtmp.m_nClientBW);
+  packet.m_body[4] = s->rtmp.m_nClientBW2;
+  return QueuePacket(s, &packet);
+}
+
+static int
+SendConnectResult(INGEST_SESSION *s, double txn)
+{
+  RTMP *r = &s->rtmp;
+  RTMPPacket packet;
+  char pbuf[384], *pend = pbuf+sizeof(pbuf);
+  char *enc;
+
+  packet.m_nChannel = 0x03;     /* control channel (invoke) */
+  packet.m_headerType = RTMP_PACKET_SIZE_MEDIUM;
+  packet.m_packetType = RTMP_PACKET_TYPE_INVOKE;
+  packet.m_nTimeStamp = 0;
+  packet.m_nInfoField2 = 0;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = pbuf + RTMP_MAX_HEADER_SIZE;
+
+  enc = packet.m_body;
+  enc = AMF_EncodeString(enc, pend, &av__result);
+  enc = AMF_EncodeNumber(enc, pend, txn);
+  *enc++ = AMF_OBJECT;
+  enc = AMF_EncodeNamedString(enc, pend, &av_fmsVer, &av_FMS_version);
+  enc = AMF_EncodeNamedNumber(enc, pend, &av_capabilities, 31.0);
+  enc = AMF_EncodeNamedNumber(enc, pend, &av_mode, 1.0);
+  *enc++ = 0;
+  *enc++ = 0;
+  *enc++ = AMF_OBJECT_END;
+
+  *enc++ = AMF_OBJECT;
+  enc = AMF_EncodeNamedString(enc, pend, &av_level, &av_status);
+  enc = AMF_EncodeNamedString(enc, pend, &av_code, &av_NetConnection_Connect_Success);
+  enc = AMF_EncodeNamedString(enc, pend, &av_description, &av_Connection_succeeded);
+  enc = AMF_EncodeNamedNumber(enc, pend, &av_objectEncoding, r->m_fEncoding);
+  *enc++ = 0;
+  *enc++ = 0;
+  *enc++ = AMF_OBJECT_END;
+
+  packet.m_nBodySize = enc - packet.m_body;
+  return QueuePacket(s, &packet);
+}
+
+static int
+SendResultNumber(INGEST_SESSION *s, double txn, double ID)
+{
+  RTMPPacket packet;
+  char pbuf[256], *pend = pbuf+sizeof(pbuf);
+  char *enc;
+
+  packet.m_nChannel = 0x03;     /* control channel (invoke) */
+  packet.m_headerType = RTMP_PACKET_SIZE_MEDIUM;
+  packet.m_packetType = RTMP_PACKET_TYPE_INVOKE;
+  packet.m_nTimeStamp = 0;
+  packet.m_nInfoField2 = 0;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = pbuf + RTMP_MAX_HEADER_SIZE;
+
+  enc = packet.m_body;
+  enc = AMF_EncodeString(enc, pend, &av__result);
+  enc = AMF_EncodeNumber(enc, pend, txn);
+  *enc++ = AMF_NULL;
+  enc = AMF_EncodeNumber(enc, pend, ID);
+
+  packet.m_nBodySize = enc - packet.m_body;
+  return QueuePacket(s, &packet);
+}
+
+static int
+SendPublishStart(INGEST_SESSION *s, int streamID)
+{
+  RTMPPacket packet;
+  char pbuf[384], *pend = pbuf+sizeof(pbuf);
+  char *enc;
+
+  packet.m_nChannel = 0x05;
+  packet.m_headerType = RTMP_PACKET_SIZE_LARGE;
+  packet.m_packetType = RTMP_PACKET_TYPE_INVOKE;
+  packet.m_nTimeStamp = 0;
+  packet.m_nInfoField2 = streamID;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = pbuf + RTMP_MAX_HEADER_SIZE;
+
+  enc = packet.m_body;
+  enc = AMF_EncodeString(enc, pend, &av_onStatus);
+  enc = AMF_EncodeNumber(enc, pend, 0);
+  *enc++ = AMF_NULL;
+  *enc++ = AMF_OBJECT;
+  enc = AMF_EncodeNamedString(enc, pend, &av_level, &av_status);
+  enc = AMF_EncodeNamedString(enc, pend, &av_code, &av_NetStream_Publish_Start);
+  enc = AMF_EncodeNamedString(enc, pend, &av_description, &av_Started_publishing);
+  *enc++ = 0;
+  *enc++ = 0;
+  *enc++ = AMF_OBJECT_END;
+
+  packet.m_nBodySize = enc - packet.m_body;
+  return QueuePacket(s, &packet);
+}
+
+static void
+CopyAVal(char *dst, size_t size, const AVal *av)
+{
+  int len = av->av_len;
+  if (len >= (int)size)
+    len = size - 1;
+  if (len > 0)
+    memcpy(dst, av->av_val, len);
+  dst[len > 0 ? len : 0] = '\0';
+}
+
+/* Returns FALSE if the session should be closed */
+static int
+ServeInvoke(INGEST_WORKER *w, INGEST_SESSION *s, RTMPPacket *packet, unsigned int offset)
+{
+  RTMP *r = &s->rtmp;
+  const char *body = packet->m_body + offset;
+  unsigned int nBodySize = packet->m_nBodySize - offset;
+  AMFObject obj;
+  AVal method;
+  double txn;
+  int ret = TRUE;
+
+  if (nBodySize < 1 || body[0] != AMF_STRING)
+    {
+      RTMP_Log(RTMP_LOGWARNING, "%s, Sanity failed. no string method in invoke packet",
+	  __FUNCTION__);
+      return TRUE;
+    }
+
+  if (AMF_Decode(&obj, body, nBodySize, FALSE) < 0)
+    {
+      RTMP_Log(RTMP_LOGERROR, "%s, error decoding invoke packet", __FUNCTION__);
+      return FALSE;
+    }
+
+  AMFProp_GetString(AMF_GetProp(&obj, NULL, 0), &method);
+  txn = AMFProp_GetNumber(AMF_GetProp(&obj, NULL, 1));
+  RTMP_Log(RTMP_LOGDEBUG, "%s, fd %d invoking <%.*s>", __FUNCTION__,
+      r->m_sb.sb_socket, method.av_len, method.av_val);
+
+  if (AVMATCH(&method, &av_connect))
+    {
+      AMFObject cobj;
+      AMFObjectProperty *prop;
+
+      AMFProp_GetObject(AMF_GetProp(&obj, NULL, 2), &cobj);
+      prop = AMF_GetProp(&cobj, &av_app, -1);
+      if (prop && prop->p_type == AMF_STRING)
+	CopyAVal(s->app, sizeof(s->app), &prop->p_vu.p_aval);
+      prop = AMF_GetProp(&cobj, &av_objectEncoding, -1);
+      if (prop && prop->p_type == AMF_NUMBER)
+	r->m_fEncoding = prop->p_vu.p_number;
+
+      if (!SendServerBW(s) || !SendClientBW(s) ||
+	  !SendConnectResult(s, txn))
+	ret = FALSE;
+    }
+  else if (AVMATCH(&method, &av_createStream))
+    {
+      ret = SendResultNumber(s, txn, ++s->streamID);
+    }
+  else if (AVMATCH(&method, &av_publish))
+    {
+      AVal name;
+      AMFProp_GetString(AMF_GetProp(&obj, NULL, 3), &name);
+      CopyAVal(s->name, sizeof(s->name), &name);
+      ret = SendPublishStart(s, packet->m_nInfoField2);
+      if (ret && s->state != SESSION_PUBLISHING)
+	{
+	  s->state = SESSION_PUBLISHING;
+	  w->publishing++;
+	  RTMP_Log(RTMP_LOGINFO, "worker %d: publish %s/%s (fd %d)", w->index,
+	      s->app, s->name, r->m_sb.sb_socket);
+	}
+    }
+  else if (AVMATCH(&method, &av_FCUnpublish) || AVMATCH(&method, &av_deleteStream))
+    {
+      ret = FALSE;
+    }
+  else if (AVMATCH(&method, &av_releaseStream) || AVMATCH(&method, &av_FCPublish))
+    {
+      /* nothing to release, and no reply is required */
+    }
+
+  AMF_Reset(&obj);
+  return ret;
+}
+
+/* RTMPChunkParser callback, chunk size changes are applied by the parser */
+static int
+ServePacket(void *opaque, RTMPPacket *packet)
+{
+  INGEST_SESSION *s = opaque;
+  INGEST_WORKER *w = s->worker;
+
+  switch (packet->m_packetType)
+    {
+    case RTMP_PACKET_TYPE_AUDIO:
+      s->audioMsgs++;
+      w->mediaMsgs++;
+      break;
+
+    case RTMP_PACKET_TYPE_VIDEO:
+      s->videoMsgs++;
+      w->mediaMsgs++;
+      break;
+
+    case RTMP_PACKET_TYPE_FLEX_MESSAGE:
+      if (packet->m_nBodySize > 1)
+	return ServeInvoke(w, s, packet, 1);
+      break;
+
+    case RTMP_PACKET_TYPE_INVOKE:
+      return ServeInvoke(w, s, packet, 0);
+
+    default:
+      break;
+    }
+  return TRUE;
+}
+
+/* The plain (type 3) handshake, as SHandShake() does it, but collecting
+ * C0C1 and C2 across as many reads as it takes. Returns the number of
+ * bytes used, or -1 on failure.
+ */
+static int
+ServeHandshake(INGEST_SESSION *s, const char *buf, int len)
+{
+  int used = 0;
+
+  while (used < len && s->state < SESSION_CONNECTING)
+    {
+      int need = (s->state == SESSION_HANDSHAKE_C0C1 ? 1 : 0) + RTMP_SIG_SIZE;
+      int n = need - s->hslen;
+
+      if (n > len - used)
+	n = len - used;
+      memcpy(s->hsbuf + s->hslen, buf + used, n);
+      s->hslen += n;
+      used += n;
+      if (s->hslen < need)
+	break;
+      s->hslen = 0;
+
+      if (s->state == SESSION_HANDSHAKE_C0C1)
+	{
+	  char serverbuf[1 + 2 * RTMP_SIG_SIZE], *serversig = serverbuf + 1;
+	  uint32_t uptime;
+	  int i;
+
+	  if (s->hsbuf[0] != 3)
+	    {
+	      RTMP_Log(RTMP_LOGERROR, "%s: Type unknown: client sent %02X",
+		  __FUNCTION__, s->hsbuf[0]);
+	      return -1;
+	    }
+
+	  serverbuf[0] = 3;
+	  uptime = htonl(RTMP_GetTime());
+	  memcpy(serversig, &uptime, 4);
+	  memset(&serversig[4], 0, 4);
+	  for (i = 8; i < RTMP_SIG_SIZE; i++)
+	    serversig[i] = (char)(rand() % 256);
+	  /* S2 echoes C1 */
+	  memcpy(serversig + RTMP_SIG_SIZE, s->hsbuf + 1, RTMP_SIG_SIZE);
+
+	  if (!QueueBytes(s, serverbuf, sizeof(serverbuf)))
+	    return -1;
+	  s->state = SESSION_HANDSHAKE_C2;
+	}
+      else
+	{
+	  s->state = SESSION_CONNECTING;
+	}
+    }
+  return used;
+}
+
+/* the acknowledgement ReadN() would have sent, we bypass it */
+static int
+SendBytesReceived(INGEST_SESSION *s)
+{
+  RTMP *r = &s->rtmp;
+  RTMPPacket packet;
+  char pbuf[RTMP_MAX_HEADER_SIZE + 4];
+
+  packet.m_nChannel = 0x02;	/* control channel */
+  packet.m_headerType = RTMP_PACKET_SIZE_MEDIUM;
+  packet.m_packetType = RTMP_PACKET_TYPE_BYTES_READ_REPORT;
+  packet.m_nTimeStamp = 0;
+  packet.m_nInfoField2 = 0;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = pbuf + RTMP_MAX_HEADER_SIZE;
+  packet.m_nBodySize = 4;
+
+  AMF_EncodeInt32(packet.m_body, pbuf + sizeof(pbuf), r->m_nBytesIn);
+  r->m_nBytesInSent = r->m_nBytesIn;
+  return QueuePacket(s, &packet);
+}
+
+/* Consume whatever the socket has; returns FALSE if the session should be closed */
+static int
+ServeSession(INGEST_WORKER *w, INGEST_SESSION *s)
+{
+  RTMP *r = &s->rtmp;
+  char *buf = w->buf;
+  int len = recv(r->m_sb.sb_socket, buf, RECV_SIZE, 0);
+
+  if (len <= 0)
+    return len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+
+  s->bytesIn += len;
+  w->bytesIn += len;
+  s->lastActive = RTMP_GetTime();
+
+  if (s->state < SESSION_CONNECTING)
+    {
+      int used = ServeHandshake(s, buf, len);
+      if (used < 0)
+	return FALSE;
+      buf += used;
+      len -= used;
+      if (!len)
+	return TRUE;
+    }
+
+  if (!RTMPChunkParser_Feed(&s->parser, buf, len))
+    return FALSE;
+
+  r->m_nBytesIn += len;
+  if (r->m_nBytesIn > r->m_nBytesInSent + r->m_nClientBW / 10)
+    return SendBytesReceived(s);
+  return TRUE;
+}
+
+static void
+CloseSession(INGEST_WORKER *w, INGEST_SESSION *s)
+{
+  RTMP *r = &s->rtmp;
+
+  epoll_ctl(w->epfd, EPOLL_CTL_DEL, r->m_sb.sb_socket, NULL);
+  if (s->state == SESSION_PUBLISHING)
+    {
+      w->publishing--;
+      RTMP_Log(RTMP_LOGINFO, "worker %d: unpublish %s/%s, %llu bytes, %u audio, %u video",
+	  w->index, s->app, s->name, (unsigned long long)s->bytesIn,
+	  s->audioMsgs, s->videoMsgs);
+    }
+
+  /* we never createStream on our side, so RTMP_Close() sends nothing */
+  RTMPChunkParser_Free(&s->parser);
+  RTMP_Close(r);
+  free(s->out);
+
+  if (s->prev)
+    s->prev->next = s->next;
+  else
+    w->sessions = s->next;
+  if (s->next)
+    s->next->prev = s->prev;
+  w->nsessions--;
+  free(s);
+}
+
+static void
+AcceptSessions(INGEST_WORKER *w)
+{
+  while (1)
+    {
+      struct epoll_event ev;
+      INGEST_SESSION *s;
+      int on = 1;
+      int sockfd = accept4(w->listenfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+      if (sockfd < 0)
+	{
+	  if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+	    RTMP_Log(RTMP_LOGERROR, "%s: accept failed, %s", __FUNCTION__, strerror(errno));
+	  return;
+	}
+      setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, (char *) &on, sizeof(on));
+
+      s = calloc(1, sizeof(INGEST_SESSION));
+      if (!s)
+	{
+	  closesocket(sockfd);
+	  return;
+	}
+      RTMP_Init(&s->rtmp);
+      s->rtmp.m_sb.sb_socket = sockfd;
+      RTMPChunkParser_Init(&s->parser, ServePacket, s);
+      s->worker = w;
+      s->state = SESSION_HANDSHAKE_C0C1;
+      s->lastActive = RTMP_GetTime();
+
+      ev.events = EPOLLIN | EPOLLRDHUP;
+      ev.data.ptr = s;
+      if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, sockfd, &ev) < 0)
+	{
+	  closesocket(sockfd);
+	  free(s);
+	  continue;
+	}
+
+      s->next = w->sessions;
+      if (w->sessions)
+	w->sessions->prev = s;
+      w->sessions = s;
+      w->nsessions++;
+      w->accepted++;
+    }
+}
+
+static void
+ExpireSessions(INGEST_WORKER *w)
+{
+  INGEST_SESSION *s = w->sessions, *next;
+  uint32_t now = RTMP_GetTime();
+
+  for (; s; s = next)
+    {
+      next = s->next;
+      if (now - s->lastActive > IDLE_TIMEOUT * 1000)
+	{
+	  RTMP_Log(RTMP_LOGWARNING, "worker %d: session fd %d timed out",
+	      w->index, s->rtmp.m_sb.sb_socket);
+	  CloseSession(w, s);
+	}
+    }
+}
+
+static int
+OpenListener(const char *address, int port)
+{
+  struct sockaddr_in addr;
+  int sockfd, tmp = 1;
+
+  sockfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+  if (sockfd == -1)
+    {
+      RTMP_Log(RTMP_LOGERROR, "%s, couldn't create socket", __FUNCTION__);
+      return -1;
+    }
+
+  setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, (char *) &tmp, sizeof(tmp));
+#ifdef SO_REUSEPORT
+  /* every worker gets its own accept queue */
+  setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, (char *) &tmp, sizeof(tmp));
+#endif
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = inet_addr(address);
+  addr.sin_port = htons(port);
+
+  if (bind(sockfd, (struct sockaddr *) &addr, sizeof(struct sockaddr_in)) == -1)
+    {
+      RTMP_Log(RTMP_LOGERROR, "%s, TCP bind failed for port number: %d", __FUNCTION__,
+	  port);
+      closesocket(sockfd);
+      return -1;
+    }
+
+  if (listen(sockfd, SOMAXCONN) == -1)
+    {
+      RTMP_Log(RTMP_LOGERROR, "%s, listen failed", __FUNCTION__);
+      closesocket(sockfd);
+      return -1;
+    }
+  return sockfd;
+}
+
+static TFTYPE
+workerThread(void *arg)
+{
+  INGEST_WORKER *w = arg;
+  struct epoll_event events[MAX_EVENTS];
+  uint32_t lastSweep = RTMP_GetTime();
+
+  while (running)
+    {
+      int i, n = epoll_wait(w->epfd, events, MAX_EVENTS, 1000);
+
+      for (i = 0; i < n; i++)
+	{
+	  INGEST_SESSION *s = events[i].data.ptr;
+
+	  if (!s)
+	    {
+	      AcceptSessions(w);
+	      continue;
+	    }
+	  /* replies queued while serving input go out right away if they fit */
+	  if (((events[i].events & EPOLLIN) && !ServeSession(w, s)) ||
+	      !FlushSession(w, s) ||
+	      ((events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) &&
+	       !(events[i].events & EPOLLIN)))
+	    CloseSession(w, s);
+	}
+
+      if (RTMP_GetTime() - lastSweep >= 1000)
+	{
+	  ExpireSessions(w);
+	  lastSweep = RTMP_GetTime();
+	}
+    }
+
+  while (w->sessions)
+    CloseSession(w, w->sessions);
+  TFRET();
+}
+
+static void
+sigIntHandler(int sig)
+{
+  RTMP_ctrlC = TRUE;
+  running = FALSE;
+  signal(SIGINT, SIG_DFL);
+}
+
+int
+main(int argc, char **argv)
+{
+  char *address = "0.0.0.0";
+  int port = 1935;
+  int i;
+  uint64_t lastBytes = 0, lastMsgs = 0;
+
+  RTMP_LogPrintf("RTMP Ingest Server %s\n", RTMPDUMP_VERSION);
+  RTMP_debuglevel = RTMP_LOGINFO;
+
+  for (i = 1; i < argc; i++)
+    {
+      if (!strcmp(argv[i], "-z"))
+	RTMP_debuglevel = RTMP_LOGALL;
+      else if (!strcmp(argv[i], "-q"))
+	RTMP_debuglevel = RTMP_LOGWARNING;
+      else if (!strcmp(argv[i], "-a") && i + 1 < argc)
+	address = argv[++i];
+      else if (!strcmp(argv[i], "-p") && i + 1 < argc)
+	port = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+	nworkers = atoi(argv[++i]);
+      else
+	{
+	  RTMP_LogPrintf("usage: %s [-a address] [-p port] [-t threads] [-q] [-z]\n", argv[0]);
+	  return RD_FAILED;
+	}
+    }
+  if (nworkers < 1)
+    nworkers = 1;
+  if (nworkers > MAX_WORKERS)
+    nworkers = MAX_WORKERS;
+
+  signal(SIGINT, sigIntHandler);
+  signal(SIGTERM, sigIntHandler);
+  signal(SIGPIPE, SIG_IGN);
+
+  for (i = 0; i < nworkers; i++)
+    {
+      INGEST_WORKER *w = &workers[i];
+      struct epoll_event ev;
+
+      w->index = i;
+      w->listenfd = OpenListener(address, port);
+      w->epfd = epoll_create1(EPOLL_CLOEXEC);
+      if (w->listenfd < 0 || w->epfd < 0)
+	{
+	  RTMP_Log(RTMP_LOGERROR, "Failed to start RTMP ingest worker %d, exiting!", i);
+	  return RD_FAILED;
+	}
+      ev.events = EPOLLIN;
+      ev.data.ptr = NULL;
+      epoll_ctl(w->epfd, EPOLL_CTL_ADD, w->listenfd, &ev);
+    }
+  for (i = 0; i < nworkers; i++)
+    ThreadCreate(workerThread, &workers[i]);
+
+  RTMP_LogPrintf("Ingesting on rtmp://%s:%d with %d worker(s)\n", address, port, nworkers);
+
+  while (running)
+    {
+      uint64_t bytes = 0, msgs = 0;
+      uint32_t publishing = 0, accepted = 0;
+
+      sleep(1);
+      for (i = 0; i < nworkers; i++)
+	{
+	  bytes += workers[i].bytesIn;
+	  msgs += workers[i].mediaMsgs;
+	  publishing += workers[i].publishing;
+	  accepted += workers[i].accepted;
+	}
+      RTMP_LogPrintf("publishing %u, accepted %u, %.2f Mbit/s, %llu msg/s\n",
+	  publishing, accepted, (bytes - lastBytes) * 8 / 1e6,
+	  (unsigned long long)(msgs - lastMsgs));
+      lastBytes = bytes;
+      lastMsgs = msgs;
+    }
+
+  /* give the workers a moment to notice and close their sessions */
+  sleep(1);
+  for (i = 0; i < nworkers; i++)
+    {
+      closesocket(workers[i].listenfd);
+      close(workers[i].epfd);
+    }
+  return RD_SUCCESS;
+}
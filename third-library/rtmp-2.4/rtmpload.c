@@ -0,0 +1,380 @@
+/*  RTMP Publish Load Generator
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RTMPDump; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA  02110-1301, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/* Opens N concurrent publishers against an RTMP server using the regular
+ * librtmp client (RTMP_Connect/RTMP_ConnectStream in write mode) and feeds
+ * each one with synthetic audio/video messages at a fixed bitrate, or with
+ * the tags of an FLV file through RTMP_Write(), paced in real time.
+ *
+ *   rtmpload -r rtmp://127.0.0.1/live/load -n 300 -b 1000 -d 60
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#include "librtmp/rtmp_sys.h"
+#include "librtmp/log.h"
+
+#include "thread.h"
+
+#define RD_SUCCESS		0
+#define RD_FAILED		1
+
+typedef struct
+{
+  int index;
+  volatile int connected;
+  volatile int failed;
+  volatile uint64_t bytesOut;
+} PUBLISHER;
+
+static char *url = "rtmp://127.0.0.1:1935/live/load";
+static char *flvData;
+static int flvSize;
+static int nPublishers = 10;
+static int kbps = 1000;
+static int fps = 25;
+static int gop = 50;
+static int chunkSize = 4096;
+static int duration = 30;
+static volatile int running = TRUE;
+
+static PUBLISHER *publishers;
+
+static int
+SendChunkSize(RTMP *r, int size)
+{
+  RTMPPacket packet;
+  char pbuf[RTMP_MAX_HEADER_SIZE + 4];
+
+  packet.m_nChannel = 0x02;	/* control channel */
+  packet.m_headerType = RTMP_PACKET_SIZE_LARGE;
+  packet.m_packetType = RTMP_PACKET_TYPE_CHUNK_SIZE;
+  packet.m_nTimeStamp = 0;
+  packet.m_nInfoField2 = 0;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = pbuf + RTMP_MAX_HEADER_SIZE;
+  packet.m_nBodySize = 4;
+  AMF_EncodeInt32(packet.m_body, packet.m_body + 4, size);
+
+  if (!RTMP_SendPacket(r, &packet, FALSE))
+    return FALSE;
+  r->m_outChunkSize = size;
+  return TRUE;
+}
+
+static int
+SendMedia(RTMP *r, int type, uint32_t ts, char *body, int size)
+{
+  RTMPPacket packet;
+
+  packet.m_nChannel = 0x04;	/* source channel */
+  packet.m_headerType = RTMP_PACKET_SIZE_MEDIUM;
+  packet.m_packetType = type;
+  packet.m_nTimeStamp = ts;
+  packet.m_nInfoField2 = r->m_stream_id;
+  packet.m_hasAbsTimestamp = 0;
+  packet.m_body = body;
+  packet.m_nBodySize = size;
+  return RTMP_SendPacket(r, &packet, FALSE);
+}
+
+/* synthetic AVC video at kbps*7/8 plus 20ms AAC frames for the rest */
+static int
+PublishSynthetic(PUBLISHER *p, RTMP *r)
+{
+  int videoSize = kbps * 1000 / 8 * 7 / 8 / fps;
+  int audioSize = kbps * 1000 / 8 / 8 / 50;
+  char *vbuf, *abuf;
+  uint32_t start = RTMP_GetTime(), frame = 0, audioTs = 0;
+  int ret = TRUE;
+
+  if (audioSize < 4)
+    audioSize = 4;
+  vbuf = calloc(1, RTMP_MAX_HEADER_SIZE + videoSize + 5);
+  abuf = calloc(1, RTMP_MAX_HEADER_SIZE + audioSize + 2);
+  if (!vbuf || !abuf)
+    {
+      free(vbuf);
+      free(abuf);
+      return FALSE;
+    }
+
+  while (running && RTMP_IsConnected(r))
+    {
+      uint32_t ts = frame * 1000 / fps;
+      uint32_t now = RTMP_GetTime() - start;
+      char *v = vbuf + RTMP_MAX_HEADER_SIZE;
+      char *a = abuf + RTMP_MAX_HEADER_SIZE;
+
+      if (now >= (uint32_t)duration * 1000)
+	break;
+      if (ts > now)
+	{
+	  msleep((ts - now));
+	  continue;
+	}
+
+      v[0] = (frame % gop == 0) ? 0x17 : 0x27;	/* key/inter frame, AVC */
+      v[1] = 1;					/* NALU */
+      if (!SendMedia(r, RTMP_PACKET_TYPE_VIDEO, ts, v, videoSize + 5))
+	{
+	  ret = FALSE;
+	  break;
+	}
+      p->bytesOut += videoSize + 5;
+
+      for (; audioTs <= ts; audioTs += 20)
+	{
+	  a[0] = (char)0xaf;			/* AAC 44.1k stereo */
+	  a[1] = 1;
+	  if (!SendMedia(r, RTMP_PACKET_TYPE_AUDIO, audioTs, a, audioSize + 2))
+	    {
+	      ret = FALSE;
+	      break;
+	    }
+	  p->bytesOut += audioSize + 2;
+	}
+      frame++;
+    }
+
+  free(vbuf);
+  free(abuf);
+  return ret;
+}
+
+/* replays the FLV tags, looping, paced by their timestamps. Tags are
+ * rebased in place, so each publisher works on its own copy of the file. */
+static int
+PublishFLV(PUBLISHER *p, RTMP *r)
+{
+  uint32_t start = RTMP_GetTime(), base = 0, lastTs = 0;
+  char *data = malloc(flvSize);
+  int ret = TRUE;
+
+  if (!data)
+    return FALSE;
+
+  while (ret && running && RTMP_IsConnected(r))
+    {
+      int pos = 13;		/* skip FLV header + PreviousTagSize0 */
+
+      memcpy(data, flvData, flvSize);
+      while (running && pos + 11 <= flvSize)
+	{
+	  int tagSize = AMF_DecodeInt24(data + pos + 1) + 11 + 4;
+	  uint32_t ts = AMF_DecodeInt24(data + pos + 4) |
+	    ((unsigned char)data[pos + 7] << 24);
+	  uint32_t now = RTMP_GetTime() - start;
+
+	  if (pos + tagSize > flvSize)
+	    break;
+	  if (now >= (uint32_t)duration * 1000)
+	    {
+	      free(data);
+	      return TRUE;
+	    }
+	  lastTs = base + ts;
+	  if (lastTs > now)
+	    msleep((lastTs - now));
+
+	  AMF_EncodeInt24(data + pos + 4, data + pos + 7, lastTs & 0xffffff);
+	  data[pos + 7] = lastTs >> 24;
+	  if (RTMP_Write(r, data + pos, tagSize) <= 0)
+	    {
+	      ret = FALSE;
+	      break;
+	    }
+
+	  p->bytesOut += tagSize;
+	  pos += tagSize;
+	}
+      base = lastTs + 40;
+    }
+  free(data);
+  return ret;
+}
+
+static TFTYPE
+publisherThread(void *arg)
+{
+  PUBLISHER *p = arg;
+  RTMP *r = RTMP_Alloc();
+  char purl[1024];
+  int ok;
+
+  snprintf(purl, sizeof(purl), "%s%d", url, p->index);
+
+  RTMP_Init(r);
+  if (!RTMP_SetupURL(r, purl))
+    {
+      p->failed = TRUE;
+      RTMP_Free(r);
+      TFRET();
+    }
+  RTMP_EnableWrite(r);
+
+  if (!RTMP_Connect(r, NULL) || !RTMP_ConnectStream(r, 0))
+    {
+      RTMP_Log(RTMP_LOGERROR, "publisher %d: connect failed", p->index);
+      p->failed = TRUE;
+      RTMP_Close(r);
+      RTMP_Free(r);
+      TFRET();
+    }
+  p->connected = TRUE;
+
+  ok = SendChunkSize(r, chunkSize);
+  if (ok)
+    {
+      if (flvData)
+	ok = PublishFLV(p, r);
+      else
+	ok = PublishSynthetic(p, r);
+    }
+  if (!ok)
+    {
+      RTMP_Log(RTMP_LOGERROR, "publisher %d: send failed", p->index);
+      p->failed = TRUE;
+    }
+
+  p->connected = FALSE;
+  RTMP_Close(r);
+  RTMP_Free(r);
+  TFRET();
+}
+
+static int
+LoadFLV(const char *path)
+{
+  FILE *fp = fopen(path, "rb");
+  long size;
+
+  if (!fp)
+    return FALSE;
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  flvData = malloc(size);
+  if (!flvData || fread(flvData, 1, size, fp) != (size_t)size ||
+      size < 13 || memcmp(flvData, "FLV", 3))
+    {
+      fclose(fp);
+      free(flvData);
+      flvData = NULL;
+      return FALSE;
+    }
+  fclose(fp);
+  flvSize = size;
+  return TRUE;
+}
+
+static void
+sigIntHandler(int sig)
+{
+  running = FALSE;
+  signal(SIGINT, SIG_DFL);
+}
+
+int
+main(int argc, char **argv)
+{
+  char *flv = NULL;
+  uint64_t lastBytes = 0;
+  uint32_t start;
+  int i;
+
+  RTMP_LogPrintf("RTMP Load Generator %s\n", RTMPDUMP_VERSION);
+  RTMP_debuglevel = RTMP_LOGWARNING;
+
+  for (i = 1; i < argc; i++)
+    {
+      if (!strcmp(argv[i], "-r") && i + 1 < argc)
+	url = argv[++i];
+      else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+	nPublishers = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+	kbps = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+	fps = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-g") && i + 1 < argc)
+	gop = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+	chunkSize = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+	duration = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+	flv = argv[++i];
+      else if (!strcmp(argv[i], "-z"))
+	RTMP_debuglevel = RTMP_LOGALL;
+      else
+	{
+	  RTMP_LogPrintf("usage: %s [-r url] [-n publishers] [-b kbps] [-f fps] [-g gop]\n"
+	      "\t[-c chunksize] [-d seconds] [-i file.flv] [-z]\n"
+	      "stream names are the url with the publisher index appended\n", argv[0]);
+	  return RD_FAILED;
+	}
+    }
+  if (nPublishers < 1 || fps < 1 || gop < 1 || kbps < 1 || chunkSize < 128)
+    {
+      RTMP_Log(RTMP_LOGERROR, "invalid arguments");
+      return RD_FAILED;
+    }
+  if (flv && !LoadFLV(flv))
+    {
+      RTMP_Log(RTMP_LOGERROR, "couldn't load %s", flv);
+      return RD_FAILED;
+    }
+
+  signal(SIGINT, sigIntHandler);
+  signal(SIGPIPE, SIG_IGN);
+
+  publishers = calloc(nPublishers, sizeof(PUBLISHER));
+  if (!publishers)
+    return RD_FAILED;
+  for (i = 0; i < nPublishers; i++)
+    {
+      publishers[i].index = i;
+      ThreadCreate(publisherThread, &publishers[i]);
+    }
+
+  start = RTMP_GetTime();
+  while (running && RTMP_GetTime() - start < (uint32_t)(duration + 1) * 1000)
+    {
+      uint64_t bytes = 0;
+      int connected = 0, failed = 0;
+
+      sleep(1);
+      for (i = 0; i < nPublishers; i++)
+	{
+	  bytes += publishers[i].bytesOut;
+	  connected += publishers[i].connected;
+	  failed += publishers[i].failed;
+	}
+      RTMP_LogPrintf("connected %d, failed %d, %.2f Mbit/s\n",
+	  connected, failed, (bytes - lastBytes) * 8 / 1e6);
+      lastBytes = bytes;
+    }
+  running = FALSE;
+  sleep(1);
+
+  return RD_SUCCESS;
+}
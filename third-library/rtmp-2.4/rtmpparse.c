@@ -0,0 +1,493 @@
+/*  RTMP Chunk Parser Benchmark
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RTMPDump; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA  02110-1301, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/* Batch-parses a chunk stream with RTMPChunkParser at memory speed.
+ *
+ * The input is either a capture of the inbound byte stream (for instance
+ * the netstackdump_read file a _DEBUG build writes; use -s 3073 to skip
+ * the client side handshake) or, by default, a synthesized one hour
+ * 2.5 Mbit/s A/V stream using every header type.
+ *
+ *   -v  re-parses with random split points and checks the messages match
+ *   -c  also pushes the stream through RTMP_ReadPacket() over a socketpair
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "librtmp/rtmp_sys.h"
+#include "librtmp/log.h"
+
+#include "thread.h"
+
+#define RD_SUCCESS		0
+#define RD_FAILED		1
+
+#define AUDIO_CHANNEL		4
+#define VIDEO_CHANNEL		6
+
+typedef struct
+{
+  uint64_t messages;
+  uint64_t bodyBytes;
+  uint64_t checksum;
+  uint32_t firstTs;
+  uint32_t lastTs;
+  int media;
+} PARSE_STATS;
+
+typedef struct
+{
+  char *data;
+  int size;
+  int alloc;
+  /* per channel state to pick the smallest header, as RTMP_SendPacket() does */
+  int started[VIDEO_CHANNEL + 1];
+  uint32_t lastSize[VIDEO_CHANNEL + 1];
+  uint32_t lastDelta[VIDEO_CHANNEL + 1];
+  uint8_t lastType[VIDEO_CHANNEL + 1];
+} STREAM_BUF;
+
+/* the stream: preamble once, then segment repeated */
+static STREAM_BUF preamble, segment;
+static int repeats = 1;
+static int blockSize = RTMP_BUFFER_CACHE_SIZE;
+
+static double
+Now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static char *
+Reserve(STREAM_BUF *sb, int n)
+{
+  if (sb->size + n > sb->alloc)
+    {
+      int alloc = sb->alloc ? sb->alloc * 2 : 1024 * 1024;
+      char *data;
+      while (alloc < sb->size + n)
+	alloc *= 2;
+      data = realloc(sb->data, alloc);
+      if (!data)
+	{
+	  RTMP_Log(RTMP_LOGCRIT, "out of memory");
+	  exit(RD_FAILED);
+	}
+      sb->data = data;
+      sb->alloc = alloc;
+    }
+  return sb->data + sb->size;
+}
+
+static void
+EncodeMessage(STREAM_BUF *sb, int channel, int type, uint32_t ts, int streamID,
+	      int size, int chunkSize)
+{
+  int headerType = RTMP_PACKET_SIZE_LARGE;
+  uint32_t tsField = ts;
+  char *ptr;
+  int i;
+
+  if (sb->started[channel])
+    {
+      headerType = RTMP_PACKET_SIZE_MEDIUM;
+      if (sb->lastSize[channel] == size && sb->lastType[channel] == type)
+	headerType = RTMP_PACKET_SIZE_SMALL;
+      if (headerType == RTMP_PACKET_SIZE_SMALL && sb->lastDelta[channel] == ts)
+	headerType = RTMP_PACKET_SIZE_MINIMUM;
+    }
+  sb->started[channel] = TRUE;
+  sb->lastSize[channel] = size;
+  sb->lastType[channel] = type;
+  sb->lastDelta[channel] = ts;
+
+  ptr = Reserve(sb, RTMP_MAX_HEADER_SIZE + size + (size / chunkSize + 1));
+  *ptr++ = (headerType << 6) | channel;
+  if (headerType < RTMP_PACKET_SIZE_MINIMUM)
+    {
+      ptr = AMF_EncodeInt24(ptr, ptr + 3, tsField >= 0xffffff ? 0xffffff : tsField);
+      if (headerType < RTMP_PACKET_SIZE_SMALL)
+	{
+	  ptr = AMF_EncodeInt24(ptr, ptr + 3, size);
+	  *ptr++ = type;
+	  if (headerType == RTMP_PACKET_SIZE_LARGE)
+	    {
+	      *ptr++ = streamID;
+	      *ptr++ = streamID >> 8;
+	      *ptr++ = streamID >> 16;
+	      *ptr++ = streamID >> 24;
+	    }
+	}
+      if (tsField >= 0xffffff)
+	ptr = AMF_EncodeInt32(ptr, ptr + 4, tsField);
+    }
+
+  for (i = 0; i < size; i++)
+    {
+      if (i && i % chunkSize == 0)
+	*ptr++ = 0xc0 | channel;
+      *ptr++ = (char)(i * 31 + size);
+    }
+  sb->size = ptr - sb->data;
+}
+
+/* 30 fps video with a 2 s GOP, 44.1 kHz AAC frames */
+static void
+Synthesize(int kbps, int segmentSecs, int chunkSize)
+{
+  int frameSize = kbps * 1000 / 8 * 15 / 16 / 30;
+  int audioSize = kbps * 1000 / 8 / 16 * 1024 / 44100;
+  uint32_t vts = 0, ats = 0, aframes = 0, vframes = 0;
+  char cs[4];
+
+  if (audioSize < 8)
+    audioSize = 8;
+
+  /* set chunk size, then the first audio/video messages with type 0 headers */
+  AMF_EncodeInt32(cs, cs + 4, chunkSize);
+  EncodeMessage(&preamble, 2, RTMP_PACKET_TYPE_CHUNK_SIZE, 0, 0, 4, RTMP_DEFAULT_CHUNKSIZE);
+  memcpy(preamble.data + preamble.size - 4, cs, 4);
+  EncodeMessage(&preamble, AUDIO_CHANNEL, RTMP_PACKET_TYPE_AUDIO, 0, 1, audioSize, chunkSize);
+  EncodeMessage(&preamble, VIDEO_CHANNEL, RTMP_PACKET_TYPE_VIDEO, 0, 1, frameSize * 8, chunkSize);
+  segment.started[AUDIO_CHANNEL] = segment.started[VIDEO_CHANNEL] = TRUE;
+  segment.lastType[AUDIO_CHANNEL] = RTMP_PACKET_TYPE_AUDIO;
+  segment.lastType[VIDEO_CHANNEL] = RTMP_PACKET_TYPE_VIDEO;
+
+  /* interleave by timestamp; deltas must repeat cleanly across segments */
+  while (vframes < (uint32_t)segmentSecs * 30)
+    {
+      uint32_t nextA = (uint32_t)((uint64_t)(aframes + 1) * 1024 * 1000 / 44100);
+      uint32_t nextV = (vframes + 1) * 1000 / 30;
+
+      if (nextA <= nextV)
+	{
+	  EncodeMessage(&segment, AUDIO_CHANNEL, RTMP_PACKET_TYPE_AUDIO, nextA - ats, 1,
+	      audioSize, chunkSize);
+	  ats = nextA;
+	  aframes++;
+	}
+      else
+	{
+	  int size = (vframes + 1) % 60 ? frameSize + (vframes % 7) * 16 : frameSize * 8;
+	  EncodeMessage(&segment, VIDEO_CHANNEL, RTMP_PACKET_TYPE_VIDEO, nextV - vts, 1,
+	      size, chunkSize);
+	  vts = nextV;
+	  vframes++;
+	}
+    }
+}
+
+static int
+LoadCapture(const char *path, int skip)
+{
+  FILE *fp = fopen(path, "rb");
+  long size;
+
+  if (!fp)
+    return FALSE;
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp) - skip;
+  fseek(fp, skip, SEEK_SET);
+  if (size <= 0 || !Reserve(&preamble, size) ||
+      fread(preamble.data, 1, size, fp) != (size_t)size)
+    {
+      fclose(fp);
+      return FALSE;
+    }
+  preamble.size = size;
+  fclose(fp);
+  repeats = 0;
+  return TRUE;
+}
+
+static void
+Account(PARSE_STATS *st, const RTMPPacket *packet)
+{
+  st->messages++;
+  st->bodyBytes += packet->m_nBodySize;
+  st->checksum = st->checksum * 31 + packet->m_nTimeStamp + packet->m_nChannel +
+    packet->m_packetType + packet->m_nBodySize +
+    (packet->m_nBodySize ? (uint8_t)packet->m_body[packet->m_nBodySize - 1] : 0);
+  if (packet->m_packetType == RTMP_PACKET_TYPE_AUDIO ||
+      packet->m_packetType == RTMP_PACKET_TYPE_VIDEO)
+    {
+      if (!st->media++)
+	st->firstTs = packet->m_nTimeStamp;
+      st->lastTs = packet->m_nTimeStamp;
+    }
+}
+
+static int
+OnPacket(void *opaque, RTMPPacket *packet)
+{
+  Account(opaque, packet);
+  return TRUE;
+}
+
+/* blocks of blockSize, or random 1..maxSplit sized pieces if maxSplit */
+static int
+FeedAll(RTMPChunkParser *cp, const STREAM_BUF *sb, int maxSplit)
+{
+  int pos = 0;
+
+  while (pos < sb->size)
+    {
+      int n = maxSplit ? 1 + rand() % maxSplit : blockSize;
+      if (n > sb->size - pos)
+	n = sb->size - pos;
+      if (!RTMPChunkParser_Feed(cp, sb->data + pos, n))
+	return FALSE;
+      pos += n;
+    }
+  return TRUE;
+}
+
+static int
+Parse(PARSE_STATS *st, int maxSplit, int segments)
+{
+  RTMPChunkParser cp;
+  int i, ret = TRUE;
+
+  memset(st, 0, sizeof(PARSE_STATS));
+  RTMPChunkParser_Init(&cp, OnPacket, st);
+  ret = FeedAll(&cp, &preamble, maxSplit);
+  for (i = 0; ret && i < segments; i++)
+    ret = FeedAll(&cp, &segment, maxSplit);
+  RTMPChunkParser_Free(&cp);
+  return ret;
+}
+
+/* a peer starting messages it never finishes, on one chunk stream after
+ * another, must run into the parser's body limits rather than our memory */
+static int
+FloodRejected(uint32_t bodySize, int channels)
+{
+  RTMPChunkParser cp;
+  PARSE_STATS st;
+  char chunk[3 + 11 + 128];
+  int i, fed = TRUE;
+
+  memset(&st, 0, sizeof(PARSE_STATS));
+  memset(chunk, 0, sizeof(chunk));
+  RTMPChunkParser_Init(&cp, OnPacket, &st);
+  RTMP_debuglevel = RTMP_LOGCRIT;
+  for (i = 0; fed && i < channels; i++)
+    {
+      int channel = 64 + i;
+      char *ptr = chunk;
+
+      /* type 0 header with a three byte basic header, then one chunk */
+      *ptr++ = 1;
+      *ptr++ = channel - 64;
+      *ptr++ = (channel - 64) >> 8;
+      ptr = AMF_EncodeInt24(ptr, ptr + 3, 0);
+      ptr = AMF_EncodeInt24(ptr, ptr + 3, bodySize);
+      *ptr++ = RTMP_PACKET_TYPE_VIDEO;
+      *ptr++ = 1;	/* stream id, little endian */
+      *ptr++ = 0;
+      *ptr++ = 0;
+      *ptr++ = 0;
+      fed = RTMPChunkParser_Feed(&cp, chunk, ptr - chunk + 128);
+    }
+  RTMP_debuglevel = RTMP_LOGWARNING;
+  RTMPChunkParser_Free(&cp);
+  return !fed;
+}
+
+static int writerFd;
+
+static TFTYPE
+writerThread(void *unused)
+{
+  int i;
+
+  send(writerFd, preamble.data, preamble.size, 0);
+  for (i = 0; i < repeats; i++)
+    {
+      int pos = 0;
+      while (pos < segment.size)
+	{
+	  int n = send(writerFd, segment.data + pos, segment.size - pos, 0);
+	  if (n <= 0)
+	    break;
+	  pos += n;
+	}
+    }
+  shutdown(writerFd, SHUT_WR);
+  TFRET();
+}
+
+/* the same stream through the blocking RTMP_ReadPacket() path */
+static void
+ParseBlocking(PARSE_STATS *st)
+{
+  RTMP r;
+  RTMPPacket packet = { 0 };
+  int fds[2];
+
+  memset(st, 0, sizeof(PARSE_STATS));
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+    return;
+  RTMP_Init(&r);
+  r.m_sb.sb_socket = fds[0];
+  writerFd = fds[1];
+  ThreadCreate(writerThread, NULL);
+
+  /* the stream simply ends, don't report that as a header error */
+  RTMP_debuglevel = RTMP_LOGCRIT;
+  while (RTMP_ReadPacket(&r, &packet))
+    {
+      if (!RTMPPacket_IsReady(&packet))
+	continue;
+      if (packet.m_packetType == RTMP_PACKET_TYPE_CHUNK_SIZE)
+	r.m_inChunkSize = AMF_DecodeInt32(packet.m_body);
+      Account(st, &packet);
+      RTMPPacket_Free(&packet);
+    }
+  RTMP_debuglevel = RTMP_LOGWARNING;
+  RTMP_Close(&r);
+  closesocket(fds[1]);
+}
+
+static void
+Report(const char *name, const PARSE_STATS *st, uint64_t bytes, double secs)
+{
+  double mediaSecs = (st->lastTs - st->firstTs) / 1000.0;
+
+  RTMP_LogPrintf("%-16s %10.3f s  %9.1f MB/s  %11.0f msg/s  %8.0fx realtime\n",
+      name, secs, bytes / secs / 1e6, st->messages / secs,
+      secs > 0 ? mediaSecs / secs : 0);
+}
+
+int
+main(int argc, char **argv)
+{
+  char *capture = NULL;
+  int skip = 0, kbps = 2500, minutes = 60, segmentSecs = 10, chunkSize = 4096;
+  int verify = FALSE, compare = FALSE;
+  PARSE_STATS st, ref;
+  uint64_t bytes;
+  double t;
+  int i;
+
+  RTMP_debuglevel = RTMP_LOGWARNING;
+
+  for (i = 1; i < argc; i++)
+    {
+      if (!strcmp(argv[i], "-i") && i + 1 < argc)
+	capture = argv[++i];
+      else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+	skip = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+	kbps = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-m") && i + 1 < argc)
+	minutes = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-k") && i + 1 < argc)
+	chunkSize = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+	blockSize = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-v"))
+	verify = TRUE;
+      else if (!strcmp(argv[i], "-c"))
+	compare = TRUE;
+      else
+	{
+	  RTMP_LogPrintf("usage: %s [-i capture [-s skip]] [-b kbps] [-m minutes] [-k chunksize]\n"
+	      "\t[-n feedsize] [-v] [-c]\n", argv[0]);
+	  return RD_FAILED;
+	}
+    }
+  if (blockSize < 1 || chunkSize < 1 || kbps < 16 || minutes < 1)
+    {
+      RTMP_Log(RTMP_LOGERROR, "invalid arguments");
+      return RD_FAILED;
+    }
+
+  if (capture)
+    {
+      if (!LoadCapture(capture, skip))
+	{
+	  RTMP_Log(RTMP_LOGERROR, "couldn't load %s", capture);
+	  return RD_FAILED;
+	}
+    }
+  else
+    {
+      Synthesize(kbps, segmentSecs, chunkSize);
+      repeats = minutes * 60 / segmentSecs;
+    }
+  bytes = preamble.size + (uint64_t)segment.size * repeats;
+  RTMP_LogPrintf("%.1f MB chunk stream, feeding %d byte blocks\n", bytes / 1e6, blockSize);
+
+  t = Now();
+  if (!Parse(&st, 0, repeats))
+    {
+      RTMP_Log(RTMP_LOGERROR, "parse failed after %llu messages",
+	  (unsigned long long)st.messages);
+      return RD_FAILED;
+    }
+  t = Now() - t;
+  RTMP_LogPrintf("%llu messages, %llu body bytes, %.1f s of media\n",
+      (unsigned long long)st.messages, (unsigned long long)st.bodyBytes,
+      (st.lastTs - st.firstTs) / 1000.0);
+  Report("RTMPChunkParser", &st, bytes, t);
+
+  if (verify)
+    {
+      int segments = repeats < 6 ? repeats : 6;
+      PARSE_STATS whole, split;
+      int ok = Parse(&whole, 0, segments);
+
+      for (i = 1; ok && i <= 64; i *= 4)
+	{
+	  ok = Parse(&split, i, segments) &&
+	    split.messages == whole.messages && split.checksum == whole.checksum;
+	}
+      RTMP_LogPrintf("split feeding %s\n", ok ? "matches" : "MISMATCH");
+      if (!ok)
+	return RD_FAILED;
+
+      ok = FloodRejected(RTMP_CHUNK_MAX_BODY + 1, 1) &&
+	FloodRejected(RTMP_CHUNK_MAX_BODY, 1000) &&
+	!FloodRejected(64 * 1024, 100);
+      RTMP_LogPrintf("body limits %s\n", ok ? "hold" : "NOT ENFORCED");
+      if (!ok)
+	return RD_FAILED;
+    }
+
+  if (compare)
+    {
+      t = Now();
+      ParseBlocking(&ref);
+      t = Now() - t;
+      Report("RTMP_ReadPacket", &ref, bytes, t);
+      if (ref.messages != st.messages || ref.checksum != st.checksum)
+	{
+	  RTMP_LogPrintf("RTMP_ReadPacket disagrees: %llu messages\n",
+	      (unsigned long long)ref.messages);
+	  return RD_FAILED;
+	}
+    }
+  return RD_SUCCESS;
+}